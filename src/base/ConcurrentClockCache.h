@@ -0,0 +1,376 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_BASE_CONCURRENTCLOCKCACHE_H_
+#define COMMON_BASE_CONCURRENTCLOCKCACHE_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include <boost/optional.hpp>
+#include <folly/SharedMutex.h>
+#include <folly/ThreadCachedInt.h>
+#include <gtest/gtest_prod.h>
+
+namespace nebula {
+
+template<class Key, class Value>
+class ClockBucket;
+
+/**
+ * A drop-in alternative of ConcurrentLRUCache, with the same interface, which
+ * approximates LRU with the CLOCK algorithm.
+ *
+ * Instead of moving the entry to the front of a list on every hit, get() only
+ * sets the access bit of the entry, which needs no exclusive lock. So readers
+ * only share the read lock of the bucket, and they don't write any shared cache
+ * line unless the access bit was cleared by the clock hand. On insertion into a
+ * full bucket, the clock hand sweeps over the entries, clearing the access bits,
+ * until it finds one not accessed since the last sweep to evict.
+ *
+ * All entries of a bucket live in a slab allocated up front, indexed by an
+ * open-addressing hash table of slab positions, so there is no allocation per
+ * insertion other than the ones of the key and the value themselves.
+ *
+ * To avoid copying large values, visit() calls a visitor with a const reference
+ * to the cached value while holding the read lock.
+ */
+template<typename K, typename V>
+class ConcurrentClockCache final {
+    FRIEND_TEST(ConcurrentClockCacheTest, SimpleTest);
+
+public:
+    explicit ConcurrentClockCache(size_t capacity, uint32_t bucketsExp = 4)
+        : bucketsNum_(1 << bucketsExp)
+        , bucketsExp_(bucketsExp) {
+        CHECK(capacity > bucketsNum_ && bucketsNum_ > 0);
+        auto capPerBucket = capacity >> bucketsExp;
+        auto left = capacity;
+        for (uint32_t i = 0; i < bucketsNum_ - 1; i++) {
+            buckets_.emplace_back(std::make_unique<ClockBucket<K, V>>(capPerBucket));
+            left -= capPerBucket;
+        }
+        CHECK_GT(left, 0);
+        buckets_.emplace_back(std::make_unique<ClockBucket<K, V>>(left));
+    }
+
+    bool contains(const K& key, int32_t hint = -1) {
+        auto hash = std::hash<K>()(key);
+        return buckets_[bucketIndex(hash, hint)]->contains(key, hash);
+    }
+
+    void insert(K key, V val, int32_t hint = -1) {
+        auto hash = std::hash<K>()(key);
+        buckets_[bucketIndex(hash, hint)]->insert(std::move(key), std::move(val), hash);
+    }
+
+    StatusOr<V> get(const K& key, int32_t hint = -1) {
+        boost::optional<V> v;
+        visit(key, [&v] (const V& val) {
+            v = val;
+        }, hint);
+        if (v == boost::none) {
+            return Status::Error();
+        }
+        return std::move(v).value();
+    }
+
+    /**
+     * Call `visitor' with the cached value of `key' without copying it, return false
+     * if the key is not cached. The bucket is read-locked during the visit, so
+     * `visitor' should be short, and must not access the cache.
+     * */
+    template <typename F>
+    bool visit(const K& key, F&& visitor, int32_t hint = -1) {
+        total_.increment(1);
+        auto hash = std::hash<K>()(key);
+        if (!buckets_[bucketIndex(hash, hint)]->visit(key, hash, std::forward<F>(visitor))) {
+            return false;
+        }
+        hits_.increment(1);
+        return true;
+    }
+
+    /**
+     * Insert the {key, val} if key not existed, and return Status::Inserted.
+     * Otherwise, just return the value for the existed key.
+     * */
+    StatusOr<V> putIfAbsent(K key, V val, int32_t hint = -1) {
+        total_.increment(1);
+        auto hash = std::hash<K>()(key);
+        auto v = buckets_[bucketIndex(hash, hint)]->putIfAbsent(std::move(key),
+                                                                 std::move(val),
+                                                                 hash);
+        if (v == boost::none) {
+            return Status::Inserted();
+        }
+        hits_.increment(1);
+        return std::move(v).value();
+    }
+
+    void evict(const K& key, int32_t hint = -1) {
+        auto hash = std::hash<K>()(key);
+        buckets_[bucketIndex(hash, hint)]->evict(key, hash);
+    }
+
+    void clear() {
+        for (uint32_t i = 0; i < bucketsNum_; i++) {
+            buckets_[i]->clear();
+        }
+        total_.set(0);
+        hits_.set(0);
+    }
+
+    uint64_t total() {
+        return total_.readFull();
+    }
+
+    uint64_t hits() {
+        return hits_.readFull();
+    }
+
+    uint64_t evicts() {
+        uint64_t evicts = 0;
+        for (uint32_t i = 0; i < bucketsNum_; i++) {
+            evicts += buckets_[i]->evicts();
+        }
+        return evicts;
+    }
+
+private:
+    /**
+     * If hint is specified, we could use it to cal the bucket index directly without hash key.
+     * */
+    uint32_t bucketIndex(size_t hash, int32_t hint = -1) {
+        return hint >= 0 ? (hint & ((1 << bucketsExp_) - 1))
+                         : (hash & ((1 << bucketsExp_) - 1));
+    }
+
+private:
+    std::vector<std::unique_ptr<ClockBucket<K, V>>> buckets_;
+    uint32_t bucketsNum_ = 1;
+    uint32_t bucketsExp_ = 0;
+    // Bumped by every reader, so keep them thread local
+    folly::ThreadCachedInt<uint64_t> total_{0};
+    folly::ThreadCachedInt<uint64_t> hits_{0};
+};
+
+
+/**
+ * One bucket of ConcurrentClockCache, i.e. a fixed-capacity slab of entries,
+ * a hash index and a clock hand, guarded by a reader-writer lock.
+ */
+template<class Key, class Value>
+class ClockBucket final {
+public:
+    explicit ClockBucket(size_t capacity)
+        : capacity_(capacity)
+        , entries_(new Entry[capacity]) {
+        CHECK_LT(capacity, static_cast<size_t>(kEmpty));
+        size_t tableSize = 1;
+        while (tableSize < capacity * 2) {
+            tableSize <<= 1;
+        }
+        table_.resize(tableSize, kEmpty);
+        tableMask_ = tableSize - 1;
+        freeList_.reserve(capacity);
+        resetFreeList();
+    }
+
+    ClockBucket(const ClockBucket&) = delete;
+    ClockBucket& operator=(const ClockBucket&) = delete;
+
+    size_t size() {
+        folly::SharedMutex::ReadHolder rh(lock_);
+        return capacity_ - freeList_.size();
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    bool contains(const Key& key, size_t hash) {
+        folly::SharedMutex::ReadHolder rh(lock_);
+        return find(key, hash) != kEmpty;
+    }
+
+    template <typename F>
+    bool visit(const Key& key, size_t hash, F&& visitor) {
+        folly::SharedMutex::ReadHolder rh(lock_);
+        auto pos = find(key, hash);
+        if (pos == kEmpty) {
+            return false;
+        }
+        auto& entry = entries_[pos];
+        // Only write the cache line if the clock hand has cleared the bit
+        if (!entry.accessed.load(std::memory_order_relaxed)) {
+            entry.accessed.store(true, std::memory_order_relaxed);
+        }
+        visitor(static_cast<const Value&>(entry.kv->second));
+        return true;
+    }
+
+    void insert(Key&& key, Value&& value, size_t hash) {
+        folly::SharedMutex::WriteHolder wh(lock_);
+        if (find(key, hash) == kEmpty) {
+            insertNew(std::move(key), std::move(value), hash);
+        }
+    }
+
+    boost::optional<Value> putIfAbsent(Key&& key, Value&& value, size_t hash) {
+        folly::SharedMutex::WriteHolder wh(lock_);
+        auto pos = find(key, hash);
+        if (pos == kEmpty) {
+            insertNew(std::move(key), std::move(value), hash);
+            return boost::none;
+        }
+        auto& entry = entries_[pos];
+        entry.accessed.store(true, std::memory_order_relaxed);
+        return entry.kv->second;
+    }
+
+    void evict(const Key& key, size_t hash) {
+        folly::SharedMutex::WriteHolder wh(lock_);
+        auto pos = find(key, hash);
+        if (pos != kEmpty) {
+            remove(pos);
+            freeList_.emplace_back(pos);
+            evicts_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void clear() {
+        folly::SharedMutex::WriteHolder wh(lock_);
+        for (size_t i = 0; i < capacity_; i++) {
+            entries_[i].kv = boost::none;
+            entries_[i].accessed.store(false, std::memory_order_relaxed);
+        }
+        std::fill(table_.begin(), table_.end(), kEmpty);
+        resetFreeList();
+        hand_ = 0;
+        evicts_ = 0;
+    }
+
+    uint64_t evicts() const {
+        return evicts_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+    struct Entry {
+        boost::optional<std::pair<Key, Value>>  kv;
+        size_t                                  hash{0};
+        std::atomic<bool>                       accessed{false};
+    };
+
+    void resetFreeList() {
+        freeList_.clear();
+        // Pop from the back, so the slab is filled from the front
+        for (size_t i = capacity_; i > 0; i--) {
+            freeList_.emplace_back(i - 1);
+        }
+    }
+
+    // The home slot in the table, mixed since std::hash is identity for integers
+    size_t home(size_t hash) const {
+        return folly::hash::twang_mix64(hash) & tableMask_;
+    }
+
+    // Return the position in the slab, or kEmpty if not found
+    uint32_t find(const Key& key, size_t hash) const {
+        for (auto i = home(hash); table_[i] != kEmpty; i = (i + 1) & tableMask_) {
+            auto& entry = entries_[table_[i]];
+            if (entry.hash == hash && entry.kv->first == key) {
+                return table_[i];
+            }
+        }
+        return kEmpty;
+    }
+
+    void insertNew(Key&& key, Value&& value, size_t hash) {
+        if (freeList_.empty()) {
+            auto victim = sweep();
+            remove(victim);
+            freeList_.emplace_back(victim);
+            evicts_.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto pos = freeList_.back();
+        freeList_.pop_back();
+
+        auto& entry = entries_[pos];
+        entry.kv.emplace(std::move(key), std::move(value));
+        entry.hash = hash;
+        entry.accessed.store(false, std::memory_order_relaxed);
+
+        auto i = home(hash);
+        while (table_[i] != kEmpty) {
+            i = (i + 1) & tableMask_;
+        }
+        table_[i] = pos;
+    }
+
+    // Advance the clock hand until an entry not accessed since the last sweep
+    uint32_t sweep() {
+        while (true) {
+            auto pos = hand_;
+            hand_ = (hand_ + 1) % capacity_;
+            auto& entry = entries_[pos];
+            if (entry.kv == boost::none) {
+                continue;
+            }
+            if (entry.accessed.load(std::memory_order_relaxed)) {
+                entry.accessed.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            return pos;
+        }
+    }
+
+    // Remove the entry at `pos' of the slab from the index, and destroy it.
+    // The following entries of the probe sequence are shifted backward,
+    // so that no tombstone is needed.
+    void remove(uint32_t pos) {
+        auto& entry = entries_[pos];
+        auto i = home(entry.hash);
+        while (table_[i] != pos) {
+            i = (i + 1) & tableMask_;
+        }
+        auto j = i;
+        while (true) {
+            j = (j + 1) & tableMask_;
+            if (table_[j] == kEmpty) {
+                break;
+            }
+            auto k = home(entries_[table_[j]].hash);
+            // Move table_[j] to the hole at i, unless its home is cyclically in (i, j]
+            bool stay = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+            if (!stay) {
+                table_[i] = table_[j];
+                i = j;
+            }
+        }
+        table_[i] = kEmpty;
+        entry.kv = boost::none;
+        entry.accessed.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    folly::SharedMutex                  lock_;
+    const size_t                        capacity_;
+    std::unique_ptr<Entry[]>            entries_;
+    std::vector<uint32_t>               table_;
+    size_t                              tableMask_{0};
+    std::vector<uint32_t>               freeList_;
+    size_t                              hand_{0};
+    std::atomic<uint64_t>               evicts_{0};
+};
+
+template<class Key, class Value>
+constexpr uint32_t ClockBucket<Key, Value>::kEmpty;
+
+}  // namespace nebula
+
+#endif  // COMMON_BASE_CONCURRENTCLOCKCACHE_H_
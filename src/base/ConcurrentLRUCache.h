@@ -19,23 +19,38 @@ namespace nebula {
 template<class Key, class Value>
 class LRU;
 
-template<typename K, typename V>
+/**
+ * A cache split into buckets, each guarded by a mutex. The eviction policy of
+ * every bucket is LRU by default, or any class with the same interface as LRU,
+ * e.g. ConcurrentLRUCache<K, V, WTinyLFU> to be resistant to scans.
+ *
+ * With a weigher, the capacity bounds the total weight of the entries, e.g.
+ * their size in bytes, instead of the number of entries. The capacity is split
+ * evenly into the budgets of the buckets at first, and rebalance() moves the
+ * budgets to the buckets under pressure.
+ */
+template<typename K, typename V, template<class, class> class Policy = LRU>
 class ConcurrentLRUCache final {
     FRIEND_TEST(ConcurrentLRUCacheTest, SimpleTest);
 
 public:
-    explicit ConcurrentLRUCache(size_t capacity, uint32_t bucketsExp = 4)
-        : bucketsNum_(1 << bucketsExp)
+    using Weigher = typename Policy<K, V>::weigher_type;
+
+    explicit ConcurrentLRUCache(size_t capacity,
+                                uint32_t bucketsExp = 4,
+                                Weigher weigher = nullptr)
+        : capacity_(capacity)
+        , bucketsNum_(1 << bucketsExp)
         , bucketsExp_(bucketsExp) {
         CHECK(capacity > bucketsNum_ && bucketsNum_ > 0);
         auto capPerBucket = capacity >> bucketsExp;
         auto left = capacity;
         for (uint32_t i = 0; i < bucketsNum_ - 1; i++) {
-            buckets_.emplace_back(capPerBucket);
+            buckets_.emplace_back(capPerBucket, weigher);
             left -= capPerBucket;
         }
         CHECK_GT(left, 0);
-        buckets_.emplace_back(left);
+        buckets_.emplace_back(left, std::move(weigher));
     }
 
     bool contains(const K& key, int32_t hint = -1) {
@@ -63,11 +78,59 @@ public:
     }
 
     void clear() {
+        std::lock_guard<std::mutex> guard(rebalanceLock_);
         for (uint32_t i = 0; i < bucketsNum_; i++) {
             buckets_[i].clear();
         }
     }
 
+    /**
+     * Move the budgets between buckets according to the evictions of each bucket
+     * since the last rebalance. Every bucket keeps at least half of an even share
+     * of the capacity, and the rest is split in proportion to the evictions, so
+     * a bucket evicting more gets a larger budget. Buckets whose budgets shrink
+     * evict their least valuable entries right away.
+     *
+     * Meant to be called periodically, e.g. from a background thread.
+     * */
+    void rebalance() {
+        std::lock_guard<std::mutex> guard(rebalanceLock_);
+        std::vector<uint64_t> pressure(bucketsNum_);
+        uint64_t totalPressure = 0;
+        for (uint32_t i = 0; i < bucketsNum_; i++) {
+            auto evicts = buckets_[i].evicts();
+            // Plus one, so that the buckets without evictions are not starved
+            pressure[i] = evicts - buckets_[i].lastEvicts_ + 1;
+            buckets_[i].lastEvicts_ = evicts;
+            totalPressure += pressure[i];
+        }
+
+        auto floor = std::max<size_t>(capacity_ / bucketsNum_ / 2, 1);
+        auto spare = capacity_ - floor * bucketsNum_;
+        auto left = capacity_;
+        for (uint32_t i = 0; i < bucketsNum_; i++) {
+            auto budget = i == bucketsNum_ - 1
+                ? left
+                : floor + static_cast<size_t>(
+                      static_cast<double>(spare) * pressure[i] / totalPressure);
+            buckets_[i].setCapacity(budget);
+            left -= budget;
+        }
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    // The total weight of all entries, i.e. the number of entries without a weigher
+    uint64_t weight() {
+        uint64_t weight = 0;
+        for (uint32_t i = 0; i < bucketsNum_; i++) {
+            weight += buckets_[i].weight();
+        }
+        return weight;
+    }
+
     uint64_t total() {
         uint64_t total = 0;
         for (uint32_t i = 0; i < bucketsNum_; i++) {
@@ -87,7 +150,7 @@ public:
     uint64_t evicts() {
         uint64_t evicts = 0;
         for (uint32_t i = 0; i < bucketsNum_; i++) {
-            evicts += buckets_[i].lru_->evicts();
+            evicts += buckets_[i].evicts();
         }
         return evicts;
     }
@@ -95,8 +158,8 @@ public:
 private:
     class Bucket {
     public:
-        explicit Bucket(size_t capacity)
-            : lru_(std::make_unique<LRU<K, V>>(capacity)) {}
+        Bucket(size_t capacity, Weigher weigher)
+            : lru_(std::make_unique<Policy<K, V>>(capacity, std::move(weigher))) {}
 
         Bucket(Bucket&& b)
             : lru_(std::move(b.lru_)) {}
@@ -138,10 +201,27 @@ private:
         void clear() {
             std::lock_guard<std::mutex> guard(lock_);
             lru_->clear();
+            lastEvicts_ = 0;
+        }
+
+        void setCapacity(size_t capacity) {
+            std::lock_guard<std::mutex> guard(lock_);
+            lru_->setCapacity(capacity);
+        }
+
+        size_t weight() {
+            std::lock_guard<std::mutex> guard(lock_);
+            return lru_->weight();
+        }
+
+        uint64_t evicts() {
+            return lru_->evicts();
         }
 
         std::mutex lock_;
-        std::unique_ptr<LRU<K, V>> lru_;
+        std::unique_ptr<Policy<K, V>> lru_;
+        // The evictions at the last rebalance, guarded by `rebalanceLock_' of the cache
+        uint64_t lastEvicts_{0};
     };
 
 
@@ -157,8 +237,10 @@ private:
 
 private:
     std::vector<Bucket> buckets_;
+    const size_t capacity_;
     uint32_t bucketsNum_ = 1;
     uint32_t bucketsExp_ = 0;
+    std::mutex rebalanceLock_;
 };
 
 
@@ -171,6 +253,7 @@ private:
     4. Add stats
     5. Avoid some extra copies
     6. Support right reference for insert.
+    7. Support weighted entries, so the capacity could be in bytes.
 */
 template<class Key, class Value>
 class LRU {
@@ -180,11 +263,18 @@ public:
     typedef std::list<key_type> list_type;
     typedef std::unordered_map<
                 key_type,
-                std::tuple<value_type, typename list_type::iterator>
+                std::tuple<value_type, typename list_type::iterator, size_t>
             > map_type;
+    // Return the weight of an entry, e.g. its size in bytes
+    typedef std::function<size_t(const key_type&, const value_type&)> weigher_type;
 
-    explicit LRU(size_t capacity)
-        : capacity_(capacity) {
+    /**
+     * Without a weigher, every entry weighs 1, i.e. the capacity is the number
+     * of entries. Otherwise, the capacity bounds the total weight of all entries.
+     * */
+    explicit LRU(size_t capacity, weigher_type weigher = nullptr)
+        : capacity_(capacity)
+        , weigher_(std::move(weigher)) {
     }
 
     ~LRU() = default;
@@ -197,6 +287,11 @@ public:
         return capacity_;
     }
 
+    // The total weight of all entries
+    size_t weight() const {
+        return weight_;
+    }
+
     bool empty() const {
         return map_.empty();
     }
@@ -208,16 +303,23 @@ public:
     void insert(key_type&& key, value_type&& value) {
         typename map_type::iterator i = map_.find(key);
         if (i == map_.end()) {
+            size_t weight = weigher_ == nullptr ? 1 : weigher_(key, value);
+            if (weight > capacity_) {
+                VLOG(3) << "Weight " << weight << " exceeds the capacity " << capacity_;
+                return;
+            }
             // insert item into the cache, but first check if it is full
-            if (size() >= capacity_) {
-                VLOG(3) << "Size:" << size() << ", capacity " << capacity_;
+            while (weight_ + weight > capacity_) {
+                VLOG(3) << "Size:" << size() << ", weight " << weight_
+                        << ", capacity " << capacity_;
                 // cache is full, evict the least recently used item
                 evict();
             }
             // insert the new item
             list_.push_front(key);
             map_.emplace(std::forward<key_type>(key),
-                         std::make_tuple(std::forward<value_type>(value), list_.begin()));
+                         std::make_tuple(std::forward<value_type>(value), list_.begin(), weight));
+            weight_ += weight;
         }
     }
 
@@ -254,14 +356,26 @@ public:
         auto it = map_.find(key);
         if (it != map_.end()) {
             list_.erase(std::get<1>(it->second));
+            weight_ -= std::get<2>(it->second);
             map_.erase(it);
             evicts_++;
         }
     }
 
+    /**
+     * Change the capacity, the least recently used items are evicted if it shrinks.
+     * */
+    void setCapacity(size_t capacity) {
+        capacity_ = capacity;
+        while (weight_ > capacity_) {
+            evict();
+        }
+    }
+
     void clear() {
         map_.clear();
         list_.clear();
+        weight_ = 0;
         total_ = 0;
         hits_ = 0;
         evicts_ = 0;
@@ -283,7 +397,9 @@ private:
     void evict() {
         // evict item from the end of most recently used list
         typename list_type::iterator i = --list_.end();
-        map_.erase(*i);
+        auto it = map_.find(*i);
+        weight_ -= std::get<2>(it->second);
+        map_.erase(it);
         list_.erase(i);
         evicts_++;
     }
@@ -292,6 +408,8 @@ private:
     map_type map_;
     list_type list_;
     size_t capacity_;
+    weigher_type weigher_;
+    size_t weight_{0};
     std::atomic_uint64_t total_{0};
     std::atomic_uint64_t hits_{0};
     std::atomic_uint64_t evicts_{0};
@@ -0,0 +1,84 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "base/CountMinSketch.h"
+
+namespace nebula {
+
+constexpr size_t CountMinSketch::kDepth;
+constexpr uint8_t CountMinSketch::kMaxCount;
+
+CountMinSketch::CountMinSketch(size_t capacity) {
+    width_ = 16;
+    while (width_ < capacity) {
+        width_ <<= 1;
+    }
+    table_.resize(width_ * kDepth, 0);
+    sampleSize_ = std::max<size_t>(capacity, 1) * 10;
+}
+
+
+void CountMinSketch::increment(size_t hash) {
+    bool added = false;
+    for (size_t row = 0; row < kDepth; row++) {
+        auto& counter = table_[index(hash, row)];
+        if (counter < kMaxCount) {
+            counter++;
+            added = true;
+        }
+    }
+    if (added && ++additions_ >= sampleSize_) {
+        age();
+    }
+}
+
+
+uint8_t CountMinSketch::estimate(size_t hash) const {
+    uint8_t freq = kMaxCount;
+    for (size_t row = 0; row < kDepth; row++) {
+        freq = std::min(freq, table_[index(hash, row)]);
+    }
+    return freq;
+}
+
+
+void CountMinSketch::clear() {
+    std::fill(table_.begin(), table_.end(), 0);
+    additions_ = 0;
+}
+
+
+void CountMinSketch::ensureCapacity(size_t capacity) {
+    if (capacity <= width_) {
+        return;
+    }
+    while (width_ < capacity) {
+        width_ <<= 1;
+    }
+    table_.assign(width_ * kDepth, 0);
+    sampleSize_ = std::max<size_t>(capacity, 1) * 10;
+    additions_ = 0;
+}
+
+
+size_t CountMinSketch::index(size_t hash, size_t row) const {
+    // Double hashing on top of a mixed hash, since std::hash is identity for integers
+    auto h = folly::hash::twang_mix64(hash);
+    auto h1 = h & 0xFFFFFFFF;
+    auto h2 = (h >> 32) | 1;
+    return row * width_ + ((h1 + row * h2) & (width_ - 1));
+}
+
+
+void CountMinSketch::age() {
+    for (auto& counter : table_) {
+        counter >>= 1;
+    }
+    additions_ /= 2;
+}
+
+}  // namespace nebula
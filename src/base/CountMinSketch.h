@@ -0,0 +1,61 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_BASE_COUNTMINSKETCH_H_
+#define COMMON_BASE_COUNTMINSKETCH_H_
+
+#include "base/Base.h"
+
+namespace nebula {
+
+/**
+ * A count-min sketch to estimate the access frequency of keys, as used by the
+ * TinyLFU admission policy.
+ *
+ * It keeps kDepth rows of small saturating counters, and the estimate of a key
+ * is the minimum among its counters, one per row. The counters are halved after
+ * every `10 * capacity' increments, so that the estimates age and keys hot in
+ * the past would not stay in the cache forever.
+ *
+ * Not thread safe.
+ */
+class CountMinSketch final {
+public:
+    static constexpr size_t kDepth = 4;
+    static constexpr uint8_t kMaxCount = 15;
+
+    // `capacity' is the number of keys the sketch is expected to track
+    explicit CountMinSketch(size_t capacity);
+
+    void increment(size_t hash);
+
+    uint8_t estimate(size_t hash) const;
+
+    void clear();
+
+    // Widen the sketch to track `capacity' keys, all counters are reset if it grows
+    void ensureCapacity(size_t capacity);
+
+    size_t width() const {
+        return width_;
+    }
+
+private:
+    size_t index(size_t hash, size_t row) const;
+
+    // Halve all counters
+    void age();
+
+private:
+    size_t                  width_{0};
+    std::vector<uint8_t>    table_;
+    size_t                  sampleSize_{0};
+    size_t                  additions_{0};
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_BASE_COUNTMINSKETCH_H_
@@ -0,0 +1,62 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_BASE_TASKSTATS_H_
+#define COMMON_BASE_TASKSTATS_H_
+
+#include "base/Base.h"
+
+/**
+ * The priority classes of the tasks run by a thread::GenericWorker or a
+ * thread::GenericThreadPool, and the interface to be notified of them.
+ *
+ * They are kept here, rather than in thread, so that the implementations
+ * of TaskStats, e.g. `stats::TaskPriorityStats', need not depend on thread.
+ */
+
+namespace nebula {
+
+enum class TaskPriority : uint8_t {
+    HIGH = 0,
+    NORMAL,
+    LOW,
+};
+
+constexpr size_t kNumTaskPriorities = 3;
+
+inline const char* toString(TaskPriority priority) {
+    switch (priority) {
+        case TaskPriority::HIGH:
+            return "high";
+        case TaskPriority::NORMAL:
+            return "normal";
+        case TaskPriority::LOW:
+            return "low";
+    }
+    return "unknown";
+}
+
+
+class TaskStats {
+public:
+    using Duration = std::chrono::steady_clock::duration;
+
+    virtual ~TaskStats() = default;
+
+    virtual void onQueued(TaskPriority priority) = 0;
+
+    // Dropped in the queue for its deadline
+    virtual void onExpired(TaskPriority priority) = 0;
+
+    // Taken out of the queue after waiting for `wait'
+    virtual void onStarted(TaskPriority priority, Duration wait) = 0;
+
+    virtual void onFinished(TaskPriority priority, Duration exec) = 0;
+};
+
+}   // namespace nebula
+
+#endif  // COMMON_BASE_TASKSTATS_H_
@@ -0,0 +1,305 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_BASE_WTINYLFU_H_
+#define COMMON_BASE_WTINYLFU_H_
+
+#include "base/Base.h"
+#include "base/CountMinSketch.h"
+#include <list>
+#include <utility>
+#include <boost/optional.hpp>
+
+namespace nebula {
+
+/**
+ * The W-TinyLFU eviction policy, with the same interface as LRU, to be used as
+ * the policy of ConcurrentLRUCache, i.e. ConcurrentLRUCache<K, V, WTinyLFU>.
+ *
+ * New keys are admitted into a small window LRU, which takes 1% of the capacity.
+ * The keys evicted from the window are candidates to enter the main cache, a
+ * segmented LRU of a probation segment and a protected segment (80% of the main
+ * cache). When the main cache is full, the candidate only replaces the victim,
+ * i.e. the least recently used key of the probation segment, if it has been
+ * accessed more frequently, according to a count-min sketch of all accesses.
+ * So keys accessed only once, e.g. by a scan, can't flush the frequently
+ * accessed keys.
+ *
+ * A key in the probation segment is promoted into the protected segment when it
+ * is hit again, and the least recently used key of the protected segment is
+ * demoted back into the probation segment when it overflows.
+ *
+ * As LRU, the capacity bounds the total weight of the entries given a weigher,
+ * and all the segments are sized by weight.
+ *
+ * Not thread safe, ConcurrentLRUCache guards every bucket with a lock.
+ */
+template<class Key, class Value>
+class WTinyLFU {
+public:
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef std::list<key_type> list_type;
+    typedef std::function<size_t(const key_type&, const value_type&)> weigher_type;
+
+    explicit WTinyLFU(size_t capacity, weigher_type weigher = nullptr)
+        // With a weigher, the number of keys is unknown, so the sketch grows with it
+        : sketch_(weigher == nullptr ? capacity : 0)
+        , weigher_(std::move(weigher)) {
+        setCapacities(capacity);
+    }
+
+    ~WTinyLFU() = default;
+
+    size_t size() const {
+        return map_.size();
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    // The total weight of all entries
+    size_t weight() const {
+        return windowWeight_ + probationWeight_ + protectedWeight_;
+    }
+
+    bool empty() const {
+        return map_.empty();
+    }
+
+    bool contains(const key_type& key) {
+        return map_.find(key) != map_.end();
+    }
+
+    void insert(key_type&& key, value_type&& value) {
+        // Inserting the key just missed by get() is the same access
+        auto hash = std::hash<key_type>()(key);
+        if (!lastMiss_ || *lastMiss_ != hash) {
+            sketch_.increment(hash);
+        }
+        lastMiss_ = boost::none;
+        auto i = map_.find(key);
+        if (i != map_.end()) {
+            return;
+        }
+        size_t weight = weigher_ == nullptr ? 1 : weigher_(key, value);
+        if (weight > capacity_) {
+            VLOG(3) << "Weight " << weight << " exceeds the capacity " << capacity_;
+            return;
+        }
+        window_.push_front(key);
+        map_.emplace(std::forward<key_type>(key),
+                     Node{std::forward<value_type>(value), Segment::WINDOW, window_.begin(),
+                          weight});
+        windowWeight_ += weight;
+        if (weigher_ != nullptr) {
+            sketch_.ensureCapacity(map_.size());
+        }
+        while (windowWeight_ > windowCapacity_) {
+            admit();
+        }
+    }
+
+    boost::optional<value_type> get(const key_type& key) {
+        total_++;
+        auto hash = std::hash<key_type>()(key);
+        sketch_.increment(hash);
+        auto i = map_.find(key);
+        if (i == map_.end()) {
+            lastMiss_ = hash;
+            return boost::none;
+        }
+        lastMiss_ = boost::none;
+        auto& node = i->second;
+        switch (node.segment) {
+            case Segment::WINDOW:
+                window_.splice(window_.begin(), window_, node.pos);
+                break;
+            case Segment::PROBATION:
+                // Promote it
+                protected_.splice(protected_.begin(), probation_, node.pos);
+                node.segment = Segment::PROTECTED;
+                probationWeight_ -= node.weight;
+                protectedWeight_ += node.weight;
+                demote();
+                break;
+            case Segment::PROTECTED:
+                protected_.splice(protected_.begin(), protected_, node.pos);
+                break;
+        }
+        hits_++;
+        return node.value;
+    }
+
+    /**
+     * evict the key if exist.
+     * */
+    void evict(const key_type& key) {
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            auto& node = it->second;
+            listOf(node.segment).erase(node.pos);
+            weightOf(node.segment) -= node.weight;
+            map_.erase(it);
+            evicts_++;
+        }
+    }
+
+    /**
+     * Change the capacity, the keys are evicted from the probation segment first,
+     * then the protected segment and the window if it shrinks.
+     * */
+    void setCapacity(size_t capacity) {
+        setCapacities(capacity);
+        while (weight() > capacity_) {
+            if (!probation_.empty()) {
+                evictLast(Segment::PROBATION);
+            } else if (!protected_.empty()) {
+                evictLast(Segment::PROTECTED);
+            } else {
+                evictLast(Segment::WINDOW);
+            }
+        }
+        demote();
+        while (windowWeight_ > windowCapacity_) {
+            admit();
+        }
+    }
+
+    void clear() {
+        map_.clear();
+        window_.clear();
+        probation_.clear();
+        protected_.clear();
+        windowWeight_ = 0;
+        probationWeight_ = 0;
+        protectedWeight_ = 0;
+        sketch_.clear();
+        lastMiss_ = boost::none;
+        total_ = 0;
+        hits_ = 0;
+        evicts_ = 0;
+    }
+
+    uint64_t total() {
+        return total_;
+    }
+
+    uint64_t hits() {
+        return hits_;
+    }
+
+    uint64_t evicts() {
+        return evicts_;
+    }
+
+private:
+    enum class Segment : uint8_t {
+        WINDOW,
+        PROBATION,
+        PROTECTED,
+    };
+
+    struct Node {
+        value_type                      value;
+        Segment                         segment;
+        typename list_type::iterator    pos;
+        size_t                          weight;
+    };
+
+    list_type& listOf(Segment segment) {
+        if (segment == Segment::WINDOW) {
+            return window_;
+        }
+        return segment == Segment::PROBATION ? probation_ : protected_;
+    }
+
+    size_t& weightOf(Segment segment) {
+        if (segment == Segment::WINDOW) {
+            return windowWeight_;
+        }
+        return segment == Segment::PROBATION ? probationWeight_ : protectedWeight_;
+    }
+
+    void setCapacities(size_t capacity) {
+        capacity_ = capacity;
+        windowCapacity_ = std::max<size_t>(capacity / 100, 1);
+        mainCapacity_ = capacity > windowCapacity_ ? capacity - windowCapacity_ : 0;
+        protectedCapacity_ = mainCapacity_ * 8 / 10;
+    }
+
+    // Move the least recently used key of the window into the main cache,
+    // if it is more frequent than the victims of the main cache
+    void admit() {
+        auto candidate = --window_.end();
+        auto& node = map_.find(*candidate)->second;
+        if (node.weight > mainCapacity_) {
+            evictLast(Segment::WINDOW);
+            return;
+        }
+        auto candidateFreq = sketch_.estimate(std::hash<key_type>()(*candidate));
+        while (probationWeight_ + protectedWeight_ + node.weight > mainCapacity_) {
+            auto victims = probation_.empty() ? Segment::PROTECTED : Segment::PROBATION;
+            auto victimFreq = sketch_.estimate(std::hash<key_type>()(listOf(victims).back()));
+            if (candidateFreq <= victimFreq) {
+                evictLast(Segment::WINDOW);
+                return;
+            }
+            evictLast(victims);
+        }
+        node.segment = Segment::PROBATION;
+        probation_.splice(probation_.begin(), window_, candidate);
+        windowWeight_ -= node.weight;
+        probationWeight_ += node.weight;
+    }
+
+    // Demote the least recently used keys of the protected segment, until it fits
+    void demote() {
+        while (protectedWeight_ > protectedCapacity_) {
+            auto demoted = --protected_.end();
+            auto& node = map_.find(*demoted)->second;
+            node.segment = Segment::PROBATION;
+            probation_.splice(probation_.begin(), protected_, demoted);
+            protectedWeight_ -= node.weight;
+            probationWeight_ += node.weight;
+        }
+    }
+
+    void evictLast(Segment segment) {
+        auto& list = listOf(segment);
+        auto i = --list.end();
+        auto it = map_.find(*i);
+        weightOf(segment) -= it->second.weight;
+        map_.erase(it);
+        list.erase(i);
+        evicts_++;
+    }
+
+private:
+    std::unordered_map<key_type, Node>  map_;
+    list_type                           window_;
+    list_type                           probation_;
+    list_type                           protected_;
+    size_t                              capacity_{0};
+    size_t                              windowCapacity_{0};
+    size_t                              mainCapacity_{0};
+    size_t                              protectedCapacity_{0};
+    size_t                              windowWeight_{0};
+    size_t                              probationWeight_{0};
+    size_t                              protectedWeight_{0};
+    CountMinSketch                      sketch_;
+    // The hash of the key missed by the last get(), if nothing else came after
+    boost::optional<size_t>             lastMiss_;
+    weigher_type                        weigher_;
+    std::atomic_uint64_t                total_{0};
+    std::atomic_uint64_t                hits_{0};
+    std::atomic_uint64_t                evicts_{0};
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_BASE_WTINYLFU_H_
@@ -0,0 +1,172 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <random>
+#include "base/ConcurrentLRUCache.h"
+#include "base/ConcurrentClockCache.h"
+#include "base/WTinyLFU.h"
+
+/**
+ * Replay a key trace against every cache policy, print the hit ratios, then
+ * benchmark the time per operation. On a miss, the key is inserted, as a
+ * read-through cache does.
+ *
+ * The trace is either loaded from --trace_file, one key per line, or generated:
+ *   zipf:       Zipfian keys
+ *   zipf_scan:  Zipfian keys, interrupted by scans over keys never seen before,
+ *               e.g. a GO over the neighbours of a supernode
+ *   loop:       keys looping over a range larger than the cache
+ */
+DEFINE_string(trace_file, "", "The trace to replay, one key per line");
+DEFINE_string(trace, "zipf_scan", "The generated trace, zipf, zipf_scan or loop");
+DEFINE_int64(trace_length, 1000000, "The length of the generated trace");
+DEFINE_int64(trace_keys, 1000000, "The number of distinct keys of the generated trace");
+DEFINE_int64(cache_capacity, 10000, "The capacity of the cache");
+DEFINE_int32(cache_buckets_exp, 4, "The number of buckets of the cache, as a power of 2");
+
+using nebula::ConcurrentLRUCache;
+using nebula::ConcurrentClockCache;
+using nebula::WTinyLFU;
+
+namespace {
+
+std::vector<int64_t> loadTrace(const std::string& path) {
+    std::ifstream in(path);
+    CHECK(in.good()) << "Failed to open " << path;
+    std::vector<int64_t> trace;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        auto key = folly::tryTo<int64_t>(line);
+        trace.emplace_back(key.hasValue() ? key.value()
+                                          : static_cast<int64_t>(std::hash<std::string>()(line)));
+    }
+    return trace;
+}
+
+
+std::vector<int64_t> generateTrace(const std::string& kind, size_t length, int64_t keys) {
+    std::mt19937 rng(0);
+    std::vector<double> cdf(keys);
+    double sum = 0;
+    for (int64_t i = 0; i < keys; i++) {
+        sum += 1.0 / std::pow(i + 1, 0.99);
+        cdf[i] = sum;
+    }
+    std::uniform_real_distribution<double> dist(0, sum);
+    auto zipf = [&] () -> int64_t {
+        return std::lower_bound(cdf.begin(), cdf.end(), dist(rng)) - cdf.begin();
+    };
+
+    std::vector<int64_t> trace;
+    trace.reserve(length);
+    if (kind == "zipf") {
+        while (trace.size() < length) {
+            trace.emplace_back(zipf());
+        }
+    } else if (kind == "zipf_scan") {
+        // Scan twice the capacity of the cache after every ten capacities of Zipfian keys
+        int64_t scanKey = keys;
+        auto capacity = static_cast<size_t>(FLAGS_cache_capacity);
+        while (trace.size() < length) {
+            for (size_t i = 0; i < capacity * 10 && trace.size() < length; i++) {
+                trace.emplace_back(zipf());
+            }
+            for (size_t i = 0; i < capacity * 2 && trace.size() < length; i++) {
+                trace.emplace_back(scanKey++);
+            }
+        }
+    } else if (kind == "loop") {
+        auto range = FLAGS_cache_capacity * 3 / 2;
+        for (size_t i = 0; i < length; i++) {
+            trace.emplace_back(i % range);
+        }
+    } else {
+        LOG(FATAL) << "Unknown trace " << kind;
+    }
+    return trace;
+}
+
+
+const std::vector<int64_t>& trace() {
+    static const std::vector<int64_t> trace = FLAGS_trace_file.empty()
+        ? generateTrace(FLAGS_trace, FLAGS_trace_length, FLAGS_trace_keys)
+        : loadTrace(FLAGS_trace_file);
+    return trace;
+}
+
+
+// Return the hit ratio
+template <class Cache>
+double replay(Cache& cache, const std::vector<int64_t>& keys) {
+    for (auto key : keys) {
+        auto v = cache.get(key);
+        if (!v.ok()) {
+            cache.insert(key, key);
+        } else {
+            folly::doNotOptimizeAway(v.value());
+        }
+    }
+    return cache.total() == 0 ? 0 : static_cast<double>(cache.hits()) / cache.total();
+}
+
+
+template <class Cache>
+size_t replayBenchmark(size_t iters) {
+    std::unique_ptr<Cache> cache;
+    for (size_t i = 0; i < iters; i++) {
+        BENCHMARK_SUSPEND {
+            cache = std::make_unique<Cache>(FLAGS_cache_capacity, FLAGS_cache_buckets_exp);
+        }
+        replay(*cache, trace());
+        BENCHMARK_SUSPEND {
+            cache.reset();
+        }
+    }
+    return iters * trace().size();
+}
+
+
+template <class Cache>
+void printHitRatio(const std::string& name) {
+    Cache cache(FLAGS_cache_capacity, FLAGS_cache_buckets_exp);
+    auto ratio = replay(cache, trace());
+    LOG(INFO) << name << ": hit ratio " << ratio << ", evicts " << cache.evicts();
+}
+
+}  // namespace
+
+using LRUCache = ConcurrentLRUCache<int64_t, int64_t>;
+using TinyLFUCache = ConcurrentLRUCache<int64_t, int64_t, WTinyLFU>;
+using ClockCache = ConcurrentClockCache<int64_t, int64_t>;
+
+BENCHMARK_MULTI(lruReplay, iters) {
+    return replayBenchmark<LRUCache>(iters);
+}
+BENCHMARK_RELATIVE_MULTI(wtinylfuReplay, iters) {
+    return replayBenchmark<TinyLFUCache>(iters);
+}
+BENCHMARK_RELATIVE_MULTI(clockReplay, iters) {
+    return replayBenchmark<ClockCache>(iters);
+}
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    LOG(INFO) << "Replaying " << trace().size() << " keys, cache capacity "
+              << FLAGS_cache_capacity;
+    printHitRatio<LRUCache>("LRU");
+    printHitRatio<TinyLFUCache>("WTinyLFU");
+    printHitRatio<ClockCache>("Clock");
+
+    folly::runBenchmarks();
+    return 0;
+}
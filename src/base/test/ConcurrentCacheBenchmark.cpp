@@ -0,0 +1,163 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <random>
+#include <folly/Random.h>
+#include "base/ConcurrentLRUCache.h"
+#include "base/ConcurrentClockCache.h"
+
+DEFINE_int64(num_keys, 1000000, "The number of distinct keys");
+DEFINE_int64(cache_capacity, 100000, "The capacity of the cache");
+DEFINE_double(zipf_skew, 0.99, "The skew of the Zipfian distribution of keys");
+DEFINE_int32(value_size, 128, "The size of the cached values");
+
+using nebula::ConcurrentLRUCache;
+using nebula::ConcurrentClockCache;
+
+static constexpr size_t kOpsPerThread = 100000;
+
+// Generate `num' keys following the Zipfian distribution over [0, FLAGS_num_keys)
+std::vector<int64_t> zipfianKeys(size_t num, uint32_t seed) {
+    static const std::vector<double> cdf = [] () {
+        std::vector<double> c(FLAGS_num_keys);
+        double sum = 0;
+        for (int64_t i = 0; i < FLAGS_num_keys; i++) {
+            sum += 1.0 / std::pow(i + 1, FLAGS_zipf_skew);
+            c[i] = sum;
+        }
+        for (auto& v : c) {
+            v /= sum;
+        }
+        return c;
+    }();
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(0, 1);
+    std::vector<int64_t> keys;
+    keys.reserve(num);
+    for (size_t i = 0; i < num; i++) {
+        auto it = std::lower_bound(cdf.begin(), cdf.end(), dist(rng));
+        // Scatter the hot keys, so that they don't fall into the same bucket
+        auto rank = std::min<int64_t>(it - cdf.begin(), FLAGS_num_keys - 1);
+        keys.emplace_back(folly::hash::twang_mix64(rank));
+    }
+    return keys;
+}
+
+// Read through the cache, i.e. insert the value on a miss
+template <class Cache>
+size_t readThrough(size_t iters, size_t threadsNum) {
+    std::unique_ptr<Cache> cache;
+    std::vector<std::vector<int64_t>> keys;
+    BENCHMARK_SUSPEND {
+        cache = std::make_unique<Cache>(FLAGS_cache_capacity);
+        for (size_t i = 0; i < threadsNum; i++) {
+            keys.emplace_back(zipfianKeys(kOpsPerThread, i));
+        }
+        // Warm up
+        for (auto key : zipfianKeys(kOpsPerThread, threadsNum)) {
+            cache->insert(key, std::string(FLAGS_value_size, 'x'));
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadsNum; i++) {
+        threads.emplace_back([&cache, &keys, iters, i] () {
+            for (size_t iter = 0; iter < iters; iter++) {
+                for (auto key : keys[i]) {
+                    auto v = cache->get(key);
+                    if (!v.ok()) {
+                        cache->insert(key, std::string(FLAGS_value_size, 'x'));
+                    } else {
+                        folly::doNotOptimizeAway(v.value().size());
+                    }
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    BENCHMARK_SUSPEND {
+        LOG(INFO) << threadsNum << " threads, hit ratio "
+                  << static_cast<double>(cache->hits()) / cache->total();
+        cache.reset();
+    }
+    return iters * threadsNum * kOpsPerThread;
+}
+
+// Same as above, but read the value in place instead of copying it
+size_t clockVisit(size_t iters, size_t threadsNum) {
+    std::unique_ptr<ConcurrentClockCache<int64_t, std::string>> cache;
+    std::vector<std::vector<int64_t>> keys;
+    BENCHMARK_SUSPEND {
+        cache = std::make_unique<ConcurrentClockCache<int64_t, std::string>>(
+            FLAGS_cache_capacity);
+        for (size_t i = 0; i < threadsNum; i++) {
+            keys.emplace_back(zipfianKeys(kOpsPerThread, i));
+        }
+        for (auto key : zipfianKeys(kOpsPerThread, threadsNum)) {
+            cache->insert(key, std::string(FLAGS_value_size, 'x'));
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadsNum; i++) {
+        threads.emplace_back([&cache, &keys, iters, i] () {
+            for (size_t iter = 0; iter < iters; iter++) {
+                for (auto key : keys[i]) {
+                    auto found = cache->visit(key, [] (const std::string& v) {
+                        folly::doNotOptimizeAway(v.size());
+                    });
+                    if (!found) {
+                        cache->insert(key, std::string(FLAGS_value_size, 'x'));
+                    }
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    BENCHMARK_SUSPEND {
+        cache.reset();
+    }
+    return iters * threadsNum * kOpsPerThread;
+}
+
+size_t lruGet(size_t iters, size_t threadsNum) {
+    return readThrough<ConcurrentLRUCache<int64_t, std::string>>(iters, threadsNum);
+}
+
+size_t clockGet(size_t iters, size_t threadsNum) {
+    return readThrough<ConcurrentClockCache<int64_t, std::string>>(iters, threadsNum);
+}
+
+BENCHMARK_NAMED_PARAM_MULTI(lruGet, 1_thread, 1)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(clockGet, 1_thread, 1)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(clockVisit, 1_thread, 1)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM_MULTI(lruGet, 4_threads, 4)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(clockGet, 4_threads, 4)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(clockVisit, 4_threads, 4)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM_MULTI(lruGet, 8_threads, 8)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(clockGet, 8_threads, 8)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(clockVisit, 8_threads, 8)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM_MULTI(lruGet, 16_threads, 16)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(clockGet, 16_threads, 16)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(clockVisit, 16_threads, 16)
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
@@ -6,6 +6,9 @@
 
 #include "base/Base.h"
 #include "base/ConcurrentLRUCache.h"
+#include "base/ConcurrentClockCache.h"
+#include "base/CountMinSketch.h"
+#include "base/WTinyLFU.h"
 #include <gtest/gtest.h>
 
 namespace nebula {
@@ -140,6 +143,482 @@ TEST(ConcurrentLRUCacheTest, MultiThreadsTest) {
 }
 
 
+TEST(ConcurrentLRUCacheTest, WeigherTest) {
+    auto weigher = [] (const int32_t&, const std::string& val) {
+        return val.size();
+    };
+    // Two buckets of 1000 bytes
+    ConcurrentLRUCache<int32_t, std::string> cache(2000, 1, weigher);
+    for (auto i = 0; i < 10; i++) {
+        cache.insert(i, std::string(100, 'a'), 0);
+    }
+    EXPECT_EQ(1000, cache.weight());
+    EXPECT_EQ(0, cache.evicts());
+
+    // Evict the three least recently used entries to make room
+    cache.insert(10, std::string(300, 'a'), 0);
+    EXPECT_EQ(1000, cache.weight());
+    EXPECT_EQ(3, cache.evicts());
+    for (auto i = 0; i < 3; i++) {
+        EXPECT_FALSE(cache.contains(i, 0));
+    }
+    for (auto i = 3; i < 11; i++) {
+        EXPECT_TRUE(cache.contains(i, 0));
+    }
+
+    // Never fits into a bucket
+    cache.insert(11, std::string(1001, 'a'), 1);
+    EXPECT_FALSE(cache.contains(11, 1));
+    EXPECT_EQ(1000, cache.weight());
+
+    cache.evict(10, 0);
+    EXPECT_EQ(700, cache.weight());
+    cache.clear();
+    EXPECT_EQ(0, cache.weight());
+}
+
+TEST(ConcurrentLRUCacheTest, RebalanceTest) {
+    auto weigher = [] (const int32_t&, const std::string& val) {
+        return val.size();
+    };
+    // Four buckets of 1000 bytes, only the first one is used
+    ConcurrentLRUCache<int32_t, std::string> cache(4000, 2, weigher);
+    auto fill = [&cache] () {
+        for (auto i = 0; i < 40; i++) {
+            cache.insert(i, std::string(100, 'a'), 0);
+        }
+        auto cached = 0;
+        for (auto i = 0; i < 40; i++) {
+            cached += cache.contains(i, 0);
+        }
+        return cached;
+    };
+    EXPECT_EQ(10, fill());
+
+    cache.rebalance();
+    // The first bucket takes most of the spare budgets of the others, which keep
+    // 500 bytes, i.e. half of an even share, plus 2000 * 1 / 34 bytes
+    EXPECT_EQ(23, fill());
+    EXPECT_EQ(4000, cache.capacity());
+    EXPECT_GE(4000, cache.weight());
+
+    cache.insert(100, std::string(300, 'a'), 1);
+    EXPECT_TRUE(cache.contains(100, 1));
+    cache.insert(101, std::string(300, 'a'), 1);
+    EXPECT_FALSE(cache.contains(100, 1));
+    EXPECT_TRUE(cache.contains(101, 1));
+}
+
+TEST(ConcurrentClockCacheTest, SimpleTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(1024);
+    cache.insert(10, "ten");
+    {
+        auto v = cache.get(10);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ("ten", v.value());
+    }
+
+    {
+        auto v = cache.get(5);
+        EXPECT_FALSE(v.ok());
+    }
+
+    auto hash = std::hash<int>()(100);
+    EXPECT_EQ(5, cache.bucketIndex(hash, 5));
+    EXPECT_EQ(11, cache.bucketIndex(hash, 11));
+    EXPECT_EQ(0, cache.bucketIndex(hash, 0));
+    EXPECT_EQ(1024 % 16, cache.bucketIndex(hash, 1024));
+    EXPECT_EQ(hash % 16, cache.bucketIndex(hash, -1));
+
+    EXPECT_EQ(0, cache.evicts());
+    EXPECT_EQ(1, cache.hits());
+    EXPECT_EQ(2, cache.total());
+
+    for (auto i = 0; i < 100; i++) {
+        auto v = cache.get(10);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ("ten", v.value());
+    }
+    EXPECT_EQ(0, cache.evicts());
+    EXPECT_EQ(101, cache.hits());
+    EXPECT_EQ(102, cache.total());
+}
+
+TEST(ConcurrentClockCacheTest, VisitTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(1024);
+    cache.insert(10, std::string(4096, 'x'));
+    size_t len = 0;
+    EXPECT_TRUE(cache.visit(10, [&len] (const std::string& v) {
+        len = v.size();
+    }));
+    EXPECT_EQ(4096, len);
+    EXPECT_FALSE(cache.visit(11, [&len] (const std::string& v) {
+        len = v.size();
+    }));
+    EXPECT_EQ(1, cache.hits());
+    EXPECT_EQ(2, cache.total());
+}
+
+TEST(ConcurrentClockCacheTest, PutIfAbsentTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(1024);
+    {
+        auto v = cache.putIfAbsent(10, "ten");
+        EXPECT_EQ(Status::Inserted(), v.status());
+    }
+
+    {
+        auto v = cache.putIfAbsent(10, "ele");
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ("ten", v.value());
+    }
+
+    EXPECT_EQ(0, cache.evicts());
+    EXPECT_EQ(1, cache.hits());
+    EXPECT_EQ(2, cache.total());
+}
+
+TEST(ConcurrentClockCacheTest, EvictTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(1000, 0);
+    for (auto j = 0; j < 1000; j++) {
+        cache.insert(j, folly::stringPrintf("%d_str", j));
+    }
+    for (auto i = 0; i < 1000; i++) {
+        auto v = cache.get(i);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ(folly::stringPrintf("%d_str", i), v.value());
+    }
+    for (auto j = 1000; j < 2000; j++) {
+        cache.insert(j, folly::stringPrintf("%d_str", j));
+    }
+    for (auto i = 1000; i < 2000; i++) {
+        auto v = cache.get(i);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ(folly::stringPrintf("%d_str", i), v.value());
+    }
+    for (auto i = 0; i < 1000; i++) {
+        auto v = cache.get(i);
+        EXPECT_FALSE(v.ok());
+    }
+    EXPECT_EQ(1000, cache.evicts());
+    EXPECT_EQ(2000, cache.hits());
+    EXPECT_EQ(3000, cache.total());
+}
+
+TEST(ConcurrentClockCacheTest, SecondChanceTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(4, 0);
+    for (auto j = 0; j < 4; j++) {
+        cache.insert(j, folly::stringPrintf("%d_str", j));
+    }
+    // 0 and 2 get a second chance
+    EXPECT_TRUE(cache.get(0).ok());
+    EXPECT_TRUE(cache.get(2).ok());
+    cache.insert(4, "4_str");
+    cache.insert(5, "5_str");
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(4));
+    EXPECT_TRUE(cache.contains(5));
+    EXPECT_EQ(2, cache.evicts());
+}
+
+TEST(ConcurrentClockCacheTest, EvictKeyTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(1024, 4);
+    for (auto j = 0; j < 1000; j++) {
+        cache.insert(j, folly::stringPrintf("%d_str", j));
+    }
+    for (auto i = 0; i < 1000; i++) {
+        auto v = cache.get(i);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ(folly::stringPrintf("%d_str", i), v.value());
+    }
+    for (auto i = 1; i < 1000; i+=2) {
+        cache.evict(i);
+    }
+    for (auto i = 0; i < 1000; i++) {
+        auto v = cache.get(i);
+        if (i % 2 != 0) {
+            EXPECT_FALSE(v.ok());
+        } else {
+            EXPECT_TRUE(v.ok());
+        }
+    }
+
+    EXPECT_EQ(500, cache.evicts());
+    EXPECT_EQ(1500, cache.hits());
+    EXPECT_EQ(2000, cache.total());
+}
+
+TEST(ConcurrentClockCacheTest, MultiThreadsTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(1024 * 1024);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 10; i++) {
+        threads.emplace_back([&cache, i] () {
+            for (auto j = i * 1000; j < (i + 1) *1000; j++) {
+                cache.insert(j, folly::stringPrintf("%d_str", j));
+            }
+        });
+    }
+    for (auto i = 0; i < 10; i++) {
+        threads[i].join();
+    }
+    for (auto i = 0; i < 10000; i++) {
+        auto v = cache.get(i);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ(folly::stringPrintf("%d_str", i), v.value());
+    }
+
+    EXPECT_EQ(0, cache.evicts());
+    EXPECT_EQ(10000, cache.hits());
+    EXPECT_EQ(10000, cache.total());
+}
+
+TEST(ConcurrentClockCacheTest, MultiThreadsEvictTest) {
+    // Much smaller than the key space, to keep evicting from all threads
+    ConcurrentClockCache<int32_t, std::string> cache(1024, 2);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 8; i++) {
+        threads.emplace_back([&cache, i] () {
+            for (auto j = 0; j < 100000; j++) {
+                auto key = (j * 7 + i * 13) % 5000;
+                switch (j % 4) {
+                    case 0:
+                        cache.insert(key, folly::stringPrintf("%d_str", key));
+                        break;
+                    case 1:
+                        cache.evict(key);
+                        break;
+                    default: {
+                        auto v = cache.get(key);
+                        if (v.ok()) {
+                            EXPECT_EQ(folly::stringPrintf("%d_str", key), v.value());
+                        }
+                        break;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (auto i = 0; i < 5000; i++) {
+        auto v = cache.get(i);
+        if (v.ok()) {
+            EXPECT_EQ(folly::stringPrintf("%d_str", i), v.value());
+        }
+    }
+}
+
+
+TEST(CountMinSketchTest, EstimateTest) {
+    CountMinSketch sketch(1024);
+    std::hash<int> hash;
+    for (auto i = 0; i < 10; i++) {
+        sketch.increment(hash(1));
+    }
+    sketch.increment(hash(2));
+    EXPECT_EQ(10, sketch.estimate(hash(1)));
+    EXPECT_LE(1, sketch.estimate(hash(2)));
+    EXPECT_GT(10, sketch.estimate(hash(2)));
+
+    // Saturated
+    for (auto i = 0; i < 10; i++) {
+        sketch.increment(hash(1));
+    }
+    EXPECT_EQ(CountMinSketch::kMaxCount, sketch.estimate(hash(1)));
+
+    sketch.clear();
+    EXPECT_EQ(0, sketch.estimate(hash(1)));
+}
+
+TEST(CountMinSketchTest, AgingTest) {
+    CountMinSketch sketch(16);
+    std::hash<int> hash;
+    for (auto i = 0; i < 8; i++) {
+        sketch.increment(hash(0));
+    }
+    EXPECT_EQ(8, sketch.estimate(hash(0)));
+    // 160 increments trigger the aging
+    for (auto i = 1; i <= 152; i++) {
+        sketch.increment(hash(i));
+    }
+    EXPECT_GE(4 + 152 / 16, sketch.estimate(hash(0)));
+    EXPECT_LE(4, sketch.estimate(hash(0)));
+}
+
+TEST(WTinyLFUTest, SimpleTest) {
+    ConcurrentLRUCache<int32_t, std::string, WTinyLFU> cache(1024);
+    cache.insert(10, "ten");
+    {
+        auto v = cache.get(10);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ("ten", v.value());
+    }
+    {
+        auto v = cache.get(5);
+        EXPECT_FALSE(v.ok());
+    }
+    {
+        auto v = cache.putIfAbsent(10, "ele");
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ("ten", v.value());
+    }
+    EXPECT_EQ(0, cache.evicts());
+    EXPECT_EQ(2, cache.hits());
+    EXPECT_EQ(3, cache.total());
+}
+
+TEST(WTinyLFUTest, EvictKeyTest) {
+    ConcurrentLRUCache<int32_t, std::string, WTinyLFU> cache(1024, 4);
+    for (auto j = 0; j < 1000; j++) {
+        cache.insert(j, folly::stringPrintf("%d_str", j));
+    }
+    for (auto i = 0; i < 1000; i++) {
+        auto v = cache.get(i);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ(folly::stringPrintf("%d_str", i), v.value());
+    }
+    for (auto i = 1; i < 1000; i+=2) {
+        cache.evict(i);
+    }
+    for (auto i = 0; i < 1000; i++) {
+        auto v = cache.get(i);
+        if (i % 2 != 0) {
+            EXPECT_FALSE(v.ok());
+        } else {
+            EXPECT_TRUE(v.ok());
+        }
+    }
+
+    EXPECT_EQ(500, cache.evicts());
+    EXPECT_EQ(1500, cache.hits());
+    EXPECT_EQ(2000, cache.total());
+}
+
+TEST(WTinyLFUTest, CapacityTest) {
+    WTinyLFU<int32_t, int32_t> lfu(100);
+    for (auto i = 0; i < 1000; i++) {
+        lfu.insert(std::move(i), std::move(i));
+        EXPECT_GE(100, lfu.size());
+    }
+    EXPECT_EQ(100, lfu.size());
+    EXPECT_EQ(900, lfu.evicts());
+}
+
+TEST(WTinyLFUTest, MissThenInsertTest) {
+    // A window of one key, and a main cache of 99 keys
+    WTinyLFU<int32_t, int32_t> lfu(100);
+    for (auto i = 0; i < 100; i++) {
+        lfu.insert(std::move(i), std::move(i));
+    }
+    EXPECT_EQ(100, lfu.size());
+    // Missed and then inserted, it is accessed only once as any other key, so it
+    // can't replace the victim of the main cache once it leaves the window
+    auto key = 1000;
+    EXPECT_FALSE(lfu.get(key));
+    lfu.insert(std::move(key), 0);
+    EXPECT_TRUE(lfu.contains(1000));
+    key = 1001;
+    lfu.insert(std::move(key), 0);
+    EXPECT_FALSE(lfu.contains(1000));
+    EXPECT_TRUE(lfu.contains(0));
+
+    // Accessed twice, it replaces the victim
+    key = 1002;
+    EXPECT_FALSE(lfu.get(key));
+    EXPECT_FALSE(lfu.get(key));
+    lfu.insert(std::move(key), 0);
+    key = 1003;
+    lfu.insert(std::move(key), 0);
+    EXPECT_TRUE(lfu.contains(1002));
+    EXPECT_FALSE(lfu.contains(0));
+}
+
+TEST(WTinyLFUTest, ScanResistanceTest) {
+    ConcurrentLRUCache<int32_t, std::string> lru(100, 0);
+    ConcurrentLRUCache<int32_t, std::string, WTinyLFU> lfu(100, 0);
+    auto access = [&lru, &lfu] (int32_t key) {
+        if (!lru.get(key).ok()) {
+            lru.insert(key, folly::stringPrintf("%d_str", key));
+        }
+        if (!lfu.get(key).ok()) {
+            lfu.insert(key, folly::stringPrintf("%d_str", key));
+        }
+    };
+    // The hot keys
+    for (auto round = 0; round < 10; round++) {
+        for (auto i = 0; i < 50; i++) {
+            access(i);
+        }
+    }
+    // A scan
+    for (auto i = 1000; i < 11000; i++) {
+        access(i);
+    }
+
+    auto lruHot = 0, lfuHot = 0;
+    for (auto i = 0; i < 50; i++) {
+        lruHot += lru.contains(i);
+        lfuHot += lfu.contains(i);
+    }
+    EXPECT_EQ(0, lruHot);
+    // The hot keys promoted into the protected segment all survive, the one left
+    // in the probation segment could be replaced after its frequency is aged
+    EXPECT_LE(49, lfuHot);
+}
+
+TEST(WTinyLFUTest, WeigherTest) {
+    auto weigher = [] (const int32_t&, const std::string& val) {
+        return val.size();
+    };
+    ConcurrentLRUCache<int32_t, std::string, WTinyLFU> cache(10000, 0, weigher);
+    for (auto i = 0; i < 1000; i++) {
+        cache.insert(i, std::string(i % 50 + 1, 'a'));
+        EXPECT_GE(10000, cache.weight());
+    }
+    EXPECT_LT(9000, cache.weight());
+
+    // Shrink it
+    cache.rebalance();
+    EXPECT_GE(10000, cache.weight());
+
+    WTinyLFU<int32_t, std::string> lfu(1000, weigher);
+    for (auto i = 0; i < 100; i++) {
+        lfu.insert(std::move(i), std::string(100, 'a'));
+    }
+    EXPECT_GE(1000, lfu.weight());
+    lfu.setCapacity(500);
+    EXPECT_GE(500, lfu.weight());
+    EXPECT_EQ(lfu.weight(), lfu.size() * 100);
+    lfu.insert(1000, std::string(501, 'a'));
+    EXPECT_FALSE(lfu.contains(1000));
+}
+
+TEST(WTinyLFUTest, MultiThreadsTest) {
+    ConcurrentLRUCache<int32_t, std::string, WTinyLFU> cache(1024, 2);
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 8; i++) {
+        threads.emplace_back([&cache, i] () {
+            for (auto j = 0; j < 10000; j++) {
+                auto key = (j * 7 + i * 13) % 5000;
+                auto v = cache.get(key);
+                if (v.ok()) {
+                    EXPECT_EQ(folly::stringPrintf("%d_str", key), v.value());
+                } else {
+                    cache.insert(key, folly::stringPrintf("%d_str", key));
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(80000, cache.total());
+}
+
+
 }  // namespace nebula
 
 
@@ -0,0 +1,142 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "clients/meta/FileBasedMetaSnapshot.h"
+#include <folly/FileUtil.h>
+#include <folly/hash/Checksum.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+#include "fs/FileUtils.h"
+
+
+namespace nebula {
+namespace meta {
+
+namespace {
+
+constexpr char kMagic[] = "NEBULAMS";
+constexpr size_t kMagicLen = sizeof(kMagic) - 1;
+// The magic, the crc32c of the payload and the size of the payload
+constexpr size_t kHeaderLen = kMagicLen + sizeof(uint32_t) + sizeof(uint64_t);
+
+uint32_t checksum(const char* data, size_t len) {
+    return folly::crc32c(reinterpret_cast<const uint8_t*>(data), len);
+}
+
+}  // namespace
+
+
+// static
+bool FileBasedMetaSnapshot::persistInFile(const cpp2::MetaSnapshot& snapshot,
+                                          const std::string& filename) {
+    auto dirname = fs::FileUtils::dirname(filename.c_str());
+    if (!fs::FileUtils::makeDir(dirname)) {
+        LOG(ERROR) << "Failed mkdir " << dirname;
+        return false;
+    }
+
+    std::string payload;
+    apache::thrift::CompactSerializer::serialize(snapshot, &payload);
+    uint32_t crc = checksum(payload.data(), payload.size());
+    uint64_t size = payload.size();
+    std::string buf;
+    buf.reserve(kHeaderLen + payload.size());
+    buf.append(kMagic, kMagicLen);
+    buf.append(reinterpret_cast<const char*>(&crc), sizeof(crc));
+    buf.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    buf.append(payload);
+
+    // Written aside and renamed, so a crash never leaves a partial snapshot.
+    // Only readable by the owner, since it holds the users and their passwords.
+    // A tmp file left behind is removed first, which may have another mode.
+    auto tmpname = filename + ".tmp";
+    ::unlink(tmpname.c_str());
+    int fd = ::open(tmpname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        LOG(ERROR) << "Open file error, file " << tmpname << ", error " << strerror(errno);
+        return false;
+    }
+    size_t written = 0;
+    while (written < buf.size()) {
+        auto bytes = ::write(fd, buf.data() + written, buf.size() - written);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(ERROR) << "Write meta snapshot failed, error " << strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        written += bytes;
+    }
+    if (::fsync(fd) != 0) {
+        LOG(ERROR) << "Sync meta snapshot failed, error " << strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+    if (::rename(tmpname.c_str(), filename.c_str()) != 0) {
+        LOG(ERROR) << "Rename " << tmpname << " to " << filename
+                   << " failed, error " << strerror(errno);
+        return false;
+    }
+    // Make the rename durable
+    int dirfd = ::open(dirname.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirfd < 0) {
+        LOG(ERROR) << "Open dir error, dir " << dirname << ", error " << strerror(errno);
+        return false;
+    }
+    if (::fsync(dirfd) != 0) {
+        LOG(ERROR) << "Sync dir " << dirname << " failed, error " << strerror(errno);
+        ::close(dirfd);
+        return false;
+    }
+    ::close(dirfd);
+    VLOG(1) << "Persist meta snapshot of " << buf.size() << " bytes in " << filename;
+    return true;
+}
+
+
+// static
+StatusOr<cpp2::MetaSnapshot> FileBasedMetaSnapshot::loadFromFile(const std::string& filename) {
+    // It is read only once, at startup, so a plain read does as well as a mapping
+    std::string content;
+    if (!folly::readFile(filename.c_str(), content)) {
+        return Status::Error("Read file %s failed, error %s", filename.c_str(), strerror(errno));
+    }
+    size_t len = content.size();
+    if (len < kHeaderLen) {
+        return Status::Error("Meta snapshot %s is truncated", filename.c_str());
+    }
+
+    auto* data = content.data();
+    if (::memcmp(data, kMagic, kMagicLen) != 0) {
+        return Status::Error("%s is not a meta snapshot", filename.c_str());
+    }
+    uint32_t crc;
+    uint64_t size;
+    ::memcpy(&crc, data + kMagicLen, sizeof(crc));
+    ::memcpy(&size, data + kMagicLen + sizeof(crc), sizeof(size));
+    if (size != len - kHeaderLen) {
+        return Status::Error("Meta snapshot %s is truncated", filename.c_str());
+    }
+    auto* payload = data + kHeaderLen;
+    if (checksum(payload, size) != crc) {
+        return Status::Error("Meta snapshot %s is corrupted", filename.c_str());
+    }
+
+    cpp2::MetaSnapshot snapshot;
+    try {
+        apache::thrift::CompactSerializer::deserialize(folly::StringPiece(payload, size),
+                                                       snapshot);
+    } catch (const std::exception& e) {
+        return Status::Error("Decode meta snapshot %s failed, %s", filename.c_str(), e.what());
+    }
+    return snapshot;
+}
+
+}  // namespace meta
+}  // namespace nebula
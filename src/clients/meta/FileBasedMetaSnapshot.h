@@ -0,0 +1,36 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef CLIENTS_META_FILEBASEDMETASNAPSHOT_H_
+#define CLIENTS_META_FILEBASEDMETASNAPSHOT_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include "interface/gen-cpp2/meta_types.h"
+
+
+namespace nebula {
+namespace meta {
+
+/**
+ * This class keeps the metadata cached by MetaClient in a local file, so a
+ * restarted client serves from it at once and revalidates it with metad in
+ * the background.
+ *
+ * The file is a header of a magic, the crc32c and the size of the payload,
+ * followed by the snapshot in thrift's compact protocol. It is replaced by a
+ * rename, and read in whole at once.
+ * */
+class FileBasedMetaSnapshot final {
+public:
+    static bool persistInFile(const cpp2::MetaSnapshot& snapshot, const std::string& filename);
+
+    static StatusOr<cpp2::MetaSnapshot> loadFromFile(const std::string& filename);
+};
+
+}  // namespace meta
+}  // namespace nebula
+#endif  // CLIENTS_META_FILEBASEDMETASNAPSHOT_H_
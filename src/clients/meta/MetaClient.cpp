@@ -12,6 +12,8 @@
 #include "conf/Configuration.h"
 #include "stats/StatsManager.h"
 #include "clients/meta/FileBasedClusterIdMan.h"
+#include "clients/meta/FileBasedMetaSnapshot.h"
+#include "time/WallClock.h"
 #include <folly/ScopeGuard.h>
 
 
@@ -23,17 +25,83 @@ DEFINE_int32(meta_client_timeout_ms, 60 * 1000,
              "meta client timeout");
 DEFINE_string(cluster_id_path, "cluster.id",
               "file path saved clusterId");
+DEFINE_int32(meta_client_load_concurrency, 16,
+             "The max number of spaces fetched concurrently when loading the metadata");
+DEFINE_string(meta_client_snapshot_path, "",
+              "The file the metadata is persisted in, to be served from on restart "
+              "before metad is reached, empty means no snapshot");
 DECLARE_string(gflags_mode_json);
 
 
 namespace nebula {
 namespace meta {
 
+namespace {
+
+// Take the value of a request collected, or its error
+template<class T>
+Status takeValue(folly::Try<StatusOr<T>>& result, T& value) {
+    if (result.hasException()) {
+        return Status::Error("%s", result.exception().what().c_str());
+    }
+    if (!result.value().ok()) {
+        return result.value().status();
+    }
+    value = std::move(result.value()).value();
+    return Status::OK();
+}
+
+
+// Whether any schema was created or dropped, or given a new version
+template<class Schemas>
+bool schemasChanged(const Schemas& oldSchemas, const Schemas& newSchemas) {
+    if (oldSchemas.size() != newSchemas.size()) {
+        return true;
+    }
+    for (auto& entry : newSchemas) {
+        auto it = oldSchemas.find(entry.first);
+        if (it == oldSchemas.end() || it->second.size() != entry.second.size()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool indexesChanged(const Indexes& oldIndexes, const Indexes& newIndexes) {
+    if (oldIndexes.size() != newIndexes.size()) {
+        return true;
+    }
+    for (auto& entry : newIndexes) {
+        auto it = oldIndexes.find(entry.first);
+        if (it == oldIndexes.end() || !(*it->second == *entry.second)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+template<class Map, class Pred>
+void eraseIf(Map& map, Pred pred) {
+    for (auto it = map.begin(); it != map.end();) {
+        if (pred(*it)) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace
+
+
 MetaClient::MetaClient(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool,
                        std::vector<HostAddr> addrs,
                        const MetaClientOptions& options)
         : ioThreadPool_(ioThreadPool)
         , addrs_(std::move(addrs))
+        , metadata_(new MetaData())
         , options_(options) {
     CHECK(ioThreadPool_ != nullptr) << "IOThreadPool is required";
     CHECK(!addrs_.empty())
@@ -44,12 +112,18 @@ MetaClient::MetaClient(std::shared_ptr<folly::IOThreadPoolExecutor> ioThreadPool
     updateActive();
     updateLeader();
     bgThread_ = std::make_unique<thread::GenericWorker>();
+    // Latencies from 1us to 100s
+    loadLatencyStat_ = stats::StatsManager::registerHdrHisto(
+        "meta_client_load_latency_us", 100000000);
+    loadSpaceLatencyStat_ = stats::StatsManager::registerHdrHisto(
+        "meta_client_load_space_latency_us", 100000000);
     LOG(INFO) << "Create meta client to " << active_;
 }
 
 
 MetaClient::~MetaClient() {
     stop();
+    delete metadata_.load();
     VLOG(3) << "~MetaClient";
 }
 
@@ -69,6 +143,7 @@ bool MetaClient::isMetadReady() {
     }
     if (ldRet && lcRet) {
         localLastUpdateTime_ = metadLastUpdateTime_;
+        persistSnapshot();
     }
     return ready_;
 }
@@ -81,6 +156,14 @@ bool MetaClient::waitForMetadReady(int count, int retryIntervalSecs) {
         gflagsDeclared_ = GflagsManager::declareGflags(gflagsModule_);
     }
     isRunning_ = true;
+    if (loadSnapshot()) {
+        // Revalidated against metad by the first heartbeat, sent at once
+        CHECK(bgThread_->start());
+        LOG(INFO) << "Serve from the meta snapshot, register time task for heartbeat!";
+        bgThread_->addTask(&MetaClient::heartBeatThreadFunc, this);
+        return ready_;
+    }
+
     int tryCount = count;
     while (!isMetadReady() && ((count == -1) || (tryCount > 0)) && isRunning_) {
         LOG(INFO) << "Waiting for the metad to be ready!";
@@ -123,41 +206,176 @@ void MetaClient::heartBeatThreadFunc() {
         return;
     }
 
-    // if MetaServer has some changes, refesh the localCache_
+    // if MetaServer has some changes, refesh the local cache
     if (localLastUpdateTime_ < metadLastUpdateTime_) {
-        bool ldRet = loadData();
+        bool ldRet = reloadData();
         bool lcRet = true;
         if (!options_.skipConfig_) {
             lcRet = loadCfg();
         }
         if (ldRet && lcRet) {
             localLastUpdateTime_ = metadLastUpdateTime_;
+            persistSnapshot();
         }
+    } else if (!configReady_ && !options_.skipConfig_) {
+        // Started from a snapshot as new as metad, but the gflags are not
+        // registered yet
+        loadCfg();
     }
 }
 
 
-bool MetaClient::loadUsersAndRoles() {
+bool MetaClient::loadSnapshot() {
+    if (FLAGS_meta_client_snapshot_path.empty()) {
+        return false;
+    }
+    auto start = time::WallClock::fastNowInMicroSec();
+    auto ret = FileBasedMetaSnapshot::loadFromFile(FLAGS_meta_client_snapshot_path);
+    if (!ret.ok()) {
+        LOG(WARNING) << "Load meta snapshot failed, status:" << ret.status();
+        return false;
+    }
+    auto snapshot = std::move(ret).value();
+
+    auto metadata = std::make_unique<MetaData>();
+    for (auto& entry : snapshot.spaces) {
+        auto data = std::make_shared<const cpp2::SpaceSnapshot>(std::move(entry.second));
+        auto spaceName = data->get_space().get_properties().get_space_name();
+        addSpace(entry.first, spaceName, std::move(data), *metadata);
+    }
+    metadata->spaceVersions_ = std::move(snapshot.space_versions);
+    metadata->userPasswordMap_ = std::move(snapshot.users);
+    metadata->userRolesMap_ = std::move(snapshot.roles);
+    metadata->usersVersion_ = snapshot.get_users_version();
+    publishMetaData(std::move(metadata));
+    if (!options_.skipConfig_) {
+        applyConfigs(snapshot.get_configs());
+    }
+
+    // The heartbeat reloads whatever changed in metad since
+    localLastUpdateTime_ = snapshot.get_last_update_time_in_ms();
+    ready_ = true;
+    LOG(INFO) << "Load meta snapshot of " << snapshot.spaces.size() << " spaces in "
+              << time::WallClock::fastNowInMicroSec() - start << "us";
+    return true;
+}
+
+
+void MetaClient::persistSnapshot() {
+    if (FLAGS_meta_client_snapshot_path.empty()) {
+        return;
+    }
+    cpp2::MetaSnapshot snapshot;
+    snapshot.set_last_update_time_in_ms(localLastUpdateTime_);
+    {
+        folly::rcu_reader guard;
+        auto* metadata = metadata_.load(std::memory_order_acquire);
+        std::unordered_map<GraphSpaceID, cpp2::SpaceSnapshot> spaces;
+        for (auto& entry : metadata->spaceSnapshots_) {
+            spaces.emplace(entry.first, *entry.second);
+        }
+        snapshot.set_spaces(std::move(spaces));
+        snapshot.set_space_versions(metadata->spaceVersions_);
+        snapshot.set_users(metadata->userPasswordMap_);
+        snapshot.set_roles(metadata->userRolesMap_);
+        snapshot.set_users_version(metadata->usersVersion_);
+    }
+    {
+        folly::RWSpinLock::ReadHolder holder(configCacheLock_);
+        snapshot.set_configs(metaConfigItems_);
+    }
+    if (!FileBasedMetaSnapshot::persistInFile(snapshot, FLAGS_meta_client_snapshot_path)) {
+        LOG(WARNING) << "Persist meta snapshot in " << FLAGS_meta_client_snapshot_path
+                     << " failed";
+    }
+}
+
+
+bool MetaClient::loadUsersAndRoles(MetaData& metadata) {
     auto userRoleRet = listUsers().get();
     if (!userRoleRet.ok()) {
         LOG(ERROR) << "List users failed, status:" << userRoleRet.status();
         return false;
     }
-    decltype(userRolesMap_)       userRolesMap;
-    decltype(userPasswordMap_)    userPasswordMap;
+    // The roles of all the users are got at once
+    std::vector<folly::Future<StatusOr<std::vector<cpp2::RoleItem>>>> futures;
+    futures.reserve(userRoleRet.value().size());
+    for (auto& user : userRoleRet.value()) {
+        futures.emplace_back(getUserRoles(user.first));
+    }
+    auto i = 0U;
     for (auto& user : userRoleRet.value()) {
-        auto rolesRet = getUserRoles(user.first).get();
+        auto rolesRet = std::move(futures[i++]).get();
         if (!rolesRet.ok()) {
             LOG(ERROR) << "List role by user failed, user : " << user.first;
             return false;
         }
-        userRolesMap[user.first] = rolesRet.value();
-        userPasswordMap[user.first] = user.second;
+        metadata.userRolesMap_[user.first] = std::move(rolesRet).value();
+        metadata.userPasswordMap_[user.first] = user.second;
     }
-    {
-        folly::RWSpinLock::WriteHolder holder(localCacheLock_);
-        userRolesMap_ = std::move(userRolesMap);
-        userPasswordMap_ = std::move(userPasswordMap);
+    return true;
+}
+
+
+bool MetaClient::loadSpaces(const std::vector<SpaceIdName>& spaces, MetaData& metadata) {
+    // A space is added once its data comes, in the order the fetches complete,
+    // and the next fetch starts as soon as one completes. No more than
+    // FLAGS_meta_client_load_concurrency are in flight. The fetches still in
+    // flight if a space fails complete into `done' after this returns
+    struct Done {
+        std::mutex                                                      lock;
+        std::condition_variable                                         cond;
+        std::vector<std::pair<size_t, StatusOr<cpp2::SpaceSnapshot>>>   results;
+    };
+    auto done = std::make_shared<Done>();
+    size_t next = 0;
+    auto fetchNext = [&] () {
+        auto i = next++;
+        fetchSpace(spaces[i].first, spaces[i].second)
+            .then([done, i] (folly::Try<StatusOr<cpp2::SpaceSnapshot>>&& result) {
+                std::lock_guard<std::mutex> g(done->lock);
+                if (result.hasException()) {
+                    done->results.emplace_back(
+                        i, Status::Error("%s", result.exception().what().c_str()));
+                } else {
+                    done->results.emplace_back(i, std::move(result).value());
+                }
+                done->cond.notify_one();
+            });
+    };
+
+    size_t window = std::max(1, FLAGS_meta_client_load_concurrency);
+    while (next < spaces.size() && next < window) {
+        fetchNext();
+    }
+    std::vector<std::pair<size_t, StatusOr<cpp2::SpaceSnapshot>>> fetched;
+    size_t added = 0;
+    while (added < spaces.size()) {
+        {
+            std::unique_lock<std::mutex> g(done->lock);
+            done->cond.wait(g, [&done] () { return !done->results.empty(); });
+            fetched.swap(done->results);
+        }
+        for (auto& result : fetched) {
+            // The window is refilled before the space is added
+            if (next < spaces.size()) {
+                fetchNext();
+            }
+            auto& space = spaces[result.first];
+            if (!result.second.ok()) {
+                LOG(ERROR) << "Load space " << space.first << " failed, status "
+                           << result.second.status();
+                return false;
+            }
+            removeSpace(space.first, metadata);
+            addSpace(space.first,
+                     space.second,
+                     std::make_shared<const cpp2::SpaceSnapshot>(
+                        std::move(result.second).value()),
+                     metadata);
+            added++;
+        }
+        fetched.clear();
     }
     return true;
 }
@@ -169,99 +387,239 @@ bool MetaClient::loadData() {
         return false;
     }
 
-    if (!loadUsersAndRoles()) {
+    auto start = time::WallClock::fastNowInMicroSec();
+    // The versions the data is loaded at, taken before any of it is fetched
+    auto metadata = std::make_unique<MetaData>();
+    if (metadHasVersions_) {
+        metadata->spaceVersions_ = metadSpaceVersions_;
+        metadata->usersVersion_ = metadUsersVersion_;
+    }
+
+    // The spaces are listed while the users are loaded
+    auto spacesFuture = listSpaces();
+    if (!loadUsersAndRoles(*metadata)) {
         LOG(ERROR) << "Load roles Failed";
         return false;
     }
 
-    auto ret = listSpaces().get();
+    auto ret = std::move(spacesFuture).get();
     if (!ret.ok()) {
         LOG(ERROR) << "List space failed, status:" << ret.status();
         return false;
     }
 
-    decltype(localCache_)               cache;
-    decltype(spaceIndexByName_)         spaceIndexByName;
-    decltype(spaceTagIndexByName_)      spaceTagIndexByName;
-    decltype(spaceEdgeIndexByName_)     spaceEdgeIndexByName;
-    decltype(spaceNewestTagVerMap_)     spaceNewestTagVerMap;
-    decltype(spaceNewestEdgeVerMap_)    spaceNewestEdgeVerMap;
-    decltype(spaceEdgeIndexByType_)     spaceEdgeIndexByType;
-    decltype(spaceTagIndexById_)        spaceTagIndexById;
-    decltype(spaceAllEdgeMap_)          spaceAllEdgeMap;
-
-    for (auto space : ret.value()) {
-        auto spaceId = space.first;
-        auto r = getPartsAlloc(spaceId).get();
-        if (!r.ok()) {
-            LOG(ERROR) << "Get parts allocation failed for spaceId " << spaceId
-                       << ", status " << r.status();
-            return false;
-        }
+    if (!loadSpaces(ret.value(), *metadata)) {
+        return false;
+    }
+
+    publishMetaData(std::move(metadata));
+    ready_ = true;
+    stats::StatsManager::addValue(loadLatencyStat_,
+                                  time::WallClock::fastNowInMicroSec() - start);
+    return true;
+}
+
 
-        auto spaceCache = std::make_shared<SpaceInfoCache>();
-        auto partsAlloc = r.value();
-        spaceCache->spaceName = space.second;
-        spaceCache->partsOnHost_ = reverse(partsAlloc);
-        spaceCache->partsAlloc_ = std::move(partsAlloc);
-        VLOG(2) << "Load space " << spaceId
-                << ", parts num:" << spaceCache->partsAlloc_.size();
-
-        // loadSchemas
-        if (!loadSchemas(spaceId,
-                         spaceCache,
-                         spaceTagIndexByName,
-                         spaceTagIndexById,
-                         spaceEdgeIndexByName,
-                         spaceEdgeIndexByType,
-                         spaceNewestTagVerMap,
-                         spaceNewestEdgeVerMap,
-                         spaceAllEdgeMap)) {
-            LOG(ERROR) << "Load Schemas Failed";
+bool MetaClient::loadChangedData() {
+    auto start = time::WallClock::fastNowInMicroSec();
+    auto spaceVersions = metadSpaceVersions_;
+    auto usersVersion = metadUsersVersion_;
+
+    // Only the loads publish, and they run one at a time, so the current
+    // cache won't be retired while it is copied
+    auto* oldData = metadata_.load(std::memory_order_acquire);
+    auto metadata = std::make_unique<MetaData>(*oldData);
+
+    if (usersVersion < 0 || usersVersion != oldData->usersVersion_) {
+        metadata->userRolesMap_.clear();
+        metadata->userPasswordMap_.clear();
+        if (!loadUsersAndRoles(*metadata)) {
+            LOG(ERROR) << "Load roles Failed";
             return false;
         }
+    }
+    metadata->usersVersion_ = usersVersion;
 
-        if (!loadIndexes(spaceId, spaceCache)) {
-            LOG(ERROR) << "Load Indexes Failed";
-            return false;
+    // The spaces dropped are removed, and the ones added or changed are
+    // fetched again
+    for (auto& entry : oldData->localCache_) {
+        if (spaceVersions.find(entry.first) == spaceVersions.end()) {
+            VLOG(1) << "Space " << entry.first << " was dropped";
+            removeSpace(entry.first, *metadata);
+        }
+    }
+    std::vector<SpaceIdName> changed;
+    bool anyAdded = false;
+    for (auto& entry : spaceVersions) {
+        auto spaceId = entry.first;
+        auto cacheIt = oldData->localCache_.find(spaceId);
+        if (cacheIt == oldData->localCache_.end()) {
+            anyAdded = true;
+            changed.emplace_back(spaceId, "");
+            continue;
         }
+        auto verIt = oldData->spaceVersions_.find(spaceId);
+        if (verIt == oldData->spaceVersions_.end() || verIt->second != entry.second) {
+            changed.emplace_back(spaceId, cacheIt->second->spaceName);
+        }
+    }
 
-        // get space properties
-        auto resp = getSpace(spaceCache->spaceName).get();
-        if (!resp.ok()) {
-            LOG(ERROR) << "Get space properties failed for space " << spaceId;
+    // Only the spaces added need their names
+    if (anyAdded) {
+        auto ret = listSpaces().get();
+        if (!ret.ok()) {
+            LOG(ERROR) << "List space failed, status:" << ret.status();
             return false;
         }
-        const auto& properties = resp.value().get_properties();
-        spaceCache->vertexIdLen_ = properties.get_vid_size();
+        std::unordered_map<GraphSpaceID, std::string> names;
+        for (auto& space : ret.value()) {
+            names.emplace(space.first, std::move(space.second));
+        }
+        auto it = changed.begin();
+        while (it != changed.end()) {
+            if (!it->second.empty()) {
+                ++it;
+                continue;
+            }
+            auto nameIt = names.find(it->first);
+            if (nameIt == names.end()) {
+                // Dropped since the heartbeat
+                it = changed.erase(it);
+            } else {
+                it->second = nameIt->second;
+                ++it;
+            }
+        }
+    }
 
-        cache.emplace(spaceId, spaceCache);
-        spaceIndexByName.emplace(space.second, spaceId);
+    if (!loadSpaces(changed, *metadata)) {
+        return false;
     }
+    VLOG(1) << changed.size() << " spaces were reloaded";
 
-    decltype(localCache_) oldCache;
-    {
-        folly::RWSpinLock::WriteHolder holder(localCacheLock_);
-        oldCache                = std::move(localCache_);
-        localCache_             = std::move(cache);
-        spaceIndexByName_       = std::move(spaceIndexByName);
-        spaceTagIndexByName_    = std::move(spaceTagIndexByName);
-        spaceEdgeIndexByName_   = std::move(spaceEdgeIndexByName);
-        spaceNewestTagVerMap_   = std::move(spaceNewestTagVerMap);
-        spaceNewestEdgeVerMap_  = std::move(spaceNewestEdgeVerMap);
-        spaceEdgeIndexByType_   = std::move(spaceEdgeIndexByType);
-        spaceTagIndexById_      = std::move(spaceTagIndexById);
-        spaceAllEdgeMap_        = std::move(spaceAllEdgeMap);
-    }
-
-    diff(oldCache, localCache_);
+    metadata->spaceVersions_ = std::move(spaceVersions);
+    publishMetaData(std::move(metadata));
     ready_ = true;
+    stats::StatsManager::addValue(loadLatencyStat_,
+                                  time::WallClock::fastNowInMicroSec() - start);
     return true;
 }
 
 
-bool MetaClient::loadSchemas(GraphSpaceID spaceId,
+bool MetaClient::reloadData() {
+    return metadHasVersions_ ? loadChangedData() : loadData();
+}
+
+
+folly::Future<StatusOr<cpp2::SpaceSnapshot>>
+MetaClient::fetchSpace(GraphSpaceID spaceId, std::string spaceName) {
+    auto start = time::WallClock::fastNowInMicroSec();
+    return folly::collectAll(getPartsAlloc(spaceId),
+                             listTagSchemas(spaceId),
+                             listEdgeSchemas(spaceId),
+                             listTagIndexes(spaceId),
+                             listEdgeIndexes(spaceId),
+                             getSpace(std::move(spaceName)))
+        .via(ioThreadPool_.get())
+        .then([stat = loadSpaceLatencyStat_, start] (auto&& results)
+                -> StatusOr<cpp2::SpaceSnapshot> {
+            stats::StatsManager::addValue(stat,
+                                          time::WallClock::fastNowInMicroSec() - start);
+            cpp2::SpaceSnapshot data;
+            auto status = takeValue(std::get<0>(results), data.parts);
+            if (status.ok()) {
+                status = takeValue(std::get<1>(results), data.tags);
+            }
+            if (status.ok()) {
+                status = takeValue(std::get<2>(results), data.edges);
+            }
+            if (status.ok()) {
+                status = takeValue(std::get<3>(results), data.tag_indexes);
+            }
+            if (status.ok()) {
+                status = takeValue(std::get<4>(results), data.edge_indexes);
+            }
+            if (status.ok()) {
+                status = takeValue(std::get<5>(results), data.space);
+            }
+            if (!status.ok()) {
+                return status;
+            }
+            return data;
+        });
+}
+
+
+void MetaClient::addSpace(GraphSpaceID spaceId,
+                          const std::string& spaceName,
+                          std::shared_ptr<const cpp2::SpaceSnapshot> data,
+                          MetaData& metadata) {
+    auto spaceCache = std::make_shared<SpaceInfoCache>();
+    spaceCache->spaceName = spaceName;
+    spaceCache->partsOnHost_ = reverse(data->parts);
+    spaceCache->partsAlloc_ = data->parts;
+    VLOG(2) << "Load space " << spaceId
+            << ", parts num:" << spaceCache->partsAlloc_.size();
+
+    loadSchemas(spaceId,
+                spaceCache,
+                data->tags,
+                data->edges,
+                metadata.spaceTagIndexByName_,
+                metadata.spaceTagIndexById_,
+                metadata.spaceEdgeIndexByName_,
+                metadata.spaceEdgeIndexByType_,
+                metadata.spaceNewestTagVerMap_,
+                metadata.spaceNewestEdgeVerMap_,
+                metadata.spaceAllEdgeMap_);
+    loadIndexes(spaceId, spaceCache, data->tag_indexes, data->edge_indexes, metadata);
+
+    spaceCache->vertexIdLen_ = data->get_space().get_properties().get_vid_size();
+
+    metadata.localCache_.emplace(spaceId, spaceCache);
+    metadata.spaceIndexByName_.emplace(spaceName, spaceId);
+    if (!FLAGS_meta_client_snapshot_path.empty()) {
+        metadata.spaceSnapshots_.emplace(spaceId, std::move(data));
+    }
+}
+
+
+void MetaClient::removeSpace(GraphSpaceID spaceId, MetaData& metadata) {
+    auto it = metadata.localCache_.find(spaceId);
+    if (it != metadata.localCache_.end()) {
+        metadata.spaceIndexByName_.erase(it->second->spaceName);
+        metadata.localCache_.erase(it);
+    }
+    auto inSpace = [spaceId] (const auto& entry) {
+        return entry.first.first == spaceId;
+    };
+    eraseIf(metadata.spaceTagIndexByName_, inSpace);
+    eraseIf(metadata.spaceTagIndexById_, inSpace);
+    eraseIf(metadata.spaceEdgeIndexByName_, inSpace);
+    eraseIf(metadata.spaceEdgeIndexByType_, inSpace);
+    eraseIf(metadata.spaceNewestTagVerMap_, inSpace);
+    eraseIf(metadata.spaceNewestEdgeVerMap_, inSpace);
+    eraseIf(metadata.tagNameIndexMap_, inSpace);
+    eraseIf(metadata.edgeNameIndexMap_, inSpace);
+    metadata.spaceAllEdgeMap_.erase(spaceId);
+    metadata.spaceSnapshots_.erase(spaceId);
+}
+
+
+void MetaClient::publishMetaData(std::unique_ptr<MetaData> metadata) {
+    // The old cache is only read by diff() here, and freed after all the
+    // readers in flight have left
+    const MetaData* newData = metadata.release();
+    auto* oldData = metadata_.exchange(newData, std::memory_order_acq_rel);
+    diff(oldData->localCache_, newData->localCache_);
+    folly::rcu_retire(const_cast<MetaData*>(oldData));
+}
+
+
+void MetaClient::loadSchemas(GraphSpaceID spaceId,
                              std::shared_ptr<SpaceInfoCache> spaceInfoCache,
+                             const std::vector<cpp2::TagItem>& tagItemVec,
+                             const std::vector<cpp2::EdgeItem>& edgeItemVec,
                              SpaceTagNameIdMap &tagNameIdMap,
                              SpaceTagIdNameMap &tagIdNameMap,
                              SpaceEdgeNameTypeMap &edgeNameTypeMap,
@@ -269,22 +627,6 @@ bool MetaClient::loadSchemas(GraphSpaceID spaceId,
                              SpaceNewestTagVerMap &newestTagVerMap,
                              SpaceNewestEdgeVerMap &newestEdgeVerMap,
                              SpaceAllEdgeMap &allEdgeMap) {
-    auto tagRet = listTagSchemas(spaceId).get();
-    if (!tagRet.ok()) {
-        LOG(ERROR) << "Get tag schemas failed for spaceId " << spaceId
-                   << ", " << tagRet.status();
-        return false;
-    }
-
-    auto edgeRet = listEdgeSchemas(spaceId).get();
-    if (!edgeRet.ok()) {
-        LOG(ERROR) << "Get edge schemas failed for spaceId " << spaceId
-                   << ", " << edgeRet.status();
-        return false;
-    }
-
-    auto tagItemVec = tagRet.value();
-    auto edgeItemVec = edgeRet.value();
     TagSchemas tagSchemas;
     EdgeSchemas edgeSchemas;
     TagID lastTagId = -1;
@@ -382,55 +724,43 @@ bool MetaClient::loadSchemas(GraphSpaceID spaceId,
 
     spaceInfoCache->tagSchemas_ = std::move(tagSchemas);
     spaceInfoCache->edgeSchemas_ = std::move(edgeSchemas);
-    return true;
 }
 
 
-bool MetaClient::loadIndexes(GraphSpaceID spaceId,
-                             std::shared_ptr<SpaceInfoCache> cache) {
-    auto tagIndexesRet = listTagIndexes(spaceId).get();
-    if (!tagIndexesRet.ok()) {
-        LOG(ERROR) << "Get tag indexes failed for spaceId " << spaceId
-                   << ", " << tagIndexesRet.status();
-        return false;
-    }
-
-    auto edgeIndexesRet = listEdgeIndexes(spaceId).get();
-    if (!edgeIndexesRet.ok()) {
-        LOG(ERROR) << "Get edge indexes failed for spaceId " << spaceId
-                   << ", " << edgeIndexesRet.status();
-        return false;
-    }
-
+void MetaClient::loadIndexes(GraphSpaceID spaceId,
+                             std::shared_ptr<SpaceInfoCache> cache,
+                             const std::vector<cpp2::IndexItem>& tagIndexItems,
+                             const std::vector<cpp2::IndexItem>& edgeIndexItems,
+                             MetaData& metadata) {
     Indexes tagIndexes;
-    for (auto tagIndex : tagIndexesRet.value()) {
+    for (auto& tagIndex : tagIndexItems) {
         auto indexName = tagIndex.get_index_name();
         auto indexID = tagIndex.get_index_id();
         std::pair<GraphSpaceID, std::string> pair(spaceId, indexName);
-        tagNameIndexMap_.emplace(std::move(pair), indexID);
+        metadata.tagNameIndexMap_.emplace(std::move(pair), indexID);
         auto tagIndexPtr = std::make_shared<cpp2::IndexItem>(tagIndex);
         tagIndexes.emplace(indexID, tagIndexPtr);
     }
     cache->tagIndexes_ = std::move(tagIndexes);
 
     Indexes edgeIndexes;
-    for (auto& edgeIndex : edgeIndexesRet.value()) {
+    for (auto& edgeIndex : edgeIndexItems) {
         auto indexName = edgeIndex.get_index_name();
         auto indexID = edgeIndex.get_index_id();
         std::pair<GraphSpaceID, std::string> pair(spaceId, indexName);
-        edgeNameIndexMap_.emplace(std::move(pair), indexID);
+        metadata.edgeNameIndexMap_.emplace(std::move(pair), indexID);
         auto edgeIndexPtr = std::make_shared<cpp2::IndexItem>(edgeIndex);
         edgeIndexes.emplace(indexID, edgeIndexPtr);
     }
     cache->edgeIndexes_ = std::move(edgeIndexes);
-    return true;
 }
 
 
 Status MetaClient::checkTagIndexed(GraphSpaceID space, TagID tagID) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(space);
-    if (it != localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->localCache_.find(space);
+    if (it != metadata->localCache_.end()) {
         auto tagIt = it->second->tagIndexes_.find(tagID);
         if (tagIt != it->second->tagIndexes_.end()) {
             return Status::OK();
@@ -443,9 +773,10 @@ Status MetaClient::checkTagIndexed(GraphSpaceID space, TagID tagID) {
 
 
 Status MetaClient::checkEdgeIndexed(GraphSpaceID space, EdgeType edgeType) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(space);
-    if (it != localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->localCache_.find(space);
+    if (it != metadata->localCache_.end()) {
         auto edgeIt = it->second->edgeIndexes_.find(edgeType);
         if (edgeIt != it->second->edgeIndexes_.end()) {
             return Status::OK();
@@ -725,6 +1056,27 @@ void MetaClient::diff(const LocalCache& oldCache, const LocalCache& newCache) {
             }
         }
     }
+    VLOG(1) << "Let's check if any schemas or indexes changed....";
+    for (auto& entry : newCache) {
+        auto spaceId = entry.first;
+        auto oldIt = oldCache.find(spaceId);
+        // The spaces not reloaded are kept as they were
+        if (oldIt == oldCache.end() || oldIt->second == entry.second) {
+            continue;
+        }
+        const auto& oldSpace = *oldIt->second;
+        const auto& newSpace = *entry.second;
+        if (schemasChanged(oldSpace.tagSchemas_, newSpace.tagSchemas_) ||
+            schemasChanged(oldSpace.edgeSchemas_, newSpace.edgeSchemas_)) {
+            VLOG(1) << "SpaceId " << spaceId << ", schemas were changed!";
+            listener_->onSchemaChanged(spaceId);
+        }
+        if (indexesChanged(oldSpace.tagIndexes_, newSpace.tagIndexes_) ||
+            indexesChanged(oldSpace.edgeIndexes_, newSpace.edgeIndexes_)) {
+            VLOG(1) << "SpaceId " << spaceId << ", indexes were changed!";
+            listener_->onIndexChanged(spaceId);
+        }
+    }
 }
 
 
@@ -736,7 +1088,11 @@ StatusOr<PartitionID> MetaClient::partId(GraphSpaceID spaceId, const VertexID id
         return Status::Error("Space not found, spaceid: %d", spaceId);
     }
 
-    auto numParts = status.value();
+    return partIdOf(status.value(), id);
+}
+
+
+PartitionID MetaClient::partIdOf(int32_t numParts, const VertexID& id) {
     // If the length of the id is 8, we will treat it as int64_t to be compatible
     // with the version 1.0
     uint64_t vid = 0;
@@ -906,9 +1262,10 @@ MetaClient::getSpaceIdByNameFromCache(const std::string& name) {
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceIndexByName_.find(name);
-    if (it != spaceIndexByName_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->spaceIndexByName_.find(name);
+    if (it != metadata->spaceIndexByName_.end()) {
         return it->second;
     }
     return Status::SpaceNotFound();
@@ -920,9 +1277,10 @@ StatusOr<TagID> MetaClient::getTagIDByNameFromCache(const GraphSpaceID& space,
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceTagIndexByName_.find(std::make_pair(space, name));
-    if (it == spaceTagIndexByName_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->spaceTagIndexByName_.find(std::make_pair(space, name));
+    if (it == metadata->spaceTagIndexByName_.end()) {
         std::string error = folly::stringPrintf("TagName `%s'  is nonexistent",
                                                 name.c_str());
         return Status::Error(std::move(error));
@@ -936,9 +1294,10 @@ StatusOr<std::string> MetaClient::getTagNameByIdFromCache(const GraphSpaceID& sp
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceTagIndexById_.find(std::make_pair(space, tagId));
-    if (it == spaceTagIndexById_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->spaceTagIndexById_.find(std::make_pair(space, tagId));
+    if (it == metadata->spaceTagIndexById_.end()) {
         std::string error = folly::stringPrintf("TagID `%d'  is nonexistent", tagId);
         return Status::Error(std::move(error));
     }
@@ -951,9 +1310,10 @@ StatusOr<EdgeType> MetaClient::getEdgeTypeByNameFromCache(const GraphSpaceID& sp
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceEdgeIndexByName_.find(std::make_pair(space, name));
-    if (it == spaceEdgeIndexByName_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->spaceEdgeIndexByName_.find(std::make_pair(space, name));
+    if (it == metadata->spaceEdgeIndexByName_.end()) {
         std::string error = folly::stringPrintf("EdgeName `%s'  is nonexistent",
                                                 name.c_str());
         return Status::Error(std::move(error));
@@ -967,9 +1327,10 @@ StatusOr<std::string> MetaClient::getEdgeNameByTypeFromCache(const GraphSpaceID&
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceEdgeIndexByType_.find(std::make_pair(space, edgeType));
-    if (it == spaceEdgeIndexByType_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->spaceEdgeIndexByType_.find(std::make_pair(space, edgeType));
+    if (it == metadata->spaceEdgeIndexByType_.end()) {
         std::string error = folly::stringPrintf("EdgeType `%d'  is nonexistent", edgeType);
         return Status::Error(std::move(error));
     }
@@ -982,9 +1343,10 @@ MetaClient::getAllEdgeFromCache(const GraphSpaceID& space) {
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceAllEdgeMap_.find(space);
-    if (it == spaceAllEdgeMap_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->spaceAllEdgeMap_.find(space);
+    if (it == metadata->spaceAllEdgeMap_.end()) {
         std::string error = folly::stringPrintf("SpaceId `%d'  is nonexistent", space);
         return Status::Error(std::move(error));
     }
@@ -1141,16 +1503,18 @@ MetaClient::removeRange(std::string segment, std::string start, std::string end)
 
 
 PartsMap MetaClient::getPartsMapFromCache(const HostAddr& host) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    return doGetPartsMap(host, localCache_);
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    return doGetPartsMap(host, metadata->localCache_);
 }
 
 
 StatusOr<PartHosts> MetaClient::getPartHostsFromCache(GraphSpaceID spaceId,
                                                       PartitionID partId) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(spaceId);
-    if (it == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->localCache_.find(spaceId);
+    if (it == metadata->localCache_.end()) {
         return Status::Error("Space not found, spaceid: %d", spaceId);
     }
     auto& cache = it->second;
@@ -1171,9 +1535,10 @@ StatusOr<PartHosts> MetaClient::getPartHostsFromCache(GraphSpaceID spaceId,
 Status MetaClient::checkPartExistInCache(const HostAddr& host,
                                          GraphSpaceID spaceId,
                                          PartitionID partId) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(spaceId);
-    if (it != localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->localCache_.find(spaceId);
+    if (it != metadata->localCache_.end()) {
         auto partsIt = it->second->partsOnHost_.find(host);
         if (partsIt != it->second->partsOnHost_.end()) {
             for (auto& pId : partsIt->second) {
@@ -1191,9 +1556,10 @@ Status MetaClient::checkPartExistInCache(const HostAddr& host,
 
 Status MetaClient::checkSpaceExistInCache(const HostAddr& host,
                                         GraphSpaceID spaceId) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(spaceId);
-    if (it != localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->localCache_.find(spaceId);
+    if (it != metadata->localCache_.end()) {
         auto partsIt = it->second->partsOnHost_.find(host);
         if (partsIt != it->second->partsOnHost_.end() && !partsIt->second.empty()) {
             return Status::OK();
@@ -1206,9 +1572,10 @@ Status MetaClient::checkSpaceExistInCache(const HostAddr& host,
 
 
 StatusOr<int32_t> MetaClient::partsNum(GraphSpaceID spaceId) const {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(spaceId);
-    if (it == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->localCache_.find(spaceId);
+    if (it == metadata->localCache_.end()) {
         return Status::Error("Space not found, spaceid: %d", spaceId);
     }
     return it->second->partsAlloc_.size();
@@ -1656,9 +2023,10 @@ StatusOr<int32_t> MetaClient::getSpaceVidLen(const GraphSpaceID& spaceId) {
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto spaceIt = metadata->localCache_.find(spaceId);
+    if (spaceIt == metadata->localCache_.end()) {
         LOG(ERROR) << "Space " << spaceId << " not found!";
         return Status::Error(folly::stringPrintf("Space %d not found", spaceId));
     }
@@ -1674,9 +2042,10 @@ MetaClient::getTagSchemaFromCache(GraphSpaceID spaceId, TagID tagID, SchemaVer v
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto spaceIt = metadata->localCache_.find(spaceId);
+    if (spaceIt == metadata->localCache_.end()) {
         LOG(ERROR) << "Space " << spaceId << " not found!";
         return std::shared_ptr<const NebulaSchemaProvider>();
     } else {
@@ -1696,9 +2065,10 @@ MetaClient::getEdgeSchemaFromCache(GraphSpaceID spaceId, EdgeType edgeType, Sche
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto spaceIt = metadata->localCache_.find(spaceId);
+    if (spaceIt == metadata->localCache_.end()) {
         LOG(ERROR) << "Space " << spaceId << " not found!";
         return std::shared_ptr<const NebulaSchemaProvider>();
     } else {
@@ -1719,9 +2089,10 @@ StatusOr<TagSchemas> MetaClient::getAllVerTagSchema(GraphSpaceID spaceId) {
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto iter = localCache_.find(spaceId);
-    if (iter == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto iter = metadata->localCache_.find(spaceId);
+    if (iter == metadata->localCache_.end()) {
         return Status::Error(folly::stringPrintf("Space not %d found", spaceId));
     }
     return iter->second->tagSchemas_;
@@ -1732,9 +2103,10 @@ StatusOr<EdgeSchemas> MetaClient::getAllVerEdgeSchema(GraphSpaceID spaceId) {
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto iter = localCache_.find(spaceId);
-    if (iter == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto iter = metadata->localCache_.find(spaceId);
+    if (iter == metadata->localCache_.end()) {
         return Status::Error(folly::stringPrintf("Space not %d found", spaceId));
     }
     return iter->second->edgeSchemas_;
@@ -1789,8 +2161,10 @@ MetaClient::getTagIndexByNameFromCache(const GraphSpaceID space, const std::stri
         return Status::Error("Not ready!");
     }
     std::pair<GraphSpaceID, std::string> key(space, name);
-    auto iter = tagNameIndexMap_.find(key);
-    if (iter == tagNameIndexMap_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto iter = metadata->tagNameIndexMap_.find(key);
+    if (iter == metadata->tagNameIndexMap_.end()) {
         return Status::IndexNotFound();
     }
     auto indexID = iter->second;
@@ -1808,8 +2182,10 @@ MetaClient::getEdgeIndexByNameFromCache(const GraphSpaceID space, const std::str
         return Status::Error("Not ready!");
     }
     std::pair<GraphSpaceID, std::string> key(space, name);
-    auto iter = edgeNameIndexMap_.find(key);
-    if (iter == edgeNameIndexMap_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto iter = metadata->edgeNameIndexMap_.find(key);
+    if (iter == metadata->edgeNameIndexMap_.end()) {
         return Status::IndexNotFound();
     }
     auto indexID = iter->second;
@@ -1827,9 +2203,10 @@ MetaClient::getTagIndexFromCache(GraphSpaceID spaceId, IndexID indexID) {
         return Status::Error("Not ready!");
     }
 
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto spaceIt = metadata->localCache_.find(spaceId);
+    if (spaceIt == metadata->localCache_.end()) {
         LOG(ERROR) << "Space " << spaceId << " not found!";
         return Status::SpaceNotFound();
     } else {
@@ -1867,9 +2244,10 @@ MetaClient::getEdgeIndexFromCache(GraphSpaceID spaceId, IndexID indexID) {
         return Status::Error("Not ready!");
     }
 
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto spaceIt = metadata->localCache_.find(spaceId);
+    if (spaceIt == metadata->localCache_.end()) {
         VLOG(3) << "Space " << spaceId << " not found!";
         return Status::SpaceNotFound();
     } else {
@@ -1907,9 +2285,10 @@ MetaClient::getTagIndexesFromCache(GraphSpaceID spaceId) {
         return Status::Error("Not ready!");
     }
 
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto spaceIt = metadata->localCache_.find(spaceId);
+    if (spaceIt == metadata->localCache_.end()) {
         VLOG(3) << "Space " << spaceId << " not found!";
         return Status::SpaceNotFound();
     } else {
@@ -1931,9 +2310,10 @@ MetaClient::getEdgeIndexesFromCache(GraphSpaceID spaceId) {
         return Status::Error("Not ready!");
     }
 
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto spaceIt = metadata->localCache_.find(spaceId);
+    if (spaceIt == metadata->localCache_.end()) {
         VLOG(3) << "Space " << spaceId << " not found!";
         return Status::SpaceNotFound();
     } else {
@@ -1956,8 +2336,10 @@ const std::vector<HostAddr>& MetaClient::getAddresses() {
 
 std::vector<cpp2::RoleItem>
 MetaClient::getRolesByUserFromCache(const std::string& user) {
-    auto iter = userRolesMap_.find(user);
-    if (iter == userRolesMap_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto iter = metadata->userRolesMap_.find(user);
+    if (iter == metadata->userRolesMap_.end()) {
         return std::vector<cpp2::RoleItem>(0);
     }
     return iter->second;
@@ -1965,8 +2347,10 @@ MetaClient::getRolesByUserFromCache(const std::string& user) {
 
 
 bool MetaClient::authCheckFromCache(const std::string& account, const std::string& password) {
-    auto iter = userPasswordMap_.find(account);
-    if (iter == userPasswordMap_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto iter = metadata->userPasswordMap_.find(account);
+    if (iter == metadata->userPasswordMap_.end()) {
         return false;
     }
     return iter->second == password;
@@ -1978,9 +2362,10 @@ StatusOr<SchemaVer> MetaClient::getLatestTagVersionFromCache(const GraphSpaceID&
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceNewestTagVerMap_.find(std::make_pair(space, tagId));
-    if (it == spaceNewestTagVerMap_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->spaceNewestTagVerMap_.find(std::make_pair(space, tagId));
+    if (it == metadata->spaceNewestTagVerMap_.end()) {
         return Status::TagNotFound();
     }
     return it->second;
@@ -1992,9 +2377,10 @@ StatusOr<SchemaVer> MetaClient::getLatestEdgeVersionFromCache(const GraphSpaceID
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceNewestEdgeVerMap_.find(std::make_pair(space, edgeType));
-    if (it == spaceNewestEdgeVerMap_.end()) {
+    folly::rcu_reader guard;
+    auto* metadata = metadata_.load(std::memory_order_acquire);
+    auto it = metadata->spaceNewestEdgeVerMap_.find(std::make_pair(space, edgeType));
+    if (it == metadata->spaceNewestEdgeVerMap_.end()) {
         return Status::EdgeNotFound();
     }
     return it->second;
@@ -2047,6 +2433,13 @@ folly::Future<StatusOr<bool>> MetaClient::heartbeat() {
                     }
                     metadLastUpdateTime_ = resp.get_last_update_time_in_ms();
                     VLOG(1) << "Metad last update time: " << metadLastUpdateTime_;
+                    metadHasVersions_ = resp.__isset.space_versions;
+                    if (metadHasVersions_) {
+                        metadSpaceVersions_ = *resp.get_space_versions();
+                        metadUsersVersion_ = resp.__isset.users_version
+                                           ? *resp.get_users_version()
+                                           : -1;
+                    }
                     return true;  // resp.code == cpp2::ErrorCode::SUCCEEDED
                 },
                 std::move(promise),
@@ -2502,29 +2895,7 @@ bool MetaClient::loadCfg() {
     auto ret = listConfigs(gflagsModule_).get();
     if (ret.ok()) {
         // if we load config from meta server successfully, update gflags and set configReady_
-        auto tItems = ret.value();
-        std::vector<ConfigItem> items;
-        for (const auto& tItem : tItems) {
-            items.emplace_back(toConfigItem(tItem));
-        }
-        MetaConfigMap metaConfigMap;
-        for (auto& item : items) {
-            std::pair<cpp2::ConfigModule, std::string> key = {item.module_, item.name_};
-            metaConfigMap.emplace(std::move(key), std::move(item));
-        }
-        {
-            // For any configurations that is in meta, update in cache to replace previous value
-            folly::RWSpinLock::WriteHolder holder(configCacheLock_);
-            for (const auto& entry : metaConfigMap) {
-                auto& key = entry.first;
-                auto it = metaConfigMap_.find(key);
-                if (it == metaConfigMap_.end() ||
-                    metaConfigMap[key].value_ != it->second.value_) {
-                    updateGflagsValue(entry.second);
-                    metaConfigMap_[key] = entry.second;
-                }
-            }
-        }
+        applyConfigs(ret.value());
     } else {
         LOG(ERROR) << "Load configs failed: " << ret.status();
         return false;
@@ -2533,6 +2904,31 @@ bool MetaClient::loadCfg() {
 }
 
 
+void MetaClient::applyConfigs(const std::vector<cpp2::ConfigItem>& tItems) {
+    std::vector<ConfigItem> items;
+    for (const auto& tItem : tItems) {
+        items.emplace_back(toConfigItem(tItem));
+    }
+    MetaConfigMap metaConfigMap;
+    for (auto& item : items) {
+        std::pair<cpp2::ConfigModule, std::string> key = {item.module_, item.name_};
+        metaConfigMap.emplace(std::move(key), std::move(item));
+    }
+    // For any configurations that is in meta, update in cache to replace previous value
+    folly::RWSpinLock::WriteHolder holder(configCacheLock_);
+    for (const auto& entry : metaConfigMap) {
+        auto& key = entry.first;
+        auto it = metaConfigMap_.find(key);
+        if (it == metaConfigMap_.end() ||
+            metaConfigMap[key].value_ != it->second.value_) {
+            updateGflagsValue(entry.second);
+            metaConfigMap_[key] = entry.second;
+        }
+    }
+    metaConfigItems_ = tItems;
+}
+
+
 void MetaClient::updateGflagsValue(const ConfigItem& item) {
     if (item.mode_ != cpp2::ConfigMode::MUTABLE) {
         return;
@@ -2587,9 +2983,16 @@ void MetaClient::updateNestedGflags(const std::string& name) {
     conf.forEachItem([&optionMap] (const std::string& key, const folly::dynamic& val) {
         optionMap.emplace(key, val.asString());
     });
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    for (const auto& spaceEntry : localCache_) {
-        listener_->onSpaceOptionUpdated(spaceEntry.first, optionMap);
+    std::vector<GraphSpaceID> spaces;
+    {
+        folly::rcu_reader guard;
+        auto* metadata = metadata_.load(std::memory_order_acquire);
+        for (const auto& spaceEntry : metadata->localCache_) {
+            spaces.emplace_back(spaceEntry.first);
+        }
+    }
+    for (auto spaceId : spaces) {
+        listener_->onSpaceOptionUpdated(spaceId, optionMap);
     }
 }
 
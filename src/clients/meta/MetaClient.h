@@ -10,6 +10,7 @@
 #include "base/Base.h"
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/RWSpinLock.h>
+#include <folly/synchronization/Rcu.h>
 #include <gtest/gtest_prod.h>
 #include "interface/gen-cpp2/MetaServiceAsyncClient.h"
 #include "base/Status.h"
@@ -85,6 +86,35 @@ using UserRolesMap = std::unordered_map<std::string, std::vector<cpp2::RoleItem>
 // get user password by account
 using UserPasswordMap = std::unordered_map<std::string, std::string>;
 
+// All the metadata cached by the client. A MetaData is never changed once
+// published, each load builds a new one, see MetaClient::metadata_
+struct MetaData {
+    LocalCache            localCache_;
+    SpaceNameIdMap        spaceIndexByName_;
+    SpaceTagNameIdMap     spaceTagIndexByName_;
+    SpaceEdgeNameTypeMap  spaceEdgeIndexByName_;
+    SpaceEdgeTypeNameMap  spaceEdgeIndexByType_;
+    SpaceTagIdNameMap     spaceTagIndexById_;
+    SpaceNewestTagVerMap  spaceNewestTagVerMap_;
+    SpaceNewestEdgeVerMap spaceNewestEdgeVerMap_;
+    SpaceAllEdgeMap       spaceAllEdgeMap_;
+
+    UserRolesMap          userRolesMap_;
+    UserPasswordMap       userPasswordMap_;
+
+    NameIndexMap          tagNameIndexMap_;
+    NameIndexMap          edgeNameIndexMap_;
+
+    // The versions of metad the data was loaded at, a space not in it is
+    // always reloaded
+    std::unordered_map<GraphSpaceID, int64_t> spaceVersions_;
+    int64_t               usersVersion_{-1};
+
+    // The spaces as fetched, kept only to be persisted, see
+    // FLAGS_meta_client_snapshot_path
+    std::unordered_map<GraphSpaceID, std::shared_ptr<const cpp2::SpaceSnapshot>> spaceSnapshots_;
+};
+
 
 struct ConfigItem {
     ConfigItem() {}
@@ -150,6 +180,10 @@ public:
     virtual void onPartUpdated(const PartHosts& partHosts) = 0;
     virtual void fetchLeaderInfo(
         std::unordered_map<GraphSpaceID, std::vector<PartitionID>>& leaderIds) = 0;
+    // Any tag or edge of the space was created, dropped or altered
+    virtual void onSchemaChanged(GraphSpaceID) {}
+    // Any index of the space was created or dropped
+    virtual void onIndexChanged(GraphSpaceID) {}
 };
 
 
@@ -441,6 +475,9 @@ public:
 
     StatusOr<PartitionID> partId(GraphSpaceID spaceId, VertexID id) const;
 
+    // The part of the id in a space of numParts parts
+    static PartitionID partIdOf(int32_t numParts, const VertexID& id);
+
     StatusOr<std::shared_ptr<const NebulaSchemaProvider>>
     getTagSchemaFromCache(GraphSpaceID spaceId, TagID tagID, SchemaVer ver = -1);
 
@@ -502,16 +539,49 @@ public:
 protected:
     // Return true if load succeeded.
     bool loadData();
+    // Reload only the spaces and the users whose versions in the last
+    // heartbeat changed, and fetch the spaces in parallel.
+    // Return true if load succeeded.
+    bool loadChangedData();
+    // Reload what changed in metad as told by the last heartbeat, by
+    // loadChangedData() if metad tells the versions, or else by loadData().
+    bool reloadData();
     bool loadCfg();
     void heartBeatThreadFunc();
 
+    // Serve from the snapshot persisted by the last run, if any, until metad
+    // is reached. Return true if the snapshot is loaded.
+    bool loadSnapshot();
+    // Persist the local cache and the configs, if a snapshot path is given
+    void persistSnapshot();
+
     bool registerCfg();
+    void applyConfigs(const std::vector<cpp2::ConfigItem>& tItems);
     void updateGflagsValue(const ConfigItem& item);
     void updateNestedGflags(const std::string& name);
 
 
-    bool loadSchemas(GraphSpaceID spaceId,
+    // Fetch the spaces and add them to the cache, with a bounded number of
+    // them in flight, see FLAGS_meta_client_load_concurrency
+    bool loadSpaces(const std::vector<SpaceIdName>& spaces, MetaData& metadata);
+
+    // Fetch the metadata of the space, with all the requests sent at once
+    folly::Future<StatusOr<cpp2::SpaceSnapshot>>
+    fetchSpace(GraphSpaceID spaceId, std::string spaceName);
+
+    // Add the space fetched, or loaded from the snapshot, to the cache
+    void addSpace(GraphSpaceID spaceId,
+                  const std::string& spaceName,
+                  std::shared_ptr<const cpp2::SpaceSnapshot> data,
+                  MetaData& metadata);
+
+    // Remove the space and all its schemas and indexes from the cache
+    void removeSpace(GraphSpaceID spaceId, MetaData& metadata);
+
+    void loadSchemas(GraphSpaceID spaceId,
                      std::shared_ptr<SpaceInfoCache> spaceInfoCache,
+                     const std::vector<cpp2::TagItem>& tagItemVec,
+                     const std::vector<cpp2::EdgeItem>& edgeItemVec,
                      SpaceTagNameIdMap &tagNameIdMap,
                      SpaceTagIdNameMap &tagIdNameMap,
                      SpaceEdgeNameTypeMap &edgeNameTypeMap,
@@ -520,10 +590,16 @@ protected:
                      SpaceNewestEdgeVerMap &newestEdgeVerMap,
                      SpaceAllEdgeMap &allEdgemap);
 
-    bool loadUsersAndRoles();
+    // Replace the local cache by one pointer swap, and notify the listener
+    void publishMetaData(std::unique_ptr<MetaData> metadata);
 
-    bool loadIndexes(GraphSpaceID spaceId,
-                     std::shared_ptr<SpaceInfoCache> cache);
+    bool loadUsersAndRoles(MetaData& metadata);
+
+    void loadIndexes(GraphSpaceID spaceId,
+                     std::shared_ptr<SpaceInfoCache> cache,
+                     const std::vector<cpp2::IndexItem>& tagIndexItems,
+                     const std::vector<cpp2::IndexItem>& edgeIndexItems,
+                     MetaData& metadata);
 
     folly::Future<StatusOr<bool>> heartbeat();
 
@@ -580,8 +656,14 @@ private:
     folly::RWSpinLock     leaderIdsLock_;
     int64_t               localLastUpdateTime_{0};
     int64_t               metadLastUpdateTime_{0};
+    // The versions in the last heartbeat, if metad reports them
+    bool                  metadHasVersions_{false};
+    std::unordered_map<GraphSpaceID, int64_t> metadSpaceVersions_;
+    int64_t               metadUsersVersion_{-1};
+    // The latencies of the loads of the cache and of each space
+    int32_t               loadLatencyStat_{0};
+    int32_t               loadSpaceLatencyStat_{0};
 
-    LocalCache localCache_;
     std::vector<HostAddr> addrs_;
     // The lock used to protect active_ and leader_.
     folly::RWSpinLock hostLock_;
@@ -590,22 +672,11 @@ private:
     HostAddr localHost_;
 
     std::unique_ptr<thread::GenericWorker> bgThread_;
-    SpaceNameIdMap        spaceIndexByName_;
-    SpaceTagNameIdMap     spaceTagIndexByName_;
-    SpaceEdgeNameTypeMap  spaceEdgeIndexByName_;
-    SpaceEdgeTypeNameMap  spaceEdgeIndexByType_;
-    SpaceTagIdNameMap     spaceTagIndexById_;
-    SpaceNewestTagVerMap  spaceNewestTagVerMap_;
-    SpaceNewestEdgeVerMap spaceNewestEdgeVerMap_;
-    SpaceAllEdgeMap       spaceAllEdgeMap_;
-
-    UserRolesMap          userRolesMap_;
-    UserPasswordMap       userPasswordMap_;
-
-    NameIndexMap          tagNameIndexMap_;
-    NameIndexMap          edgeNameIndexMap_;
 
-    mutable folly::RWSpinLock     localCacheLock_;
+    // The local cache. A reader loads the pointer inside a folly::rcu_reader
+    // section and takes no lock, and loadData() swaps in a new MetaData and
+    // retires the old one once no reader could still see it
+    std::atomic<const MetaData*> metadata_;
     MetaChangedListener*  listener_{nullptr};
     folly::RWSpinLock     listenerLock_;
     std::atomic<ClusterID> clusterId_{0};
@@ -613,6 +684,8 @@ private:
     bool                  sendHeartBeat_{false};
     std::atomic_bool      ready_{false};
     MetaConfigMap         metaConfigMap_;
+    // The configs as listed from metad, kept to be persisted
+    std::vector<cpp2::ConfigItem> metaConfigItems_;
     folly::RWSpinLock     configCacheLock_;
     cpp2::ConfigModule    gflagsModule_{cpp2::ConfigModule::UNKNOWN};
     std::atomic_bool      configReady_{false};
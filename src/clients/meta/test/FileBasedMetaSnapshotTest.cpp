@@ -0,0 +1,91 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include <folly/FileUtil.h>
+#include "fs/TempDir.h"
+#include "clients/meta/FileBasedMetaSnapshot.h"
+
+namespace nebula {
+namespace meta {
+
+cpp2::MetaSnapshot mockSnapshot() {
+    cpp2::SpaceSnapshot space;
+    space.parts[1] = {HostAddr("127.0.0.1", 44500), HostAddr("127.0.0.1", 44501)};
+    space.parts[2] = {HostAddr("127.0.0.1", 44502)};
+    cpp2::TagItem tag;
+    tag.set_tag_id(3);
+    tag.set_tag_name("person");
+    space.tags.emplace_back(std::move(tag));
+    space.space.set_space_id(1);
+    space.space.properties.set_space_name("default_space");
+
+    cpp2::MetaSnapshot snapshot;
+    snapshot.set_last_update_time_in_ms(1577836800000);
+    snapshot.spaces.emplace(1, std::move(space));
+    snapshot.space_versions.emplace(1, 5);
+    snapshot.users.emplace("root", "password");
+    snapshot.set_users_version(2);
+    return snapshot;
+}
+
+
+TEST(FileBasedMetaSnapshotTest, ReadWriteTest) {
+    fs::TempDir rootPath("/tmp/FileBasedMetaSnapshotTest.XXXXXX");
+    auto file = folly::stringPrintf("%s/meta/snapshot", rootPath.path());
+    auto snapshot = mockSnapshot();
+    ASSERT_TRUE(FileBasedMetaSnapshot::persistInFile(snapshot, file));
+    auto ret = FileBasedMetaSnapshot::loadFromFile(file);
+    ASSERT_TRUE(ret.ok()) << ret.status();
+    EXPECT_EQ(snapshot, ret.value());
+    // Only accessible by the owner
+    struct stat st;
+    ASSERT_EQ(0, ::stat(file.c_str(), &st));
+    EXPECT_EQ(0600, st.st_mode & 0777);
+
+    // Overwritten by the next one
+    snapshot.set_users_version(3);
+    ASSERT_TRUE(FileBasedMetaSnapshot::persistInFile(snapshot, file));
+    ret = FileBasedMetaSnapshot::loadFromFile(file);
+    ASSERT_TRUE(ret.ok()) << ret.status();
+    EXPECT_EQ(3, ret.value().get_users_version());
+}
+
+
+TEST(FileBasedMetaSnapshotTest, BadFileTest) {
+    fs::TempDir rootPath("/tmp/FileBasedMetaSnapshotTest.XXXXXX");
+    auto file = folly::stringPrintf("%s/snapshot", rootPath.path());
+    EXPECT_FALSE(FileBasedMetaSnapshot::loadFromFile(file).ok());
+
+    ASSERT_TRUE(FileBasedMetaSnapshot::persistInFile(mockSnapshot(), file));
+    std::string content;
+    ASSERT_TRUE(folly::readFile(file.c_str(), content));
+
+    // A byte of the payload flipped
+    auto corrupted = content;
+    corrupted.back() ^= 0xFF;
+    ASSERT_TRUE(folly::writeFile(corrupted, file.c_str()));
+    EXPECT_FALSE(FileBasedMetaSnapshot::loadFromFile(file).ok());
+
+    // Truncated
+    ASSERT_TRUE(folly::writeFile(content.substr(0, content.size() - 1), file.c_str()));
+    EXPECT_FALSE(FileBasedMetaSnapshot::loadFromFile(file).ok());
+
+    ASSERT_TRUE(folly::writeFile(std::string("not a snapshot"), file.c_str()));
+    EXPECT_FALSE(FileBasedMetaSnapshot::loadFromFile(file).ok());
+}
+
+}  // namespace meta
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,184 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "clients/meta/MetaClient.h"
+
+namespace nebula {
+namespace meta {
+
+static constexpr GraphSpaceID kSpaceId = 1;
+static constexpr int32_t kNumParts = 100;
+
+// A client whose cache is filled without any metad
+class FakeMetaClient : public MetaClient {
+public:
+    FakeMetaClient()
+        : MetaClient(std::make_shared<folly::IOThreadPoolExecutor>(1),
+                     {HostAddr("127.0.0.1", 45500)}) {
+        publishMetaData(makeMetaData());
+    }
+
+    // Publish a new cache, as a reload does
+    void reload() {
+        publishMetaData(makeMetaData());
+    }
+
+    static std::unique_ptr<MetaData> makeMetaData() {
+        auto spaceCache = std::make_shared<SpaceInfoCache>();
+        spaceCache->spaceName = "test_space";
+        for (PartitionID partId = 1; partId <= kNumParts; partId++) {
+            spaceCache->partsAlloc_[partId] = {HostAddr("127.0.0.1", 44500 + partId % 3)};
+        }
+        auto metadata = std::make_unique<MetaData>();
+        metadata->localCache_.emplace(kSpaceId, std::move(spaceCache));
+        metadata->spaceIndexByName_.emplace("test_space", kSpaceId);
+        return metadata;
+    }
+};
+
+
+// The local cache as it was guarded before, all the readers take the same lock
+class LockedCache {
+public:
+    LockedCache() : metadata_(FakeMetaClient::makeMetaData()) {}
+
+    StatusOr<int32_t> partsNum(GraphSpaceID spaceId) const {
+        folly::RWSpinLock::ReadHolder holder(lock_);
+        auto it = metadata_->localCache_.find(spaceId);
+        if (it == metadata_->localCache_.end()) {
+            return Status::Error("Space not found, spaceid: %d", spaceId);
+        }
+        return it->second->partsAlloc_.size();
+    }
+
+private:
+    mutable folly::RWSpinLock lock_;
+    std::unique_ptr<MetaData> metadata_;
+};
+
+
+// Each of the threads reads iters times, so the time of an iteration keeps
+// flat as the threads are added if the reads scale
+template <class F>
+void readInThreads(size_t iters, size_t numThreads, F read) {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for (size_t t = 0; t < numThreads; t++) {
+        threads.emplace_back([iters, &read] () {
+            for (size_t i = 0; i < iters; i++) {
+                folly::doNotOptimizeAway(read());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+
+void lockedPartsNum(size_t iters, size_t numThreads) {
+    LockedCache* cache = nullptr;
+    BENCHMARK_SUSPEND {
+        cache = new LockedCache();
+    }
+    readInThreads(iters, numThreads, [cache] () {
+        return cache->partsNum(kSpaceId);
+    });
+    BENCHMARK_SUSPEND {
+        delete cache;
+    }
+}
+
+
+void snapshotPartsNum(size_t iters, size_t numThreads) {
+    FakeMetaClient* client = nullptr;
+    BENCHMARK_SUSPEND {
+        client = new FakeMetaClient();
+    }
+    readInThreads(iters, numThreads, [client] () {
+        return client->partsNum(kSpaceId);
+    });
+    BENCHMARK_SUSPEND {
+        delete client;
+    }
+}
+
+
+void snapshotPartHosts(size_t iters, size_t numThreads) {
+    FakeMetaClient* client = nullptr;
+    BENCHMARK_SUSPEND {
+        client = new FakeMetaClient();
+    }
+    readInThreads(iters, numThreads, [client] () {
+        return client->getPartHostsFromCache(kSpaceId, kNumParts / 2);
+    });
+    BENCHMARK_SUSPEND {
+        delete client;
+    }
+}
+
+
+// The readers go on while the cache is reloaded by another thread
+void snapshotPartsNumWithReload(size_t iters, size_t numThreads) {
+    FakeMetaClient* client = nullptr;
+    BENCHMARK_SUSPEND {
+        client = new FakeMetaClient();
+    }
+    std::atomic<bool> stop{false};
+    std::thread reloader([client, &stop] () {
+        while (!stop.load()) {
+            client->reload();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    readInThreads(iters, numThreads, [client] () {
+        return client->partsNum(kSpaceId);
+    });
+    stop = true;
+    reloader.join();
+    BENCHMARK_SUSPEND {
+        delete client;
+    }
+}
+
+}  // namespace meta
+}  // namespace nebula
+
+using nebula::meta::lockedPartsNum;
+using nebula::meta::snapshotPartsNum;
+using nebula::meta::snapshotPartHosts;
+using nebula::meta::snapshotPartsNumWithReload;
+
+BENCHMARK_PARAM(lockedPartsNum, 1);
+BENCHMARK_RELATIVE_PARAM(snapshotPartsNum, 1);
+BENCHMARK_PARAM(lockedPartsNum, 4);
+BENCHMARK_RELATIVE_PARAM(snapshotPartsNum, 4);
+BENCHMARK_PARAM(lockedPartsNum, 16);
+BENCHMARK_RELATIVE_PARAM(snapshotPartsNum, 16);
+BENCHMARK_PARAM(lockedPartsNum, 32);
+BENCHMARK_RELATIVE_PARAM(snapshotPartsNum, 32);
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(snapshotPartHosts, 1);
+BENCHMARK_PARAM(snapshotPartHosts, 4);
+BENCHMARK_PARAM(snapshotPartHosts, 16);
+BENCHMARK_PARAM(snapshotPartHosts, 32);
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(snapshotPartsNumWithReload, 1);
+BENCHMARK_PARAM(snapshotPartsNumWithReload, 4);
+BENCHMARK_PARAM(snapshotPartsNumWithReload, 16);
+BENCHMARK_PARAM(snapshotPartsNumWithReload, 32);
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
@@ -0,0 +1,121 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "clients/meta/test/MockMetaServer.h"
+
+DEFINE_int32(reload_bm_tags, 20, "Number of tags, and of edges, in each space");
+DEFINE_int32(reload_bm_versions, 10, "Number of versions of each tag and edge");
+DEFINE_int32(reload_bm_parts, 100, "Number of parts in each space");
+DEFINE_int32(reload_bm_rpc_delay_us, 0, "The delay of the mock metad on each space's request");
+
+DECLARE_int32(meta_client_load_concurrency);
+
+namespace nebula {
+namespace meta {
+
+std::shared_ptr<MockMetaServiceHandler> makeHandler(int32_t numSpaces) {
+    auto handler = std::make_shared<MockMetaServiceHandler>(numSpaces,
+                                                            FLAGS_reload_bm_tags,
+                                                            FLAGS_reload_bm_versions,
+                                                            FLAGS_reload_bm_parts);
+    handler->setRpcDelay(FLAGS_reload_bm_rpc_delay_us);
+    return handler;
+}
+
+
+// Each iteration is an ALTER of one space seen by a heartbeat, followed by a
+// refresh of the client's cache
+void reload(size_t iters, int32_t numSpaces, bool delta) {
+    std::shared_ptr<MockMetaServiceHandler> handler;
+    std::unique_ptr<MockMetaServer> server;
+    std::unique_ptr<TestMetaClient> client;
+    BENCHMARK_SUSPEND {
+        handler = makeHandler(numSpaces);
+        server = std::make_unique<MockMetaServer>(handler);
+        client = std::make_unique<TestMetaClient>(server->port());
+        CHECK(client->heartbeat().get().ok());
+        CHECK(client->loadData());
+    }
+    for (size_t i = 0; i < iters; i++) {
+        handler->bump(1 + i % numSpaces);
+        CHECK(client->heartbeat().get().ok());
+        CHECK(delta ? client->loadChangedData() : client->loadData());
+    }
+    BENCHMARK_SUSPEND {
+        client.reset();
+        server.reset();
+    }
+}
+
+
+// The first load of a client started against a cluster of 100 spaces, with
+// the given number of spaces in flight
+void coldLoad(size_t iters, int32_t concurrency) {
+    std::shared_ptr<MockMetaServiceHandler> handler;
+    std::unique_ptr<MockMetaServer> server;
+    auto oldConcurrency = FLAGS_meta_client_load_concurrency;
+    BENCHMARK_SUSPEND {
+        handler = makeHandler(100);
+        server = std::make_unique<MockMetaServer>(handler);
+        FLAGS_meta_client_load_concurrency = concurrency;
+    }
+    for (size_t i = 0; i < iters; i++) {
+        std::unique_ptr<TestMetaClient> client;
+        BENCHMARK_SUSPEND {
+            client = std::make_unique<TestMetaClient>(server->port());
+        }
+        CHECK(client->heartbeat().get().ok());
+        CHECK(client->loadData());
+        BENCHMARK_SUSPEND {
+            client.reset();
+        }
+    }
+    BENCHMARK_SUSPEND {
+        FLAGS_meta_client_load_concurrency = oldConcurrency;
+        server.reset();
+    }
+}
+
+
+void fullReload(size_t iters, int32_t numSpaces) {
+    reload(iters, numSpaces, false);
+}
+
+
+void deltaReload(size_t iters, int32_t numSpaces) {
+    reload(iters, numSpaces, true);
+}
+
+}  // namespace meta
+}  // namespace nebula
+
+using nebula::meta::fullReload;
+using nebula::meta::deltaReload;
+using nebula::meta::coldLoad;
+
+BENCHMARK_PARAM(fullReload, 1);
+BENCHMARK_RELATIVE_PARAM(deltaReload, 1);
+BENCHMARK_PARAM(fullReload, 10);
+BENCHMARK_RELATIVE_PARAM(deltaReload, 10);
+BENCHMARK_PARAM(fullReload, 100);
+BENCHMARK_RELATIVE_PARAM(deltaReload, 100);
+BENCHMARK_PARAM(fullReload, 500);
+BENCHMARK_RELATIVE_PARAM(deltaReload, 500);
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(coldLoad, 1);
+BENCHMARK_RELATIVE_PARAM(coldLoad, 4);
+BENCHMARK_RELATIVE_PARAM(coldLoad, 16);
+BENCHMARK_RELATIVE_PARAM(coldLoad, 64);
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
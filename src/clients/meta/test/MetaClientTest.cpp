@@ -0,0 +1,125 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "clients/meta/test/MockMetaServer.h"
+
+namespace nebula {
+namespace meta {
+
+class RecordingListener : public MetaChangedListener {
+public:
+    void onSpaceAdded(GraphSpaceID) override {}
+    void onSpaceRemoved(GraphSpaceID) override {}
+    void onSpaceOptionUpdated(GraphSpaceID,
+                              const std::unordered_map<std::string, std::string>&) override {}
+    void onPartAdded(const PartHosts&) override {}
+    void onPartRemoved(GraphSpaceID, PartitionID) override {}
+    void onPartUpdated(const PartHosts&) override {}
+    void fetchLeaderInfo(std::unordered_map<GraphSpaceID, std::vector<PartitionID>>&) override {}
+
+    void onSchemaChanged(GraphSpaceID spaceId) override {
+        schemaChanged.emplace_back(spaceId);
+    }
+
+    void onIndexChanged(GraphSpaceID spaceId) override {
+        indexChanged.emplace_back(spaceId);
+    }
+
+    std::vector<GraphSpaceID> schemaChanged;
+    std::vector<GraphSpaceID> indexChanged;
+};
+
+
+TEST(MetaClientTest, ReloadChangedTest) {
+    auto handler = std::make_shared<MockMetaServiceHandler>(3);
+    MockMetaServer server(handler);
+    TestMetaClient client(server.port());
+    RecordingListener listener;
+    client.registerListener(&listener);
+    ASSERT_TRUE(client.heartbeat().get().ok());
+    ASSERT_TRUE(client.loadData());
+    ASSERT_EQ(3UL, handler->numFetched());
+    for (GraphSpaceID spaceId = 1; spaceId <= 3; spaceId++) {
+        auto name = folly::stringPrintf("space_%d", spaceId);
+        ASSERT_EQ(spaceId, client.getSpaceIdByNameFromCache(name).value());
+        ASSERT_EQ(0, client.getLatestTagVersionFromCache(spaceId, 1).value());
+    }
+
+    {
+        // A space dropped, one added and one altered
+        handler->dropSpace(2);
+        handler->addSpace(4);
+        handler->alterTags(1);
+        ASSERT_TRUE(client.heartbeat().get().ok());
+        ASSERT_TRUE(client.reloadData());
+        EXPECT_EQ(5UL, handler->numFetched());
+        EXPECT_FALSE(client.getSpaceIdByNameFromCache("space_2").ok());
+        EXPECT_FALSE(client.getLatestTagVersionFromCache(2, 1).ok());
+        EXPECT_EQ(4, client.getSpaceIdByNameFromCache("space_4").value());
+        EXPECT_EQ(0, client.getLatestTagVersionFromCache(4, 1).value());
+        EXPECT_EQ(1, client.getLatestTagVersionFromCache(1, 1).value());
+        EXPECT_EQ(0, client.getLatestTagVersionFromCache(3, 1).value());
+        EXPECT_EQ(std::vector<GraphSpaceID>{1}, listener.schemaChanged);
+        EXPECT_TRUE(listener.indexChanged.empty());
+    }
+    {
+        // An index created
+        handler->addTagIndex(3, "tag_1_index");
+        ASSERT_TRUE(client.heartbeat().get().ok());
+        ASSERT_TRUE(client.reloadData());
+        EXPECT_EQ(6UL, handler->numFetched());
+        auto indexes = client.getTagIndexesFromCache(3).value();
+        ASSERT_EQ(1UL, indexes.size());
+        EXPECT_EQ("tag_1_index", indexes[0]->get_index_name());
+        EXPECT_EQ(std::vector<GraphSpaceID>{1}, listener.schemaChanged);
+        EXPECT_EQ(std::vector<GraphSpaceID>{3}, listener.indexChanged);
+    }
+    {
+        // A user created, so no space is fetched
+        EXPECT_FALSE(client.authCheckFromCache("root", "nebula"));
+        handler->addUser("root", "nebula");
+        ASSERT_TRUE(client.heartbeat().get().ok());
+        ASSERT_TRUE(client.reloadData());
+        EXPECT_EQ(6UL, handler->numFetched());
+        EXPECT_TRUE(client.authCheckFromCache("root", "nebula"));
+    }
+    {
+        // Versioned again, with nothing the client keeps changed
+        handler->bump(4);
+        ASSERT_TRUE(client.heartbeat().get().ok());
+        ASSERT_TRUE(client.reloadData());
+        EXPECT_EQ(7UL, handler->numFetched());
+        EXPECT_EQ(std::vector<GraphSpaceID>{1}, listener.schemaChanged);
+        EXPECT_EQ(std::vector<GraphSpaceID>{3}, listener.indexChanged);
+    }
+    {
+        // A metad of old tells no versions, so everything is loaded again
+        handler->setWithVersions(false);
+        ASSERT_TRUE(client.heartbeat().get().ok());
+        ASSERT_TRUE(client.reloadData());
+        EXPECT_EQ(10UL, handler->numFetched());
+        EXPECT_FALSE(client.getSpaceIdByNameFromCache("space_2").ok());
+        EXPECT_EQ(1, client.getLatestTagVersionFromCache(1, 1).value());
+        EXPECT_EQ(1UL, client.getTagIndexesFromCache(3).value().size());
+        EXPECT_TRUE(client.authCheckFromCache("root", "nebula"));
+        EXPECT_EQ(std::vector<GraphSpaceID>{1}, listener.schemaChanged);
+        EXPECT_EQ(std::vector<GraphSpaceID>{3}, listener.indexChanged);
+    }
+    client.unRegisterListener();
+}
+
+}  // namespace meta
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,342 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_CLIENTS_META_TEST_MOCKMETASERVER_H_
+#define COMMON_CLIENTS_META_TEST_MOCKMETASERVER_H_
+
+#include "base/Base.h"
+#include <thrift/lib/cpp2/server/ThriftServer.h>
+#include "interface/gen-cpp2/MetaService.h"
+#include "clients/meta/MetaClient.h"
+#include "thread/NamedThread.h"
+
+namespace nebula {
+namespace meta {
+
+/**
+ * A metad serving the spaces named space_<id>, each of `numTags' tags, and as
+ * many edges, of `numVersions' versions, and of `numParts' parts. The spaces,
+ * their schemas and indexes, and the users are changed by the test, and each
+ * change bumps the versions told by the heartbeat, as metad does.
+ */
+class MockMetaServiceHandler : public cpp2::MetaServiceSvIf {
+public:
+    explicit MockMetaServiceHandler(int32_t numSpaces,
+                                    int32_t numTags = 1,
+                                    int32_t numVersions = 1,
+                                    int32_t numParts = 1)
+        : numTags_(numTags)
+        , numVersions_(numVersions)
+        , numParts_(numParts) {
+        for (GraphSpaceID spaceId = 1; spaceId <= numSpaces; spaceId++) {
+            spaces_[spaceId].tagVersions = numVersions;
+        }
+    }
+
+    // Stand for the round trip to a remote metad, on each space's request
+    void setRpcDelay(int32_t us) {
+        rpcDelayUs_ = us;
+    }
+
+    // Whether the heartbeat tells the versions, which the metad of old doesn't
+    void setWithVersions(bool withVersions) {
+        std::lock_guard<std::mutex> guard(lock_);
+        withVersions_ = withVersions;
+        lastUpdateTime_++;
+    }
+
+    // Stand for an ALTER which changes nothing the client keeps
+    void bump(GraphSpaceID spaceId) {
+        std::lock_guard<std::mutex> guard(lock_);
+        spaces_[spaceId].version++;
+        lastUpdateTime_++;
+    }
+
+    // A new version of every tag of the space
+    void alterTags(GraphSpaceID spaceId) {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto& space = spaces_[spaceId];
+        space.tagVersions++;
+        space.version++;
+        lastUpdateTime_++;
+    }
+
+    // An index on the first tag of the space
+    void addTagIndex(GraphSpaceID spaceId, const std::string& name) {
+        std::lock_guard<std::mutex> guard(lock_);
+        auto& space = spaces_[spaceId];
+        space.tagIndexes.emplace_back(name);
+        space.version++;
+        lastUpdateTime_++;
+    }
+
+    void addSpace(GraphSpaceID spaceId) {
+        std::lock_guard<std::mutex> guard(lock_);
+        spaces_[spaceId].tagVersions = numVersions_;
+        lastUpdateTime_++;
+    }
+
+    void dropSpace(GraphSpaceID spaceId) {
+        std::lock_guard<std::mutex> guard(lock_);
+        spaces_.erase(spaceId);
+        lastUpdateTime_++;
+    }
+
+    void addUser(const std::string& account, const std::string& password) {
+        std::lock_guard<std::mutex> guard(lock_);
+        users_[account] = password;
+        usersVersion_++;
+        lastUpdateTime_++;
+    }
+
+    // The number of spaces fetched so far
+    size_t numFetched() const {
+        return numFetched_.load();
+    }
+
+    folly::Future<cpp2::HBResp> future_heartBeat(const cpp2::HBReq&) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        cpp2::HBResp resp;
+        resp.set_last_update_time_in_ms(lastUpdateTime_);
+        if (withVersions_) {
+            std::unordered_map<GraphSpaceID, int64_t> versions;
+            for (auto& entry : spaces_) {
+                versions.emplace(entry.first, entry.second.version);
+            }
+            resp.set_space_versions(std::move(versions));
+            resp.set_users_version(usersVersion_);
+        }
+        return resp;
+    }
+
+    folly::Future<cpp2::ListSpacesResp>
+    future_listSpaces(const cpp2::ListSpacesReq&) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        cpp2::ListSpacesResp resp;
+        std::vector<cpp2::IdName> spaces;
+        for (auto& entry : spaces_) {
+            cpp2::IdName idName;
+            cpp2::ID id;
+            id.set_space_id(entry.first);
+            idName.set_id(std::move(id));
+            idName.set_name(spaceName(entry.first));
+            spaces.emplace_back(std::move(idName));
+        }
+        resp.set_spaces(std::move(spaces));
+        return resp;
+    }
+
+    folly::Future<cpp2::GetSpaceResp> future_getSpace(const cpp2::GetSpaceReq& req) override {
+        delay();
+        cpp2::GetSpaceResp resp;
+        cpp2::SpaceItem item;
+        cpp2::SpaceProperties properties;
+        properties.set_space_name(req.get_space_name());
+        properties.set_partition_num(numParts_);
+        properties.set_replica_factor(1);
+        item.set_properties(std::move(properties));
+        resp.set_item(std::move(item));
+        return resp;
+    }
+
+    folly::Future<cpp2::GetPartsAllocResp>
+    future_getPartsAlloc(const cpp2::GetPartsAllocReq&) override {
+        delay();
+        numFetched_++;
+        cpp2::GetPartsAllocResp resp;
+        std::unordered_map<PartitionID, std::vector<HostAddr>> parts;
+        for (PartitionID partId = 1; partId <= numParts_; partId++) {
+            parts[partId] = {HostAddr("127.0.0.1", 44500 + partId % 3)};
+        }
+        resp.set_parts(std::move(parts));
+        return resp;
+    }
+
+    folly::Future<cpp2::ListTagsResp> future_listTags(const cpp2::ListTagsReq& req) override {
+        delay();
+        int32_t numVersions = 0;
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            auto it = spaces_.find(req.get_space_id());
+            if (it != spaces_.end()) {
+                numVersions = it->second.tagVersions;
+            }
+        }
+        cpp2::ListTagsResp resp;
+        std::vector<cpp2::TagItem> tags;
+        for (TagID tagId = 1; tagId <= numTags_; tagId++) {
+            // From the newest version to the oldest, as metad returns
+            for (SchemaVer ver = numVersions - 1; ver >= 0; ver--) {
+                cpp2::TagItem item;
+                item.set_tag_id(tagId);
+                item.set_tag_name(folly::stringPrintf("tag_%d", tagId));
+                item.set_version(ver);
+                item.set_schema(makeSchema());
+                tags.emplace_back(std::move(item));
+            }
+        }
+        resp.set_tags(std::move(tags));
+        return resp;
+    }
+
+    folly::Future<cpp2::ListEdgesResp> future_listEdges(const cpp2::ListEdgesReq&) override {
+        delay();
+        cpp2::ListEdgesResp resp;
+        std::vector<cpp2::EdgeItem> edges;
+        for (EdgeType edgeType = 1; edgeType <= numTags_; edgeType++) {
+            for (SchemaVer ver = numVersions_ - 1; ver >= 0; ver--) {
+                cpp2::EdgeItem item;
+                item.set_edge_type(edgeType);
+                item.set_edge_name(folly::stringPrintf("edge_%d", edgeType));
+                item.set_version(ver);
+                item.set_schema(makeSchema());
+                edges.emplace_back(std::move(item));
+            }
+        }
+        resp.set_edges(std::move(edges));
+        return resp;
+    }
+
+    folly::Future<cpp2::ListTagIndexesResp>
+    future_listTagIndexes(const cpp2::ListTagIndexesReq& req) override {
+        delay();
+        std::vector<std::string> names;
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            auto it = spaces_.find(req.get_space_id());
+            if (it != spaces_.end()) {
+                names = it->second.tagIndexes;
+            }
+        }
+        cpp2::ListTagIndexesResp resp;
+        std::vector<cpp2::IndexItem> items;
+        for (size_t i = 0; i < names.size(); i++) {
+            cpp2::IndexItem item;
+            item.set_index_id(i + 1);
+            item.set_index_name(names[i]);
+            cpp2::SchemaID schemaId;
+            schemaId.set_tag_id(1);
+            item.set_schema_id(std::move(schemaId));
+            item.set_schema_name("tag_1");
+            items.emplace_back(std::move(item));
+        }
+        resp.set_items(std::move(items));
+        return resp;
+    }
+
+    folly::Future<cpp2::ListEdgeIndexesResp>
+    future_listEdgeIndexes(const cpp2::ListEdgeIndexesReq&) override {
+        delay();
+        return cpp2::ListEdgeIndexesResp();
+    }
+
+    folly::Future<cpp2::ListUsersResp> future_listUsers(const cpp2::ListUsersReq&) override {
+        std::lock_guard<std::mutex> guard(lock_);
+        cpp2::ListUsersResp resp;
+        resp.set_users(users_);
+        return resp;
+    }
+
+    folly::Future<cpp2::ListRolesResp>
+    future_getUserRoles(const cpp2::GetUserRolesReq&) override {
+        return cpp2::ListRolesResp();
+    }
+
+private:
+    struct Space {
+        int64_t                     version{1};
+        int32_t                     tagVersions{1};
+        std::vector<std::string>    tagIndexes;
+    };
+
+    void delay() const {
+        auto us = rpcDelayUs_.load();
+        if (us > 0) {
+            ::usleep(us);
+        }
+    }
+
+    static std::string spaceName(GraphSpaceID spaceId) {
+        return folly::stringPrintf("space_%d", spaceId);
+    }
+
+    static cpp2::Schema makeSchema() {
+        cpp2::Schema schema;
+        std::vector<cpp2::ColumnDef> columns;
+        for (int32_t i = 0; i < 5; i++) {
+            cpp2::ColumnDef column;
+            column.set_name(folly::stringPrintf("col_%d", i));
+            column.set_type(cpp2::PropertyType::INT64);
+            columns.emplace_back(std::move(column));
+        }
+        schema.set_columns(std::move(columns));
+        return schema;
+    }
+
+private:
+    const int32_t                                       numTags_;
+    const int32_t                                       numVersions_;
+    const int32_t                                       numParts_;
+    std::atomic<int32_t>                                rpcDelayUs_{0};
+    std::atomic<size_t>                                 numFetched_{0};
+
+    std::mutex                                          lock_;
+    std::map<GraphSpaceID, Space>                       spaces_;
+    std::unordered_map<std::string, std::string>        users_;
+    int64_t                                             usersVersion_{1};
+    bool                                                withVersions_{true};
+    int64_t                                             lastUpdateTime_{1};
+};
+
+
+class MockMetaServer {
+public:
+    explicit MockMetaServer(std::shared_ptr<MockMetaServiceHandler> handler) {
+        server_ = std::make_unique<apache::thrift::ThriftServer>();
+        server_->setInterface(std::move(handler));
+        server_->setPort(0);
+        thread_ = std::make_unique<thread::NamedThread>("mock-metad", [this] {
+            server_->serve();
+        });
+        while (!server_->getServeEventBase() ||
+               !server_->getServeEventBase()->isRunning()) {
+            usleep(10000);
+        }
+        port_ = server_->getAddress().getPort();
+    }
+
+    ~MockMetaServer() {
+        server_->stop();
+        thread_->join();
+    }
+
+    uint16_t port() const {
+        return port_;
+    }
+
+private:
+    std::unique_ptr<apache::thrift::ThriftServer>   server_;
+    std::unique_ptr<thread::NamedThread>            thread_;
+    uint16_t                                        port_{0};
+};
+
+
+class TestMetaClient : public MetaClient {
+public:
+    explicit TestMetaClient(uint16_t port)
+        : MetaClient(std::make_shared<folly::IOThreadPoolExecutor>(4),
+                     {HostAddr("127.0.0.1", port)}) {}
+
+    using MetaClient::heartbeat;
+    using MetaClient::loadData;
+    using MetaClient::loadChangedData;
+    using MetaClient::reloadData;
+};
+
+}  // namespace meta
+}  // namespace nebula
+
+#endif  // COMMON_CLIENTS_META_TEST_MOCKMETASERVER_H_
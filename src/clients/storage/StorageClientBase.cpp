@@ -5,10 +5,21 @@
  */
 
 #include "clients/storage/StorageClientBase.h"
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 
 DEFINE_int32(storage_client_timeout_ms, 60 * 1000, "storage client timeout");
+DEFINE_int32(storage_client_parallel_cluster_threshold, 100000,
+             "The batches of more ids are hashed to parts on multiple threads, 0 to disable");
 
 namespace nebula {
 namespace storage {
+
+folly::CPUThreadPoolExecutor* clusterIdsExecutor() {
+    static folly::CPUThreadPoolExecutor executor(
+        std::max(1U, std::thread::hardware_concurrency()),
+        std::make_shared<folly::NamedThreadFactory>("cluster-ids"));
+    return &executor;
+}
+
 }   // namespace storage
 }   // namespace nebula
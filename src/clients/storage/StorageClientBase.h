@@ -10,6 +10,7 @@
 #include "base/Base.h"
 #include <folly/futures/Future.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include "base/StatusOr.h"
 #include "meta/Common.h"
 #include "thrift/ThriftClientManager.h"
@@ -17,6 +18,7 @@
 #include "interface/gen-cpp2/storage_types.h"
 
 DECLARE_int32(storage_client_timeout_ms);
+DECLARE_int32(storage_client_parallel_cluster_threshold);
 
 
 namespace nebula {
@@ -82,6 +84,11 @@ private:
 };
 
 
+// The threads hashing the ids of the large batches to their parts, shared by
+// all the storage clients
+folly::CPUThreadPoolExecutor* clusterIdsExecutor();
+
+
 /**
  * A base class for all storage clients
  */
@@ -127,17 +134,37 @@ protected:
     // The method returns a map
     //  host_addr (A host, but in most case, the leader will be chosen)
     //      => (partition -> [ids that belong to the shard])
+    //
+    // The leaders are looked up once for the batch. The ids are moved into the
+    // result if the container is given as an rvalue, or else copied. The ids
+    // of a part whose hosts are unknown are left out. A batch of more ids than
+    // FLAGS_storage_client_parallel_cluster_threshold is hashed on multiple
+    // threads, so f must be safe to call concurrently
     template<class Container, class GetIdFunc>
     StatusOr<
         std::unordered_map<
             HostAddr,
             std::unordered_map<
                 PartitionID,
-                std::vector<typename Container::value_type>
+                std::vector<typename std::decay_t<Container>::value_type>
             >
         >
     >
-    clusterIdsToHosts(GraphSpaceID spaceId, const Container& ids, GetIdFunc f) const;
+    clusterIdsToHosts(GraphSpaceID spaceId, Container&& ids, GetIdFunc f) const;
+
+    // The leaders of all the parts of a space
+    struct PartLeaders {
+        // The leaders were taken at the version, see leadersVersion_
+        int64_t                 version;
+        // The leader of the part i is leaders[i - 1], which is empty if the
+        // hosts of the part are unknown
+        std::vector<HostAddr>   leaders;
+    };
+
+    // Get the snapshot of the leaders of the space. The snapshot is immutable,
+    // and shared by all the batches until any leader of the client changes,
+    // unless the hosts of any part are unknown
+    StatusOr<std::shared_ptr<const PartLeaders>> getPartLeaders(GraphSpaceID spaceId) const;
 
     virtual StatusOr<meta::PartHosts> getPartHosts(GraphSpaceID spaceId,
                                                    PartitionID partId) const {
@@ -145,6 +172,11 @@ protected:
         return metaClient_->getPartHostsFromCache(spaceId, partId);
     }
 
+    virtual StatusOr<int32_t> partsNum(GraphSpaceID spaceId) const {
+        CHECK(metaClient_ != nullptr);
+        return metaClient_->partsNum(spaceId);
+    }
+
     virtual StatusOr<std::unordered_map<HostAddr, std::vector<PartitionID>>>
     getHostParts(GraphSpaceID spaceId) const;
 
@@ -157,6 +189,11 @@ private:
 
     mutable folly::RWSpinLock leadersLock_;
     mutable std::unordered_map<std::pair<GraphSpaceID, PartitionID>, HostAddr> leaders_;
+    // Bumped under leadersLock_ whenever a leader known is changed, so the
+    // snapshots taken before are rebuilt
+    mutable std::atomic<int64_t> leadersVersion_{0};
+    mutable folly::RWSpinLock partLeadersLock_;
+    mutable std::unordered_map<GraphSpaceID, std::shared_ptr<const PartLeaders>> partLeaders_;
     mutable std::atomic_bool loadLeaderBefore_{false};
     mutable std::atomic_bool isLoadingLeader_{false};
 };
@@ -5,6 +5,7 @@
  */
 
 #include <folly/Try.h>
+#include <folly/futures/Future.h>
 #include "time/WallClock.h"
 
 namespace nebula {
@@ -68,6 +69,61 @@ private:
     bool fulfilled_{false};
 };
 
+
+// Hash the ids in [begin, end) to their parts
+template<class Iter, class GetIdFunc>
+void hashIdsToParts(Iter begin,
+                    Iter end,
+                    GetIdFunc& f,
+                    int32_t numParts,
+                    PartitionID* parts) {
+    for (; begin != end; ++begin, ++parts) {
+        *parts = meta::MetaClient::partIdOf(numParts, f(*begin));
+    }
+}
+
+
+template<class Iter, class GetIdFunc>
+void hashIdsToParts(Iter begin,
+                    Iter end,
+                    GetIdFunc& f,
+                    int32_t numParts,
+                    PartitionID* parts,
+                    std::input_iterator_tag) {
+    hashIdsToParts(begin, end, f, numParts, parts);
+}
+
+
+// The ids of a large batch are split into a chunk for each thread of
+// clusterIdsExecutor(), and the calling thread hashes the first one
+template<class Iter, class GetIdFunc>
+void hashIdsToParts(Iter begin,
+                    Iter end,
+                    GetIdFunc& f,
+                    int32_t numParts,
+                    PartitionID* parts,
+                    std::random_access_iterator_tag) {
+    size_t size = end - begin;
+    auto threshold = FLAGS_storage_client_parallel_cluster_threshold;
+    if (threshold <= 0 || size < static_cast<size_t>(threshold)) {
+        hashIdsToParts(begin, end, f, numParts, parts);
+        return;
+    }
+
+    auto* executor = clusterIdsExecutor();
+    size_t numChunks = executor->numThreads() + 1;
+    size_t chunkSize = (size + numChunks - 1) / numChunks;
+    std::vector<folly::Future<folly::Unit>> futures;
+    for (size_t from = chunkSize; from < size; from += chunkSize) {
+        auto to = std::min(size, from + chunkSize);
+        futures.emplace_back(folly::via(executor, [begin, from, to, &f, numParts, parts] () {
+            hashIdsToParts(begin + from, begin + to, f, numParts, parts + from);
+        }));
+    }
+    hashIdsToParts(begin, begin + std::min(size, chunkSize), f, numParts, parts);
+    folly::collectAll(futures).wait();
+}
+
 }  // Anonymous namespace
 
 
@@ -102,6 +158,7 @@ void StorageClientBase<ClientType>::loadLeader() const {
         if (status.ok()) {
             folly::RWSpinLock::WriteHolder wh(leadersLock_);
             leaders_ = std::move(status).value();
+            leadersVersion_++;
             loadLeaderBefore_ = true;
         }
         isLoadingLeader_ = false;
@@ -129,6 +186,8 @@ StorageClientBase<ClientType>::getLeader(const meta::PartHosts& partHosts) const
         rh.reset();
         folly::RWSpinLock::WriteHolder wh(std::move(uh));
 
+        // No snapshot has a leader of the part, so the version is kept, see
+        // getPartLeaders()
         auto& random = partHosts.hosts_[folly::Random::rand32(partHosts.hosts_.size())];
         leaders_[part] = random;
         return random;
@@ -146,6 +205,7 @@ void StorageClientBase<ClientType>::updateLeader(GraphSpaceID spaceId,
 
     folly::RWSpinLock::WriteHolder wh(leadersLock_);
     leaders_[std::make_pair(spaceId, partId)] = leader;
+    leadersVersion_++;
 }
 
 
@@ -157,7 +217,80 @@ void StorageClientBase<ClientType>::invalidLeader(GraphSpaceID spaceId,
     auto it = leaders_.find(std::make_pair(spaceId, partId));
     if (it != leaders_.end()) {
         leaders_.erase(it);
+        leadersVersion_++;
+    }
+}
+
+
+template<typename ClientType>
+StatusOr<std::shared_ptr<const typename StorageClientBase<ClientType>::PartLeaders>>
+StorageClientBase<ClientType>::getPartLeaders(GraphSpaceID spaceId) const {
+    loadLeader();
+    auto numStatus = partsNum(spaceId);
+    if (!numStatus.ok()) {
+        return numStatus.status();
+    }
+    auto numParts = numStatus.value();
+    if (numParts <= 0) {
+        return Status::Error("No parts in the space, spaceid: %d", spaceId);
+    }
+
+    {
+        folly::RWSpinLock::ReadHolder rh(partLeadersLock_);
+        auto it = partLeaders_.find(spaceId);
+        if (it != partLeaders_.end()
+                && it->second->version == leadersVersion_.load()
+                && it->second->leaders.size() == static_cast<size_t>(numParts)) {
+            return it->second;
+        }
     }
+
+    // Rebuild the snapshot. The hosts are got before taking the lock of the
+    // leaders, since getPartHosts() takes the lock of the meta cache
+    std::vector<meta::PartHosts> allPartHosts;
+    allPartHosts.reserve(numParts);
+    bool complete = true;
+    for (PartitionID partId = 1; partId <= numParts; partId++) {
+        auto metaStatus = getPartHosts(spaceId, partId);
+        if (!metaStatus.ok() || metaStatus.value().hosts_.empty()) {
+            LOG(ERROR) << "No hosts of the part " << partId << " of the space " << spaceId
+                       << ", so it is skipped";
+            complete = false;
+            allPartHosts.emplace_back();
+            allPartHosts.back().partId_ = partId;
+            continue;
+        }
+        allPartHosts.emplace_back(std::move(metaStatus).value());
+    }
+
+    auto snapshot = std::make_shared<PartLeaders>();
+    snapshot->leaders.reserve(numParts);
+    {
+        folly::RWSpinLock::WriteHolder wh(leadersLock_);
+        snapshot->version = leadersVersion_.load();
+        for (auto& partHosts : allPartHosts) {
+            if (partHosts.hosts_.empty()) {
+                snapshot->leaders.emplace_back();
+                continue;
+            }
+            auto part = std::make_pair(spaceId, partHosts.partId_);
+            auto it = leaders_.find(part);
+            if (it == leaders_.end()) {
+                // Choose one random as getLeader() does
+                auto& random = partHosts.hosts_[folly::Random::rand32(partHosts.hosts_.size())];
+                it = leaders_.emplace(part, random).first;
+            }
+            snapshot->leaders.emplace_back(it->second);
+        }
+    }
+
+    std::shared_ptr<const PartLeaders> result = std::move(snapshot);
+    // Built again by the next batch, which may find the hosts missing here
+    if (complete) {
+        folly::RWSpinLock::WriteHolder wh(partLeadersLock_);
+        partLeaders_[spaceId] = result;
+    }
+    return result;
 }
 
 
@@ -343,37 +476,66 @@ StatusOr<
         HostAddr,
         std::unordered_map<
             PartitionID,
-            std::vector<typename Container::value_type>
+            std::vector<typename std::decay_t<Container>::value_type>
         >
     >
 >
 StorageClientBase<ClientType>::clusterIdsToHosts(GraphSpaceID spaceId,
-                                                 const Container& ids,
+                                                 Container&& ids,
                                                  GetIdFunc f) const {
+    using Id = typename std::decay_t<Container>::value_type;
+    // The ids are moved only out of an rvalue container
+    using IdRef = std::conditional_t<std::is_lvalue_reference<Container>::value,
+                                     const Id&,
+                                     Id&&>;
+    auto status = getPartLeaders(spaceId);
+    if (!status.ok()) {
+        return status.status();
+    }
+    auto partLeaders = std::move(status).value();
+    auto numParts = static_cast<int32_t>(partLeaders->leaders.size());
+
+    std::vector<PartitionID> parts(ids.size());
+    hashIdsToParts(
+        ids.begin(),
+        ids.end(),
+        f,
+        numParts,
+        parts.data(),
+        typename std::iterator_traits<decltype(ids.begin())>::iterator_category());
+
+    // Copy or move the ids into the buckets of their parts, each sized once
+    std::vector<size_t> counts(numParts + 1, 0);
+    for (auto part : parts) {
+        counts[part]++;
+    }
+    std::vector<std::vector<Id>> buckets(numParts + 1);
+    for (PartitionID part = 1; part <= numParts; part++) {
+        buckets[part].reserve(counts[part]);
+    }
+    auto partIter = parts.begin();
+    for (auto& id : ids) {
+        buckets[*partIter++].emplace_back(static_cast<IdRef>(id));
+    }
+
     std::unordered_map<
         HostAddr,
         std::unordered_map<
             PartitionID,
-            std::vector<typename Container::value_type>
+            std::vector<Id>
         >
     > clusters;
-    for (auto& id : ids) {
-        CHECK(!!metaClient_);
-        auto status = metaClient_->partId(spaceId, f(id));
-        if (!status.ok()) {
-            return status.status();
+    for (PartitionID part = 1; part <= numParts; part++) {
+        if (buckets[part].empty()) {
+            continue;
         }
-
-        auto part = status.value();
-        auto metaStatus = getPartHosts(spaceId, part);
-        if (!metaStatus.ok()) {
-            return status.status();
+        auto& leader = partLeaders->leaders[part - 1];
+        if (leader.host.empty()) {
+            LOG(ERROR) << "Skip " << buckets[part].size() << " ids of the part " << part
+                       << " of the space " << spaceId << ", whose hosts are unknown";
+            continue;
         }
-
-        auto partHosts = metaStatus.value();
-        CHECK_GT(partHosts.hosts_.size(), 0U);
-        const auto leader = this->getLeader(partHosts);
-        clusters[leader][part].emplace_back(std::move(id));
+        clusters[leader].emplace(part, std::move(buckets[part]));
     }
     return clusters;
 }
@@ -382,22 +544,19 @@ StorageClientBase<ClientType>::clusterIdsToHosts(GraphSpaceID spaceId,
 template<typename ClientType>
 StatusOr<std::unordered_map<HostAddr, std::vector<PartitionID>>>
 StorageClientBase<ClientType>::getHostParts(GraphSpaceID spaceId) const {
-    std::unordered_map<HostAddr, std::vector<PartitionID>> hostParts;
-    auto status = metaClient_->partsNum(spaceId);
+    auto status = getPartLeaders(spaceId);
     if (!status.ok()) {
-        return Status::Error("Space not found, spaceid: %d", spaceId);
+        return status.status();
     }
 
-    auto parts = status.value();
-    for (auto partId = 1; partId <= parts; partId++) {
-        auto metaStatus = getPartHosts(spaceId, partId);
-        if (!metaStatus.ok()) {
-            return metaStatus.status();
+    std::unordered_map<HostAddr, std::vector<PartitionID>> hostParts;
+    auto& leaders = status.value()->leaders;
+    for (size_t i = 0; i < leaders.size(); i++) {
+        // The hosts of the part are unknown
+        if (leaders[i].host.empty()) {
+            continue;
         }
-        auto partHosts = std::move(metaStatus).value();
-        DCHECK_GT(partHosts.hosts_.size(), 0U);
-        const auto leader = getLeader(partHosts);
-        hostParts[leader].emplace_back(partId);
+        hostParts[leaders[i]].emplace_back(i + 1);
     }
     return hostParts;
 }
@@ -0,0 +1,144 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "interface/gen-cpp2/GraphStorageServiceAsyncClient.h"
+#include "clients/storage/StorageClientBase.h"
+
+namespace nebula {
+namespace storage {
+
+static constexpr int32_t kNumParts = 100;
+static constexpr int32_t kNumHosts = 3;
+
+// A client of fixed parts, whose meta cache is guarded by a lock as the
+// MetaClient's is
+class FakeStorageClient
+        : public StorageClientBase<cpp2::GraphStorageServiceAsyncClient> {
+public:
+    FakeStorageClient() : StorageClientBase(nullptr, nullptr) {}
+
+    void loadLeader() const override {}
+
+    StatusOr<meta::PartHosts> getPartHosts(GraphSpaceID spaceId,
+                                           PartitionID partId) const override {
+        folly::RWSpinLock::ReadHolder rh(cacheLock_);
+        meta::PartHosts partHosts;
+        partHosts.spaceId_ = spaceId;
+        partHosts.partId_ = partId;
+        for (int32_t i = 0; i < kNumHosts; i++) {
+            partHosts.hosts_.emplace_back(folly::stringPrintf("127.0.0.%d", i + 1), 9779);
+        }
+        return partHosts;
+    }
+
+    StatusOr<int32_t> partsNum(GraphSpaceID) const override {
+        folly::RWSpinLock::ReadHolder rh(cacheLock_);
+        return kNumParts;
+    }
+
+    // Look up the part and the leader of each id, as clusterIdsToHosts() did
+    // before the leaders were taken once for a batch
+    std::unordered_map<HostAddr, std::unordered_map<PartitionID, std::vector<VertexID>>>
+    clusterPerId(GraphSpaceID spaceId, const std::vector<VertexID>& ids) const {
+        std::unordered_map<
+            HostAddr,
+            std::unordered_map<PartitionID, std::vector<VertexID>>
+        > clusters;
+        for (auto& id : ids) {
+            auto numParts = partsNum(spaceId).value();
+            auto part = meta::MetaClient::partIdOf(numParts, id);
+            auto partHosts = getPartHosts(spaceId, part).value();
+            const auto leader = getLeader(partHosts);
+            clusters[leader][part].emplace_back(id);
+        }
+        return clusters;
+    }
+
+    auto cluster(GraphSpaceID spaceId, const std::vector<VertexID>& ids) const {
+        return clusterIdsToHosts(spaceId, ids, [] (const VertexID& id) -> const VertexID& {
+            return id;
+        }).value();
+    }
+
+private:
+    mutable folly::RWSpinLock cacheLock_;
+};
+
+
+std::vector<VertexID> makeIds(size_t num) {
+    std::vector<VertexID> ids;
+    ids.reserve(num);
+    for (size_t i = 0; i < num; i++) {
+        ids.emplace_back(folly::stringPrintf("vertex_%lu", i));
+    }
+    return ids;
+}
+
+
+void perId(size_t iters, size_t num) {
+    FakeStorageClient client;
+    std::vector<VertexID> ids;
+    BENCHMARK_SUSPEND {
+        ids = makeIds(num);
+    }
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(client.clusterPerId(1, ids));
+    }
+}
+
+
+void batch(size_t iters, size_t num) {
+    FakeStorageClient client;
+    std::vector<VertexID> ids;
+    BENCHMARK_SUSPEND {
+        ids = makeIds(num);
+    }
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(client.cluster(1, ids));
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+using nebula::storage::perId;
+using nebula::storage::batch;
+
+BENCHMARK(perId_1K, iters) {
+    perId(iters, 1000);
+}
+
+BENCHMARK_RELATIVE(batch_1K, iters) {
+    batch(iters, 1000);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(perId_100K, iters) {
+    perId(iters, 100000);
+}
+
+BENCHMARK_RELATIVE(batch_100K, iters) {
+    batch(iters, 100000);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(perId_1M, iters) {
+    perId(iters, 1000000);
+}
+
+BENCHMARK_RELATIVE(batch_1M, iters) {
+    batch(iters, 1000000);
+}
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
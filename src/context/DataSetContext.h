@@ -0,0 +1,90 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef CONTEXT_DATASETCONTEXT_H_
+#define CONTEXT_DATASETCONTEXT_H_
+
+#include "base/Base.h"
+#include "context/ExpressionContext.h"
+#include "datatypes/DataSet.h"
+
+namespace nebula {
+
+/***************************************************************************
+ *
+ * The context of evaluating expressions on the rows of a DataSet, i.e. the
+ * input, so the input properties $-.prop_name are the columns of the current
+ * row. The other properties are null. The input properties are resolved to the
+ * indexes of the columns.
+ *
+ **************************************************************************/
+class DataSetContext : public ExpressionContext {
+public:
+    explicit DataSetContext(const DataSet* ds) : ds_(ds) {
+        for (size_t i = 0; i < ds_->colNames.size(); i++) {
+            cols_.emplace(ds_->colNames[i], i);
+        }
+    }
+
+    const DataSet& dataSet() const {
+        return *ds_;
+    }
+
+    void setRow(size_t row) {
+        row_ = &ds_->rows[row];
+    }
+
+    const Value& getVar(const std::string&) const override {
+        return Value::null();
+    }
+
+    const Value& getVarProp(const std::string&, const std::string&) const override {
+        return Value::null();
+    }
+
+    const Value& getEdgeProp(const std::string&, const std::string&) const override {
+        return Value::null();
+    }
+
+    const Value& getSrcProp(const std::string&) const override {
+        return Value::null();
+    }
+
+    const Value& getDstProp(const std::string&) const override {
+        return Value::null();
+    }
+
+    const Value& getInputProp(const std::string& prop) const override {
+        auto col = column(prop);
+        return col < 0 ? Value::null() : row_->columns[col];
+    }
+
+    int32_t resolveProp(PropKind kind,
+                        const std::string& alias,
+                        const std::string& prop) const override {
+        UNUSED(alias);
+        return kind == PropKind::INPUT ? column(prop) : -1;
+    }
+
+    const Value& getSlot(int32_t slot) const override {
+        return row_->columns[slot];
+    }
+
+protected:
+    // The index of the column, -1 if not found
+    int32_t column(const std::string& name) const {
+        auto it = cols_.find(name);
+        return it == cols_.end() ? -1 : it->second;
+    }
+
+protected:
+    const DataSet*                                  ds_;
+    const Row*                                      row_{nullptr};
+    std::unordered_map<std::string, size_t>         cols_;
+};
+
+}  // namespace nebula
+#endif  // CONTEXT_DATASETCONTEXT_H_
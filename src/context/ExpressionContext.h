@@ -23,6 +23,15 @@ namespace nebula {
  **************************************************************************/
 class ExpressionContext {
 public:
+    // The kinds of the properties, which may be resolved to slots
+    enum class PropKind {
+        INPUT,      // $-.prop_name
+        VAR,        // $a.prop_name
+        EDGE,       // edge_type.prop_name
+        SRC,        // $^.tag_name.prop_name
+        DST,        // $$.tag_name.prop_name
+    };
+
     virtual ~ExpressionContext() = default;
 
     // Get the value for the given variable name, such as $a, $b
@@ -44,6 +53,24 @@ public:
 
     // Get the specified property from the input, such as $-.prop_name
     virtual const Value& getInputProp(const std::string& prop) const = 0;
+
+    // Resolve the property to a slot, once for a query, so the property of each
+    // row is got by getSlot() without looking up the names. Return -1 if it is
+    // not resolved, then the property is got by the names as above
+    virtual int32_t resolveProp(PropKind kind,
+                                const std::string& alias,
+                                const std::string& prop) const {
+        UNUSED(kind);
+        UNUSED(alias);
+        UNUSED(prop);
+        return -1;
+    }
+
+    // Get the property resolved to the slot
+    virtual const Value& getSlot(int32_t slot) const {
+        LOG(FATAL) << "The slot " << slot << " is not resolved";
+        return Value::null();
+    }
 };
 
 }  // namespace nebula
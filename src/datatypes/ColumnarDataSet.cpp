@@ -0,0 +1,479 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "datatypes/ColumnarDataSet.h"
+
+namespace nebula {
+
+// The same as Value.cpp
+constexpr auto EPSILON = 1e-8;
+
+// The kind of a column of the given cells, i.e. VALUE unless all cells not null
+// are of the same type
+template <class Get>
+static Column::Kind kindOf(size_t size, Get& get) {
+    bool found = false;
+    Value::Type type = Value::Type::__EMPTY__;
+    size_t chars = 0;
+    for (size_t i = 0; i < size; i++) {
+        const Value& v = get(i);
+        if (v.isNull()) {
+            if (v.getNull() != NullType::__NULL__) {
+                return Column::Kind::VALUE;
+            }
+            continue;
+        }
+        if (!found) {
+            found = true;
+            type = v.type();
+        } else if (v.type() != type) {
+            return Column::Kind::VALUE;
+        }
+        if (type == Value::Type::STRING) {
+            chars += v.getStr().size();
+        }
+    }
+    if (!found) {
+        // All null
+        return size == 0 ? Column::Kind::VALUE : Column::Kind::INT;
+    }
+    switch (type) {
+        case Value::Type::INT:
+            return Column::Kind::INT;
+        case Value::Type::FLOAT:
+            return Column::Kind::FLOAT;
+        case Value::Type::BOOL:
+            return Column::Kind::BOOL;
+        case Value::Type::STRING:
+            // The offsets are 32 bits
+            return chars <= std::numeric_limits<uint32_t>::max() ? Column::Kind::STRING
+                                                                 : Column::Kind::VALUE;
+        default:
+            return Column::Kind::VALUE;
+    }
+}
+
+
+template <class Get>
+Column Column::build(size_t size, Get&& get) {
+    Column col;
+    col.size_ = size;
+    col.kind_ = kindOf(size, get);
+    switch (col.kind_) {
+        case Kind::INT: {
+            col.ints_.resize(size, 0);
+            for (size_t i = 0; i < size; i++) {
+                const Value& v = get(i);
+                if (v.isNull()) {
+                    col.setNull(i);
+                } else {
+                    col.ints_[i] = v.getInt();
+                }
+            }
+            break;
+        }
+        case Kind::FLOAT: {
+            col.floats_.resize(size, 0);
+            for (size_t i = 0; i < size; i++) {
+                const Value& v = get(i);
+                if (v.isNull()) {
+                    col.setNull(i);
+                } else {
+                    col.floats_[i] = v.getFloat();
+                }
+            }
+            break;
+        }
+        case Kind::BOOL: {
+            col.bools_.resize(size, 0);
+            for (size_t i = 0; i < size; i++) {
+                const Value& v = get(i);
+                if (v.isNull()) {
+                    col.setNull(i);
+                } else {
+                    col.bools_[i] = v.getBool();
+                }
+            }
+            break;
+        }
+        case Kind::STRING: {
+            col.offsets_.reserve(size + 1);
+            col.offsets_.emplace_back(0);
+            for (size_t i = 0; i < size; i++) {
+                const Value& v = get(i);
+                if (v.isNull()) {
+                    col.setNull(i);
+                } else {
+                    col.chars_.append(v.getStr());
+                }
+                col.offsets_.emplace_back(col.chars_.size());
+            }
+            break;
+        }
+        case Kind::VALUE: {
+            col.values_.reserve(size);
+            for (size_t i = 0; i < size; i++) {
+                // Moved if `get' returns an rvalue
+                col.values_.emplace_back(get(i));
+            }
+            break;
+        }
+    }
+    return col;
+}
+
+
+Column Column::fromValues(std::vector<Value>&& values) {
+    return build(values.size(), [&values] (size_t i) -> Value&& {
+        return std::move(values[i]);
+    });
+}
+
+
+void Column::setNull(size_t i) {
+    if (nulls_.empty()) {
+        nulls_.resize((size_ + 63) / 64, 0);
+    }
+    nulls_[i >> 6] |= uint64_t{1} << (i & 63);
+}
+
+
+Value Column::value(size_t i) const {
+    if (isNull(i)) {
+        return Value(NullType::__NULL__);
+    }
+    switch (kind_) {
+        case Kind::INT:
+            return Value(ints_[i]);
+        case Kind::FLOAT:
+            return Value(floats_[i]);
+        case Kind::BOOL:
+            return Value(bools_[i] != 0);
+        case Kind::STRING:
+            return Value(str(i));
+        case Kind::VALUE:
+            return values_[i];
+    }
+    return Value();
+}
+
+
+size_t Column::memoryUsage() const {
+    return sizeof(Column)
+        + nulls_.capacity() * sizeof(uint64_t)
+        + ints_.capacity() * sizeof(int64_t)
+        + floats_.capacity() * sizeof(double)
+        + bools_.capacity() * sizeof(uint8_t)
+        + chars_.capacity()
+        + offsets_.capacity() * sizeof(uint32_t)
+        + values_.capacity() * sizeof(Value);
+}
+
+
+bool Column::operator==(const Column& rhs) const {
+    return kind_ == rhs.kind_ &&
+           size_ == rhs.size_ &&
+           nulls_ == rhs.nulls_ &&
+           ints_ == rhs.ints_ &&
+           floats_ == rhs.floats_ &&
+           bools_ == rhs.bools_ &&
+           chars_ == rhs.chars_ &&
+           offsets_ == rhs.offsets_ &&
+           values_ == rhs.values_;
+}
+
+
+ColumnarDataSet::ColumnarDataSet(const DataSet& ds) {
+    static const Value kEmpty;
+    colNames = ds.colNames;
+    columns.reserve(colNames.size());
+    for (size_t c = 0; c < colNames.size(); c++) {
+        columns.emplace_back(Column::build(ds.rows.size(), [&ds, c] (size_t i) -> const Value& {
+            auto& cells = ds.rows[i].columns;
+            return c < cells.size() ? cells[c] : kEmpty;
+        }));
+    }
+}
+
+
+ColumnarDataSet::ColumnarDataSet(DataSet&& ds) {
+    colNames = std::move(ds.colNames);
+    for (auto& row : ds.rows) {
+        row.columns.resize(colNames.size());
+    }
+    columns.reserve(colNames.size());
+    for (size_t c = 0; c < colNames.size(); c++) {
+        columns.emplace_back(Column::build(ds.rows.size(), [&ds, c] (size_t i) -> Value&& {
+            return std::move(ds.rows[i].columns[c]);
+        }));
+    }
+    ds.clear();
+}
+
+
+DataSet ColumnarDataSet::toDataSet() const {
+    DataSet ds;
+    ds.colNames = colNames;
+    ds.rows.resize(rowSize());
+    for (auto& row : ds.rows) {
+        row.columns.reserve(columns.size());
+    }
+    for (auto& col : columns) {
+        for (size_t i = 0; i < col.size(); i++) {
+            ds.rows[i].columns.emplace_back(col.value(i));
+        }
+    }
+    return ds;
+}
+
+
+static int64_t modOf(int64_t lhs, int64_t rhs) {
+    return lhs % rhs;
+}
+
+template <class L, class R>
+static double modOf(L lhs, R rhs) {
+    return std::fmod(lhs, rhs);
+}
+
+static bool equalTo(int64_t lhs, int64_t rhs) {
+    return lhs == rhs;
+}
+
+static bool equalTo(uint8_t lhs, uint8_t rhs) {
+    return lhs == rhs;
+}
+
+static bool equalTo(folly::StringPiece lhs, folly::StringPiece rhs) {
+    return lhs == rhs;
+}
+
+template <class L, class R>
+static bool equalTo(L lhs, R rhs) {
+    return std::abs(lhs - rhs) < EPSILON;
+}
+
+
+struct ColumnOps {
+    static bool isNumeric(const Column& col) {
+        return col.kind_ == Column::Kind::INT || col.kind_ == Column::Kind::FLOAT;
+    }
+
+    // Whether any cell not null is zero, as a denominator
+    static bool hasZero(const Column& col) {
+        for (size_t i = 0; i < col.size_; i++) {
+            if (col.isNull(i)) {
+                continue;
+            }
+            if (col.kind_ == Column::Kind::INT ? col.ints_[i] == 0
+                                               : std::abs(col.floats_[i]) <= EPSILON) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The i-th cell, materialized into `tmp' unless the column stores Values
+    static const Value& cell(const Column& col, size_t i, Value& tmp) {
+        if (col.kind_ == Column::Kind::VALUE) {
+            return col.values_[i];
+        }
+        tmp = col.value(i);
+        return tmp;
+    }
+
+    // The cells where either operand is null are null
+    static void mergeNulls(const Column& lhs, const Column& rhs, Column& result) {
+        if (!lhs.hasNulls() && !rhs.hasNulls()) {
+            return;
+        }
+        result.nulls_.resize((result.size_ + 63) / 64, 0);
+        for (size_t w = 0; w < result.nulls_.size(); w++) {
+            result.nulls_[w] = (lhs.hasNulls() ? lhs.nulls_[w] : 0)
+                             | (rhs.hasNulls() ? rhs.nulls_[w] : 0);
+        }
+    }
+
+    template <class L, class R, class T, class Op>
+    static void loop(const std::vector<L>& lhs,
+                     const std::vector<R>& rhs,
+                     std::vector<T>& result,
+                     Op op) {
+        result.resize(lhs.size());
+        for (size_t i = 0; i < lhs.size(); i++) {
+            result[i] = op(lhs[i], rhs[i]);
+        }
+    }
+
+    template <class T, class Op>
+    static void numericLoop(const Column& lhs, const Column& rhs, std::vector<T>& result, Op op) {
+        if (lhs.kind_ == Column::Kind::INT) {
+            if (rhs.kind_ == Column::Kind::INT) {
+                loop(lhs.ints_, rhs.ints_, result, op);
+            } else {
+                loop(lhs.ints_, rhs.floats_, result, op);
+            }
+        } else {
+            if (rhs.kind_ == Column::Kind::INT) {
+                loop(lhs.floats_, rhs.ints_, result, op);
+            } else {
+                loop(lhs.floats_, rhs.floats_, result, op);
+            }
+        }
+    }
+
+    template <class Op, class ValueOp>
+    static Column arithmetic(const Column& lhs,
+                             const Column& rhs,
+                             Op op,
+                             ValueOp valueOp,
+                             bool divide) {
+        CHECK_EQ(lhs.size_, rhs.size_);
+        auto size = lhs.size_;
+        if (!isNumeric(lhs) || !isNumeric(rhs) || (divide && hasZero(rhs))) {
+            // Evaluate by Value, e.g. string concatenation or division by zero
+            std::vector<Value> values;
+            values.reserve(size);
+            Value l, r;
+            for (size_t i = 0; i < size; i++) {
+                values.emplace_back(valueOp(cell(lhs, i, l), cell(rhs, i, r)));
+            }
+            return Column::fromValues(std::move(values));
+        }
+
+        Column result;
+        result.size_ = size;
+        mergeNulls(lhs, rhs, result);
+        if (lhs.kind_ == Column::Kind::INT && rhs.kind_ == Column::Kind::INT) {
+            result.kind_ = Column::Kind::INT;
+            numericLoop(lhs, rhs, result.ints_, op);
+        } else {
+            result.kind_ = Column::Kind::FLOAT;
+            numericLoop(lhs, rhs, result.floats_, op);
+        }
+        return result;
+    }
+
+    template <class Op, class ValueOp>
+    static Column compare(const Column& lhs,
+                          const Column& rhs,
+                          Op op,
+                          ValueOp valueOp,
+                          bool nullsEqual) {
+        CHECK_EQ(lhs.size_, rhs.size_);
+        auto size = lhs.size_;
+        Column result;
+        result.kind_ = Column::Kind::BOOL;
+        result.size_ = size;
+        if (isNumeric(lhs) && isNumeric(rhs)) {
+            numericLoop(lhs, rhs, result.bools_, op);
+        } else if (lhs.kind_ == Column::Kind::BOOL && rhs.kind_ == Column::Kind::BOOL) {
+            loop(lhs.bools_, rhs.bools_, result.bools_, op);
+        } else if (lhs.kind_ == Column::Kind::STRING && rhs.kind_ == Column::Kind::STRING) {
+            result.bools_.resize(size);
+            for (size_t i = 0; i < size; i++) {
+                result.bools_[i] = op(lhs.str(i), rhs.str(i));
+            }
+        } else {
+            result.bools_.resize(size);
+            Value l, r;
+            for (size_t i = 0; i < size; i++) {
+                result.bools_[i] = valueOp(cell(lhs, i, l), cell(rhs, i, r));
+            }
+            return result;
+        }
+
+        if (lhs.hasNulls() || rhs.hasNulls()) {
+            for (size_t i = 0; i < size; i++) {
+                bool lNull = lhs.isNull(i);
+                bool rNull = rhs.isNull(i);
+                if (lNull || rNull) {
+                    result.bools_[i] = nullsEqual && lNull && rNull;
+                }
+            }
+        }
+        return result;
+    }
+
+    static Column negate(Column&& col) {
+        for (auto& b : col.bools_) {
+            b = !b;
+        }
+        return std::move(col);
+    }
+};
+
+
+namespace columnar {
+
+Column add(const Column& lhs, const Column& rhs) {
+    return ColumnOps::arithmetic(lhs, rhs,
+                                 [] (auto l, auto r) { return l + r; },
+                                 [] (const Value& l, const Value& r) { return l + r; },
+                                 false);
+}
+
+Column sub(const Column& lhs, const Column& rhs) {
+    return ColumnOps::arithmetic(lhs, rhs,
+                                 [] (auto l, auto r) { return l - r; },
+                                 [] (const Value& l, const Value& r) { return l - r; },
+                                 false);
+}
+
+Column mul(const Column& lhs, const Column& rhs) {
+    return ColumnOps::arithmetic(lhs, rhs,
+                                 [] (auto l, auto r) { return l * r; },
+                                 [] (const Value& l, const Value& r) { return l * r; },
+                                 false);
+}
+
+Column div(const Column& lhs, const Column& rhs) {
+    // The cells which are null are zero
+    return ColumnOps::arithmetic(lhs, rhs,
+                                 [] (auto l, auto r) { return r == 0 ? 0 : l / r; },
+                                 [] (const Value& l, const Value& r) { return l / r; },
+                                 true);
+}
+
+Column mod(const Column& lhs, const Column& rhs) {
+    return ColumnOps::arithmetic(lhs, rhs,
+                                 [] (auto l, auto r) { return r == 0 ? 0 : modOf(l, r); },
+                                 [] (const Value& l, const Value& r) { return l % r; },
+                                 true);
+}
+
+Column lt(const Column& lhs, const Column& rhs) {
+    return ColumnOps::compare(lhs, rhs,
+                              [] (const auto& l, const auto& r) { return l < r; },
+                              [] (const Value& l, const Value& r) { return l < r; },
+                              false);
+}
+
+Column le(const Column& lhs, const Column& rhs) {
+    return ColumnOps::negate(lt(rhs, lhs));
+}
+
+Column gt(const Column& lhs, const Column& rhs) {
+    return lt(rhs, lhs);
+}
+
+Column ge(const Column& lhs, const Column& rhs) {
+    return ColumnOps::negate(lt(lhs, rhs));
+}
+
+Column eq(const Column& lhs, const Column& rhs) {
+    return ColumnOps::compare(lhs, rhs,
+                              [] (const auto& l, const auto& r) { return equalTo(l, r); },
+                              [] (const Value& l, const Value& r) { return l == r; },
+                              true);
+}
+
+Column ne(const Column& lhs, const Column& rhs) {
+    return ColumnOps::negate(eq(lhs, rhs));
+}
+
+}  // namespace columnar
+}  // namespace nebula
@@ -0,0 +1,182 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef DATATYPES_COLUMNARDATASET_H_
+#define DATATYPES_COLUMNARDATASET_H_
+
+#include "base/Base.h"
+#include "datatypes/Value.h"
+#include "datatypes/DataSet.h"
+
+namespace nebula {
+
+/**
+ * One column of a ColumnarDataSet.
+ *
+ * When all the cells are of one type, i.e. INT, FLOAT, BOOL or STRING, or null,
+ * they are stored in a typed vector, with a bitmap of the null cells. The
+ * strings are concatenated in one buffer, indexed by the offsets. Otherwise,
+ * e.g. a column of vertices, or mixing types, the cells are stored as Values.
+ *
+ * Only NullType::__NULL__ is kept in the bitmap, a column with any other kind of
+ * null, e.g. BAD_TYPE, is stored as Values.
+ */
+class Column final {
+public:
+    enum class Kind : uint8_t {
+        INT,
+        FLOAT,
+        BOOL,
+        STRING,
+        VALUE,
+    };
+
+    Column() = default;
+
+    // Build a column of the given values, moved when stored as Values
+    static Column fromValues(std::vector<Value>&& values);
+
+    Kind kind() const {
+        return kind_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool hasNulls() const {
+        return !nulls_.empty();
+    }
+
+    bool isNull(size_t i) const {
+        return hasNulls() && (nulls_[i >> 6] & (uint64_t{1} << (i & 63))) != 0;
+    }
+
+    // The typed cells, the cells which are null are zero
+    const std::vector<int64_t>& ints() const {
+        DCHECK(kind_ == Kind::INT);
+        return ints_;
+    }
+
+    const std::vector<double>& floats() const {
+        DCHECK(kind_ == Kind::FLOAT);
+        return floats_;
+    }
+
+    const std::vector<uint8_t>& bools() const {
+        DCHECK(kind_ == Kind::BOOL);
+        return bools_;
+    }
+
+    folly::StringPiece str(size_t i) const {
+        DCHECK(kind_ == Kind::STRING);
+        return folly::StringPiece(chars_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+
+    const std::vector<Value>& values() const {
+        DCHECK(kind_ == Kind::VALUE);
+        return values_;
+    }
+
+    // Materialize the i-th cell
+    Value value(size_t i) const;
+
+    // The bytes taken by the column
+    size_t memoryUsage() const;
+
+    bool operator==(const Column& rhs) const;
+
+private:
+    friend struct ColumnarDataSet;
+    // The kernels of namespace columnar, which build typed columns
+    friend struct ColumnOps;
+
+    template <class Get>
+    static Column build(size_t size, Get&& get);
+
+    void setNull(size_t i);
+
+private:
+    Kind                    kind_{Kind::VALUE};
+    size_t                  size_{0};
+    // Bit i is set if the i-th cell is null, empty if no cell is null
+    std::vector<uint64_t>   nulls_;
+    std::vector<int64_t>    ints_;
+    std::vector<double>     floats_;
+    std::vector<uint8_t>    bools_;
+    // The i-th string is chars_[offsets_[i], offsets_[i + 1])
+    std::string             chars_;
+    std::vector<uint32_t>   offsets_;
+    std::vector<Value>      values_;
+};
+
+
+/**
+ * A DataSet stored column by column, so a filter or an aggregation over one
+ * column scans a typed vector instead of jumping across the rows.
+ *
+ * It converts from and to the row based DataSet, which is still the one
+ * serialized by thrift, i.e. DataSetOps.
+ */
+struct ColumnarDataSet {
+    std::vector<std::string> colNames;
+    std::vector<Column> columns;
+
+    ColumnarDataSet() = default;
+    // The cells which are not typed are copied
+    explicit ColumnarDataSet(const DataSet& ds);
+    // The cells which are not typed are moved
+    explicit ColumnarDataSet(DataSet&& ds);
+
+    size_t rowSize() const {
+        return columns.empty() ? 0 : columns.front().size();
+    }
+
+    size_t colSize() const {
+        return colNames.size();
+    }
+
+    DataSet toDataSet() const;
+
+    void clear() {
+        colNames.clear();
+        columns.clear();
+    }
+
+    bool operator==(const ColumnarDataSet& rhs) const {
+        return colNames == rhs.colNames && columns == rhs.columns;
+    }
+};
+
+
+/**
+ * Column at a time versions of the operators of Value, i.e. the i-th cell of
+ * the result is the operator applied to the i-th cells of the operands, and the
+ * operands must be of the same size.
+ *
+ * The numeric columns, and the comparison of string or bool columns, run in
+ * tight loops over the typed vectors. Otherwise the cells are evaluated one by
+ * one by the operators of Value.
+ */
+namespace columnar {
+
+// Arithmetic operations
+Column add(const Column& lhs, const Column& rhs);
+Column sub(const Column& lhs, const Column& rhs);
+Column mul(const Column& lhs, const Column& rhs);
+Column div(const Column& lhs, const Column& rhs);
+Column mod(const Column& lhs, const Column& rhs);
+// Comparison operations, the result is a BOOL column without nulls
+Column lt(const Column& lhs, const Column& rhs);
+Column le(const Column& lhs, const Column& rhs);
+Column gt(const Column& lhs, const Column& rhs);
+Column ge(const Column& lhs, const Column& rhs);
+Column eq(const Column& lhs, const Column& rhs);
+Column ne(const Column& lhs, const Column& rhs);
+
+}  // namespace columnar
+}  // namespace nebula
+#endif  // DATATYPES_COLUMNARDATASET_H_
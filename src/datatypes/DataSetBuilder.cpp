@@ -0,0 +1,32 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "datatypes/DataSetBuilder.h"
+
+namespace nebula {
+
+DataSetBuilder::DataSetBuilder(std::vector<std::string> colNames, size_t expectedRows) {
+    ds_.colNames = std::move(colNames);
+    ds_.rows.reserve(expectedRows);
+}
+
+
+void DataSetBuilder::newRow() {
+    if (!ds_.rows.empty()) {
+        DCHECK_EQ(ds_.colNames.size(), ds_.rows.back().columns.size());
+    }
+    ds_.rows.emplace_back();
+    ds_.rows.back().columns.reserve(ds_.colNames.size());
+}
+
+
+DataSet DataSetBuilder::finish() {
+    DataSet ds = std::move(ds_);
+    ds_.colNames = ds.colNames;
+    return ds;
+}
+
+}  // namespace nebula
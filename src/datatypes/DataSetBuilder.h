@@ -0,0 +1,67 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef DATATYPES_DATASETBUILDER_H_
+#define DATATYPES_DATASETBUILDER_H_
+
+#include "base/Base.h"
+#include "datatypes/Value.h"
+#include "datatypes/DataSet.h"
+
+namespace nebula {
+
+/**
+ * Builds a DataSet row by row with few allocations, e.g. a response of
+ * GetNeighbors. The rows and the cells of each row are reserved up front, and
+ * the strings are made by a Value::StrArena. The DataSet built is an ordinary
+ * one, which may outlive the builder.
+ *
+ *   DataSetBuilder builder({"name", "age"}, 100);
+ *   builder.newRow();
+ *   builder.addStr("Tim");
+ *   builder.add(18);
+ *   DataSet ds = builder.finish();
+ */
+class DataSetBuilder final {
+public:
+    // expectedRows is the number of rows reserved, it is only a hint
+    explicit DataSetBuilder(std::vector<std::string> colNames, size_t expectedRows = 0);
+
+    // Start a row, whose cells are appended by add() and addStr()
+    void newRow();
+
+    void add(Value&& v) {
+        DCHECK(!ds_.rows.empty());
+        ds_.rows.back().columns.emplace_back(std::move(v));
+    }
+
+    void addStr(folly::StringPiece v) {
+        add(strs_.makeStr(v));
+    }
+
+    void addStr(std::string&& v) {
+        add(strs_.makeStr(std::move(v)));
+    }
+
+    void addStr(const char* v) {
+        addStr(folly::StringPiece(v));
+    }
+
+    size_t rowSize() const {
+        return ds_.rows.size();
+    }
+
+    // Take the data set built, then the builder builds another one of the same
+    // columns
+    DataSet finish();
+
+private:
+    DataSet             ds_;
+    Value::StrArena     strs_;
+};
+
+}  // namespace nebula
+#endif  // DATATYPES_DATASETBUILDER_H_
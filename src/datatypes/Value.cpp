@@ -80,6 +80,113 @@ namespace nebula {
 
 constexpr auto EPSILON = 1e-8;
 
+static_assert(sizeof(Value) == 16, "Value is expected to take 16 bytes");
+
+struct Value::SharedStr {
+    template <typename... Args>
+    explicit SharedStr(Args&&... args) : str(std::forward<Args>(args)...) {}
+
+    SharedStr* acquire() {
+        refs.fetch_add(1, std::memory_order_relaxed);
+        return this;
+    }
+
+    void release();
+
+    bool shared() const {
+        return refs.load(std::memory_order_acquire) > 1;
+    }
+
+    std::atomic<uint32_t>   refs{1};
+    // The chunk of the StrArena holding the buffer, null if allocated by new
+    StrChunk*               chunk{nullptr};
+    std::string             str;
+};
+
+// The chunks not freed yet
+static std::atomic<size_t> gNumStrChunks{0};
+
+// The buffers of the strings made by a StrArena, followed by the chunk
+struct Value::StrChunk {
+    static StrChunk* create(size_t capacity) {
+        static_assert(sizeof(StrChunk) % alignof(SharedStr) == 0,
+                      "The buffers following a chunk must be aligned");
+        void* mem = ::operator new(sizeof(StrChunk) + capacity * sizeof(SharedStr));
+        gNumStrChunks.fetch_add(1, std::memory_order_relaxed);
+        return new (mem) StrChunk(capacity);
+    }
+
+    explicit StrChunk(size_t cap) : capacity(cap) {}
+
+    SharedStr* slot(size_t i) {
+        return reinterpret_cast<SharedStr*>(this + 1) + i;
+    }
+
+    void release() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            this->~StrChunk();
+            ::operator delete(this);
+            gNumStrChunks.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // One held by the arena until the chunk is full, and one by each string
+    std::atomic<uint32_t>   refs{1};
+    const size_t            capacity;
+    size_t                  used{0};
+};
+
+void Value::SharedStr::release() {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (chunk == nullptr) {
+            delete this;
+            return;
+        }
+        auto* c = chunk;
+        this->~SharedStr();
+        c->release();
+    }
+}
+
+Value::StrArena::StrArena(size_t chunkSize) : chunkSize_(std::max<size_t>(chunkSize, 1)) {}
+
+Value::StrArena::~StrArena() {
+    if (chunk_ != nullptr) {
+        chunk_->release();
+    }
+}
+
+template <class... Args>
+Value Value::StrArena::make(Args&&... args) {
+    if (chunk_ == nullptr || chunk_->used == chunk_->capacity) {
+        if (chunk_ != nullptr) {
+            chunk_->release();
+            chunk_ = nullptr;
+        }
+        chunk_ = StrChunk::create(chunkSize_);
+    }
+    auto* str = new (chunk_->slot(chunk_->used)) SharedStr(std::forward<Args>(args)...);
+    chunk_->used++;
+    str->chunk = chunk_;
+    chunk_->refs.fetch_add(1, std::memory_order_relaxed);
+    Value v;
+    v.setS(str);
+    return v;
+}
+
+Value Value::StrArena::makeStr(folly::StringPiece v) {
+    return make(v.data(), v.size());
+}
+
+Value Value::StrArena::makeStr(std::string&& v) {
+    return make(std::move(v));
+}
+
+// static
+size_t Value::StrArena::numChunks() {
+    return gNumStrChunks.load(std::memory_order_relaxed);
+}
+
 Value::Value(Value&& rhs) : type_(Value::Type::__EMPTY__) {
     if (this == &rhs) { return; }
     if (rhs.type_ == Type::__EMPTY__) { return; }
@@ -106,7 +213,7 @@ Value::Value(Value&& rhs) : type_(Value::Type::__EMPTY__) {
         }
         case Type::STRING:
         {
-            setS(std::move(rhs.value_.sVal));
+            setS(std::exchange(rhs.value_.sVal, nullptr));
             break;
         }
         case Type::DATE:
@@ -190,7 +297,7 @@ Value::Value(const Value& rhs) : type_(Value::Type::__EMPTY__) {
         }
         case Type::STRING:
         {
-            setS(rhs.value_.sVal);
+            setS(rhs.value_.sVal->acquire());
             break;
         }
         case Type::DATE:
@@ -633,7 +740,7 @@ const double& Value::getFloat() const {
 
 const std::string& Value::getStr() const {
     CHECK_EQ(type_, Type::STRING);
-    return value_.sVal;
+    return value_.sVal->str;
 }
 
 const Date& Value::getDate() const {
@@ -643,7 +750,7 @@ const Date& Value::getDate() const {
 
 const DateTime& Value::getDateTime() const {
     CHECK_EQ(type_, Type::DATETIME);
-    return value_.tVal;
+    return *(value_.tVal);
 }
 
 const Vertex& Value::getVertex() const {
@@ -739,7 +846,13 @@ double& Value::mutableFloat() {
 
 std::string& Value::mutableStr() {
     CHECK_EQ(type_, Type::STRING);
-    return value_.sVal;
+    if (value_.sVal->shared()) {
+        // Copy on write
+        auto* copy = new SharedStr(value_.sVal->str);
+        value_.sVal->release();
+        value_.sVal = copy;
+    }
+    return value_.sVal->str;
 }
 
 Date& Value::mutableDate() {
@@ -749,7 +862,7 @@ Date& Value::mutableDate() {
 
 DateTime& Value::mutableDateTime() {
     CHECK_EQ(type_, Type::DATETIME);
-    return value_.tVal;
+    return *(value_.tVal);
 }
 
 Vertex& Value::mutableVertex() {
@@ -818,7 +931,7 @@ double Value::moveFloat() {
 
 std::string Value::moveStr() {
     CHECK_EQ(type_, Type::STRING);
-    std::string v = std::move(value_.sVal);
+    std::string v = value_.sVal->shared() ? value_.sVal->str : std::move(value_.sVal->str);
     clear();
     return v;
 }
@@ -832,7 +945,7 @@ Date Value::moveDate() {
 
 DateTime Value::moveDateTime() {
     CHECK_EQ(type_, Type::DATETIME);
-    DateTime v = std::move(value_.tVal);
+    DateTime v = std::move(*(value_.tVal));
     clear();
     return v;
 }
@@ -914,7 +1027,10 @@ void Value::clear() {
         }
         case Type::STRING:
         {
-            destruct(value_.sVal);
+            // Null if moved
+            if (value_.sVal != nullptr) {
+                value_.sVal->release();
+            }
             break;
         }
         case Type::DATE:
@@ -994,7 +1110,7 @@ Value& Value::operator=(Value&& rhs) {
         }
         case Type::STRING:
         {
-            setS(std::move(rhs.value_.sVal));
+            setS(std::exchange(rhs.value_.sVal, nullptr));
             break;
         }
         case Type::DATE:
@@ -1080,7 +1196,7 @@ Value& Value::operator=(const Value& rhs) {
         }
         case Type::STRING:
         {
-            setS(rhs.value_.sVal);
+            setS(rhs.value_.sVal->acquire());
             break;
         }
         case Type::DATE:
@@ -1181,22 +1297,27 @@ void Value::setF(double&& v) {
 
 void Value::setS(const std::string& v) {
     type_ = Type::STRING;
-    new (std::addressof(value_.sVal)) std::string(v);
+    value_.sVal = new SharedStr(v);
 }
 
 void Value::setS(std::string&& v) {
     type_ = Type::STRING;
-    new (std::addressof(value_.sVal)) std::string(std::move(v));
+    value_.sVal = new SharedStr(std::move(v));
 }
 
 void Value::setS(const char* v) {
     type_ = Type::STRING;
-    new (std::addressof(value_.sVal)) std::string(v);
+    value_.sVal = new SharedStr(v);
 }
 
 void Value::setS(folly::StringPiece v) {
     type_ = Type::STRING;
-    new (std::addressof(value_.sVal)) std::string(v.data(), v.size());
+    value_.sVal = new SharedStr(v.data(), v.size());
+}
+
+void Value::setS(SharedStr* v) {
+    type_ = Type::STRING;
+    value_.sVal = v;
 }
 
 void Value::setD(const Date& v) {
@@ -1209,14 +1330,24 @@ void Value::setD(Date&& v) {
     new (std::addressof(value_.dVal)) Date(std::move(v));
 }
 
+void Value::setT(const std::unique_ptr<DateTime>& v) {
+    type_ = Type::DATETIME;
+    new (std::addressof(value_.tVal)) std::unique_ptr<DateTime>(new DateTime(*v));
+}
+
+void Value::setT(std::unique_ptr<DateTime>&& v) {
+    type_ = Type::DATETIME;
+    new (std::addressof(value_.tVal)) std::unique_ptr<DateTime>(std::move(v));
+}
+
 void Value::setT(const DateTime& v) {
     type_ = Type::DATETIME;
-    new (std::addressof(value_.tVal)) DateTime(v);
+    new (std::addressof(value_.tVal)) std::unique_ptr<DateTime>(new DateTime(v));
 }
 
 void Value::setT(DateTime&& v) {
     type_ = Type::DATETIME;
-    new (std::addressof(value_.tVal)) DateTime(std::move(v));
+    new (std::addressof(value_.tVal)) std::unique_ptr<DateTime>(new DateTime(std::move(v)));
 }
 
 void Value::setV(const std::unique_ptr<Vertex>& v) {
@@ -2041,4 +2172,169 @@ Value operator||(const Value& lhs, const Value& rhs) {
         return Value(NullType::BAD_TYPE);
     }
 }
+
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+// Compile the function for each of the targets, the one run is picked by the
+// CPU when the library is loaded
+#define NEBULA_BATCH_KERNEL __attribute__((target_clones("avx2", "sse4.2", "default")))
+#else
+#define NEBULA_BATCH_KERNEL
+#endif
+
+struct BatchOps {
+    // Whether the cells of both operands are all of the given type
+    static bool allOf(Value::Type type, const Value* lhs, const Value* rhs, size_t n) {
+        bool all = true;
+        for (size_t i = 0; i < n; i++) {
+            all &= (lhs[i].type_ == type) & (rhs[i].type_ == type);
+        }
+        return all;
+    }
+
+    // Release the buffers owned by the cells of out, so their payloads can be
+    // overwritten. It is done before the loop to keep the loop free of branches
+    static void release(Value* out, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (out[i].type_ >= Value::Type::STRING && out[i].type_ != Value::Type::DATE) {
+                out[i].clear();
+            }
+        }
+    }
+
+    template <class IntOp, class FloatOp, class ValueOp>
+    static void arithmetic(const Value* lhs,
+                           const Value* rhs,
+                           Value* out,
+                           size_t n,
+                           IntOp intOp,
+                           FloatOp floatOp,
+                           ValueOp valueOp) {
+        if (allOf(Value::Type::INT, lhs, rhs, n)) {
+            release(out, n);
+            for (size_t i = 0; i < n; i++) {
+                auto v = intOp(lhs[i].value_.iVal, rhs[i].value_.iVal);
+                out[i].type_ = Value::Type::INT;
+                out[i].value_.iVal = v;
+            }
+        } else if (allOf(Value::Type::FLOAT, lhs, rhs, n)) {
+            release(out, n);
+            for (size_t i = 0; i < n; i++) {
+                auto v = floatOp(lhs[i].value_.fVal, rhs[i].value_.fVal);
+                out[i].type_ = Value::Type::FLOAT;
+                out[i].value_.fVal = v;
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                out[i] = valueOp(lhs[i], rhs[i]);
+            }
+        }
+    }
+
+    template <class IntOp, class FloatOp, class ValueOp>
+    static void compare(const Value* lhs,
+                        const Value* rhs,
+                        uint8_t* mask,
+                        size_t n,
+                        IntOp intOp,
+                        FloatOp floatOp,
+                        ValueOp valueOp) {
+        if (allOf(Value::Type::INT, lhs, rhs, n)) {
+            for (size_t i = 0; i < n; i++) {
+                mask[i] = intOp(lhs[i].value_.iVal, rhs[i].value_.iVal);
+            }
+        } else if (allOf(Value::Type::FLOAT, lhs, rhs, n)) {
+            for (size_t i = 0; i < n; i++) {
+                mask[i] = floatOp(lhs[i].value_.fVal, rhs[i].value_.fVal);
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                mask[i] = valueOp(lhs[i], rhs[i]);
+            }
+        }
+    }
+};
+
+
+namespace batch {
+
+// The operations below agree with the operators of Value, e.g. a <= b is
+// !(b < a), which differs from b >= a when either is NaN
+
+NEBULA_BATCH_KERNEL
+void add(const Value* lhs, const Value* rhs, Value* out, size_t n) {
+    BatchOps::arithmetic(lhs, rhs, out, n,
+                         [] (int64_t l, int64_t r) { return l + r; },
+                         [] (double l, double r) { return l + r; },
+                         [] (const Value& l, const Value& r) { return l + r; });
+}
+
+NEBULA_BATCH_KERNEL
+void sub(const Value* lhs, const Value* rhs, Value* out, size_t n) {
+    BatchOps::arithmetic(lhs, rhs, out, n,
+                         [] (int64_t l, int64_t r) { return l - r; },
+                         [] (double l, double r) { return l - r; },
+                         [] (const Value& l, const Value& r) { return l - r; });
+}
+
+NEBULA_BATCH_KERNEL
+void mul(const Value* lhs, const Value* rhs, Value* out, size_t n) {
+    BatchOps::arithmetic(lhs, rhs, out, n,
+                         [] (int64_t l, int64_t r) { return l * r; },
+                         [] (double l, double r) { return l * r; },
+                         [] (const Value& l, const Value& r) { return l * r; });
+}
+
+NEBULA_BATCH_KERNEL
+void compareLt(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n) {
+    BatchOps::compare(lhs, rhs, mask, n,
+                      [] (int64_t l, int64_t r) { return l < r; },
+                      [] (double l, double r) { return l < r; },
+                      [] (const Value& l, const Value& r) { return l < r; });
+}
+
+NEBULA_BATCH_KERNEL
+void compareLe(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n) {
+    BatchOps::compare(lhs, rhs, mask, n,
+                      [] (int64_t l, int64_t r) { return !(r < l); },
+                      [] (double l, double r) { return !(r < l); },
+                      [] (const Value& l, const Value& r) { return l <= r; });
+}
+
+NEBULA_BATCH_KERNEL
+void compareGt(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n) {
+    BatchOps::compare(lhs, rhs, mask, n,
+                      [] (int64_t l, int64_t r) { return r < l; },
+                      [] (double l, double r) { return r < l; },
+                      [] (const Value& l, const Value& r) { return l > r; });
+}
+
+NEBULA_BATCH_KERNEL
+void compareGe(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n) {
+    BatchOps::compare(lhs, rhs, mask, n,
+                      [] (int64_t l, int64_t r) { return !(l < r); },
+                      [] (double l, double r) { return !(l < r); },
+                      [] (const Value& l, const Value& r) { return l >= r; });
+}
+
+NEBULA_BATCH_KERNEL
+void compareEq(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n) {
+    BatchOps::compare(lhs, rhs, mask, n,
+                      [] (int64_t l, int64_t r) { return l == r; },
+                      [] (double l, double r) { return std::abs(l - r) < EPSILON; },
+                      [] (const Value& l, const Value& r) { return l == r; });
+}
+
+NEBULA_BATCH_KERNEL
+void compareNe(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n) {
+    BatchOps::compare(lhs, rhs, mask, n,
+                      [] (int64_t l, int64_t r) { return l != r; },
+                      [] (double l, double r) { return !(std::abs(l - r) < EPSILON); },
+                      [] (const Value& l, const Value& r) { return l != r; });
+}
+
+}  // namespace batch
+
+#undef NEBULA_BATCH_KERNEL
+
 }  // namespace nebula
@@ -43,9 +43,27 @@ enum class NullType {
 };
 
 
+/**
+ * A Value takes 16 bytes, i.e. the type and an 8-byte payload. The scalars and
+ * the Date are stored inline. A string is stored in a reference counted buffer
+ * shared by all the copies of the Value, which is only copied when mutableStr()
+ * is called on a Value sharing it. So copying a string Value never copies the
+ * characters. A reference returned by mutableStr() must not be written after
+ * the Value is copied. The DateTime and the composite values are stored out of
+ * line, each owned by the Value.
+ */
 struct Value {
     friend class apache::thrift::Cpp2Ops<Value, void>;
+    // The batch operations, which read and write the payloads directly
+    friend struct BatchOps;
+
+private:
+    // The reference counted buffer of a string
+    struct SharedStr;
+    // A chunk of the buffers of a StrArena
+    struct StrChunk;
 
+public:
     enum class Type {
         __EMPTY__ = 0,
         NULLVALUE = 1,
@@ -231,7 +249,45 @@ struct Value {
 
     StatusOr<std::string> toString();
 
+    /**
+     * Makes string Values whose shared buffers are allocated in chunks, instead
+     * of one by one, e.g. when building a large DataSet. The characters longer
+     * than the inline buffer of std::string are still allocated apart. A chunk
+     * is freed when all its strings are released, so the Values made may
+     * outlive the arena. It is not thread safe.
+     *
+     * As a result, a single string kept alive pins its whole chunk, i.e.
+     * chunkSize * ~48 bytes, ~12KB by default. A few strings to be kept long
+     * after the rest are dropped, e.g. in a cache, should be copied out into
+     * Values of their own, by Value(v.getStr()).
+     */
+    class StrArena final {
+    public:
+        // chunkSize is the number of strings in one chunk
+        explicit StrArena(size_t chunkSize = 256);
+        ~StrArena();
+
+        StrArena(const StrArena&) = delete;
+        StrArena& operator=(const StrArena&) = delete;
+
+        Value makeStr(folly::StringPiece v);
+        Value makeStr(std::string&& v);
+
+        // The number of the chunks not freed yet, of all arenas
+        static size_t numChunks();
+
+    private:
+        template <class... Args>
+        Value make(Args&&... args);
+
+    private:
+        const size_t    chunkSize_;
+        // The chunk being filled
+        StrChunk*       chunk_{nullptr};
+    };
+
 private:
+
     Type type_;
 
     union Storage {
@@ -239,9 +295,9 @@ private:
         bool                        bVal;
         int64_t                     iVal;
         double                      fVal;
-        std::string                 sVal;
+        SharedStr*                  sVal;
         Date                        dVal;
-        DateTime                    tVal;
+        std::unique_ptr<DateTime>   tVal;
         std::unique_ptr<Vertex>     vVal;
         std::unique_ptr<Edge>       eVal;
         std::unique_ptr<Path>       pVal;
@@ -276,10 +332,14 @@ private:
     void setS(std::string&& v);
     void setS(const char* v);
     void setS(folly::StringPiece v);
+    // Take over one reference of the shared string
+    void setS(SharedStr* v);
     // Date value
     void setD(const Date& v);
     void setD(Date&& v);
     // DateTime value
+    void setT(const std::unique_ptr<DateTime>& v);
+    void setT(std::unique_ptr<DateTime>&& v);
     void setT(const DateTime& v);
     void setT(DateTime&& v);
     // Vertex value
@@ -343,6 +403,25 @@ bool operator>=(const Value& lhs, const Value& rhs);
 // Logical operations
 Value operator&&(const Value& lhs, const Value& rhs);
 Value operator||(const Value& lhs, const Value& rhs);
+
+// Batch operations, i.e. out[i] or mask[i] is the operation applied to lhs[i]
+// and rhs[i], for i in [0, n). When the operands are all INT, or all FLOAT,
+// they are evaluated in one loop without branches, which is compiled for AVX2,
+// SSE4.2 and the baseline, picked by the CPU. Otherwise they are evaluated cell
+// by cell by the operators above. out may be the same array as lhs or rhs.
+namespace batch {
+
+void add(const Value* lhs, const Value* rhs, Value* out, size_t n);
+void sub(const Value* lhs, const Value* rhs, Value* out, size_t n);
+void mul(const Value* lhs, const Value* rhs, Value* out, size_t n);
+void compareLt(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n);
+void compareLe(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n);
+void compareGt(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n);
+void compareGe(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n);
+void compareEq(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n);
+void compareNe(const Value* lhs, const Value* rhs, uint8_t* mask, size_t n);
+
+}  // namespace batch
 }  // namespace nebula
 
 
@@ -0,0 +1,149 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "datatypes/ColumnarDataSet.h"
+
+namespace nebula {
+
+DataSet makeDataSet() {
+    DataSet ds;
+    ds.colNames = {"int", "float", "bool", "str", "mixed", "null"};
+    for (int64_t i = 0; i < 100; i++) {
+        Row row;
+        if (i % 7 == 0) {
+            row.columns.emplace_back(NullType::__NULL__);
+        } else {
+            row.columns.emplace_back(i - 50);
+        }
+        row.columns.emplace_back(i % 5 == 0 ? Value(0.0) : Value(i / 4.0));
+        row.columns.emplace_back(i % 3 == 0);
+        if (i % 11 == 0) {
+            row.columns.emplace_back(NullType::__NULL__);
+        } else {
+            row.columns.emplace_back(folly::stringPrintf("str_%ld", i % 13));
+        }
+        if (i % 2 == 0) {
+            row.columns.emplace_back(i);
+        } else {
+            row.columns.emplace_back(folly::stringPrintf("%ld", i));
+        }
+        row.columns.emplace_back(NullType::__NULL__);
+        ds.rows.emplace_back(std::move(row));
+    }
+    return ds;
+}
+
+
+TEST(ColumnarDataSet, Convert) {
+    auto ds = makeDataSet();
+    ColumnarDataSet cds(ds);
+    ASSERT_EQ(6, cds.colSize());
+    ASSERT_EQ(100, cds.rowSize());
+    EXPECT_EQ(Column::Kind::INT, cds.columns[0].kind());
+    EXPECT_EQ(Column::Kind::FLOAT, cds.columns[1].kind());
+    EXPECT_EQ(Column::Kind::BOOL, cds.columns[2].kind());
+    EXPECT_EQ(Column::Kind::STRING, cds.columns[3].kind());
+    EXPECT_EQ(Column::Kind::VALUE, cds.columns[4].kind());
+    EXPECT_EQ(Column::Kind::INT, cds.columns[5].kind());
+
+    EXPECT_TRUE(cds.columns[0].isNull(0));
+    EXPECT_FALSE(cds.columns[0].isNull(1));
+    EXPECT_EQ(-49, cds.columns[0].ints()[1]);
+    EXPECT_EQ("str_1", cds.columns[3].str(1));
+    EXPECT_FALSE(cds.columns[1].hasNulls());
+
+    EXPECT_EQ(ds, cds.toDataSet());
+
+    // Move
+    auto copy = ds;
+    ColumnarDataSet moved(std::move(copy));
+    EXPECT_EQ(cds, moved);
+    EXPECT_EQ(ds, moved.toDataSet());
+}
+
+
+TEST(ColumnarDataSet, OtherNulls) {
+    std::vector<Value> values = {1, NullType::DIV_BY_ZERO, 2};
+    auto col = Column::fromValues(std::move(values));
+    // Only __NULL__ is kept in the bitmap
+    EXPECT_EQ(Column::Kind::VALUE, col.kind());
+    EXPECT_EQ(Value(NullType::DIV_BY_ZERO), col.value(1));
+}
+
+
+TEST(ColumnarDataSet, Kernels) {
+    ColumnarDataSet cds(makeDataSet());
+    using Kernel = Column (*)(const Column&, const Column&);
+    std::vector<std::pair<Kernel, std::function<Value(const Value&, const Value&)>>> ops = {
+        {columnar::add, [] (const Value& l, const Value& r) { return l + r; }},
+        {columnar::sub, [] (const Value& l, const Value& r) { return l - r; }},
+        {columnar::mul, [] (const Value& l, const Value& r) { return l * r; }},
+        {columnar::div, [] (const Value& l, const Value& r) { return l / r; }},
+        {columnar::mod, [] (const Value& l, const Value& r) { return l % r; }},
+        {columnar::lt, [] (const Value& l, const Value& r) { return l < r; }},
+        {columnar::le, [] (const Value& l, const Value& r) { return l <= r; }},
+        {columnar::gt, [] (const Value& l, const Value& r) { return l > r; }},
+        {columnar::ge, [] (const Value& l, const Value& r) { return l >= r; }},
+        {columnar::eq, [] (const Value& l, const Value& r) { return l == r; }},
+        {columnar::ne, [] (const Value& l, const Value& r) { return l != r; }},
+    };
+    // Every kernel over every pair of columns is the same as the operator of Value
+    for (size_t o = 0; o < ops.size(); o++) {
+        for (auto& lhs : cds.columns) {
+            for (auto& rhs : cds.columns) {
+                auto result = ops[o].first(lhs, rhs);
+                ASSERT_EQ(lhs.size(), result.size());
+                for (size_t i = 0; i < result.size(); i++) {
+                    auto expected = ops[o].second(lhs.value(i), rhs.value(i));
+                    auto actual = result.value(i);
+                    ASSERT_EQ(expected.type(), actual.type()) << "op " << o << ", row " << i;
+                    if (expected.isNull()) {
+                        ASSERT_EQ(expected.getNull(), actual.getNull());
+                    } else {
+                        ASSERT_EQ(expected, actual) << "op " << o << ", row " << i;
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+TEST(ColumnarDataSet, TypedResult) {
+    ColumnarDataSet cds(makeDataSet());
+    auto& ints = cds.columns[0];
+    auto& floats = cds.columns[1];
+
+    auto sum = columnar::add(ints, ints);
+    EXPECT_EQ(Column::Kind::INT, sum.kind());
+    EXPECT_TRUE(sum.isNull(0));
+    EXPECT_EQ(-98, sum.ints()[1]);
+
+    EXPECT_EQ(Column::Kind::FLOAT, columnar::mul(ints, floats).kind());
+    EXPECT_EQ(Column::Kind::BOOL, columnar::lt(ints, floats).kind());
+    EXPECT_EQ(Column::Kind::BOOL, columnar::eq(cds.columns[3], cds.columns[3]).kind());
+
+    // Division by zero falls back to Values
+    auto quotient = columnar::div(ints, floats);
+    EXPECT_EQ(Column::Kind::VALUE, quotient.kind());
+    EXPECT_EQ(Value(NullType::DIV_BY_ZERO), quotient.value(5));
+    auto twos = Column::fromValues(std::vector<Value>(ints.size(), Value(2)));
+    EXPECT_EQ(Column::Kind::FLOAT, columnar::div(floats, twos).kind());
+    EXPECT_EQ(Column::Kind::INT, columnar::mod(ints, twos).kind());
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,103 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "datatypes/DataSetBuilder.h"
+
+DEFINE_int64(rows, 100000, "The number of rows of the data set");
+
+using nebula::Value;
+using nebula::Row;
+using nebula::DataSet;
+using nebula::DataSetBuilder;
+
+// Count the allocations made by operator new
+static std::atomic<size_t> gAllocs{0};
+
+void* operator new(size_t size) {
+    gAllocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// The columns of a response of GetNeighbors, i.e. vid, name, age, score and tag
+const std::vector<std::string>& colNames() {
+    static const std::vector<std::string> names = {"vid", "name", "age", "score", "tag"};
+    return names;
+}
+
+DataSet buildByRows() {
+    DataSet ds;
+    ds.colNames = colNames();
+    for (int64_t i = 0; i < FLAGS_rows; i++) {
+        Row row;
+        row.columns.emplace_back(i);
+        row.columns.emplace_back(folly::stringPrintf("name_%ld", i % 10000));
+        row.columns.emplace_back(i % 100);
+        row.columns.emplace_back(i / 3.0);
+        row.columns.emplace_back("player");
+        ds.rows.emplace_back(std::move(row));
+    }
+    return ds;
+}
+
+DataSet buildByBuilder() {
+    DataSetBuilder builder(colNames(), FLAGS_rows);
+    char buf[32];
+    for (int64_t i = 0; i < FLAGS_rows; i++) {
+        builder.newRow();
+        builder.add(i);
+        auto len = snprintf(buf, sizeof(buf), "name_%ld", i % 10000);
+        builder.addStr(folly::StringPiece(buf, len));
+        builder.add(i % 100);
+        builder.add(i / 3.0);
+        builder.addStr("player");
+    }
+    return builder.finish();
+}
+
+// Log the allocations taken to build and destroy a data set
+void logAllocs(const char* name, DataSet (*build)()) {
+    auto before = gAllocs.load();
+    {
+        auto ds = build();
+        folly::doNotOptimizeAway(ds);
+    }
+    LOG(INFO) << name << ": " << gAllocs.load() - before << " allocations for "
+              << FLAGS_rows << " rows";
+}
+
+BENCHMARK(byRows, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(buildByRows());
+    }
+}
+
+BENCHMARK_RELATIVE(byBuilder, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(buildByBuilder());
+    }
+}
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    logAllocs("byRows", buildByRows);
+    logAllocs("byBuilder", buildByBuilder);
+    folly::runBenchmarks();
+    return 0;
+}
@@ -0,0 +1,59 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "datatypes/DataSetBuilder.h"
+
+namespace nebula {
+
+TEST(DataSetBuilder, Build) {
+    DataSet expected;
+    expected.colNames = {"vid", "name", "score"};
+    for (int64_t i = 0; i < 1000; i++) {
+        Row row;
+        row.columns.emplace_back(i);
+        row.columns.emplace_back(folly::stringPrintf("name_%ld", i));
+        row.columns.emplace_back(i / 2.0);
+        expected.rows.emplace_back(std::move(row));
+    }
+
+    DataSet ds;
+    {
+        DataSetBuilder builder({"vid", "name", "score"}, 10);
+        for (int64_t i = 0; i < 1000; i++) {
+            builder.newRow();
+            builder.add(i);
+            builder.addStr(folly::stringPrintf("name_%ld", i));
+            builder.add(i / 2.0);
+        }
+        EXPECT_EQ(1000, builder.rowSize());
+        ds = builder.finish();
+        EXPECT_EQ(0, builder.rowSize());
+
+        builder.newRow();
+        builder.add(1);
+        builder.addStr("Tim");
+        builder.add(NullType::__NULL__);
+        auto another = builder.finish();
+        EXPECT_EQ(expected.colNames, another.colNames);
+        ASSERT_EQ(1, another.rows.size());
+        EXPECT_EQ("Tim", another.rows[0].columns[1].getStr());
+    }
+    // The data set outlives the builder
+    EXPECT_EQ(expected, ds);
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
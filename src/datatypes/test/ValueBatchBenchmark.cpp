@@ -0,0 +1,112 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <random>
+#include "datatypes/Value.h"
+
+DEFINE_int64(cells, 1000000, "The number of cells of each operand");
+
+using nebula::Value;
+
+// The operands, of which every cell is an INT, a FLOAT, or either
+struct Operands {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+};
+
+const Operands& operands(Value::Type type) {
+    static const auto make = [] (Value::Type t) {
+        Operands ops;
+        std::mt19937 rng(0);
+        auto cell = [&rng, t] () -> Value {
+            bool isInt = t == Value::Type::INT || (t != Value::Type::FLOAT && rng() % 2 == 0);
+            if (isInt) {
+                return static_cast<int64_t>(rng() % 1000);
+            }
+            return static_cast<double>(rng()) / rng.max();
+        };
+        for (int64_t i = 0; i < FLAGS_cells; i++) {
+            ops.lhs.emplace_back(cell());
+            ops.rhs.emplace_back(cell());
+        }
+        return ops;
+    };
+    static const Operands ints = make(Value::Type::INT);
+    static const Operands floats = make(Value::Type::FLOAT);
+    static const Operands mixed = make(Value::Type::__EMPTY__);
+    switch (type) {
+        case Value::Type::INT:
+            return ints;
+        case Value::Type::FLOAT:
+            return floats;
+        default:
+            return mixed;
+    }
+}
+
+void scalarAdd(size_t iters, Value::Type type) {
+    auto& ops = operands(type);
+    std::vector<Value> out(ops.lhs.size());
+    for (size_t i = 0; i < iters; i++) {
+        for (size_t j = 0; j < out.size(); j++) {
+            out[j] = ops.lhs[j] + ops.rhs[j];
+        }
+        folly::doNotOptimizeAway(out);
+    }
+}
+
+void batchAdd(size_t iters, Value::Type type) {
+    auto& ops = operands(type);
+    std::vector<Value> out(ops.lhs.size());
+    for (size_t i = 0; i < iters; i++) {
+        nebula::batch::add(ops.lhs.data(), ops.rhs.data(), out.data(), out.size());
+        folly::doNotOptimizeAway(out);
+    }
+}
+
+void scalarLt(size_t iters, Value::Type type) {
+    auto& ops = operands(type);
+    std::vector<uint8_t> mask(ops.lhs.size());
+    for (size_t i = 0; i < iters; i++) {
+        for (size_t j = 0; j < mask.size(); j++) {
+            mask[j] = ops.lhs[j] < ops.rhs[j];
+        }
+        folly::doNotOptimizeAway(mask);
+    }
+}
+
+void batchLt(size_t iters, Value::Type type) {
+    auto& ops = operands(type);
+    std::vector<uint8_t> mask(ops.lhs.size());
+    for (size_t i = 0; i < iters; i++) {
+        nebula::batch::compareLt(ops.lhs.data(), ops.rhs.data(), mask.data(), mask.size());
+        folly::doNotOptimizeAway(mask);
+    }
+}
+
+BENCHMARK_PARAM(scalarAdd, Value::Type::INT)
+BENCHMARK_RELATIVE_PARAM(batchAdd, Value::Type::INT)
+BENCHMARK_PARAM(scalarAdd, Value::Type::FLOAT)
+BENCHMARK_RELATIVE_PARAM(batchAdd, Value::Type::FLOAT)
+BENCHMARK_PARAM(scalarAdd, Value::Type::__EMPTY__)
+BENCHMARK_RELATIVE_PARAM(batchAdd, Value::Type::__EMPTY__)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_PARAM(scalarLt, Value::Type::INT)
+BENCHMARK_RELATIVE_PARAM(batchLt, Value::Type::INT)
+BENCHMARK_PARAM(scalarLt, Value::Type::FLOAT)
+BENCHMARK_RELATIVE_PARAM(batchLt, Value::Type::FLOAT)
+BENCHMARK_PARAM(scalarLt, Value::Type::__EMPTY__)
+BENCHMARK_RELATIVE_PARAM(batchLt, Value::Type::__EMPTY__)
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
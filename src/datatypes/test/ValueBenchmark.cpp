@@ -0,0 +1,162 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <random>
+#include "datatypes/Value.h"
+#include "datatypes/DataSet.h"
+
+DEFINE_int64(rows, 100000, "The number of rows of the data set");
+DEFINE_int32(long_str_size, 64, "The size of the long string column");
+
+using nebula::Value;
+using nebula::Row;
+using nebula::DataSet;
+using nebula::DateTime;
+
+// Bytes and blocks allocated through the global operator new, to measure the
+// footprint of the data set
+static std::atomic<size_t> gAllocatedBytes{0};
+static std::atomic<size_t> gAllocations{0};
+
+void* operator new(size_t size) {
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    auto* p = ::malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    ::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    ::free(p);
+}
+
+// A data set as returned by a GO query, i.e. vid, name, age, score, a long
+// description, a flag and the time created, so the strings are mostly short
+const DataSet& dataSet() {
+    static const DataSet ds = [] () {
+        DataSet d;
+        d.colNames = {"vid", "name", "age", "score", "desc", "flag", "created"};
+        std::mt19937 rng(0);
+        for (int64_t i = 0; i < FLAGS_rows; i++) {
+            Row row;
+            row.columns.emplace_back(static_cast<int64_t>(rng()));
+            row.columns.emplace_back(folly::stringPrintf("name_%u", rng() % 10000));
+            row.columns.emplace_back(static_cast<int64_t>(rng() % 100));
+            row.columns.emplace_back(static_cast<double>(rng()) / rng.max());
+            row.columns.emplace_back(std::string(FLAGS_long_str_size, 'a' + rng() % 26));
+            row.columns.emplace_back(rng() % 2 == 0);
+            DateTime created;
+            created.clear();
+            created.year = 2020;
+            created.microsec = rng() % 1000000;
+            row.columns.emplace_back(std::move(created));
+            d.rows.emplace_back(std::move(row));
+        }
+        return d;
+    }();
+    return ds;
+}
+
+// A cell of the layout before the strings were shared, i.e. a std::string held
+// inline, which is the largest member of the union then, so the short strings
+// take no heap, nor do the DateTimes
+struct BaselineCell {
+    explicit BaselineCell(const Value& v) : type(v.type()) {
+        if (type == Value::Type::STRING) {
+            str = v.getStr();
+        }
+    }
+
+    Value::Type         type;
+    std::string         str;
+};
+
+// The bytes allocated for the data set, i.e. the cells, the shared strings with
+// their buffers and the DateTimes, against those of the baseline layout
+void logFootprint() {
+    auto bytes = gAllocatedBytes.load();
+    auto allocations = gAllocations.load();
+    const auto& ds = dataSet();
+    bytes = gAllocatedBytes.load() - bytes;
+    allocations = gAllocations.load() - allocations;
+
+    auto baselineBytes = gAllocatedBytes.load();
+    auto baselineAllocations = gAllocations.load();
+    // Grown as the data set is
+    std::vector<std::vector<BaselineCell>> baseline;
+    for (auto& row : ds.rows) {
+        baseline.emplace_back();
+        for (auto& col : row.columns) {
+            baseline.back().emplace_back(col);
+        }
+    }
+    baselineBytes = gAllocatedBytes.load() - baselineBytes;
+    baselineAllocations = gAllocations.load() - baselineAllocations;
+
+    LOG(INFO) << "sizeof(Value) " << sizeof(Value)
+              << ", " << bytes << " bytes in " << allocations << " allocations";
+    LOG(INFO) << "Baseline sizeof(Value) " << sizeof(BaselineCell)
+              << ", " << baselineBytes << " bytes in " << baselineAllocations
+              << " allocations";
+}
+
+BENCHMARK(copyDataSet, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        DataSet copy = dataSet();
+        folly::doNotOptimizeAway(copy);
+    }
+}
+
+BENCHMARK(copyRows, iters) {
+    // Copy the rows picked by a filter, as a project over the data set does
+    for (size_t i = 0; i < iters; i++) {
+        std::vector<Row> rows;
+        for (auto& row : dataSet().rows) {
+            if (row.columns[5].getBool()) {
+                rows.emplace_back(row);
+            }
+        }
+        folly::doNotOptimizeAway(rows);
+    }
+}
+
+BENCHMARK(compareDataSet, iters) {
+    DataSet copy;
+    BENCHMARK_SUSPEND {
+        copy = dataSet();
+    }
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(copy == dataSet());
+    }
+}
+
+BENCHMARK(sortByName, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        std::vector<Row> rows;
+        BENCHMARK_SUSPEND {
+            rows = dataSet().rows;
+        }
+        std::sort(rows.begin(), rows.end(), [] (const Row& a, const Row& b) {
+            return a.columns[1] < b.columns[1];
+        });
+        folly::doNotOptimizeAway(rows);
+    }
+}
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    logFootprint();
+    folly::runBenchmarks();
+    return 0;
+}
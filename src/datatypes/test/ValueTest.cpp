@@ -378,6 +378,177 @@ TEST(Value, Logical) {
         EXPECT_EQ(true, v.getBool());
     }
 }
+TEST(Value, Layout) {
+    EXPECT_EQ(16, sizeof(Value));
+}
+
+TEST(Value, SharedString) {
+    Value v1("Hello World");
+    Value v2 = v1;
+    // The copy shares the buffer
+    EXPECT_EQ(&v1.getStr(), &v2.getStr());
+
+    // Copy on write
+    v2.mutableStr().append("!");
+    EXPECT_NE(&v1.getStr(), &v2.getStr());
+    EXPECT_EQ("Hello World", v1.getStr());
+    EXPECT_EQ("Hello World!", v2.getStr());
+
+    // Not shared any more, so written in place
+    auto* buf = &v1.getStr();
+    v1.mutableStr().append("?");
+    EXPECT_EQ(buf, &v1.getStr());
+    EXPECT_EQ("Hello World?", v1.getStr());
+
+    {
+        Value v3 = v1;
+        // Moving out a shared string copies it
+        EXPECT_EQ("Hello World?", v3.moveStr());
+        EXPECT_EQ(Value::Type::__EMPTY__, v3.type());
+        EXPECT_EQ("Hello World?", v1.getStr());
+    }
+
+    Value v4 = std::move(v1);
+    EXPECT_EQ(Value::Type::__EMPTY__, v1.type());
+    EXPECT_EQ(buf, &v4.getStr());
+    EXPECT_EQ("Hello World?", v4.moveStr());
+
+    v2 = Value(1);
+    EXPECT_EQ(1, v2.getInt());
+}
+
+TEST(Value, StrArena) {
+    std::vector<Value> values;
+    {
+        Value::StrArena arena(2);
+        for (int i = 0; i < 5; i++) {
+            values.emplace_back(arena.makeStr(folly::stringPrintf("str_%d", i)));
+        }
+        values.emplace_back(arena.makeStr(std::string(100, 'a')));
+    }
+    // The strings outlive the arena
+    EXPECT_EQ("str_0", values[0].getStr());
+    EXPECT_EQ("str_4", values[4].getStr());
+    EXPECT_EQ(std::string(100, 'a'), values[5].getStr());
+
+    // Copy on write
+    Value copy = values[1];
+    copy.mutableStr().append("!");
+    EXPECT_EQ("str_1", values[1].getStr());
+    EXPECT_EQ("str_1!", copy.getStr());
+
+    EXPECT_EQ("str_2", values[2].moveStr());
+    values.clear();
+    EXPECT_EQ("str_1!", copy.getStr());
+}
+
+TEST(Value, StrArenaRetention) {
+    auto before = Value::StrArena::numChunks();
+    std::vector<Value> values;
+    Value kept;
+    {
+        Value::StrArena arena(4);
+        for (int i = 0; i < 10; i++) {
+            values.emplace_back(arena.makeStr(folly::stringPrintf("str_%d", i)));
+        }
+        EXPECT_EQ(before + 3, Value::StrArena::numChunks());
+        // A copy out pins no chunk
+        kept = Value(values[0].getStr());
+    }
+    // Each chunk is held by any string in it
+    values.erase(values.begin(), values.begin() + 8);
+    EXPECT_EQ(before + 1, Value::StrArena::numChunks());
+    values.resize(1);
+    EXPECT_EQ(before + 1, Value::StrArena::numChunks());
+    values.clear();
+    EXPECT_EQ(before, Value::StrArena::numChunks());
+    EXPECT_EQ("str_0", kept.getStr());
+}
+
+TEST(Value, DateTime) {
+    DateTime dt;
+    dt.clear();
+    dt.year = 2020;
+    dt.month = 2;
+    dt.day = 29;
+    dt.hour = 12;
+    Value v1(dt);
+    Value v2 = v1;
+    v2.mutableDateTime().hour = 13;
+    EXPECT_EQ(12, v1.getDateTime().hour);
+    EXPECT_EQ(13, v2.getDateTime().hour);
+
+    Value v3 = std::move(v2);
+    EXPECT_EQ(Value::Type::__EMPTY__, v2.type());
+    EXPECT_EQ(13, v3.moveDateTime().hour);
+    EXPECT_EQ(Value::Type::__EMPTY__, v3.type());
+}
+
+TEST(Value, Batch) {
+    using Arithmetic = void (*)(const Value*, const Value*, Value*, size_t);
+    using Compare = void (*)(const Value*, const Value*, uint8_t*, size_t);
+    std::vector<std::pair<Arithmetic, std::function<Value(const Value&, const Value&)>>>
+    arithmetics = {
+        {batch::add, [] (const Value& l, const Value& r) { return l + r; }},
+        {batch::sub, [] (const Value& l, const Value& r) { return l - r; }},
+        {batch::mul, [] (const Value& l, const Value& r) { return l * r; }},
+    };
+    std::vector<std::pair<Compare, std::function<bool(const Value&, const Value&)>>>
+    compares = {
+        {batch::compareLt, [] (const Value& l, const Value& r) { return l < r; }},
+        {batch::compareLe, [] (const Value& l, const Value& r) { return l <= r; }},
+        {batch::compareGt, [] (const Value& l, const Value& r) { return l > r; }},
+        {batch::compareGe, [] (const Value& l, const Value& r) { return l >= r; }},
+        {batch::compareEq, [] (const Value& l, const Value& r) { return l == r; }},
+        {batch::compareNe, [] (const Value& l, const Value& r) { return l != r; }},
+    };
+
+    std::vector<Value> ints, floats, mixed;
+    for (int64_t i = 0; i < 100; i++) {
+        ints.emplace_back(i % 10 - 5);
+        floats.emplace_back((i % 10) / 4.0);
+        if (i % 3 == 0) {
+            mixed.emplace_back(i);
+        } else if (i % 3 == 1) {
+            mixed.emplace_back(i / 3.0);
+        } else {
+            mixed.emplace_back(NullType::__NULL__);
+        }
+    }
+    std::vector<std::vector<Value>> operands = {ints, floats, mixed};
+    for (auto& lhs : operands) {
+        for (auto& rhs : operands) {
+            for (auto& op : arithmetics) {
+                // Overwrite a string, which is released
+                std::vector<Value> out(lhs.size(), Value("Hello World"));
+                op.first(lhs.data(), rhs.data(), out.data(), lhs.size());
+                for (size_t i = 0; i < lhs.size(); i++) {
+                    auto expected = op.second(lhs[i], rhs[i]);
+                    ASSERT_EQ(expected.type(), out[i].type());
+                    if (expected.isNull()) {
+                        ASSERT_EQ(expected.getNull(), out[i].getNull());
+                    } else {
+                        ASSERT_EQ(expected, out[i]);
+                    }
+                }
+            }
+            for (auto& op : compares) {
+                std::vector<uint8_t> mask(lhs.size());
+                op.first(lhs.data(), rhs.data(), mask.data(), lhs.size());
+                for (size_t i = 0; i < lhs.size(); i++) {
+                    ASSERT_EQ(op.second(lhs[i], rhs[i]), mask[i] != 0);
+                }
+            }
+        }
+    }
+
+    // In place
+    auto sum = ints;
+    batch::add(sum.data(), ints.data(), sum.data(), sum.size());
+    EXPECT_EQ(Value(-10), sum[0]);
+    EXPECT_EQ(Value(8), sum[9]);
+}
+
 }  // namespace nebula
 
 
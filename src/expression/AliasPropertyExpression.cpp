@@ -5,50 +5,57 @@
  */
 
 #include "expression/AliasPropertyExpression.h"
+#include "datatypes/DataSet.h"
 
 namespace nebula {
-Value AliasPropertyExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+Value AliasPropertyExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getEdgeProp(*alias_, *prop_);
 }
 
-Value InputPropertyExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+Value InputPropertyExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getInputProp(*prop_);
 }
 
-Value VariablePropertyExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+void InputPropertyExpression::evalBatch(const DataSet& ds,
+                                        const Selection& sel,
+                                        std::vector<Value>& out) const {
+    auto it = std::find(ds.colNames.begin(), ds.colNames.end(), *prop_);
+    if (it == ds.colNames.end()) {
+        out.assign(sel.size(), Value::null());
+        return;
+    }
+    auto col = it - ds.colNames.begin();
+    out.resize(sel.size());
+    for (size_t i = 0; i < sel.size(); i++) {
+        out[i] = ds.rows[sel[i]].columns[col];
+    }
 }
 
-Value SourcePropertyExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+Value VariablePropertyExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getVarProp(*alias_, *prop_);
 }
 
-Value DestPropertyExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+Value SourcePropertyExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getSrcProp(*prop_);
 }
 
-Value EdgeSrcIdExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+Value DestPropertyExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getDstProp(*prop_);
 }
 
-Value EdgeTypeExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+Value EdgeSrcIdExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getEdgeProp(*alias_, *prop_);
 }
 
-Value EdgeRankExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+Value EdgeTypeExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getEdgeProp(*alias_, *prop_);
 }
 
-Value EdgeDstIdExpression::eval() const {
-    // TODO
-    return Value(NullType::NaN);
+Value EdgeRankExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getEdgeProp(*alias_, *prop_);
+}
+
+Value EdgeDstIdExpression::eval(const ExpressionContext& ctx) const {
+    return ctx.getEdgeProp(*alias_, *prop_);
 }
 }  // namespace nebula
@@ -29,21 +29,23 @@ public:
         prop_.reset(prop);
     }
 
-    Value eval() const override;
+    Value eval(const ExpressionContext& ctx) const override;
 
-    std::string encode() const override {
+    std::string toString() const override {
         // TODO
         return "";
     }
 
-    std::string decode() const override {
-        // TODO
-        return "";
+    const std::string& ref() const {
+        return *ref_;
     }
 
-    std::string toString() const override {
-        // TODO
-        return "";
+    const std::string& alias() const {
+        return *alias_;
+    }
+
+    const std::string& prop() const {
+        return *prop_;
     }
 
 protected:
@@ -61,17 +63,11 @@ public:
                                   new std::string(""),
                                   prop) {}
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    void evalBatch(const DataSet& ds,
+                   const Selection& sel,
+                   std::vector<Value>& out) const override;
 
     std::string toString() const override {
         // TODO
@@ -89,17 +85,7 @@ public:
                                   var,
                                   prop) {}
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
-
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
     std::string toString() const override {
         // TODO
@@ -117,17 +103,7 @@ public:
                                   tag,
                                   prop) {}
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
-
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
     std::string toString() const override {
         // TODO
@@ -145,17 +121,7 @@ public:
                                   tag,
                                   prop) {}
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
-
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
     std::string toString() const override {
         // TODO
@@ -172,17 +138,7 @@ public:
                                   alias,
                                   new std::string(_SRC)) {}
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
-
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
     std::string toString() const override {
         // TODO
@@ -199,17 +155,7 @@ public:
                                   alias,
                                   new std::string(_TYPE)) {}
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
-
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
     std::string toString() const override {
         // TODO
@@ -226,17 +172,7 @@ public:
                                   alias,
                                   new std::string(_RANK)) {}
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
-
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
     std::string toString() const override {
         // TODO
@@ -253,17 +189,7 @@ public:
                                   alias,
                                   new std::string(_DST)) {}
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
-
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
     std::string toString() const override {
         // TODO
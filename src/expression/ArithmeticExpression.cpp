@@ -8,18 +8,18 @@
 
 namespace nebula {
 
-Value ArithmeticExpression::eval() const {
+Value ArithmeticExpression::eval(const ExpressionContext& ctx) const {
     switch (type_) {
         case Type::EXP_ADD:
-            return lhs_->eval() + rhs_->eval();
+            return lhs_->eval(ctx) + rhs_->eval(ctx);
         case Type::EXP_MINUS:
-            return lhs_->eval() - rhs_->eval();
+            return lhs_->eval(ctx) - rhs_->eval(ctx);
         case Type::EXP_MULTIPLY:
-            return lhs_->eval() * rhs_->eval();
+            return lhs_->eval(ctx) * rhs_->eval(ctx);
         case Type::EXP_DIVIDE:
-            return lhs_->eval() / rhs_->eval();
+            return lhs_->eval(ctx) / rhs_->eval(ctx);
         case Type::EXP_MOD:
-            return lhs_->eval() % rhs_->eval();
+            return lhs_->eval(ctx) % rhs_->eval(ctx);
         default:
             break;
     }
@@ -27,8 +27,38 @@ Value ArithmeticExpression::eval() const {
 }
 
 
-std::string ArithmeticExpression::encode() const {
-    return "";
+void ArithmeticExpression::evalBatch(const DataSet& ds,
+                                     const Selection& sel,
+                                     std::vector<Value>& out) const {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    lhs_->evalBatch(ds, sel, lhs);
+    rhs_->evalBatch(ds, sel, rhs);
+    out.resize(sel.size());
+    switch (type_) {
+        case Type::EXP_ADD:
+            batch::add(lhs.data(), rhs.data(), out.data(), out.size());
+            return;
+        case Type::EXP_MINUS:
+            batch::sub(lhs.data(), rhs.data(), out.data(), out.size());
+            return;
+        case Type::EXP_MULTIPLY:
+            batch::mul(lhs.data(), rhs.data(), out.data(), out.size());
+            return;
+        case Type::EXP_DIVIDE:
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = lhs[i] / rhs[i];
+            }
+            return;
+        case Type::EXP_MOD:
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = lhs[i] % rhs[i];
+            }
+            return;
+        default:
+            break;
+    }
+    LOG(FATAL) << "Unknown type: " << type_;
 }
 
 }  // namespace nebula
@@ -21,21 +21,28 @@ public:
         rhs_.reset(rhs);
     }
 
-    Value eval() const override;
+    Value eval(const ExpressionContext& ctx) const override;
 
-    std::string encode() const override;
+    void evalBatch(const DataSet& ds,
+                   const Selection& sel,
+                   std::vector<Value>& out) const override;
 
-    std::string decode() const override {
+    std::string toString() const override {
         // TODO
         return "";
     }
 
-    std::string toString() const override {
-        // TODO
-        return "";
+    const Expression* lhs() const {
+        return lhs_.get();
+    }
+
+    const Expression* rhs() const {
+        return rhs_.get();
     }
 
 private:
+    friend class ExpressionSimplifier;
+
     std::unique_ptr<Expression> lhs_;
     std::unique_ptr<Expression> rhs_;
 };
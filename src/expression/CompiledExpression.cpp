@@ -0,0 +1,247 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "expression/CompiledExpression.h"
+#include "expression/ConstantExpression.h"
+#include "expression/ArithmeticExpression.h"
+#include "expression/UnaryExpression.h"
+#include "expression/RelationalExpression.h"
+#include "expression/LogicalExpression.h"
+#include "expression/AliasPropertyExpression.h"
+
+namespace nebula {
+
+CompiledExpression::CompiledExpression(const Expression* expr) {
+    result_ = compile(expr);
+}
+
+
+CompiledExpression::OpCode CompiledExpression::opOf(Expression::Type type) {
+    switch (type) {
+        case Expression::Type::EXP_ADD:
+            return OpCode::ADD;
+        case Expression::Type::EXP_MINUS:
+            return OpCode::MINUS;
+        case Expression::Type::EXP_MULTIPLY:
+            return OpCode::MULTIPLY;
+        case Expression::Type::EXP_DIVIDE:
+            return OpCode::DIVIDE;
+        case Expression::Type::EXP_MOD:
+            return OpCode::MOD;
+        case Expression::Type::EXP_REL_EQ:
+            return OpCode::EQ;
+        case Expression::Type::EXP_REL_NE:
+            return OpCode::NE;
+        case Expression::Type::EXP_REL_LT:
+            return OpCode::LT;
+        case Expression::Type::EXP_REL_LE:
+            return OpCode::LE;
+        case Expression::Type::EXP_REL_GT:
+            return OpCode::GT;
+        case Expression::Type::EXP_REL_GE:
+            return OpCode::GE;
+        case Expression::Type::EXP_LOGICAL_AND:
+            return OpCode::AND;
+        case Expression::Type::EXP_LOGICAL_OR:
+            return OpCode::OR;
+        case Expression::Type::EXP_LOGICAL_XOR:
+            return OpCode::XOR;
+        default:
+            break;
+    }
+    LOG(FATAL) << "Unknown type: " << type;
+    return OpCode::EVAL_TREE;
+}
+
+
+uint32_t CompiledExpression::compile(const Expression* expr) {
+    switch (expr->type()) {
+        case Expression::Type::EXP_CONSTANT: {
+            consts_.emplace_back(static_cast<const ConstantExpression*>(expr)->value());
+            return emit(OpCode::LOAD_CONST, consts_.size() - 1);
+        }
+        case Expression::Type::EXP_ADD:
+        case Expression::Type::EXP_MINUS:
+        case Expression::Type::EXP_MULTIPLY:
+        case Expression::Type::EXP_DIVIDE:
+        case Expression::Type::EXP_MOD: {
+            auto* arith = static_cast<const ArithmeticExpression*>(expr);
+            auto lhs = compile(arith->lhs());
+            auto rhs = compile(arith->rhs());
+            return emit(opOf(expr->type()), lhs, rhs);
+        }
+        case Expression::Type::EXP_UNARY_PLUS: {
+            return compile(static_cast<const UnaryExpression*>(expr)->operand());
+        }
+        case Expression::Type::EXP_UNARY_NEGATE: {
+            return emit(OpCode::NEGATE,
+                        compile(static_cast<const UnaryExpression*>(expr)->operand()));
+        }
+        case Expression::Type::EXP_UNARY_NOT: {
+            return emit(OpCode::NOT,
+                        compile(static_cast<const UnaryExpression*>(expr)->operand()));
+        }
+        case Expression::Type::EXP_REL_EQ:
+        case Expression::Type::EXP_REL_NE:
+        case Expression::Type::EXP_REL_LT:
+        case Expression::Type::EXP_REL_LE:
+        case Expression::Type::EXP_REL_GT:
+        case Expression::Type::EXP_REL_GE: {
+            auto* rel = static_cast<const RelationalExpression*>(expr);
+            auto lhs = compile(rel->lhs());
+            auto rhs = compile(rel->rhs());
+            return emit(opOf(expr->type()), lhs, rhs);
+        }
+        case Expression::Type::EXP_LOGICAL_AND:
+        case Expression::Type::EXP_LOGICAL_OR:
+        case Expression::Type::EXP_LOGICAL_XOR: {
+            auto* logical = static_cast<const LogicalExpression*>(expr);
+            auto lhs = compile(logical->lhs());
+            auto rhs = compile(logical->rhs());
+            return emit(opOf(expr->type()), lhs, rhs);
+        }
+        case Expression::Type::EXP_INPUT_PROPERTY: {
+            return emitProp(ExpressionContext::PropKind::INPUT, expr);
+        }
+        case Expression::Type::EXP_VAR_PROPERTY: {
+            return emitProp(ExpressionContext::PropKind::VAR, expr);
+        }
+        case Expression::Type::EXP_SRC_PROPERTY: {
+            return emitProp(ExpressionContext::PropKind::SRC, expr);
+        }
+        case Expression::Type::EXP_DST_PROPERTY: {
+            return emitProp(ExpressionContext::PropKind::DST, expr);
+        }
+        case Expression::Type::EXP_ALIAS_PROPERTY:
+        case Expression::Type::EXP_EDGE_SRC:
+        case Expression::Type::EXP_EDGE_TYPE:
+        case Expression::Type::EXP_EDGE_RANK:
+        case Expression::Type::EXP_EDGE_DST: {
+            return emitProp(ExpressionContext::PropKind::EDGE, expr);
+        }
+        default: {
+            trees_.emplace_back(expr);
+            return emit(OpCode::EVAL_TREE, trees_.size() - 1);
+        }
+    }
+}
+
+
+uint32_t CompiledExpression::emit(OpCode op, uint32_t lhs, uint32_t rhs) {
+    uint32_t dst = regs_.size();
+    regs_.emplace_back(nullptr);
+    vals_.emplace_back();
+    code_.emplace_back(Instruction{op, dst, lhs, rhs});
+    return dst;
+}
+
+
+uint32_t CompiledExpression::emitProp(ExpressionContext::PropKind kind, const Expression* expr) {
+    auto* prop = static_cast<const AliasPropertyExpression*>(expr);
+    props_.emplace_back(Prop{kind, prop->alias(), prop->prop()});
+    return emit(OpCode::LOAD_PROP, props_.size() - 1);
+}
+
+
+void CompiledExpression::bind(const ExpressionContext& ctx) {
+    for (auto& prop : props_) {
+        prop.slot = ctx.resolveProp(prop.kind, prop.alias, prop.prop);
+    }
+}
+
+
+const Value& CompiledExpression::getProp(const ExpressionContext& ctx, const Prop& prop) const {
+    if (prop.slot >= 0) {
+        return ctx.getSlot(prop.slot);
+    }
+    switch (prop.kind) {
+        case ExpressionContext::PropKind::INPUT:
+            return ctx.getInputProp(prop.prop);
+        case ExpressionContext::PropKind::VAR:
+            return ctx.getVarProp(prop.alias, prop.prop);
+        case ExpressionContext::PropKind::EDGE:
+            return ctx.getEdgeProp(prop.alias, prop.prop);
+        case ExpressionContext::PropKind::SRC:
+            return ctx.getSrcProp(prop.prop);
+        case ExpressionContext::PropKind::DST:
+            return ctx.getDstProp(prop.prop);
+    }
+    LOG(FATAL) << "Unknown property kind";
+    return Value::null();
+}
+
+
+const Value& CompiledExpression::eval(const ExpressionContext& ctx) {
+    for (auto& ins : code_) {
+        auto& dst = vals_[ins.dst];
+        switch (ins.op) {
+            case OpCode::LOAD_CONST:
+                regs_[ins.dst] = &consts_[ins.lhs];
+                continue;
+            case OpCode::LOAD_PROP:
+                regs_[ins.dst] = &getProp(ctx, props_[ins.lhs]);
+                continue;
+            case OpCode::EVAL_TREE:
+                dst = trees_[ins.lhs]->eval(ctx);
+                break;
+            case OpCode::ADD:
+                dst = *regs_[ins.lhs] + *regs_[ins.rhs];
+                break;
+            case OpCode::MINUS:
+                dst = *regs_[ins.lhs] - *regs_[ins.rhs];
+                break;
+            case OpCode::MULTIPLY:
+                dst = *regs_[ins.lhs] * *regs_[ins.rhs];
+                break;
+            case OpCode::DIVIDE:
+                dst = *regs_[ins.lhs] / *regs_[ins.rhs];
+                break;
+            case OpCode::MOD:
+                dst = *regs_[ins.lhs] % *regs_[ins.rhs];
+                break;
+            case OpCode::NEGATE:
+                dst = -*regs_[ins.lhs];
+                break;
+            case OpCode::NOT:
+                dst = !*regs_[ins.lhs];
+                break;
+            case OpCode::EQ:
+                dst.setBool(*regs_[ins.lhs] == *regs_[ins.rhs]);
+                break;
+            case OpCode::NE:
+                dst.setBool(*regs_[ins.lhs] != *regs_[ins.rhs]);
+                break;
+            case OpCode::LT:
+                dst.setBool(*regs_[ins.lhs] < *regs_[ins.rhs]);
+                break;
+            case OpCode::LE:
+                dst.setBool(*regs_[ins.lhs] <= *regs_[ins.rhs]);
+                break;
+            case OpCode::GT:
+                dst.setBool(*regs_[ins.lhs] > *regs_[ins.rhs]);
+                break;
+            case OpCode::GE:
+                dst.setBool(*regs_[ins.lhs] >= *regs_[ins.rhs]);
+                break;
+            case OpCode::AND:
+                dst = *regs_[ins.lhs] && *regs_[ins.rhs];
+                break;
+            case OpCode::OR:
+                dst = *regs_[ins.lhs] || *regs_[ins.rhs];
+                break;
+            case OpCode::XOR: {
+                auto& lhs = *regs_[ins.lhs];
+                auto& rhs = *regs_[ins.rhs];
+                dst = (lhs && !rhs) || (!lhs && rhs);
+                break;
+            }
+        }
+        regs_[ins.dst] = &dst;
+    }
+    return *regs_[result_];
+}
+
+}  // namespace nebula
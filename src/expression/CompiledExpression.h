@@ -0,0 +1,118 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef EXPRESSION_COMPILEDEXPRESSION_H_
+#define EXPRESSION_COMPILEDEXPRESSION_H_
+
+#include "base/Base.h"
+#include "expression/Expression.h"
+
+namespace nebula {
+
+/**
+ * An expression flattened into a program of registers, so it is evaluated for
+ * each row by one loop over the instructions instead of the virtual calls down
+ * the tree. The properties are resolved to the slots of the context once for a
+ * query by bind(), and read by reference. The results of the nodes are kept in
+ * registers reused by every row.
+ *
+ * The nodes which are not compiled, e.g. function calls, are evaluated as
+ * trees, so the expression must outlive the program. The program is NOT
+ * thread-safe, every thread evaluates its own copy.
+ *
+ *   CompiledExpression filter(expr);
+ *   filter.bind(ctx);
+ *   for each row of ctx:
+ *       if (filter.eval(ctx) == true) ...
+ */
+class CompiledExpression final {
+public:
+    explicit CompiledExpression(const Expression* expr);
+
+    // Resolve the properties to the slots of the context, once for a query
+    void bind(const ExpressionContext& ctx);
+
+    // Evaluate the expression on the current row of the context, the result is
+    // valid until the next call
+    const Value& eval(const ExpressionContext& ctx);
+
+    // The number of the instructions
+    size_t size() const {
+        return code_.size();
+    }
+
+private:
+    enum class OpCode : uint8_t {
+        LOAD_CONST,
+        LOAD_PROP,
+        EVAL_TREE,
+
+        ADD,
+        MINUS,
+        MULTIPLY,
+        DIVIDE,
+        MOD,
+
+        NEGATE,
+        NOT,
+
+        EQ,
+        NE,
+        LT,
+        LE,
+        GT,
+        GE,
+
+        AND,
+        OR,
+        XOR,
+    };
+
+    struct Instruction {
+        OpCode      op;
+        // The register of the result
+        uint32_t    dst;
+        // The registers of the operands, or the index of the constant, the
+        // property or the tree loaded
+        uint32_t    lhs;
+        uint32_t    rhs;
+    };
+
+    struct Prop {
+        ExpressionContext::PropKind kind;
+        std::string                 alias;
+        std::string                 prop;
+        // -1 if not resolved
+        int32_t                     slot{-1};
+    };
+
+    // The operation of a binary expression
+    static OpCode opOf(Expression::Type type);
+
+    // Append the instructions of the expression, and return the register of the
+    // result
+    uint32_t compile(const Expression* expr);
+
+    uint32_t emit(OpCode op, uint32_t lhs, uint32_t rhs = 0);
+
+    uint32_t emitProp(ExpressionContext::PropKind kind, const Expression* expr);
+
+    const Value& getProp(const ExpressionContext& ctx, const Prop& prop) const;
+
+private:
+    std::vector<Instruction>        code_;
+    std::vector<Value>              consts_;
+    std::vector<Prop>               props_;
+    std::vector<const Expression*>  trees_;
+    // regs_[i] points to the value of the i-th register, i.e. a constant, a
+    // property of the context or vals_[i]
+    std::vector<const Value*>       regs_;
+    std::vector<Value>              vals_;
+    uint32_t                        result_{0};
+};
+
+}  // namespace nebula
+#endif  // EXPRESSION_COMPILEDEXPRESSION_H_
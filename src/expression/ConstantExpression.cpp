@@ -1,16 +0,0 @@
-/* Copyright (c) 2020 vesoft inc. All rights reserved.
- *
- * This source code is licensed under Apache 2.0 License,
- * attached with Common Clause Condition 1.0, found in the LICENSES directory.
- */
-
-#include "expression/ConstantExpression.h"
-
-namespace nebula {
-
-std::string ConstantExpression::encode() const {
-    return "";
-}
-
-}  // namespace nebula
-
@@ -17,15 +17,20 @@ public:
     explicit ConstantExpression(Value v)
         : Expression(Expression::Type::EXP_CONSTANT), val_(std::move(v)) {}
 
-    Value eval() const override {
+    Value eval(const ExpressionContext& ctx) const override {
+        UNUSED(ctx);
         return val_;
     }
 
-    std::string encode() const override;
+    void evalBatch(const DataSet& ds,
+                   const Selection& sel,
+                   std::vector<Value>& out) const override {
+        UNUSED(ds);
+        out.assign(sel.size(), val_);
+    }
 
-    std::string decode() const override {
-        // TODO
-        return "";
+    const Value& value() const {
+        return val_;
     }
 
     std::string toString() const override {
@@ -5,8 +5,781 @@
  */
 
 #include "expression/Expression.h"
+#include "context/DataSetContext.h"
+#include "datatypes/List.h"
+#include "datatypes/Set.h"
+#include "datatypes/Map.h"
+#include "expression/ConstantExpression.h"
+#include "expression/ArithmeticExpression.h"
+#include "expression/UnaryExpression.h"
+#include "expression/RelationalExpression.h"
+#include "expression/LogicalExpression.h"
+#include "expression/TypeCastingExpression.h"
+#include "expression/FunctionCallExpression.h"
+#include "expression/AliasPropertyExpression.h"
+#include "expression/UUIDExpression.h"
 
 namespace nebula {
+
+void Expression::evalBatch(const DataSet& ds,
+                           const Selection& sel,
+                           std::vector<Value>& out) const {
+    DataSetContext ctx(&ds);
+    out.resize(sel.size());
+    for (size_t i = 0; i < sel.size(); i++) {
+        ctx.setRow(sel[i]);
+        out[i] = eval(ctx);
+    }
+}
+
+
+void Expression::filterBatch(const DataSet& ds, Selection& sel) const {
+    std::vector<Value> vals;
+    evalBatch(ds, sel, vals);
+    size_t n = 0;
+    for (size_t i = 0; i < sel.size(); i++) {
+        if (vals[i].type() == Value::Type::BOOL && vals[i].getBool()) {
+            sel[n++] = sel[i];
+        }
+    }
+    sel.resize(n);
+}
+
+
+/**
+ * The wire format of an expression, i.e. the result of encode():
+ *
+ *   varint     the version, i.e. kCodecVersion
+ *   varint     the number of the names, i.e. of the properties, the tags etc.
+ *   names      each as a varint of the length followed by the bytes
+ *   varint     the number of the nodes
+ *   nodes      in post order, i.e. the operands before the operator, each as a
+ *              varint of the Expression::Type followed by the fields below
+ *
+ *   CONSTANT                   the value, see writeValue()
+ *   TYPE_CASTING               varint of the Value::Type
+ *   FUNCTION_CALL              the name, varint of the number of the arguments
+ *   ALIAS_PROPERTY             the ref, the alias and the prop
+ *   INPUT_PROPERTY             the prop
+ *   VAR/SRC/DST_PROPERTY       the alias, i.e. the var or the tag, and the prop
+ *   EDGE_SRC/TYPE/RANK/DST     the alias
+ *   UUID                       the field
+ *
+ * where a name is a varint of its index in the names. The other nodes have no
+ * fields. Both the encoder and the decoder walk the tree by a stack of their
+ * own. Still, evaluating and destroying a tree recurse, so the decoder refuses
+ * a tree deeper than kMaxExprDepth, which no query would make.
+ */
+namespace {
+
+constexpr uint64_t kCodecVersion = 1;
+// The deeper values, e.g. lists in lists, are refused by the decoder
+constexpr size_t kMaxValueDepth = 64;
+// Likewise the deeper expressions
+constexpr size_t kMaxExprDepth = 512;
+
+void writeVarint(std::string& out, uint64_t v) {
+    uint8_t buf[folly::kMaxVarintLength64];
+    out.append(reinterpret_cast<const char*>(buf), folly::encodeVarint(v, buf));
+}
+
+void writeZigZag(std::string& out, int64_t v) {
+    writeVarint(out, folly::encodeZigZag(v));
+}
+
+void writeBytes(std::string& out, folly::StringPiece v) {
+    writeVarint(out, v.size());
+    out.append(v.data(), v.size());
+}
+
+// Little endian
+void writeFixed64(std::string& out, uint64_t v) {
+    for (size_t i = 0; i < sizeof(v); i++) {
+        out.push_back(static_cast<char>(v >> (i * 8)));
+    }
+}
+
+void writeValue(std::string& out, const Value& v) {
+    switch (v.type()) {
+        case Value::Type::VERTEX:
+        case Value::Type::EDGE:
+        case Value::Type::PATH:
+        case Value::Type::DATASET: {
+            // They are never constants of a query
+            LOG(ERROR) << "Unable to encode a constant of " << v.type();
+            writeValue(out, Value(NullType::BAD_TYPE));
+            return;
+        }
+        default:
+            break;
+    }
+
+    writeVarint(out, static_cast<uint64_t>(v.type()));
+    switch (v.type()) {
+        case Value::Type::NULLVALUE: {
+            writeVarint(out, static_cast<uint64_t>(v.getNull()));
+            break;
+        }
+        case Value::Type::BOOL: {
+            out.push_back(v.getBool() ? 1 : 0);
+            break;
+        }
+        case Value::Type::INT: {
+            writeZigZag(out, v.getInt());
+            break;
+        }
+        case Value::Type::FLOAT: {
+            double f = v.getFloat();
+            uint64_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            writeFixed64(out, bits);
+            break;
+        }
+        case Value::Type::STRING: {
+            writeBytes(out, v.getStr());
+            break;
+        }
+        case Value::Type::DATE: {
+            auto& d = v.getDate();
+            writeZigZag(out, d.year);
+            writeZigZag(out, d.month);
+            writeZigZag(out, d.day);
+            break;
+        }
+        case Value::Type::DATETIME: {
+            auto& dt = v.getDateTime();
+            writeZigZag(out, dt.year);
+            writeZigZag(out, dt.month);
+            writeZigZag(out, dt.day);
+            writeZigZag(out, dt.hour);
+            writeZigZag(out, dt.minute);
+            writeZigZag(out, dt.sec);
+            writeZigZag(out, dt.microsec);
+            writeZigZag(out, dt.timezone);
+            break;
+        }
+        case Value::Type::LIST: {
+            auto& values = v.getList().values;
+            writeVarint(out, values.size());
+            for (auto& e : values) {
+                writeValue(out, e);
+            }
+            break;
+        }
+        case Value::Type::SET: {
+            auto& values = v.getSet().values;
+            writeVarint(out, values.size());
+            for (auto& e : values) {
+                writeValue(out, e);
+            }
+            break;
+        }
+        case Value::Type::MAP: {
+            auto& kvs = v.getMap().kvs;
+            writeVarint(out, kvs.size());
+            for (auto& kv : kvs) {
+                writeBytes(out, kv.first);
+                writeValue(out, kv.second);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+
+class Encoder final {
+public:
+    std::string encode(const Expression* root) {
+        size_t numNodes = 0;
+        // The nodes, and whether their operands have been pushed
+        std::vector<std::pair<const Expression*, bool>> stack;
+        std::vector<const Expression*> operands;
+        stack.emplace_back(root, false);
+        while (!stack.empty()) {
+            auto node = stack.back();
+            stack.pop_back();
+            if (node.second) {
+                writeNode(node.first);
+                numNodes++;
+                continue;
+            }
+            stack.emplace_back(node.first, true);
+            operands.clear();
+            operandsOf(node.first, operands);
+            for (auto it = operands.rbegin(); it != operands.rend(); ++it) {
+                stack.emplace_back(*it, false);
+            }
+        }
+
+        std::string out;
+        writeVarint(out, kCodecVersion);
+        writeVarint(out, names_.size());
+        for (auto& name : names_) {
+            writeBytes(out, name);
+        }
+        writeVarint(out, numNodes);
+        out.append(nodes_);
+        return out;
+    }
+
+private:
+    static void operandsOf(const Expression* expr, std::vector<const Expression*>& operands) {
+        switch (expr->type()) {
+            case Expression::Type::EXP_ADD:
+            case Expression::Type::EXP_MINUS:
+            case Expression::Type::EXP_MULTIPLY:
+            case Expression::Type::EXP_DIVIDE:
+            case Expression::Type::EXP_MOD: {
+                auto* arith = static_cast<const ArithmeticExpression*>(expr);
+                operands.emplace_back(arith->lhs());
+                operands.emplace_back(arith->rhs());
+                break;
+            }
+            case Expression::Type::EXP_UNARY_PLUS:
+            case Expression::Type::EXP_UNARY_NEGATE:
+            case Expression::Type::EXP_UNARY_NOT: {
+                operands.emplace_back(static_cast<const UnaryExpression*>(expr)->operand());
+                break;
+            }
+            case Expression::Type::EXP_REL_EQ:
+            case Expression::Type::EXP_REL_NE:
+            case Expression::Type::EXP_REL_LT:
+            case Expression::Type::EXP_REL_LE:
+            case Expression::Type::EXP_REL_GT:
+            case Expression::Type::EXP_REL_GE: {
+                auto* rel = static_cast<const RelationalExpression*>(expr);
+                operands.emplace_back(rel->lhs());
+                operands.emplace_back(rel->rhs());
+                break;
+            }
+            case Expression::Type::EXP_LOGICAL_AND:
+            case Expression::Type::EXP_LOGICAL_OR:
+            case Expression::Type::EXP_LOGICAL_XOR: {
+                auto* logical = static_cast<const LogicalExpression*>(expr);
+                operands.emplace_back(logical->lhs());
+                operands.emplace_back(logical->rhs());
+                break;
+            }
+            case Expression::Type::EXP_TYPE_CASTING: {
+                operands.emplace_back(static_cast<const TypeCastingExpression*>(expr)->operand());
+                break;
+            }
+            case Expression::Type::EXP_FUNCTION_CALL: {
+                auto* args = static_cast<const FunctionCallExpression*>(expr)->args();
+                for (size_t i = 0; i < args->numArgs(); i++) {
+                    operands.emplace_back(args->arg(i));
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+
+    void writeName(const std::string& name) {
+        auto it = nameIndexes_.find(name);
+        if (it == nameIndexes_.end()) {
+            it = nameIndexes_.emplace(name, names_.size()).first;
+            names_.emplace_back(name);
+        }
+        writeVarint(nodes_, it->second);
+    }
+
+    void writeNode(const Expression* expr) {
+        writeVarint(nodes_, static_cast<uint64_t>(expr->type()));
+        switch (expr->type()) {
+            case Expression::Type::EXP_CONSTANT: {
+                writeValue(nodes_, static_cast<const ConstantExpression*>(expr)->value());
+                break;
+            }
+            case Expression::Type::EXP_TYPE_CASTING: {
+                auto* cast = static_cast<const TypeCastingExpression*>(expr);
+                writeVarint(nodes_, static_cast<uint64_t>(cast->targetType()));
+                break;
+            }
+            case Expression::Type::EXP_FUNCTION_CALL: {
+                auto* call = static_cast<const FunctionCallExpression*>(expr);
+                writeName(call->name());
+                writeVarint(nodes_, call->args()->numArgs());
+                break;
+            }
+            case Expression::Type::EXP_ALIAS_PROPERTY: {
+                auto* prop = static_cast<const AliasPropertyExpression*>(expr);
+                writeName(prop->ref());
+                writeName(prop->alias());
+                writeName(prop->prop());
+                break;
+            }
+            case Expression::Type::EXP_INPUT_PROPERTY: {
+                writeName(static_cast<const AliasPropertyExpression*>(expr)->prop());
+                break;
+            }
+            case Expression::Type::EXP_VAR_PROPERTY:
+            case Expression::Type::EXP_SRC_PROPERTY:
+            case Expression::Type::EXP_DST_PROPERTY: {
+                auto* prop = static_cast<const AliasPropertyExpression*>(expr);
+                writeName(prop->alias());
+                writeName(prop->prop());
+                break;
+            }
+            case Expression::Type::EXP_EDGE_SRC:
+            case Expression::Type::EXP_EDGE_TYPE:
+            case Expression::Type::EXP_EDGE_RANK:
+            case Expression::Type::EXP_EDGE_DST: {
+                writeName(static_cast<const AliasPropertyExpression*>(expr)->alias());
+                break;
+            }
+            case Expression::Type::EXP_UUID: {
+                writeName(static_cast<const UUIDExpression*>(expr)->field());
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+
+private:
+    std::vector<std::string>                    names_;
+    std::unordered_map<std::string, uint64_t>   nameIndexes_;
+    std::string                                 nodes_;
+};
+
+
+class Decoder final {
+public:
+    explicit Decoder(folly::StringPiece encoded)
+        : size_(encoded.size()), in_(folly::ByteRange(encoded)) {}
+
+    StatusOr<std::unique_ptr<Expression>> decode() {
+        uint64_t version;
+        if (!readVarint(version)) {
+            return malformed();
+        }
+        if (version != kCodecVersion) {
+            return Status::Error("Unsupported version %lu of the expression", version);
+        }
+
+        uint64_t numNames;
+        // Each name takes one byte at least
+        if (!readVarint(numNames) || numNames > in_.size()) {
+            return malformed();
+        }
+        names_.resize(numNames);
+        for (auto& name : names_) {
+            if (!readBytes(name)) {
+                return malformed();
+            }
+        }
+
+        uint64_t numNodes;
+        if (!readVarint(numNodes) || numNodes == 0 || numNodes > in_.size()) {
+            return malformed();
+        }
+        stack_.reserve(numNodes);
+        for (uint64_t i = 0; i < numNodes; i++) {
+            if (!readNode()) {
+                return malformed();
+            }
+            if (stack_.back().depth > kMaxExprDepth) {
+                return Status::Error("Expression deeper than %lu at byte %lu",
+                                     kMaxExprDepth, size_ - in_.size());
+            }
+        }
+        if (!in_.empty() || stack_.size() != 1) {
+            return malformed();
+        }
+        return std::move(stack_.back().expr);
+    }
+
+private:
+    Status malformed() const {
+        return Status::Error("Malformed expression at byte %lu", size_ - in_.size());
+    }
+
+    bool readVarint(uint64_t& v) {
+        auto result = folly::tryDecodeVarint(in_);
+        if (result.hasError()) {
+            return false;
+        }
+        v = result.value();
+        return true;
+    }
+
+    template <class T>
+    bool readZigZag(T& v) {
+        uint64_t u;
+        if (!readVarint(u)) {
+            return false;
+        }
+        v = static_cast<T>(folly::decodeZigZag(u));
+        return true;
+    }
+
+    bool readFixed64(uint64_t& v) {
+        if (in_.size() < sizeof(v)) {
+            return false;
+        }
+        v = 0;
+        for (size_t i = 0; i < sizeof(v); i++) {
+            v |= static_cast<uint64_t>(in_[i]) << (i * 8);
+        }
+        in_.advance(sizeof(v));
+        return true;
+    }
+
+    bool readBytes(folly::StringPiece& v) {
+        uint64_t len;
+        if (!readVarint(len) || len > in_.size()) {
+            return false;
+        }
+        v.reset(reinterpret_cast<const char*>(in_.data()), len);
+        in_.advance(len);
+        return true;
+    }
+
+    bool readName(folly::StringPiece& v) {
+        uint64_t i;
+        if (!readVarint(i) || i >= names_.size()) {
+            return false;
+        }
+        v = names_[i];
+        return true;
+    }
+
+    bool readValue(Value& v, size_t depth) {
+        uint64_t type;
+        if (depth > kMaxValueDepth || !readVarint(type)) {
+            return false;
+        }
+        switch (static_cast<Value::Type>(type)) {
+            case Value::Type::__EMPTY__: {
+                v.clear();
+                return true;
+            }
+            case Value::Type::NULLVALUE: {
+                uint64_t null;
+                if (!readVarint(null) || null > static_cast<uint64_t>(NullType::DIV_BY_ZERO)) {
+                    return false;
+                }
+                v.setNull(static_cast<NullType>(null));
+                return true;
+            }
+            case Value::Type::BOOL: {
+                if (in_.empty()) {
+                    return false;
+                }
+                v.setBool(in_.front() != 0);
+                in_.advance(1);
+                return true;
+            }
+            case Value::Type::INT: {
+                int64_t i;
+                if (!readZigZag(i)) {
+                    return false;
+                }
+                v.setInt(i);
+                return true;
+            }
+            case Value::Type::FLOAT: {
+                uint64_t bits;
+                if (!readFixed64(bits)) {
+                    return false;
+                }
+                double f;
+                memcpy(&f, &bits, sizeof(f));
+                v.setFloat(f);
+                return true;
+            }
+            case Value::Type::STRING: {
+                folly::StringPiece str;
+                if (!readBytes(str)) {
+                    return false;
+                }
+                v.setStr(str);
+                return true;
+            }
+            case Value::Type::DATE: {
+                Date d;
+                if (!readZigZag(d.year) || !readZigZag(d.month) || !readZigZag(d.day)) {
+                    return false;
+                }
+                v.setDate(std::move(d));
+                return true;
+            }
+            case Value::Type::DATETIME: {
+                DateTime dt;
+                dt.clear();
+                if (!readZigZag(dt.year) || !readZigZag(dt.month) || !readZigZag(dt.day)
+                        || !readZigZag(dt.hour) || !readZigZag(dt.minute) || !readZigZag(dt.sec)
+                        || !readZigZag(dt.microsec) || !readZigZag(dt.timezone)) {
+                    return false;
+                }
+                v.setDateTime(std::move(dt));
+                return true;
+            }
+            case Value::Type::LIST: {
+                uint64_t size;
+                if (!readVarint(size) || size > in_.size()) {
+                    return false;
+                }
+                List list;
+                list.values.resize(size);
+                for (auto& e : list.values) {
+                    if (!readValue(e, depth + 1)) {
+                        return false;
+                    }
+                }
+                v.setList(std::move(list));
+                return true;
+            }
+            case Value::Type::SET: {
+                uint64_t size;
+                if (!readVarint(size) || size > in_.size()) {
+                    return false;
+                }
+                Set set;
+                set.values.reserve(size);
+                for (uint64_t i = 0; i < size; i++) {
+                    Value e;
+                    if (!readValue(e, depth + 1)) {
+                        return false;
+                    }
+                    set.values.emplace(std::move(e));
+                }
+                v.setSet(std::move(set));
+                return true;
+            }
+            case Value::Type::MAP: {
+                uint64_t size;
+                if (!readVarint(size) || size > in_.size()) {
+                    return false;
+                }
+                Map map;
+                map.kvs.reserve(size);
+                for (uint64_t i = 0; i < size; i++) {
+                    folly::StringPiece key;
+                    Value e;
+                    if (!readBytes(key) || !readValue(e, depth + 1)) {
+                        return false;
+                    }
+                    map.kvs.emplace(key.str(), std::move(e));
+                }
+                v.setMap(std::move(map));
+                return true;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+
+    // A node decoded, whose parent is not yet
+    struct Entry {
+        Entry(Expression* e, size_t d) : expr(e), depth(d) {}
+
+        std::unique_ptr<Expression>     expr;
+        // Of the subtree, 1 for a leaf
+        size_t                          depth;
+    };
+
+    // Pop the operand, to be a child of the node pushed at `depth'
+    std::unique_ptr<Expression> pop(size_t& depth) {
+        auto expr = std::move(stack_.back().expr);
+        depth = std::max(depth, stack_.back().depth + 1);
+        stack_.pop_back();
+        return expr;
+    }
+
+    void pushLeaf(Expression* expr) {
+        stack_.emplace_back(expr, 1);
+    }
+
+    template <class T>
+    bool pushBinary(Expression::Type type) {
+        if (stack_.size() < 2) {
+            return false;
+        }
+        size_t depth = 1;
+        auto rhs = pop(depth);
+        auto lhs = pop(depth);
+        stack_.emplace_back(new T(type, lhs.release(), rhs.release()), depth);
+        return true;
+    }
+
+    bool readNode() {
+        uint64_t t;
+        if (!readVarint(t) || t > static_cast<uint64_t>(Expression::Type::EXP_UUID)) {
+            return false;
+        }
+        auto type = static_cast<Expression::Type>(t);
+        switch (type) {
+            case Expression::Type::EXP_CONSTANT: {
+                Value v;
+                if (!readValue(v, 0)) {
+                    return false;
+                }
+                pushLeaf(new ConstantExpression(std::move(v)));
+                return true;
+            }
+            case Expression::Type::EXP_ADD:
+            case Expression::Type::EXP_MINUS:
+            case Expression::Type::EXP_MULTIPLY:
+            case Expression::Type::EXP_DIVIDE:
+            case Expression::Type::EXP_MOD: {
+                return pushBinary<ArithmeticExpression>(type);
+            }
+            case Expression::Type::EXP_UNARY_PLUS:
+            case Expression::Type::EXP_UNARY_NEGATE:
+            case Expression::Type::EXP_UNARY_NOT: {
+                if (stack_.empty()) {
+                    return false;
+                }
+                size_t depth = 1;
+                auto operand = pop(depth);
+                stack_.emplace_back(new UnaryExpression(type, operand.release()), depth);
+                return true;
+            }
+            case Expression::Type::EXP_REL_EQ:
+            case Expression::Type::EXP_REL_NE:
+            case Expression::Type::EXP_REL_LT:
+            case Expression::Type::EXP_REL_LE:
+            case Expression::Type::EXP_REL_GT:
+            case Expression::Type::EXP_REL_GE: {
+                return pushBinary<RelationalExpression>(type);
+            }
+            case Expression::Type::EXP_LOGICAL_AND:
+            case Expression::Type::EXP_LOGICAL_OR:
+            case Expression::Type::EXP_LOGICAL_XOR: {
+                return pushBinary<LogicalExpression>(type);
+            }
+            case Expression::Type::EXP_TYPE_CASTING: {
+                uint64_t vType;
+                if (!readVarint(vType)
+                        || vType > static_cast<uint64_t>(Value::Type::DATASET)
+                        || stack_.empty()) {
+                    return false;
+                }
+                size_t depth = 1;
+                auto operand = pop(depth);
+                stack_.emplace_back(new TypeCastingExpression(static_cast<Value::Type>(vType),
+                                                              operand.release()),
+                                    depth);
+                return true;
+            }
+            case Expression::Type::EXP_FUNCTION_CALL: {
+                folly::StringPiece name;
+                uint64_t numArgs;
+                if (!readName(name) || !readVarint(numArgs) || numArgs > stack_.size()) {
+                    return false;
+                }
+                size_t depth = 1;
+                auto* args = new ArgumentList();
+                for (auto i = stack_.size() - numArgs; i < stack_.size(); i++) {
+                    args->addArgument(stack_[i].expr.release());
+                    depth = std::max(depth, stack_[i].depth + 1);
+                }
+                stack_.erase(stack_.end() - numArgs, stack_.end());
+                stack_.emplace_back(new FunctionCallExpression(new std::string(name.str()), args),
+                                    depth);
+                return true;
+            }
+            case Expression::Type::EXP_ALIAS_PROPERTY: {
+                folly::StringPiece ref, alias, prop;
+                if (!readName(ref) || !readName(alias) || !readName(prop)) {
+                    return false;
+                }
+                pushLeaf(new AliasPropertyExpression(type,
+                                                     new std::string(ref.str()),
+                                                     new std::string(alias.str()),
+                                                     new std::string(prop.str())));
+                return true;
+            }
+            case Expression::Type::EXP_INPUT_PROPERTY: {
+                folly::StringPiece prop;
+                if (!readName(prop)) {
+                    return false;
+                }
+                pushLeaf(new InputPropertyExpression(new std::string(prop.str())));
+                return true;
+            }
+            case Expression::Type::EXP_VAR_PROPERTY:
+            case Expression::Type::EXP_SRC_PROPERTY:
+            case Expression::Type::EXP_DST_PROPERTY: {
+                folly::StringPiece alias, prop;
+                if (!readName(alias) || !readName(prop)) {
+                    return false;
+                }
+                auto* a = new std::string(alias.str());
+                auto* p = new std::string(prop.str());
+                if (type == Expression::Type::EXP_VAR_PROPERTY) {
+                    pushLeaf(new VariablePropertyExpression(a, p));
+                } else if (type == Expression::Type::EXP_SRC_PROPERTY) {
+                    pushLeaf(new SourcePropertyExpression(a, p));
+                } else {
+                    pushLeaf(new DestPropertyExpression(a, p));
+                }
+                return true;
+            }
+            case Expression::Type::EXP_EDGE_SRC:
+            case Expression::Type::EXP_EDGE_TYPE:
+            case Expression::Type::EXP_EDGE_RANK:
+            case Expression::Type::EXP_EDGE_DST: {
+                folly::StringPiece alias;
+                if (!readName(alias)) {
+                    return false;
+                }
+                auto* a = new std::string(alias.str());
+                if (type == Expression::Type::EXP_EDGE_SRC) {
+                    pushLeaf(new EdgeSrcIdExpression(a));
+                } else if (type == Expression::Type::EXP_EDGE_TYPE) {
+                    pushLeaf(new EdgeTypeExpression(a));
+                } else if (type == Expression::Type::EXP_EDGE_RANK) {
+                    pushLeaf(new EdgeRankExpression(a));
+                } else {
+                    pushLeaf(new EdgeDstIdExpression(a));
+                }
+                return true;
+            }
+            case Expression::Type::EXP_UUID: {
+                folly::StringPiece field;
+                if (!readName(field)) {
+                    return false;
+                }
+                pushLeaf(new UUIDExpression(new std::string(field.str())));
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const size_t                                size_;
+    folly::ByteRange                            in_;
+    // Point into the encoded
+    std::vector<folly::StringPiece>             names_;
+    std::vector<Entry>                          stack_;
+};
+
+}  // namespace
+
+
+std::string Expression::encode() const {
+    Encoder encoder;
+    return encoder.encode(this);
+}
+
+
+StatusOr<std::unique_ptr<Expression>> Expression::decode(folly::StringPiece encoded) {
+    Decoder decoder(encoded);
+    return decoder.decode();
+}
+
+
 std::ostream& operator<<(std::ostream& os, Expression::Type type) {
     switch (type) {
         case Expression::Type::EXP_CONSTANT:
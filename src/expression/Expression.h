@@ -8,7 +8,9 @@
 #define EXPRESSION_EXPRESSION_H_
 
 #include "base/Base.h"
+#include "base/StatusOr.h"
 #include "datatypes/Value.h"
+#include "context/ExpressionContext.h"
 
 namespace nebula {
 
@@ -55,6 +57,9 @@ public:
         EXP_UUID,
     };
 
+    // The indexes of the rows of a DataSet evaluated in a batch, ascending
+    using Selection = std::vector<uint32_t>;
+
     explicit Expression(Type type) : type_(type) {}
 
     virtual ~Expression() = default;
@@ -63,13 +68,25 @@ public:
         return type_;
     }
 
-    virtual Value eval() const = 0;
+    virtual Value eval(const ExpressionContext& ctx) const = 0;
+
+    // Evaluate the expression on the rows selected of the data set, i.e. the
+    // input, and out[i] is the value on the row sel[i]. By default each row is
+    // evaluated by eval(), the subclasses evaluate the batch node by node
+    virtual void evalBatch(const DataSet& ds,
+                           const Selection& sel,
+                           std::vector<Value>& out) const;
+
+    // Narrow the selection to the rows on which the expression is true
+    virtual void filterBatch(const DataSet& ds, Selection& sel) const;
 
     virtual std::string toString() const = 0;
 
-    virtual std::string encode() const = 0;
+    // Encode the tree into a compact binary, see Expression.cpp for the format
+    std::string encode() const;
 
-    virtual std::string decode() const = 0;
+    // Build the tree encoded by encode()
+    static StatusOr<std::unique_ptr<Expression>> decode(folly::StringPiece encoded);
 
 protected:
     Type type_;
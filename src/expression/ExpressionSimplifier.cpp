@@ -0,0 +1,282 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "expression/ExpressionSimplifier.h"
+#include "expression/ConstantExpression.h"
+#include "expression/ArithmeticExpression.h"
+#include "expression/UnaryExpression.h"
+#include "expression/RelationalExpression.h"
+#include "expression/LogicalExpression.h"
+#include "expression/TypeCastingExpression.h"
+#include "expression/FunctionCallExpression.h"
+
+namespace nebula {
+
+namespace {
+
+// The context of the expressions folded, which read no properties
+class NoPropContext final : public ExpressionContext {
+public:
+    const Value& getVar(const std::string& var) const override {
+        LOG(FATAL) << "Folding an expression which reads $" << var;
+        return Value::null();
+    }
+
+    const Value& getVarProp(const std::string& var, const std::string& prop) const override {
+        LOG(FATAL) << "Folding an expression which reads $" << var << "." << prop;
+        return Value::null();
+    }
+
+    const Value& getEdgeProp(const std::string& edge, const std::string& prop) const override {
+        LOG(FATAL) << "Folding an expression which reads " << edge << "." << prop;
+        return Value::null();
+    }
+
+    const Value& getSrcProp(const std::string& prop) const override {
+        LOG(FATAL) << "Folding an expression which reads $^." << prop;
+        return Value::null();
+    }
+
+    const Value& getDstProp(const std::string& prop) const override {
+        LOG(FATAL) << "Folding an expression which reads $$." << prop;
+        return Value::null();
+    }
+
+    const Value& getInputProp(const std::string& prop) const override {
+        LOG(FATAL) << "Folding an expression which reads $-." << prop;
+        return Value::null();
+    }
+};
+
+
+const Value* constantOf(const Expression* expr) {
+    if (expr->type() != Expression::Type::EXP_CONSTANT) {
+        return nullptr;
+    }
+    return &static_cast<const ConstantExpression*>(expr)->value();
+}
+
+
+// The type of the value of the expression unless it is null, __EMPTY__ if it
+// is not known before the evaluation
+Value::Type resultType(const Expression* expr) {
+    switch (expr->type()) {
+        case Expression::Type::EXP_CONSTANT:
+            return static_cast<const ConstantExpression*>(expr)->value().type();
+        case Expression::Type::EXP_UNARY_NOT:
+        case Expression::Type::EXP_REL_EQ:
+        case Expression::Type::EXP_REL_NE:
+        case Expression::Type::EXP_REL_LT:
+        case Expression::Type::EXP_REL_LE:
+        case Expression::Type::EXP_REL_GT:
+        case Expression::Type::EXP_REL_GE:
+        case Expression::Type::EXP_LOGICAL_AND:
+        case Expression::Type::EXP_LOGICAL_OR:
+        case Expression::Type::EXP_LOGICAL_XOR:
+            return Value::Type::BOOL;
+        case Expression::Type::EXP_TYPE_CASTING:
+            return static_cast<const TypeCastingExpression*>(expr)->targetType();
+        default:
+            break;
+    }
+    return Value::Type::__EMPTY__;
+}
+
+
+// Whether the expression is a bool and never null
+bool isBool(const Expression* expr) {
+    switch (expr->type()) {
+        case Expression::Type::EXP_CONSTANT:
+            return static_cast<const ConstantExpression*>(expr)->value().type()
+                == Value::Type::BOOL;
+        case Expression::Type::EXP_REL_EQ:
+        case Expression::Type::EXP_REL_NE:
+        case Expression::Type::EXP_REL_LT:
+        case Expression::Type::EXP_REL_LE:
+        case Expression::Type::EXP_REL_GT:
+        case Expression::Type::EXP_REL_GE:
+            return true;
+        default:
+            break;
+    }
+    return false;
+}
+
+}  // namespace
+
+
+std::unique_ptr<Expression> ExpressionSimplifier::simplify(std::unique_ptr<Expression> expr) {
+    return rewrite(std::move(expr), false);
+}
+
+
+std::unique_ptr<Expression>
+ExpressionSimplifier::simplifyFilter(std::unique_ptr<Expression> expr) {
+    return rewrite(std::move(expr), true);
+}
+
+
+std::unique_ptr<Expression> ExpressionSimplifier::fold(std::unique_ptr<Expression> expr) {
+    static const NoPropContext ctx;
+    return std::make_unique<ConstantExpression>(expr->eval(ctx));
+}
+
+
+std::unique_ptr<Expression> ExpressionSimplifier::rewrite(std::unique_ptr<Expression> expr,
+                                                          bool asFilter) {
+    switch (expr->type()) {
+        case Expression::Type::EXP_ADD:
+        case Expression::Type::EXP_MINUS:
+        case Expression::Type::EXP_MULTIPLY:
+        case Expression::Type::EXP_DIVIDE:
+        case Expression::Type::EXP_MOD: {
+            auto* arith = static_cast<ArithmeticExpression*>(expr.get());
+            arith->lhs_ = rewrite(std::move(arith->lhs_), false);
+            arith->rhs_ = rewrite(std::move(arith->rhs_), false);
+            if (constantOf(arith->lhs_.get()) && constantOf(arith->rhs_.get())) {
+                stats_.folded++;
+                return fold(std::move(expr));
+            }
+            return expr;
+        }
+        case Expression::Type::EXP_UNARY_PLUS:
+        case Expression::Type::EXP_UNARY_NEGATE:
+        case Expression::Type::EXP_UNARY_NOT: {
+            auto* unary = static_cast<UnaryExpression*>(expr.get());
+            // NOT x is true when x is false, so x is not a filter
+            unary->operand_ = rewrite(std::move(unary->operand_), false);
+            if (constantOf(unary->operand_.get())) {
+                stats_.folded++;
+                return fold(std::move(expr));
+            }
+            if (expr->type() == Expression::Type::EXP_UNARY_PLUS) {
+                stats_.identities++;
+                return std::move(unary->operand_);
+            }
+            if (expr->type() == Expression::Type::EXP_UNARY_NOT
+                    && unary->operand_->type() == Expression::Type::EXP_UNARY_NOT) {
+                // NOT NOT x is a null of BAD_TYPE when x is not a bool
+                auto* inner = static_cast<UnaryExpression*>(unary->operand_.get());
+                if (asFilter || resultType(inner->operand_.get()) == Value::Type::BOOL) {
+                    stats_.identities++;
+                    return std::move(inner->operand_);
+                }
+            }
+            return expr;
+        }
+        case Expression::Type::EXP_REL_EQ:
+        case Expression::Type::EXP_REL_NE:
+        case Expression::Type::EXP_REL_LT:
+        case Expression::Type::EXP_REL_LE:
+        case Expression::Type::EXP_REL_GT:
+        case Expression::Type::EXP_REL_GE: {
+            auto* rel = static_cast<RelationalExpression*>(expr.get());
+            rel->lhs_ = rewrite(std::move(rel->lhs_), false);
+            rel->rhs_ = rewrite(std::move(rel->rhs_), false);
+            if (constantOf(rel->lhs_.get()) && constantOf(rel->rhs_.get())) {
+                stats_.folded++;
+                return fold(std::move(expr));
+            }
+            return expr;
+        }
+        case Expression::Type::EXP_LOGICAL_AND:
+        case Expression::Type::EXP_LOGICAL_OR:
+        case Expression::Type::EXP_LOGICAL_XOR: {
+            return rewriteLogical(std::move(expr), asFilter);
+        }
+        case Expression::Type::EXP_TYPE_CASTING: {
+            return rewriteCasting(std::move(expr));
+        }
+        case Expression::Type::EXP_FUNCTION_CALL: {
+            // The function may be not deterministic, only its arguments are folded
+            auto* call = static_cast<FunctionCallExpression*>(expr.get());
+            for (auto& arg : call->args_->args_) {
+                arg = rewrite(std::move(arg), false);
+            }
+            return expr;
+        }
+        default:
+            break;
+    }
+    return expr;
+}
+
+
+std::unique_ptr<Expression>
+ExpressionSimplifier::rewriteLogical(std::unique_ptr<Expression> expr, bool asFilter) {
+    auto* logical = static_cast<LogicalExpression*>(expr.get());
+    bool isAnd = expr->type() == Expression::Type::EXP_LOGICAL_AND;
+    // x AND y is true iff both x and y are true, which does not hold for OR
+    logical->lhs_ = rewrite(std::move(logical->lhs_), asFilter && isAnd);
+    logical->rhs_ = rewrite(std::move(logical->rhs_), asFilter && isAnd);
+
+    auto* lhs = constantOf(logical->lhs_.get());
+    auto* rhs = constantOf(logical->rhs_.get());
+    if (lhs != nullptr && rhs != nullptr) {
+        stats_.folded++;
+        return fold(std::move(expr));
+    }
+    if (expr->type() == Expression::Type::EXP_LOGICAL_XOR || (lhs == nullptr && rhs == nullptr)) {
+        return expr;
+    }
+
+    // The null lhs is the result whatever the rhs is
+    if (lhs != nullptr && lhs->isNull()) {
+        stats_.identities++;
+        return std::move(logical->lhs_);
+    }
+
+    const Value& constant = lhs != nullptr ? *lhs : *rhs;
+    auto& constExpr = lhs != nullptr ? logical->lhs_ : logical->rhs_;
+    auto& other = lhs != nullptr ? logical->rhs_ : logical->lhs_;
+    if (constant.type() == Value::Type::BOOL) {
+        if (constant.getBool() == isAnd) {
+            // true AND x, false OR x are x when x is a bool or null, and only
+            // true when x is true
+            if (asFilter || resultType(other.get()) == Value::Type::BOOL) {
+                stats_.identities++;
+                return std::move(other);
+            }
+        } else {
+            // false AND x, true OR x are the constant when x is a bool
+            if (isBool(other.get())) {
+                stats_.identities++;
+                return std::move(constExpr);
+            }
+            if (asFilter && isAnd) {
+                stats_.identities++;
+                return std::make_unique<ConstantExpression>(false);
+            }
+        }
+        return expr;
+    }
+
+    // AND and OR of a constant which is not a bool are never true
+    if (asFilter) {
+        stats_.identities++;
+        return std::make_unique<ConstantExpression>(false);
+    }
+    return expr;
+}
+
+
+std::unique_ptr<Expression> ExpressionSimplifier::rewriteCasting(std::unique_ptr<Expression> expr) {
+    auto* casting = static_cast<TypeCastingExpression*>(expr.get());
+    casting->operand_ = rewrite(std::move(casting->operand_), false);
+    if (constantOf(casting->operand_.get())) {
+        stats_.casts++;
+        return fold(std::move(expr));
+    }
+    // The cast keeps the null and the value already of the type, so the casts
+    // of x to the type of x, including a cast to the same type, are removed
+    if (resultType(casting->operand_.get()) == casting->vType_) {
+        stats_.casts++;
+        return std::move(casting->operand_);
+    }
+    return expr;
+}
+
+}  // namespace nebula
@@ -0,0 +1,79 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef EXPRESSION_EXPRESSIONSIMPLIFIER_H_
+#define EXPRESSION_EXPRESSIONSIMPLIFIER_H_
+
+#include "base/Base.h"
+#include "expression/Expression.h"
+
+namespace nebula {
+
+/**
+ * Rewrite an expression into a smaller one which is cheaper to evaluate for
+ * each row, once before the expression is evaluated or sent to the storage:
+ *
+ *   - The sub-trees which read no properties, e.g. 1 + 2 * 3, are folded into
+ *     constants. Function calls and UUID are never folded, but their arguments
+ *     are.
+ *   - The casts of the constants are folded, and the casts of the values which
+ *     already are of the type, e.g. of a cast to the same type, are removed.
+ *   - The boolean identities, e.g. true AND x, are applied.
+ *
+ * An expression simplified by simplify() evaluates to the same value on every
+ * context. A null or a non-bool x makes true AND x differ from x, so most
+ * boolean identities only apply when x is known to be a bool. An expression
+ * simplified by simplifyFilter() is only true on the same rows, which allows
+ * more of them, e.g. false AND x to false.
+ *
+ *   ExpressionSimplifier simplifier;
+ *   filter = simplifier.simplifyFilter(std::move(filter));
+ *   if (simplifier.stats().changed()) ...
+ */
+class ExpressionSimplifier final {
+public:
+    struct Stats {
+        // The sub-trees folded into constants
+        size_t folded{0};
+        // The rewrites by the boolean identities, and of +x to x
+        size_t identities{0};
+        // The casts folded or removed
+        size_t casts{0};
+
+        bool changed() const {
+            return folded + identities + casts > 0;
+        }
+    };
+
+    // Simplify the expression keeping its value
+    std::unique_ptr<Expression> simplify(std::unique_ptr<Expression> expr);
+
+    // Simplify the expression keeping the rows on which it is true
+    std::unique_ptr<Expression> simplifyFilter(std::unique_ptr<Expression> expr);
+
+    // The rewrites by all the calls so far
+    const Stats& stats() const {
+        return stats_;
+    }
+
+private:
+    // The expression is a filter when only whether it is true matters, which
+    // holds for the operands of the AND of a filter too
+    std::unique_ptr<Expression> rewrite(std::unique_ptr<Expression> expr, bool asFilter);
+
+    std::unique_ptr<Expression> rewriteLogical(std::unique_ptr<Expression> expr, bool asFilter);
+
+    std::unique_ptr<Expression> rewriteCasting(std::unique_ptr<Expression> expr);
+
+    // Evaluate the expression, which reads no properties, into a constant
+    static std::unique_ptr<Expression> fold(std::unique_ptr<Expression> expr);
+
+private:
+    Stats stats_;
+};
+
+}  // namespace nebula
+#endif  // EXPRESSION_EXPRESSIONSIMPLIFIER_H_
@@ -7,7 +7,24 @@
 #include "expression/FunctionCallExpression.h"
 
 namespace nebula {
-Value FunctionCallExpression::eval() const {
-    return Value(NullType::NaN);
+Value FunctionCallExpression::eval(const ExpressionContext& ctx) const {
+    Value result;
+    eval(ctx, result);
+    return result;
+}
+
+void FunctionCallExpression::eval(const ExpressionContext& ctx, Value& result) const {
+    if (func_ == nullptr) {
+        result.setNull(NullType::NaN);
+        return;
+    }
+    // The arity is checked when resolved, so the arguments are kept on the stack
+    auto numArgs = args_->numArgs();
+    DCHECK_LE(numArgs, FunctionManager::kMaxArity);
+    std::array<Value, FunctionManager::kMaxArity> args;
+    for (size_t i = 0; i < numArgs; i++) {
+        args[i] = args_->arg(i)->eval(ctx);
+    }
+    func_(args.data(), numArgs, result);
 }
 }  // namespace nebula
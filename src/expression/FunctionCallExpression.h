@@ -8,6 +8,7 @@
 #define EXPRESSION_FUNCTIONCALLEXPRESSION_H_
 
 #include "expression/Expression.h"
+#include "function/FunctionManager.h"
 
 namespace nebula {
 class ArgumentList final {
@@ -20,7 +21,17 @@ public:
         return std::move(args_);
     }
 
+    size_t numArgs() const {
+        return args_.size();
+    }
+
+    const Expression* arg(size_t i) const {
+        return args_[i].get();
+    }
+
 private:
+    friend class ExpressionSimplifier;
+
     std::vector<std::unique_ptr<Expression>>    args_;
 };
 
@@ -31,28 +42,43 @@ public:
         : Expression(Type::EXP_FUNCTION_CALL) {
         name_.reset(name);
         args_.reset(args);
+        auto func = FunctionManager::get(*name_, args_->numArgs());
+        if (func.ok()) {
+            func_ = func.value();
+        }
     }
 
-    Value eval() const override;
+    Value eval(const ExpressionContext& ctx) const override;
+
+    // Evaluate the call into the result, which allocates nothing for a scalar
+    void eval(const ExpressionContext& ctx, Value& result) const;
 
-    std::string encode() const override {
+    std::string toString() const override {
         // TODO
         return "";
     }
 
-    std::string decode() const override {
-        // TODO
-        return "";
+    const std::string& name() const {
+        return *name_;
     }
 
-    std::string toString() const override {
-        // TODO
-        return "";
+    const ArgumentList* args() const {
+        return args_.get();
+    }
+
+    // Whether the name is of a builtin taking the number of the arguments,
+    // otherwise the call evaluates to NaN
+    bool isResolved() const {
+        return func_ != nullptr;
     }
 
 private:
+    friend class ExpressionSimplifier;
+
     std::unique_ptr<std::string>                name_;
     std::unique_ptr<ArgumentList>               args_;
+    // Resolved from the name once
+    FunctionManager::Function                   func_{nullptr};
 };
 }  // namespace nebula
 #endif
@@ -7,9 +7,9 @@
 #include "expression/LogicalExpression.h"
 
 namespace nebula {
-Value LogicalExpression::eval() const {
-    auto lhs = lhs_->eval();
-    auto rhs = rhs_->eval();
+Value LogicalExpression::eval(const ExpressionContext& ctx) const {
+    auto lhs = lhs_->eval(ctx);
+    auto rhs = rhs_->eval(ctx);
 
     switch (type_) {
         case Type::EXP_LOGICAL_AND:
@@ -23,4 +23,77 @@ Value LogicalExpression::eval() const {
     }
     LOG(FATAL) << "Unknown type: " << type_;
 }
+
+void LogicalExpression::evalBatch(const DataSet& ds,
+                                  const Selection& sel,
+                                  std::vector<Value>& out) const {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    lhs_->evalBatch(ds, sel, lhs);
+    rhs_->evalBatch(ds, sel, rhs);
+    out.resize(sel.size());
+    switch (type_) {
+        case Type::EXP_LOGICAL_AND:
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = lhs[i] && rhs[i];
+            }
+            return;
+        case Type::EXP_LOGICAL_OR:
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = lhs[i] || rhs[i];
+            }
+            return;
+        case Type::EXP_LOGICAL_XOR:
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = (lhs[i] && !rhs[i]) || (!lhs[i] && rhs[i]);
+            }
+            return;
+        default:
+            break;
+    }
+    LOG(FATAL) << "Unknown type: " << type_;
+}
+
+void LogicalExpression::filterBatch(const DataSet& ds, Selection& sel) const {
+    switch (type_) {
+        case Type::EXP_LOGICAL_AND: {
+            // Only the rows on which the lhs is true are evaluated by the rhs
+            lhs_->filterBatch(ds, sel);
+            if (!sel.empty()) {
+                rhs_->filterBatch(ds, sel);
+            }
+            return;
+        }
+        case Type::EXP_LOGICAL_OR: {
+            // The result is null unless both sides are bool, so only the rows on
+            // which the lhs is a bool are evaluated by the rhs
+            std::vector<Value> lhs;
+            lhs_->evalBatch(ds, sel, lhs);
+            Selection bools;
+            std::vector<uint8_t> lhsTrue;
+            for (size_t i = 0; i < sel.size(); i++) {
+                if (lhs[i].type() == Value::Type::BOOL) {
+                    bools.emplace_back(sel[i]);
+                    lhsTrue.emplace_back(lhs[i].getBool());
+                }
+            }
+            sel.clear();
+            if (bools.empty()) {
+                return;
+            }
+            std::vector<Value> rhs;
+            rhs_->evalBatch(ds, bools, rhs);
+            for (size_t i = 0; i < bools.size(); i++) {
+                if (rhs[i].type() == Value::Type::BOOL && (lhsTrue[i] || rhs[i].getBool())) {
+                    sel.emplace_back(bools[i]);
+                }
+            }
+            return;
+        }
+        default: {
+            Expression::filterBatch(ds, sel);
+            return;
+        }
+    }
+}
 }  // namespace nebula
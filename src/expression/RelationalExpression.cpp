@@ -7,26 +7,82 @@
 #include "expression/RelationalExpression.h"
 
 namespace nebula {
-Value RelationalExpression::eval() const {
-    auto lhs = lhs_->eval();
-    auto rhs = rhs_->eval();
+Value RelationalExpression::eval(const ExpressionContext& ctx) const {
+    auto lhs = lhs_->eval(ctx);
+    auto rhs = rhs_->eval(ctx);
 
     switch (type_) {
         case Type::EXP_REL_EQ:
-            return lhs_ == rhs_;
+            return lhs == rhs;
         case Type::EXP_REL_NE:
-            return lhs_ != rhs_;
+            return lhs != rhs;
         case Type::EXP_REL_LT:
-            return lhs_ < rhs_;
+            return lhs < rhs;
         case Type::EXP_REL_LE:
-            return lhs_ <= rhs_;
+            return lhs <= rhs;
         case Type::EXP_REL_GT:
-            return lhs_ > rhs_;
+            return lhs > rhs;
         case Type::EXP_REL_GE:
-            return lhs_ >= rhs_;
+            return lhs >= rhs;
         default:
             break;
     }
     LOG(FATAL) << "Unknown type: " << type_;
 }
+
+void RelationalExpression::compareBatch(const DataSet& ds,
+                                        const Selection& sel,
+                                        std::vector<uint8_t>& mask) const {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    lhs_->evalBatch(ds, sel, lhs);
+    rhs_->evalBatch(ds, sel, rhs);
+    mask.resize(sel.size());
+    switch (type_) {
+        case Type::EXP_REL_EQ:
+            batch::compareEq(lhs.data(), rhs.data(), mask.data(), mask.size());
+            return;
+        case Type::EXP_REL_NE:
+            batch::compareNe(lhs.data(), rhs.data(), mask.data(), mask.size());
+            return;
+        case Type::EXP_REL_LT:
+            batch::compareLt(lhs.data(), rhs.data(), mask.data(), mask.size());
+            return;
+        case Type::EXP_REL_LE:
+            batch::compareLe(lhs.data(), rhs.data(), mask.data(), mask.size());
+            return;
+        case Type::EXP_REL_GT:
+            batch::compareGt(lhs.data(), rhs.data(), mask.data(), mask.size());
+            return;
+        case Type::EXP_REL_GE:
+            batch::compareGe(lhs.data(), rhs.data(), mask.data(), mask.size());
+            return;
+        default:
+            break;
+    }
+    LOG(FATAL) << "Unknown type: " << type_;
+}
+
+void RelationalExpression::evalBatch(const DataSet& ds,
+                                     const Selection& sel,
+                                     std::vector<Value>& out) const {
+    std::vector<uint8_t> mask;
+    compareBatch(ds, sel, mask);
+    out.resize(sel.size());
+    for (size_t i = 0; i < out.size(); i++) {
+        out[i].setBool(mask[i] != 0);
+    }
+}
+
+void RelationalExpression::filterBatch(const DataSet& ds, Selection& sel) const {
+    std::vector<uint8_t> mask;
+    compareBatch(ds, sel, mask);
+    size_t n = 0;
+    for (size_t i = 0; i < sel.size(); i++) {
+        if (mask[i]) {
+            sel[n++] = sel[i];
+        }
+    }
+    sel.resize(n);
+}
 }  // namespace nebula
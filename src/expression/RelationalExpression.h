@@ -20,24 +20,36 @@ public:
         rhs_.reset(rhs);
     }
 
-    Value eval() const override;
+    Value eval(const ExpressionContext& ctx) const override;
 
-    std::string encode() const override {
+    void evalBatch(const DataSet& ds,
+                   const Selection& sel,
+                   std::vector<Value>& out) const override;
+
+    void filterBatch(const DataSet& ds, Selection& sel) const override;
+
+    std::string toString() const override {
         // TODO
         return "";
     }
 
-    std::string decode() const override {
-        // TODO
-        return "";
+    const Expression* lhs() const {
+        return lhs_.get();
     }
 
-    std::string toString() const override {
-        // TODO
-        return "";
+    const Expression* rhs() const {
+        return rhs_.get();
     }
 
 private:
+    // mask[i] is the comparison on the row sel[i]
+    void compareBatch(const DataSet& ds,
+                      const Selection& sel,
+                      std::vector<uint8_t>& mask) const;
+
+private:
+    friend class ExpressionSimplifier;
+
     std::unique_ptr<Expression>                 lhs_;
     std::unique_ptr<Expression>                 rhs_;
 };
@@ -7,9 +7,94 @@
 #include "expression/TypeCastingExpression.h"
 
 namespace nebula {
-Value TypeCastingExpression::eval() const {
-    // TODO:
-    UNUSED(vType_);
-    return Value(NullType::NaN);
+
+Value TypeCastingExpression::cast(const Value& val, Value::Type vType) {
+    if (val.isNull() || val.type() == vType) {
+        return val;
+    }
+
+    switch (vType) {
+        case Value::Type::BOOL: {
+            switch (val.type()) {
+                case Value::Type::INT:
+                    return val.getInt() != 0;
+                case Value::Type::FLOAT:
+                    return val.getFloat() != 0.0;
+                case Value::Type::STRING: {
+                    auto res = folly::tryTo<bool>(val.getStr());
+                    if (res.hasValue()) {
+                        return res.value();
+                    }
+                    return Value(NullType::BAD_DATA);
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case Value::Type::INT: {
+            switch (val.type()) {
+                case Value::Type::BOOL:
+                    return static_cast<int64_t>(val.getBool());
+                case Value::Type::FLOAT: {
+                    auto f = val.getFloat();
+                    // Out of the range, or NaN
+                    if (!(f >= -9223372036854775808.0 && f < 9223372036854775808.0)) {
+                        return Value(NullType::ERR_OVERFLOW);
+                    }
+                    return static_cast<int64_t>(f);
+                }
+                case Value::Type::STRING: {
+                    auto res = folly::tryTo<int64_t>(val.getStr());
+                    if (res.hasValue()) {
+                        return res.value();
+                    }
+                    return Value(NullType::BAD_DATA);
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case Value::Type::FLOAT: {
+            switch (val.type()) {
+                case Value::Type::BOOL:
+                    return static_cast<double>(val.getBool());
+                case Value::Type::INT:
+                    return static_cast<double>(val.getInt());
+                case Value::Type::STRING: {
+                    auto res = folly::tryTo<double>(val.getStr());
+                    if (res.hasValue()) {
+                        return res.value();
+                    }
+                    return Value(NullType::BAD_DATA);
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case Value::Type::STRING: {
+            switch (val.type()) {
+                case Value::Type::BOOL:
+                    return val.getBool() ? "true" : "false";
+                case Value::Type::INT:
+                    return folly::to<std::string>(val.getInt());
+                case Value::Type::FLOAT:
+                    return folly::to<std::string>(val.getFloat());
+                default:
+                    break;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return Value(NullType::BAD_TYPE);
+}
+
+
+Value TypeCastingExpression::eval(const ExpressionContext& ctx) const {
+    return cast(operand_->eval(ctx), vType_);
 }
 }  // namespace nebula
@@ -18,24 +18,28 @@ public:
         operand_.reset(operand);
     }
 
-    Value eval() const override;
+    Value eval(const ExpressionContext& ctx) const override;
 
-    std::string encode() const override {
+    // Cast the value to the type, null stays the null, and the value which
+    // can not be cast is a null of BAD_DATA, BAD_TYPE or ERR_OVERFLOW
+    static Value cast(const Value& val, Value::Type vType);
+
+    std::string toString() const override {
         // TODO
         return "";
     }
 
-    std::string decode() const override {
-        // TODO
-        return "";
+    Value::Type targetType() const {
+        return vType_;
     }
 
-    std::string toString() const override {
-        // TODO
-        return "";
+    const Expression* operand() const {
+        return operand_.get();
     }
 
 private:
+    friend class ExpressionSimplifier;
+
     Value::Type                                 vType_;
     std::unique_ptr<Expression>                 operand_;
 };
@@ -7,7 +7,8 @@
 #include "expression/UUIDExpression.h"
 
 namespace nebula {
-Value UUIDExpression::eval() const {
+Value UUIDExpression::eval(const ExpressionContext& ctx) const {
+    UNUSED(ctx);
     // TODO
     return Value(NullType::NaN);
 }
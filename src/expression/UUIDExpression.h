@@ -16,23 +16,16 @@ public:
         field_.reset(field);
     }
 
-    Value eval() const override;
-
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
-
-    std::string decode() const override {
-        // TODO
-        return "";
-    }
+    Value eval(const ExpressionContext& ctx) const override;
 
     std::string toString() const override {
         // TODO
         return "";
     }
 
+    const std::string& field() const {
+        return *field_;
+    }
 
 private:
     std::unique_ptr<std::string>                field_;
@@ -7,17 +7,40 @@
 #include "expression/UnaryExpression.h"
 
 namespace nebula {
-Value UnaryExpression::eval() const {
+Value UnaryExpression::eval(const ExpressionContext& ctx) const {
    switch (type_) {
        case Type::EXP_UNARY_PLUS:
-           return operand_->eval();
+           return operand_->eval(ctx);
        case Type::EXP_UNARY_NEGATE:
-           return -(operand_->eval());
+           return -(operand_->eval(ctx));
        case Type::EXP_UNARY_NOT:
-           return !(operand_->eval());
+           return !(operand_->eval(ctx));
        default:
            break;
    }
    LOG(FATAL) << "Unknown type: " << type_;
 }
+
+void UnaryExpression::evalBatch(const DataSet& ds,
+                                const Selection& sel,
+                                std::vector<Value>& out) const {
+    operand_->evalBatch(ds, sel, out);
+    switch (type_) {
+        case Type::EXP_UNARY_PLUS:
+            return;
+        case Type::EXP_UNARY_NEGATE:
+            for (auto& v : out) {
+                v = -v;
+            }
+            return;
+        case Type::EXP_UNARY_NOT:
+            for (auto& v : out) {
+                v = !v;
+            }
+            return;
+        default:
+            break;
+    }
+    LOG(FATAL) << "Unknown type: " << type_;
+}
 }  // namespace nebula
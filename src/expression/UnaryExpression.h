@@ -17,24 +17,24 @@ public:
         operand_.reset(operand);
     }
 
-    Value eval() const override;
+    Value eval(const ExpressionContext& ctx) const override;
 
-    std::string encode() const override {
-        // TODO
-        return "";
-    }
+    void evalBatch(const DataSet& ds,
+                   const Selection& sel,
+                   std::vector<Value>& out) const override;
 
-    std::string decode() const override {
+    std::string toString() const override {
         // TODO
         return "";
     }
 
-    std::string toString() const override {
-        // TODO
-        return "";
+    const Expression* operand() const {
+        return operand_.get();
     }
 
 private:
+    friend class ExpressionSimplifier;
+
     std::unique_ptr<Expression>                 operand_;
 };
 }  // namespace nebula
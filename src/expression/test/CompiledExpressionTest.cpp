@@ -0,0 +1,104 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "expression/CompiledExpression.h"
+#include "expression/ConstantExpression.h"
+#include "expression/ArithmeticExpression.h"
+#include "expression/UnaryExpression.h"
+#include "expression/RelationalExpression.h"
+#include "expression/LogicalExpression.h"
+#include "expression/AliasPropertyExpression.h"
+#include "expression/FunctionCallExpression.h"
+#include "expression/test/TestUtils.h"
+
+namespace nebula {
+
+TEST(CompiledExpression, SameAsTree) {
+    std::vector<std::unique_ptr<Expression>> exprs;
+    // $-.age > 30 && $-.score < 0.5
+    exprs.emplace_back(new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_AND,
+        new RelationalExpression(Expression::Type::EXP_REL_GT,
+                                 inputProp("age"),
+                                 new ConstantExpression(30)),
+        new RelationalExpression(Expression::Type::EXP_REL_LT,
+                                 inputProp("score"),
+                                 new ConstantExpression(0.5))));
+    // -(like.likeness + 10) * 2 >= $-.age % 7
+    exprs.emplace_back(new RelationalExpression(
+        Expression::Type::EXP_REL_GE,
+        new ArithmeticExpression(
+            Expression::Type::EXP_MULTIPLY,
+            new UnaryExpression(
+                Expression::Type::EXP_UNARY_NEGATE,
+                new ArithmeticExpression(
+                    Expression::Type::EXP_ADD,
+                    new AliasPropertyExpression(Expression::Type::EXP_ALIAS_PROPERTY,
+                                                new std::string(""),
+                                                new std::string("like"),
+                                                new std::string("likeness")),
+                    new ConstantExpression(10))),
+            new ConstantExpression(2)),
+        new ArithmeticExpression(Expression::Type::EXP_MOD,
+                                 inputProp("age"),
+                                 new ConstantExpression(7))));
+    // $-.name == "Tim" XOR !($-.score / $-.age <= 0.01)
+    exprs.emplace_back(new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_XOR,
+        new RelationalExpression(Expression::Type::EXP_REL_EQ,
+                                 inputProp("name"),
+                                 new ConstantExpression("Tim")),
+        new UnaryExpression(
+            Expression::Type::EXP_UNARY_NOT,
+            new RelationalExpression(
+                Expression::Type::EXP_REL_LE,
+                new ArithmeticExpression(Expression::Type::EXP_DIVIDE,
+                                         inputProp("score"),
+                                         inputProp("age")),
+                new ConstantExpression(0.01)))));
+    // +$-.unknown - f()
+    exprs.emplace_back(new ArithmeticExpression(
+        Expression::Type::EXP_MINUS,
+        new UnaryExpression(Expression::Type::EXP_UNARY_PLUS, inputProp("unknown")),
+        new FunctionCallExpression(new std::string("f"), new ArgumentList())));
+
+    auto ds = makeDataSet();
+    EdgeColumnsContext ctx(&ds);
+    for (auto& expr : exprs) {
+        CompiledExpression byNames(expr.get());
+        CompiledExpression bySlots(expr.get());
+        bySlots.bind(ctx);
+        for (size_t i = 0; i < ds.rows.size(); i++) {
+            ctx.setRow(i);
+            auto expected = expr->eval(ctx);
+            for (auto* compiled : {&byNames, &bySlots}) {
+                auto& actual = compiled->eval(ctx);
+                ASSERT_EQ(expected.type(), actual.type()) << "row " << i;
+                if (expected.isNull()) {
+                    ASSERT_EQ(expected.getNull(), actual.getNull()) << "row " << i;
+                } else {
+                    ASSERT_EQ(expected, actual) << "row " << i;
+                }
+            }
+        }
+    }
+
+    // The unary plus takes no instruction
+    EXPECT_EQ(3, CompiledExpression(exprs.back().get()).size());
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
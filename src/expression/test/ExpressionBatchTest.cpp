@@ -0,0 +1,116 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "context/DataSetContext.h"
+#include "expression/ConstantExpression.h"
+#include "expression/ArithmeticExpression.h"
+#include "expression/UnaryExpression.h"
+#include "expression/RelationalExpression.h"
+#include "expression/LogicalExpression.h"
+#include "expression/AliasPropertyExpression.h"
+#include "expression/TypeCastingExpression.h"
+#include "expression/test/TestUtils.h"
+
+namespace nebula {
+
+Expression* compare(Expression::Type type, const char* prop, Value v) {
+    return new RelationalExpression(type, inputProp(prop), new ConstantExpression(std::move(v)));
+}
+
+TEST(ExpressionBatch, SameAsRows) {
+    std::vector<std::unique_ptr<Expression>> exprs;
+    // $-.age > 30 && $-.score < 0.5
+    exprs.emplace_back(new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_AND,
+        compare(Expression::Type::EXP_REL_GT, "age", 30),
+        compare(Expression::Type::EXP_REL_LT, "score", 0.5)));
+    // $-.flag || $-.name == "Tim", where the flag may be null
+    exprs.emplace_back(new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_OR,
+        inputProp("flag"),
+        compare(Expression::Type::EXP_REL_EQ, "name", "Tim")));
+    // !($-.score * 100 - $-.age >= $-.age % 7) XOR $-.flag
+    exprs.emplace_back(new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_XOR,
+        new UnaryExpression(
+            Expression::Type::EXP_UNARY_NOT,
+            new RelationalExpression(
+                Expression::Type::EXP_REL_GE,
+                new ArithmeticExpression(
+                    Expression::Type::EXP_MINUS,
+                    new ArithmeticExpression(Expression::Type::EXP_MULTIPLY,
+                                             inputProp("score"),
+                                             new ConstantExpression(100)),
+                    inputProp("age")),
+                new ArithmeticExpression(Expression::Type::EXP_MOD,
+                                         inputProp("age"),
+                                         new ConstantExpression(7)))),
+        inputProp("flag")));
+    // -($-.age / $-.unknown) != +$-.score, and a node evaluated by rows
+    exprs.emplace_back(new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_OR,
+        new RelationalExpression(
+            Expression::Type::EXP_REL_NE,
+            new UnaryExpression(Expression::Type::EXP_UNARY_NEGATE,
+                                new ArithmeticExpression(Expression::Type::EXP_DIVIDE,
+                                                         inputProp("age"),
+                                                         inputProp("unknown"))),
+            new UnaryExpression(Expression::Type::EXP_UNARY_PLUS, inputProp("score"))),
+        new TypeCastingExpression(Value::Type::BOOL, inputProp("flag"))));
+
+    auto ds = makeDataSet();
+    DataSetContext ctx(&ds);
+    for (auto& expr : exprs) {
+        std::vector<Value> expected;
+        Expression::Selection expectedSel;
+        for (size_t i = 0; i < ds.rows.size(); i++) {
+            ctx.setRow(i);
+            expected.emplace_back(expr->eval(ctx));
+            if (expected.back() == Value(true)) {
+                expectedSel.emplace_back(i);
+            }
+        }
+
+        for (size_t batch : {1, 7, 64, 200}) {
+            Expression::Selection filtered;
+            for (size_t start = 0; start < ds.rows.size(); start += batch) {
+                Expression::Selection sel;
+                for (size_t i = start; i < std::min(start + batch, ds.rows.size()); i++) {
+                    sel.emplace_back(i);
+                }
+                std::vector<Value> out;
+                expr->evalBatch(ds, sel, out);
+                ASSERT_EQ(sel.size(), out.size());
+                for (size_t i = 0; i < sel.size(); i++) {
+                    auto& exp = expected[sel[i]];
+                    ASSERT_EQ(exp.type(), out[i].type()) << "row " << sel[i];
+                    if (exp.isNull()) {
+                        ASSERT_EQ(exp.getNull(), out[i].getNull()) << "row " << sel[i];
+                    } else {
+                        ASSERT_EQ(exp, out[i]) << "row " << sel[i];
+                    }
+                }
+
+                expr->filterBatch(ds, sel);
+                filtered.insert(filtered.end(), sel.begin(), sel.end());
+            }
+            EXPECT_EQ(expectedSel, filtered) << "batch " << batch;
+        }
+    }
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,282 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <random>
+#include "expression/CompiledExpression.h"
+#include "expression/ExpressionSimplifier.h"
+#include "expression/ConstantExpression.h"
+#include "expression/ArithmeticExpression.h"
+#include "expression/RelationalExpression.h"
+#include "expression/LogicalExpression.h"
+#include "expression/AliasPropertyExpression.h"
+#include "expression/TypeCastingExpression.h"
+#include "context/DataSetContext.h"
+#include "expression/test/TestUtils.h"
+
+DEFINE_int64(rows, 100000, "The number of rows filtered");
+
+using nebula::Value;
+using nebula::Row;
+using nebula::DataSet;
+using nebula::DataSetContext;
+using nebula::Expression;
+using nebula::CompiledExpression;
+using nebula::ConstantExpression;
+using nebula::ArithmeticExpression;
+using nebula::RelationalExpression;
+using nebula::LogicalExpression;
+using nebula::InputPropertyExpression;
+using nebula::TypeCastingExpression;
+using nebula::ExpressionSimplifier;
+using nebula::inputProp;
+
+const DataSet& dataSet() {
+    static const DataSet ds = [] () {
+        DataSet d;
+        d.colNames = {"vid", "name", "age", "score", "likeness"};
+        std::mt19937 rng(0);
+        for (int64_t i = 0; i < FLAGS_rows; i++) {
+            Row row;
+            row.columns.emplace_back(static_cast<int64_t>(rng()));
+            row.columns.emplace_back(folly::stringPrintf("name_%u", rng() % 1000));
+            row.columns.emplace_back(static_cast<int64_t>(rng() % 100));
+            row.columns.emplace_back(static_cast<double>(rng()) / rng.max());
+            row.columns.emplace_back(static_cast<int64_t>(rng() % 100));
+            d.rows.emplace_back(std::move(row));
+        }
+        return d;
+    }();
+    return ds;
+}
+
+// WHERE $-.age > 30 AND $-.score < 0.5
+const Expression* simpleFilter() {
+    static const std::unique_ptr<Expression> expr(new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_AND,
+        new RelationalExpression(Expression::Type::EXP_REL_GT,
+                                 inputProp("age"),
+                                 new ConstantExpression(30)),
+        new RelationalExpression(Expression::Type::EXP_REL_LT,
+                                 inputProp("score"),
+                                 new ConstantExpression(0.5))));
+    return expr.get();
+}
+
+// WHERE ($-.likeness + 10) * 2 >= $-.age OR $-.name == "name_1"
+const Expression* arithmeticFilter() {
+    static const std::unique_ptr<Expression> expr(new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_OR,
+        new RelationalExpression(
+            Expression::Type::EXP_REL_GE,
+            new ArithmeticExpression(
+                Expression::Type::EXP_MULTIPLY,
+                new ArithmeticExpression(Expression::Type::EXP_ADD,
+                                         inputProp("likeness"),
+                                         new ConstantExpression(10)),
+                new ConstantExpression(2)),
+            inputProp("age")),
+        new RelationalExpression(Expression::Type::EXP_REL_EQ,
+                                 inputProp("name"),
+                                 new ConstantExpression("name_1"))));
+    return expr.get();
+}
+
+// WHERE $-.age > 10 + 20 AND true AND $-.score < cast("0.5" AS float)
+Expression* makeConstantFilter() {
+    return new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_AND,
+        new LogicalExpression(
+            Expression::Type::EXP_LOGICAL_AND,
+            new RelationalExpression(Expression::Type::EXP_REL_GT,
+                                     inputProp("age"),
+                                     new ArithmeticExpression(Expression::Type::EXP_ADD,
+                                                              new ConstantExpression(10),
+                                                              new ConstantExpression(20))),
+            new ConstantExpression(true)),
+        new RelationalExpression(
+            Expression::Type::EXP_REL_LT,
+            inputProp("score"),
+            new TypeCastingExpression(Value::Type::FLOAT, new ConstantExpression("0.5"))));
+}
+
+const Expression* constantFilter() {
+    static const std::unique_ptr<Expression> expr(makeConstantFilter());
+    return expr.get();
+}
+
+// i.e. WHERE $-.age > 30 AND $-.score < 0.5
+const Expression* simplifiedFilter() {
+    static const std::unique_ptr<Expression> expr = [] () {
+        ExpressionSimplifier simplifier;
+        return simplifier.simplifyFilter(std::unique_ptr<Expression>(makeConstantFilter()));
+    }();
+    return expr.get();
+}
+
+size_t treeWalk(size_t iters, const Expression* expr) {
+    DataSetContext ctx(&dataSet());
+    size_t count = 0;
+    for (size_t i = 0; i < iters; i++) {
+        for (size_t row = 0; row < dataSet().rows.size(); row++) {
+            ctx.setRow(row);
+            count += expr->eval(ctx) == Value(true);
+        }
+    }
+    return count;
+}
+
+size_t compiled(size_t iters, const Expression* expr, bool bind) {
+    DataSetContext ctx(&dataSet());
+    CompiledExpression program(expr);
+    if (bind) {
+        program.bind(ctx);
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < iters; i++) {
+        for (size_t row = 0; row < dataSet().rows.size(); row++) {
+            ctx.setRow(row);
+            count += program.eval(ctx) == Value(true);
+        }
+    }
+    return count;
+}
+
+// Filter the data set a batch of rows at a time
+size_t batched(size_t iters, const Expression* expr, size_t batch) {
+    auto& ds = dataSet();
+    size_t count = 0;
+    Expression::Selection sel;
+    for (size_t i = 0; i < iters; i++) {
+        for (size_t start = 0; start < ds.rows.size(); start += batch) {
+            sel.clear();
+            for (size_t row = start; row < std::min(start + batch, ds.rows.size()); row++) {
+                sel.emplace_back(row);
+            }
+            expr->filterBatch(ds, sel);
+            count += sel.size();
+        }
+    }
+    return count;
+}
+
+void simpleBatch(size_t iters, size_t batch) {
+    folly::doNotOptimizeAway(batched(iters, simpleFilter(), batch));
+}
+
+void arithmeticBatch(size_t iters, size_t batch) {
+    folly::doNotOptimizeAway(batched(iters, arithmeticFilter(), batch));
+}
+
+BENCHMARK(simpleTreeWalk, iters) {
+    folly::doNotOptimizeAway(treeWalk(iters, simpleFilter()));
+}
+
+BENCHMARK_RELATIVE(simpleCompiledByNames, iters) {
+    folly::doNotOptimizeAway(compiled(iters, simpleFilter(), false));
+}
+
+BENCHMARK_RELATIVE(simpleCompiledBySlots, iters) {
+    folly::doNotOptimizeAway(compiled(iters, simpleFilter(), true));
+}
+
+BENCHMARK_RELATIVE_PARAM(simpleBatch, 16)
+BENCHMARK_RELATIVE_PARAM(simpleBatch, 64)
+BENCHMARK_RELATIVE_PARAM(simpleBatch, 256)
+BENCHMARK_RELATIVE_PARAM(simpleBatch, 1024)
+BENCHMARK_RELATIVE_PARAM(simpleBatch, 4096)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(arithmeticTreeWalk, iters) {
+    folly::doNotOptimizeAway(treeWalk(iters, arithmeticFilter()));
+}
+
+BENCHMARK_RELATIVE(arithmeticCompiledByNames, iters) {
+    folly::doNotOptimizeAway(compiled(iters, arithmeticFilter(), false));
+}
+
+BENCHMARK_RELATIVE(arithmeticCompiledBySlots, iters) {
+    folly::doNotOptimizeAway(compiled(iters, arithmeticFilter(), true));
+}
+
+BENCHMARK_RELATIVE_PARAM(arithmeticBatch, 16)
+BENCHMARK_RELATIVE_PARAM(arithmeticBatch, 64)
+BENCHMARK_RELATIVE_PARAM(arithmeticBatch, 256)
+BENCHMARK_RELATIVE_PARAM(arithmeticBatch, 1024)
+BENCHMARK_RELATIVE_PARAM(arithmeticBatch, 4096)
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(constantTreeWalk, iters) {
+    folly::doNotOptimizeAway(treeWalk(iters, constantFilter()));
+}
+
+BENCHMARK_RELATIVE(simplifiedTreeWalk, iters) {
+    folly::doNotOptimizeAway(treeWalk(iters, simplifiedFilter()));
+}
+
+BENCHMARK_RELATIVE(constantBatch, iters) {
+    folly::doNotOptimizeAway(batched(iters, constantFilter(), 1024));
+}
+
+BENCHMARK_RELATIVE(simplifiedBatch, iters) {
+    folly::doNotOptimizeAway(batched(iters, simplifiedFilter(), 1024));
+}
+
+BENCHMARK(simplify, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        std::unique_ptr<Expression> expr;
+        BENCHMARK_SUSPEND {
+            expr.reset(makeConstantFilter());
+        }
+        ExpressionSimplifier simplifier;
+        folly::doNotOptimizeAway(simplifier.simplifyFilter(std::move(expr)));
+    }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(encodeSimple, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(simpleFilter()->encode());
+    }
+}
+
+BENCHMARK(decodeSimple, iters) {
+    std::string encoded;
+    BENCHMARK_SUSPEND {
+        encoded = simpleFilter()->encode();
+    }
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(Expression::decode(encoded));
+    }
+}
+
+BENCHMARK(encodeArithmetic, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(arithmeticFilter()->encode());
+    }
+}
+
+BENCHMARK(decodeArithmetic, iters) {
+    std::string encoded;
+    BENCHMARK_SUSPEND {
+        encoded = arithmeticFilter()->encode();
+    }
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(Expression::decode(encoded));
+    }
+}
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    // Build the data set before running
+    dataSet();
+    folly::runBenchmarks();
+    return 0;
+}
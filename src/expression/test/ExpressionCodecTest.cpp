@@ -0,0 +1,222 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <folly/Varint.h>
+#include "context/DataSetContext.h"
+#include "datatypes/List.h"
+#include "datatypes/Map.h"
+#include "expression/ConstantExpression.h"
+#include "expression/ArithmeticExpression.h"
+#include "expression/UnaryExpression.h"
+#include "expression/RelationalExpression.h"
+#include "expression/LogicalExpression.h"
+#include "expression/AliasPropertyExpression.h"
+#include "expression/TypeCastingExpression.h"
+#include "expression/FunctionCallExpression.h"
+#include "expression/UUIDExpression.h"
+#include "expression/test/TestUtils.h"
+
+namespace nebula {
+
+// ($-.age + 1) * 2 > $-.score && !($-.name == "Tim") || $-.age % 3 != -1
+Expression* makeFilter() {
+    return new LogicalExpression(
+        Expression::Type::EXP_LOGICAL_OR,
+        new LogicalExpression(
+            Expression::Type::EXP_LOGICAL_AND,
+            new RelationalExpression(
+                Expression::Type::EXP_REL_GT,
+                new ArithmeticExpression(
+                    Expression::Type::EXP_MULTIPLY,
+                    new ArithmeticExpression(Expression::Type::EXP_ADD,
+                                             inputProp("age"),
+                                             new ConstantExpression(1)),
+                    new ConstantExpression(2)),
+                inputProp("score")),
+            new UnaryExpression(
+                Expression::Type::EXP_UNARY_NOT,
+                new RelationalExpression(Expression::Type::EXP_REL_EQ,
+                                         inputProp("name"),
+                                         new ConstantExpression("Tim")))),
+        new RelationalExpression(
+            Expression::Type::EXP_REL_NE,
+            new ArithmeticExpression(Expression::Type::EXP_MOD,
+                                     inputProp("age"),
+                                     new ConstantExpression(3)),
+            new UnaryExpression(Expression::Type::EXP_UNARY_NEGATE,
+                                new ConstantExpression(1))));
+}
+
+TEST(ExpressionCodec, SameEvaluation) {
+    DataSet ds;
+    ds.colNames = {"age", "score", "name"};
+    for (int64_t i = 0; i < 100; i++) {
+        Row row;
+        row.columns.emplace_back(i);
+        row.columns.emplace_back(i * 1.5);
+        row.columns.emplace_back(i % 4 == 0 ? "Tim" : "Tony");
+        ds.rows.emplace_back(std::move(row));
+    }
+
+    std::unique_ptr<Expression> expr(makeFilter());
+    auto encoded = expr->encode();
+    auto decoded = Expression::decode(encoded);
+    ASSERT_TRUE(decoded.ok()) << decoded.status();
+    auto copy = std::move(decoded).value();
+    EXPECT_EQ(encoded, copy->encode());
+
+    DataSetContext ctx(&ds);
+    for (size_t i = 0; i < ds.rows.size(); i++) {
+        ctx.setRow(i);
+        EXPECT_EQ(expr->eval(ctx), copy->eval(ctx)) << "row " << i;
+    }
+}
+
+TEST(ExpressionCodec, AllNodes) {
+    std::vector<std::unique_ptr<Expression>> exprs;
+    List list;
+    list.values = {1, 2.5, "three", NullType::NaN, Date(2020, 2, 29)};
+    Map map;
+    map.kvs.emplace("list", Value(List(list)));
+    DateTime dt;
+    dt.clear();
+    dt.year = 1999;
+    dt.month = 12;
+    dt.day = 31;
+    dt.hour = 23;
+    dt.microsec = 999999;
+    dt.timezone = -28800;
+    exprs.emplace_back(new ConstantExpression(Value()));
+    exprs.emplace_back(new ConstantExpression(std::numeric_limits<int64_t>::min()));
+    exprs.emplace_back(new ConstantExpression(-0.0));
+    exprs.emplace_back(new ConstantExpression(std::string("bin\0ary", 7)));
+    exprs.emplace_back(new ConstantExpression(std::move(dt)));
+    exprs.emplace_back(new ConstantExpression(std::move(list)));
+    exprs.emplace_back(new ConstantExpression(std::move(map)));
+    exprs.emplace_back(new TypeCastingExpression(Value::Type::STRING,
+                                                 new ConstantExpression(12)));
+    auto* args = new ArgumentList();
+    args->addArgument(inputProp("name"));
+    args->addArgument(new ConstantExpression(3));
+    exprs.emplace_back(new FunctionCallExpression(new std::string("substr"), args));
+    exprs.emplace_back(new FunctionCallExpression(new std::string("now"), new ArgumentList()));
+    exprs.emplace_back(new AliasPropertyExpression(Expression::Type::EXP_ALIAS_PROPERTY,
+                                                   new std::string("ref"),
+                                                   new std::string("alias"),
+                                                   new std::string("prop")));
+    exprs.emplace_back(new VariablePropertyExpression(new std::string("var"),
+                                                      new std::string("prop")));
+    exprs.emplace_back(new SourcePropertyExpression(new std::string("player"),
+                                                    new std::string("name")));
+    exprs.emplace_back(new DestPropertyExpression(new std::string("team"),
+                                                  new std::string("name")));
+    exprs.emplace_back(new EdgeSrcIdExpression(new std::string("like")));
+    exprs.emplace_back(new EdgeTypeExpression(new std::string("like")));
+    exprs.emplace_back(new EdgeRankExpression(new std::string("like")));
+    exprs.emplace_back(new EdgeDstIdExpression(new std::string("like")));
+    exprs.emplace_back(new UUIDExpression(new std::string("Tim")));
+    exprs.emplace_back(new LogicalExpression(Expression::Type::EXP_LOGICAL_XOR,
+                                             new ConstantExpression(true),
+                                             new UnaryExpression(
+                                                Expression::Type::EXP_UNARY_PLUS,
+                                                new ConstantExpression(false))));
+
+    for (auto& expr : exprs) {
+        auto encoded = expr->encode();
+        auto decoded = Expression::decode(encoded);
+        ASSERT_TRUE(decoded.ok()) << decoded.status();
+        auto copy = std::move(decoded).value();
+        EXPECT_EQ(expr->type(), copy->type());
+        EXPECT_EQ(encoded, copy->encode());
+    }
+
+    auto* constant = static_cast<const ConstantExpression*>(exprs[6].get());
+    auto copy = std::move(Expression::decode(constant->encode())).value();
+    EXPECT_EQ(constant->value(), static_cast<const ConstantExpression*>(copy.get())->value());
+}
+
+TEST(ExpressionCodec, InternNames) {
+    // $-.a_rather_long_property_name + ... + $-.a_rather_long_property_name
+    std::unique_ptr<Expression> expr(inputProp("a_rather_long_property_name"));
+    for (int i = 0; i < 100; i++) {
+        expr.reset(new ArithmeticExpression(Expression::Type::EXP_ADD,
+                                            expr.release(),
+                                            inputProp("a_rather_long_property_name")));
+    }
+    auto encoded = expr->encode();
+    // The name is written once, each node takes no more than two bytes
+    EXPECT_GT(400UL, encoded.size());
+}
+
+TEST(ExpressionCodec, DeepTree) {
+    // ------...------1, as deep as allowed
+    std::unique_ptr<Expression> expr(new ConstantExpression(1));
+    for (int i = 0; i < 511; i++) {
+        expr.reset(new UnaryExpression(Expression::Type::EXP_UNARY_NEGATE, expr.release()));
+    }
+    auto encoded = expr->encode();
+    auto decoded = Expression::decode(encoded);
+    ASSERT_TRUE(decoded.ok()) << decoded.status();
+    EXPECT_EQ(encoded, decoded.value()->encode());
+
+    // One more
+    expr.reset(new UnaryExpression(Expression::Type::EXP_UNARY_NEGATE, expr.release()));
+    EXPECT_FALSE(Expression::decode(expr->encode()).ok());
+
+    // A million nested nodes made by hand, refused without being built
+    constexpr uint64_t kNumNodes = 1000000;
+    uint8_t buf[folly::kMaxVarintLength64];
+    std::string hostile;
+    hostile.push_back(1);   // The version
+    hostile.push_back(0);   // No names
+    hostile.append(reinterpret_cast<const char*>(buf), folly::encodeVarint(kNumNodes, buf));
+    hostile.push_back(static_cast<char>(Expression::Type::EXP_CONSTANT));
+    hostile.push_back(static_cast<char>(Value::Type::INT));
+    hostile.push_back(2);   // ZigZag of 1
+    hostile.append(kNumNodes - 1, static_cast<char>(Expression::Type::EXP_UNARY_NEGATE));
+    auto refused = Expression::decode(hostile);
+    ASSERT_FALSE(refused.ok());
+    EXPECT_NE(std::string::npos, refused.status().toString().find("deeper"));
+}
+
+TEST(ExpressionCodec, Malformed) {
+    std::unique_ptr<Expression> expr(makeFilter());
+    auto encoded = expr->encode();
+
+    EXPECT_FALSE(Expression::decode("").ok());
+    // Truncated
+    for (size_t i = 0; i < encoded.size(); i++) {
+        EXPECT_FALSE(Expression::decode(folly::StringPiece(encoded.data(), i)).ok()) << i;
+    }
+    // Trailing bytes
+    EXPECT_FALSE(Expression::decode(encoded + '\0').ok());
+    // Unknown version
+    auto bad = encoded;
+    bad[0] = 2;
+    EXPECT_FALSE(Expression::decode(bad).ok());
+
+    // Corrupted bytes never crash, whether or not they are decoded
+    std::mt19937 rng(0);
+    for (int i = 0; i < 1000; i++) {
+        bad = encoded;
+        bad[rng() % bad.size()] = static_cast<char>(rng());
+        Expression::decode(bad);
+    }
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,258 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "context/DataSetContext.h"
+#include "expression/ExpressionSimplifier.h"
+#include "expression/ConstantExpression.h"
+#include "expression/ArithmeticExpression.h"
+#include "expression/UnaryExpression.h"
+#include "expression/RelationalExpression.h"
+#include "expression/LogicalExpression.h"
+#include "expression/AliasPropertyExpression.h"
+#include "expression/TypeCastingExpression.h"
+#include "expression/FunctionCallExpression.h"
+#include "expression/test/TestUtils.h"
+
+namespace nebula {
+
+Expression* constant(Value v) {
+    return new ConstantExpression(std::move(v));
+}
+
+Expression* logical(Expression::Type type, Expression* lhs, Expression* rhs) {
+    return new LogicalExpression(type, lhs, rhs);
+}
+
+Expression* relational(Expression::Type type, Expression* lhs, Expression* rhs) {
+    return new RelationalExpression(type, lhs, rhs);
+}
+
+Expression* arithmetic(Expression::Type type, Expression* lhs, Expression* rhs) {
+    return new ArithmeticExpression(type, lhs, rhs);
+}
+
+const Value& valueOf(const Expression* expr) {
+    CHECK(expr->type() == Expression::Type::EXP_CONSTANT);
+    return static_cast<const ConstantExpression*>(expr)->value();
+}
+
+TEST(ExpressionSimplifier, FoldConstants) {
+    ExpressionSimplifier simplifier;
+    // 1 + 2 * 3
+    auto expr = simplifier.simplify(std::unique_ptr<Expression>(
+        arithmetic(Expression::Type::EXP_ADD,
+                   constant(1),
+                   arithmetic(Expression::Type::EXP_MULTIPLY, constant(2), constant(3)))));
+    EXPECT_EQ(Value(7), valueOf(expr.get()));
+    EXPECT_EQ(2UL, simplifier.stats().folded);
+
+    // $-.i > -(10 / 2) keeps the property
+    expr = simplifier.simplify(std::unique_ptr<Expression>(
+        relational(Expression::Type::EXP_REL_GT,
+                   inputProp("i"),
+                   new UnaryExpression(
+                       Expression::Type::EXP_UNARY_NEGATE,
+                       arithmetic(Expression::Type::EXP_DIVIDE, constant(10), constant(2))))));
+    ASSERT_EQ(Expression::Type::EXP_REL_GT, expr->type());
+    auto* rel = static_cast<const RelationalExpression*>(expr.get());
+    EXPECT_EQ(Expression::Type::EXP_INPUT_PROPERTY, rel->lhs()->type());
+    EXPECT_EQ(Value(-5), valueOf(rel->rhs()));
+    EXPECT_EQ(4UL, simplifier.stats().folded);
+
+    // The errors are folded as they are evaluated
+    expr = simplifier.simplify(std::unique_ptr<Expression>(
+        arithmetic(Expression::Type::EXP_MOD, constant(1), constant(0))));
+    EXPECT_EQ(Value(NullType::DIV_BY_ZERO), valueOf(expr.get()));
+    EXPECT_EQ(0UL, simplifier.stats().identities);
+    EXPECT_EQ(0UL, simplifier.stats().casts);
+}
+
+TEST(ExpressionSimplifier, NotFolded) {
+    ExpressionSimplifier simplifier;
+    // The function call is kept, but its arguments are folded
+    auto* args = new ArgumentList();
+    args->addArgument(inputProp("i"));
+    args->addArgument(arithmetic(Expression::Type::EXP_ADD, constant(1), constant(2)));
+    auto expr = simplifier.simplify(std::unique_ptr<Expression>(
+        new FunctionCallExpression(new std::string("substr"), args)));
+    ASSERT_EQ(Expression::Type::EXP_FUNCTION_CALL, expr->type());
+    auto* call = static_cast<const FunctionCallExpression*>(expr.get());
+    EXPECT_EQ(Value(3), valueOf(call->args()->arg(1)));
+    EXPECT_EQ(1UL, simplifier.stats().folded);
+
+    // The XOR of a property
+    expr = simplifier.simplifyFilter(std::unique_ptr<Expression>(
+        logical(Expression::Type::EXP_LOGICAL_XOR, constant(true), inputProp("b"))));
+    EXPECT_EQ(Expression::Type::EXP_LOGICAL_XOR, expr->type());
+    EXPECT_EQ(1UL, simplifier.stats().folded);
+    EXPECT_FALSE(simplifier.stats().identities);
+}
+
+TEST(ExpressionSimplifier, Casts) {
+    EXPECT_EQ(Value(12), TypeCastingExpression::cast("12", Value::Type::INT));
+    EXPECT_EQ(Value(NullType::BAD_DATA), TypeCastingExpression::cast("x", Value::Type::INT));
+    EXPECT_EQ(Value(2), TypeCastingExpression::cast(2.9, Value::Type::INT));
+    EXPECT_EQ(Value(NullType::ERR_OVERFLOW), TypeCastingExpression::cast(1e19, Value::Type::INT));
+    EXPECT_EQ(Value(0.5), TypeCastingExpression::cast("0.5", Value::Type::FLOAT));
+    EXPECT_EQ(Value("true"), TypeCastingExpression::cast(true, Value::Type::STRING));
+    EXPECT_EQ(Value(false), TypeCastingExpression::cast(0, Value::Type::BOOL));
+    EXPECT_EQ(Value(NullType::NaN), TypeCastingExpression::cast(NullType::NaN, Value::Type::INT));
+    EXPECT_EQ(Value(NullType::BAD_TYPE),
+              TypeCastingExpression::cast(Date(2020, 2, 29), Value::Type::INT));
+
+    ExpressionSimplifier simplifier;
+    // $-.i < cast("0.5" as float)
+    auto expr = simplifier.simplify(std::unique_ptr<Expression>(
+        relational(Expression::Type::EXP_REL_LT,
+                   inputProp("i"),
+                   new TypeCastingExpression(Value::Type::FLOAT, constant("0.5")))));
+    ASSERT_EQ(Expression::Type::EXP_REL_LT, expr->type());
+    EXPECT_EQ(Value(0.5), valueOf(static_cast<const RelationalExpression*>(expr.get())->rhs()));
+    EXPECT_EQ(1UL, simplifier.stats().casts);
+
+    // cast(cast($-.i as string) as string)
+    expr = simplifier.simplify(std::unique_ptr<Expression>(
+        new TypeCastingExpression(
+            Value::Type::STRING,
+            new TypeCastingExpression(Value::Type::STRING, inputProp("i")))));
+    ASSERT_EQ(Expression::Type::EXP_TYPE_CASTING, expr->type());
+    auto* casting = static_cast<const TypeCastingExpression*>(expr.get());
+    EXPECT_EQ(Expression::Type::EXP_INPUT_PROPERTY, casting->operand()->type());
+    EXPECT_EQ(2UL, simplifier.stats().casts);
+
+    // cast($-.i == 1 as bool)
+    expr = simplifier.simplify(std::unique_ptr<Expression>(
+        new TypeCastingExpression(
+            Value::Type::BOOL,
+            relational(Expression::Type::EXP_REL_EQ, inputProp("i"), constant(1)))));
+    EXPECT_EQ(Expression::Type::EXP_REL_EQ, expr->type());
+    EXPECT_EQ(3UL, simplifier.stats().casts);
+}
+
+TEST(ExpressionSimplifier, BooleanIdentities) {
+    ExpressionSimplifier simplifier;
+    // true AND $-.b is null of BAD_TYPE when $-.b is an int, so it is only
+    // simplified in a filter
+    auto expr = simplifier.simplify(std::unique_ptr<Expression>(
+        logical(Expression::Type::EXP_LOGICAL_AND, constant(true), inputProp("b"))));
+    EXPECT_EQ(Expression::Type::EXP_LOGICAL_AND, expr->type());
+    EXPECT_FALSE(simplifier.stats().changed());
+    expr = simplifier.simplifyFilter(std::move(expr));
+    EXPECT_EQ(Expression::Type::EXP_INPUT_PROPERTY, expr->type());
+    EXPECT_EQ(1UL, simplifier.stats().identities);
+
+    // $-.i > 1 OR false
+    expr = simplifier.simplify(std::unique_ptr<Expression>(
+        logical(Expression::Type::EXP_LOGICAL_OR,
+                relational(Expression::Type::EXP_REL_GT, inputProp("i"), constant(1)),
+                constant(false))));
+    EXPECT_EQ(Expression::Type::EXP_REL_GT, expr->type());
+    EXPECT_EQ(2UL, simplifier.stats().identities);
+
+    // true OR $-.i > 1
+    expr = simplifier.simplify(std::unique_ptr<Expression>(
+        logical(Expression::Type::EXP_LOGICAL_OR,
+                constant(true),
+                relational(Expression::Type::EXP_REL_GT, inputProp("i"), constant(1)))));
+    EXPECT_EQ(Value(true), valueOf(expr.get()));
+    EXPECT_EQ(3UL, simplifier.stats().identities);
+
+    // $-.i > 1 AND (false AND $-.b) in a filter
+    expr = simplifier.simplifyFilter(std::unique_ptr<Expression>(
+        logical(Expression::Type::EXP_LOGICAL_AND,
+                relational(Expression::Type::EXP_REL_GT, inputProp("i"), constant(1)),
+                logical(Expression::Type::EXP_LOGICAL_AND, constant(false), inputProp("b")))));
+    EXPECT_EQ(Value(false), valueOf(expr.get()));
+    EXPECT_EQ(5UL, simplifier.stats().identities);
+
+    // NOT NOT ($-.i == +1)
+    expr = simplifier.simplify(std::unique_ptr<Expression>(
+        new UnaryExpression(
+            Expression::Type::EXP_UNARY_NOT,
+            new UnaryExpression(
+                Expression::Type::EXP_UNARY_NOT,
+                relational(Expression::Type::EXP_REL_EQ,
+                           inputProp("i"),
+                           new UnaryExpression(Expression::Type::EXP_UNARY_PLUS,
+                                               constant(1)))))));
+    EXPECT_EQ(Expression::Type::EXP_REL_EQ, expr->type());
+    EXPECT_EQ(6UL, simplifier.stats().identities);
+}
+
+TEST(ExpressionSimplifier, SameEvaluation) {
+    using Factory = std::function<Expression*()>;
+    std::vector<Factory> factories;
+    auto rel = [] () {
+        return relational(Expression::Type::EXP_REL_GE, inputProp("i"), constant(0));
+    };
+    std::vector<Value> constants = {true, false, Value(NullType::__NULL__), 1};
+    for (auto type : {Expression::Type::EXP_LOGICAL_AND,
+                      Expression::Type::EXP_LOGICAL_OR,
+                      Expression::Type::EXP_LOGICAL_XOR}) {
+        for (auto& c : constants) {
+            factories.emplace_back([=] () {
+                return logical(type, constant(c), inputProp("b"));
+            });
+            factories.emplace_back([=] () {
+                return logical(type, inputProp("b"), constant(c));
+            });
+            factories.emplace_back([=] () {
+                return logical(type, constant(c), rel());
+            });
+            factories.emplace_back([=] () {
+                return logical(type, rel(), constant(c));
+            });
+            factories.emplace_back([=] () {
+                return new UnaryExpression(Expression::Type::EXP_UNARY_NOT,
+                                           logical(type, constant(c), rel()));
+            });
+            factories.emplace_back([=] () {
+                return logical(Expression::Type::EXP_LOGICAL_AND,
+                               inputProp("b"),
+                               logical(type, constant(c), inputProp("b")));
+            });
+        }
+    }
+    factories.emplace_back([] () {
+        return new UnaryExpression(
+            Expression::Type::EXP_UNARY_NOT,
+            new UnaryExpression(Expression::Type::EXP_UNARY_NOT, inputProp("b")));
+    });
+    factories.emplace_back([] () {
+        return new TypeCastingExpression(
+            Value::Type::INT,
+            new TypeCastingExpression(Value::Type::INT, inputProp("b")));
+    });
+
+    auto ds = makeDataSet();
+    DataSetContext ctx(&ds);
+    for (size_t i = 0; i < factories.size(); i++) {
+        std::unique_ptr<Expression> expr(factories[i]());
+        ExpressionSimplifier simplifier;
+        auto value = simplifier.simplify(std::unique_ptr<Expression>(factories[i]()));
+        auto filter = simplifier.simplifyFilter(std::unique_ptr<Expression>(factories[i]()));
+        for (size_t row = 0; row < ds.rows.size(); row++) {
+            ctx.setRow(row);
+            auto expected = expr->eval(ctx);
+            EXPECT_EQ(expected, value->eval(ctx)) << "expression " << i << ", row " << row;
+            EXPECT_EQ(expected == Value(true), filter->eval(ctx) == Value(true))
+                << "expression " << i << ", row " << row;
+        }
+    }
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
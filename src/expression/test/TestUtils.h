@@ -0,0 +1,76 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_EXPRESSION_TEST_TESTUTILS_H_
+#define COMMON_EXPRESSION_TEST_TESTUTILS_H_
+
+#include "base/Base.h"
+#include "context/DataSetContext.h"
+#include "expression/AliasPropertyExpression.h"
+
+namespace nebula {
+
+inline Expression* inputProp(const char* prop) {
+    return new InputPropertyExpression(new std::string(prop));
+}
+
+// 200 rows of the columns below, with nulls in between:
+//   age            an int
+//   score          a float or null
+//   name           "Tim" or "Tony"
+//   flag           a bool or null
+//   like.likeness  an int, as the edge property of EdgeColumnsContext
+//   b, i           every pair of a bool, null or an int, and an int or null
+inline DataSet makeDataSet() {
+    const std::vector<Value> bs = {true, false, Value(NullType::__NULL__), 1};
+    const std::vector<Value> is = {0, 7, -3, Value(NullType::__NULL__)};
+    DataSet ds;
+    ds.colNames = {"age", "score", "name", "flag", "like.likeness", "b", "i"};
+    for (int64_t i = 0; i < 200; i++) {
+        Row row;
+        row.columns.emplace_back(i % 50);
+        if (i % 9 == 0) {
+            row.columns.emplace_back(NullType::__NULL__);
+        } else {
+            row.columns.emplace_back(i / 100.0);
+        }
+        row.columns.emplace_back(i % 3 == 0 ? "Tim" : "Tony");
+        if (i % 5 == 0) {
+            row.columns.emplace_back(NullType::__NULL__);
+        } else {
+            row.columns.emplace_back(i % 2 == 0);
+        }
+        row.columns.emplace_back(i % 7);
+        row.columns.emplace_back(bs[i % bs.size()]);
+        row.columns.emplace_back(is[i / bs.size() % is.size()]);
+        ds.rows.emplace_back(std::move(row));
+    }
+    return ds;
+}
+
+// Besides the input properties, the edge properties are the columns named
+// edge.prop_name
+class EdgeColumnsContext final : public DataSetContext {
+public:
+    explicit EdgeColumnsContext(const DataSet* ds) : DataSetContext(ds) {}
+
+    const Value& getEdgeProp(const std::string& edge, const std::string& prop) const override {
+        return getInputProp(edge + "." + prop);
+    }
+
+    int32_t resolveProp(PropKind kind,
+                        const std::string& alias,
+                        const std::string& prop) const override {
+        if (kind == PropKind::EDGE) {
+            return column(alias + "." + prop);
+        }
+        return DataSetContext::resolveProp(kind, alias, prop);
+    }
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_EXPRESSION_TEST_TESTUTILS_H_
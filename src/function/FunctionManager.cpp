@@ -0,0 +1,266 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "function/FunctionManager.h"
+#include <time.h>
+
+namespace nebula {
+
+namespace {
+
+// Set the result to the first null argument, if any
+bool nullArg(const Value* args, size_t numArgs, Value& result) {
+    for (size_t i = 0; i < numArgs; i++) {
+        if (args[i].isNull()) {
+            result.setNull(args[i].getNull());
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool toFloat(const Value& val, double& out) {
+    switch (val.type()) {
+        case Value::Type::INT:
+            out = static_cast<double>(val.getInt());
+            return true;
+        case Value::Type::FLOAT:
+            out = val.getFloat();
+            return true;
+        default:
+            return false;
+    }
+}
+
+
+void setFloat(double v, Value& result) {
+    if (std::isnan(v)) {
+        result.setNull(NullType::NaN);
+    } else {
+        result.setFloat(v);
+    }
+}
+
+
+// The functions of one float, e.g. floor(x)
+template <typename F>
+void callMath(const Value* args, size_t numArgs, Value& result, F f) {
+    if (nullArg(args, numArgs, result)) {
+        return;
+    }
+    double x;
+    if (!toFloat(args[0], x)) {
+        result.setNull(NullType::BAD_TYPE);
+        return;
+    }
+    setFloat(f(x), result);
+}
+
+
+// The functions of one string, e.g. lower(s)
+template <typename F>
+void callString(const Value* args, size_t numArgs, Value& result, F f) {
+    if (nullArg(args, numArgs, result)) {
+        return;
+    }
+    if (args[0].type() != Value::Type::STRING) {
+        result.setNull(NullType::BAD_TYPE);
+        return;
+    }
+    f(args[0].getStr(), result);
+}
+
+
+void funcAbs(const Value* args, size_t numArgs, Value& result) {
+    if (nullArg(args, numArgs, result)) {
+        return;
+    }
+    switch (args[0].type()) {
+        case Value::Type::INT: {
+            auto v = args[0].getInt();
+            if (v == std::numeric_limits<int64_t>::min()) {
+                result.setNull(NullType::ERR_OVERFLOW);
+            } else {
+                result.setInt(v < 0 ? -v : v);
+            }
+            return;
+        }
+        case Value::Type::FLOAT: {
+            result.setFloat(std::fabs(args[0].getFloat()));
+            return;
+        }
+        default:
+            break;
+    }
+    result.setNull(NullType::BAD_TYPE);
+}
+
+
+void funcPow(const Value* args, size_t numArgs, Value& result) {
+    if (nullArg(args, numArgs, result)) {
+        return;
+    }
+    double base;
+    double exp;
+    if (!toFloat(args[0], base) || !toFloat(args[1], exp)) {
+        result.setNull(NullType::BAD_TYPE);
+        return;
+    }
+    setFloat(std::pow(base, exp), result);
+}
+
+
+// substr(s, start[, length]), the start is counted from 0
+void funcSubstr(const Value* args, size_t numArgs, Value& result) {
+    if (nullArg(args, numArgs, result)) {
+        return;
+    }
+    if (args[0].type() != Value::Type::STRING
+            || args[1].type() != Value::Type::INT
+            || (numArgs == 3 && args[2].type() != Value::Type::INT)) {
+        result.setNull(NullType::BAD_TYPE);
+        return;
+    }
+    auto& str = args[0].getStr();
+    auto start = args[1].getInt();
+    auto length = numArgs == 3 ? args[2].getInt() : std::numeric_limits<int64_t>::max();
+    if (start < 0 || length < 0) {
+        result.setNull(NullType::BAD_DATA);
+        return;
+    }
+    if (static_cast<uint64_t>(start) >= str.size()) {
+        result.setStr("");
+        return;
+    }
+    auto size = std::min(static_cast<uint64_t>(length), str.size() - start);
+    result.setStr(folly::StringPiece(str.data() + start, size));
+}
+
+
+void funcHash(const Value* args, size_t numArgs, Value& result) {
+    if (nullArg(args, numArgs, result)) {
+        return;
+    }
+    result.setInt(static_cast<int64_t>(std::hash<Value>()(args[0])));
+}
+
+
+void funcNow(const Value* args, size_t numArgs, Value& result) {
+    UNUSED(args);
+    UNUSED(numArgs);
+    // Not time::WallClock, whose calibration thread the registry needn't
+    // depend on, while time() is served by the vDSO anyway
+    result.setInt(static_cast<int64_t>(::time(nullptr)));
+}
+
+
+// timestamp(x), the seconds since the epoch of an int, or of a string of
+// "%Y-%m-%d %H:%M:%S" in UTC
+void funcTimestamp(const Value* args, size_t numArgs, Value& result) {
+    if (nullArg(args, numArgs, result)) {
+        return;
+    }
+    switch (args[0].type()) {
+        case Value::Type::INT: {
+            if (args[0].getInt() < 0) {
+                result.setNull(NullType::BAD_DATA);
+            } else {
+                result.setInt(args[0].getInt());
+            }
+            return;
+        }
+        case Value::Type::STRING: {
+            struct tm tm;
+            ::memset(&tm, 0, sizeof(tm));
+            auto* end = ::strptime(args[0].getStr().c_str(), "%Y-%m-%d %H:%M:%S", &tm);
+            if (end == nullptr || *end != '\0') {
+                result.setNull(NullType::BAD_DATA);
+            } else {
+                result.setInt(static_cast<int64_t>(::timegm(&tm)));
+            }
+            return;
+        }
+        default:
+            break;
+    }
+    result.setNull(NullType::BAD_TYPE);
+}
+
+}  // namespace
+
+
+FunctionManager::FunctionManager() {
+    functions_ = {
+        {"abs", {&funcAbs, 1, 1}},
+        {"floor", {[] (const Value* args, size_t numArgs, Value& result) {
+            callMath(args, numArgs, result, [] (double x) { return std::floor(x); });
+        }, 1, 1}},
+        {"ceil", {[] (const Value* args, size_t numArgs, Value& result) {
+            callMath(args, numArgs, result, [] (double x) { return std::ceil(x); });
+        }, 1, 1}},
+        {"sqrt", {[] (const Value* args, size_t numArgs, Value& result) {
+            callMath(args, numArgs, result, [] (double x) { return std::sqrt(x); });
+        }, 1, 1}},
+        {"pow", {&funcPow, 2, 2}},
+        {"lower", {[] (const Value* args, size_t numArgs, Value& result) {
+            callString(args, numArgs, result, [] (const std::string& s, Value& r) {
+                std::string str(s);
+                folly::toLowerAscii(str);
+                r.setStr(std::move(str));
+            });
+        }, 1, 1}},
+        {"upper", {[] (const Value* args, size_t numArgs, Value& result) {
+            callString(args, numArgs, result, [] (const std::string& s, Value& r) {
+                std::string str(s);
+                for (auto& c : str) {
+                    c = static_cast<char>(::toupper(static_cast<unsigned char>(c)));
+                }
+                r.setStr(std::move(str));
+            });
+        }, 1, 1}},
+        {"strlen", {[] (const Value* args, size_t numArgs, Value& result) {
+            callString(args, numArgs, result, [] (const std::string& s, Value& r) {
+                r.setInt(static_cast<int64_t>(s.size()));
+            });
+        }, 1, 1}},
+        {"substr", {&funcSubstr, 2, 3}},
+        {"hash", {&funcHash, 1, 1}},
+        {"now", {&funcNow, 0, 0}},
+        {"timestamp", {&funcTimestamp, 1, 1}},
+    };
+}
+
+
+// static
+const FunctionManager& FunctionManager::instance() {
+    static const FunctionManager manager;
+    return manager;
+}
+
+
+// static
+StatusOr<FunctionManager::Function> FunctionManager::get(folly::StringPiece name,
+                                                         size_t arity) {
+    auto lower = name.str();
+    folly::toLowerAscii(lower);
+    auto& functions = instance().functions_;
+    auto iter = functions.find(lower);
+    if (iter == functions.end()) {
+        return Status::Error("Function `%s' not defined", lower.c_str());
+    }
+    auto& attrs = iter->second;
+    if (arity < attrs.minArity || arity > attrs.maxArity) {
+        return Status::Error("Function `%s' takes %lu to %lu arguments, but %lu given",
+                             lower.c_str(),
+                             attrs.minArity,
+                             attrs.maxArity,
+                             arity);
+    }
+    return attrs.body;
+}
+
+}  // namespace nebula
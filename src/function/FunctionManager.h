@@ -0,0 +1,53 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef FUNCTION_FUNCTIONMANAGER_H_
+#define FUNCTION_FUNCTIONMANAGER_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include "datatypes/Value.h"
+
+namespace nebula {
+
+/**
+ * The registry of the builtin functions called by FunctionCallExpression. A
+ * function is looked up by its name and its number of arguments once, when the
+ * expression is built, and then called through a plain function pointer on
+ * each row.
+ *
+ * A function reads the evaluated arguments and writes its result into a Value
+ * given by the caller, so no scalar result is allocated. A null argument makes
+ * the result null, and an argument of a wrong type makes it BAD_TYPE.
+ */
+class FunctionManager final {
+public:
+    using Function = void (*)(const Value* args, size_t numArgs, Value& result);
+
+    // The most arguments of a builtin, so the caller may keep them on the stack
+    static constexpr size_t kMaxArity = 3;
+
+    // Get the function called by the name, which is case-insensitive, with the
+    // number of arguments
+    static StatusOr<Function> get(folly::StringPiece name, size_t arity);
+
+private:
+    struct FunctionAttributes {
+        Function    body;
+        size_t      minArity;
+        size_t      maxArity;
+    };
+
+    FunctionManager();
+
+    static const FunctionManager& instance();
+
+private:
+    std::unordered_map<std::string, FunctionAttributes>    functions_;
+};
+
+}  // namespace nebula
+#endif  // FUNCTION_FUNCTIONMANAGER_H_
@@ -0,0 +1,103 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "function/FunctionManager.h"
+
+using nebula::Value;
+using nebula::FunctionManager;
+
+// Call the function resolved once, into one result reused by every call
+void callFunction(size_t iters, const char* name, std::vector<Value> args) {
+    FunctionManager::Function func = nullptr;
+    BENCHMARK_SUSPEND {
+        auto res = FunctionManager::get(name, args.size());
+        CHECK(res.ok()) << res.status();
+        func = res.value();
+    }
+    Value result;
+    for (size_t i = 0; i < iters; i++) {
+        func(args.data(), args.size(), result);
+        folly::doNotOptimizeAway(result);
+    }
+}
+
+BENCHMARK(lookup, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        folly::doNotOptimizeAway(FunctionManager::get("substr", 3));
+    }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(absInt, iters) {
+    callFunction(iters, "abs", {-12345});
+}
+
+BENCHMARK(absFloat, iters) {
+    callFunction(iters, "abs", {-123.45});
+}
+
+BENCHMARK(floor, iters) {
+    callFunction(iters, "floor", {123.45});
+}
+
+BENCHMARK(ceil, iters) {
+    callFunction(iters, "ceil", {123.45});
+}
+
+BENCHMARK(sqrt, iters) {
+    callFunction(iters, "sqrt", {123.45});
+}
+
+BENCHMARK(pow, iters) {
+    callFunction(iters, "pow", {1.5, 10});
+}
+
+BENCHMARK(hashInt, iters) {
+    callFunction(iters, "hash", {1234567});
+}
+
+BENCHMARK(now, iters) {
+    callFunction(iters, "now", {});
+}
+
+BENCHMARK(timestampInt, iters) {
+    callFunction(iters, "timestamp", {1577836800});
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(lower, iters) {
+    callFunction(iters, "lower", {"Hello World"});
+}
+
+BENCHMARK(upper, iters) {
+    callFunction(iters, "upper", {"Hello World"});
+}
+
+BENCHMARK(strlen, iters) {
+    callFunction(iters, "strlen", {"Hello World"});
+}
+
+BENCHMARK(substr, iters) {
+    callFunction(iters, "substr", {"Hello World", 6, 5});
+}
+
+BENCHMARK(hashString, iters) {
+    callFunction(iters, "hash", {"Hello World"});
+}
+
+BENCHMARK(timestampString, iters) {
+    callFunction(iters, "timestamp", {"2020-01-01 00:00:00"});
+}
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
@@ -0,0 +1,136 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "context/DataSetContext.h"
+#include "function/FunctionManager.h"
+#include "expression/ConstantExpression.h"
+#include "expression/FunctionCallExpression.h"
+#include "expression/AliasPropertyExpression.h"
+
+namespace nebula {
+
+Value call(const char* name, std::vector<Value> args) {
+    auto func = FunctionManager::get(name, args.size());
+    CHECK(func.ok()) << func.status();
+    Value result;
+    func.value()(args.data(), args.size(), result);
+    return result;
+}
+
+bool isNullOf(const Value& val, NullType type) {
+    return val.isNull() && val.getNull() == type;
+}
+
+TEST(FunctionManager, Lookup) {
+    EXPECT_TRUE(FunctionManager::get("abs", 1).ok());
+    EXPECT_TRUE(FunctionManager::get("ABS", 1).ok());
+    EXPECT_TRUE(FunctionManager::get("substr", 2).ok());
+    EXPECT_TRUE(FunctionManager::get("substr", 3).ok());
+    EXPECT_TRUE(FunctionManager::get("now", 0).ok());
+    EXPECT_FALSE(FunctionManager::get("abs", 0).ok());
+    EXPECT_FALSE(FunctionManager::get("substr", 4).ok());
+    EXPECT_FALSE(FunctionManager::get("no_such_function", 1).ok());
+}
+
+TEST(FunctionManager, Math) {
+    EXPECT_EQ(Value(3), call("abs", {-3}));
+    EXPECT_EQ(Value::Type::INT, call("abs", {-3}).type());
+    EXPECT_EQ(Value(2.5), call("abs", {-2.5}));
+    EXPECT_TRUE(isNullOf(call("abs", {std::numeric_limits<int64_t>::min()}),
+                         NullType::ERR_OVERFLOW));
+    EXPECT_EQ(Value(1.0), call("floor", {1.7}));
+    EXPECT_EQ(Value(-2.0), call("floor", {-1.5}));
+    EXPECT_EQ(Value(2.0), call("ceil", {1.2}));
+    EXPECT_EQ(Value(5.0), call("ceil", {5}));
+    EXPECT_EQ(Value(3.0), call("sqrt", {9}));
+    EXPECT_TRUE(isNullOf(call("sqrt", {-1}), NullType::NaN));
+    EXPECT_EQ(Value(1024.0), call("pow", {2, 10}));
+    EXPECT_EQ(Value(0.5), call("pow", {4, -0.5}));
+
+    EXPECT_TRUE(isNullOf(call("abs", {"-1"}), NullType::BAD_TYPE));
+    EXPECT_TRUE(isNullOf(call("pow", {2, true}), NullType::BAD_TYPE));
+    EXPECT_TRUE(isNullOf(call("floor", {NullType::__NULL__}), NullType::__NULL__));
+    EXPECT_TRUE(isNullOf(call("pow", {2, NullType::DIV_BY_ZERO}), NullType::DIV_BY_ZERO));
+}
+
+TEST(FunctionManager, String) {
+    EXPECT_EQ(Value("hello world"), call("lower", {"Hello World"}));
+    EXPECT_EQ(Value("HELLO WORLD"), call("upper", {"Hello World"}));
+    EXPECT_EQ(Value(11), call("strlen", {"Hello World"}));
+    EXPECT_EQ(Value(0), call("strlen", {""}));
+    EXPECT_EQ(Value("cdef"), call("substr", {"abcdefg", 2, 4}));
+    EXPECT_EQ(Value("efg"), call("substr", {"abcdefg", 4}));
+    EXPECT_EQ(Value("fg"), call("substr", {"abcdefg", 5, 100}));
+    EXPECT_EQ(Value(""), call("substr", {"abcdefg", 7, 1}));
+    EXPECT_TRUE(isNullOf(call("substr", {"abcdefg", -1, 1}), NullType::BAD_DATA));
+    EXPECT_TRUE(isNullOf(call("substr", {"abcdefg", 1, -1}), NullType::BAD_DATA));
+    EXPECT_TRUE(isNullOf(call("substr", {"abcdefg", 1.0}), NullType::BAD_TYPE));
+    EXPECT_TRUE(isNullOf(call("upper", {1}), NullType::BAD_TYPE));
+}
+
+TEST(FunctionManager, Others) {
+    EXPECT_EQ(Value(static_cast<int64_t>(std::hash<Value>()(Value("Tim")))),
+              call("hash", {"Tim"}));
+    EXPECT_EQ(call("hash", {123}), call("hash", {123}));
+    EXPECT_NE(call("hash", {"Tim"}), call("hash", {"Tony"}));
+
+    auto now = call("now", {});
+    ASSERT_EQ(Value::Type::INT, now.type());
+    EXPECT_GT(now.getInt(), 1577836800);
+
+    EXPECT_EQ(Value(1577836800), call("timestamp", {"2020-01-01 00:00:00"}));
+    EXPECT_EQ(Value(1577836800), call("timestamp", {1577836800}));
+    EXPECT_TRUE(isNullOf(call("timestamp", {"2020-01-01"}), NullType::BAD_DATA));
+    EXPECT_TRUE(isNullOf(call("timestamp", {-1}), NullType::BAD_DATA));
+    EXPECT_TRUE(isNullOf(call("timestamp", {1.5}), NullType::BAD_TYPE));
+}
+
+TEST(FunctionManager, FunctionCallExpression) {
+    DataSet ds;
+    ds.colNames = {"name"};
+    Row row;
+    row.columns.emplace_back("abcdefg");
+    ds.rows.emplace_back(std::move(row));
+    DataSetContext ctx(&ds);
+    ctx.setRow(0);
+
+    // substr($-.name, 1, 3)
+    auto* args = new ArgumentList();
+    args->addArgument(new InputPropertyExpression(new std::string("name")));
+    args->addArgument(new ConstantExpression(1));
+    args->addArgument(new ConstantExpression(3));
+    FunctionCallExpression substr(new std::string("SUBSTR"), args);
+    EXPECT_TRUE(substr.isResolved());
+    EXPECT_EQ(Value("bcd"), substr.eval(ctx));
+
+    // The result is overwritten
+    Value result("a string");
+    substr.eval(ctx, result);
+    EXPECT_EQ(Value("bcd"), result);
+
+    FunctionCallExpression unknown(new std::string("no_such_function"), new ArgumentList());
+    EXPECT_FALSE(unknown.isResolved());
+    EXPECT_TRUE(isNullOf(unknown.eval(ctx), NullType::NaN));
+
+    // The wrong number of arguments
+    args = new ArgumentList();
+    args->addArgument(new ConstantExpression(1));
+    FunctionCallExpression pow(new std::string("pow"), args);
+    EXPECT_FALSE(pow.isResolved());
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
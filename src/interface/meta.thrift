@@ -537,6 +537,12 @@ struct HBResp {
     2: common.HostAddr  leader,
     3: ClusterID        cluster_id,
     4: i64              last_update_time_in_ms,
+    // The version of each space, bumped by any change of its parts, schemas or
+    // indexes. A client with them reloads only the spaces changed
+    5: optional map<common.GraphSpaceID, i64>
+        (cpp.template = "std::unordered_map") space_versions,
+    // The version of the users and their roles
+    6: optional i64     users_version,
 }
 
 struct HBReq {
@@ -810,6 +816,32 @@ struct ListIndexStatusResp {
     3: list<IndexStatus>    statuses,
 }
 
+// The metadata of a space cached by a client, as fetched from metad
+struct SpaceSnapshot {
+    1: map<common.PartitionID, list<common.HostAddr>>
+        (cpp.template = "std::unordered_map") parts,
+    2: list<TagItem>        tags,
+    3: list<EdgeItem>       edges,
+    4: list<IndexItem>      tag_indexes,
+    5: list<IndexItem>      edge_indexes,
+    6: SpaceItem            space,
+}
+
+// The metadata cached by a client. It is persisted locally, so a restarted
+// client serves from it before it reaches metad
+struct MetaSnapshot {
+    1: i64                  last_update_time_in_ms,
+    2: map<common.GraphSpaceID, SpaceSnapshot>
+        (cpp.template = "std::unordered_map") spaces,
+    3: map<common.GraphSpaceID, i64>
+        (cpp.template = "std::unordered_map") space_versions,
+    // map<account, encoded password>
+    4: map<binary, binary> (cpp.template = "std::unordered_map") users,
+    5: map<binary, list<RoleItem>> (cpp.template = "std::unordered_map") roles,
+    6: i64                  users_version,
+    7: list<ConfigItem>     configs,
+}
+
 
 service MetaService {
     ExecResp createSpace(1: CreateSpaceReq req);
@@ -0,0 +1,62 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_STATS_CACHESTATS_H_
+#define COMMON_STATS_CACHESTATS_H_
+
+#include "base/Base.h"
+#include "stats/StatsManager.h"
+
+namespace nebula {
+namespace stats {
+
+/**
+ * Export the stats of a ConcurrentLRUCache as gauges of StatsManager, for as
+ * long as the CacheStats lives, so it should not outlive the cache:
+ *   <prefix>_weight    -- The total weight of all entries, i.e. bytes with a
+ *                         weigher returning the size in bytes
+ *   <prefix>_capacity  -- The capacity in the same unit as the weight
+ *   <prefix>_hits      -- The number of hits
+ *   <prefix>_total     -- The number of lookups
+ *   <prefix>_evicts    -- The number of evicted entries
+ */
+class CacheStats final {
+public:
+    template <class Cache>
+    CacheStats(const std::string& prefix, Cache& cache) {
+        add(prefix + "_weight", [&cache] { return cache.weight(); });
+        add(prefix + "_capacity", [&cache] { return cache.capacity(); });
+        add(prefix + "_hits", [&cache] { return cache.hits(); });
+        add(prefix + "_total", [&cache] { return cache.total(); });
+        add(prefix + "_evicts", [&cache] { return cache.evicts(); });
+    }
+
+    CacheStats(const CacheStats&) = delete;
+    CacheStats& operator=(const CacheStats&) = delete;
+
+    ~CacheStats() {
+        for (auto& name : names_) {
+            StatsManager::unregisterGauge(name);
+        }
+    }
+
+private:
+    template <class F>
+    void add(std::string name, F&& f) {
+        StatsManager::registerGauge(name, [f] () -> int64_t {
+            return f();
+        });
+        names_.emplace_back(std::move(name));
+    }
+
+private:
+    std::vector<std::string> names_;
+};
+
+}  // namespace stats
+}  // namespace nebula
+
+#endif  // COMMON_STATS_CACHESTATS_H_
@@ -0,0 +1,222 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "stats/HdrHistogram.h"
+
+namespace nebula {
+namespace stats {
+
+namespace {
+
+struct Level {
+    int64_t     slotSeconds;
+    size_t      numSlots;
+    // The index of the first slot of the level
+    size_t      offset;
+};
+
+constexpr Level kLevels[HdrHistogram::kNumLevels] = {
+    {1, 5, 0},          // 5 seconds
+    {5, 12, 5},         // 1 minute
+    {60, 10, 17},       // 10 minutes
+    {600, 6, 27},       // 1 hour
+};
+constexpr size_t kTotalSlots = 33;
+
+constexpr int64_t kSubBucketCount = 1L << HdrHistogram::kSubBucketBits;
+
+}  // namespace
+
+
+HdrHistogram::HdrHistogram(VT max)
+        : max_(max)
+        , numBuckets_(bucketIndex(max) + 1)
+        , shards_(kNumShards)
+        , slots_(kTotalSlots)
+        , slotBuckets_(kTotalSlots * numBuckets_, 0)
+        , delta_(numBuckets_, 0) {
+    CHECK_GT(max, 0);
+    CHECK_LT(max, std::numeric_limits<VT>::max() >> 2);
+    for (auto& shard : shards_) {
+        shard.buckets.reset(new std::atomic<uint64_t>[numBuckets_]());
+    }
+}
+
+
+// static
+size_t HdrHistogram::bucketIndex(VT value) {
+    if (value < kSubBucketCount) {
+        return value < 0 ? 0 : value;
+    }
+    int64_t shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+    int64_t sub = (value >> shift) - kSubBucketCount;
+    return kSubBucketCount + shift * kSubBucketCount + sub;
+}
+
+
+// static
+HdrHistogram::VT HdrHistogram::bucketLowerBound(size_t index) {
+    if (static_cast<int64_t>(index) < kSubBucketCount) {
+        return index;
+    }
+    int64_t shift = (index - kSubBucketCount) / kSubBucketCount;
+    int64_t sub = (index - kSubBucketCount) % kSubBucketCount;
+    return (kSubBucketCount + sub) << shift;
+}
+
+
+void HdrHistogram::addValue(size_t shard, VT value) {
+    auto& s = shards_[shard % kNumShards];
+    auto index = bucketIndex(std::min(value, max_));
+    s.buckets[index].fetch_add(1, std::memory_order_relaxed);
+    s.sum.fetch_add(value, std::memory_order_relaxed);
+    s.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void HdrHistogram::update(std::chrono::seconds now) {
+    if (firstUpdate_ < 0) {
+        firstUpdate_ = now.count();
+    }
+    // Never go back in time
+    lastUpdate_ = std::max(lastUpdate_, static_cast<int64_t>(now.count()));
+
+    VT sum = 0;
+    int64_t count = 0;
+    std::fill(delta_.begin(), delta_.end(), 0);
+    for (auto& shard : shards_) {
+        if (shard.count.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        sum += shard.sum.exchange(0, std::memory_order_relaxed);
+        count += shard.count.exchange(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < numBuckets_; i++) {
+            if (shard.buckets[i].load(std::memory_order_relaxed) != 0) {
+                delta_[i] += shard.buckets[i].exchange(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (auto& level : kLevels) {
+        int64_t seq = lastUpdate_ / level.slotSeconds;
+        auto index = level.offset + seq % level.numSlots;
+        auto& slot = slots_[index];
+        auto* buckets = &slotBuckets_[index * numBuckets_];
+        if (slot.seq != seq) {
+            // The slot has expired, start over
+            slot.seq = seq;
+            slot.sum = 0;
+            slot.count = 0;
+            std::fill(buckets, buckets + numBuckets_, 0);
+        }
+        if (count == 0) {
+            continue;
+        }
+        slot.sum += sum;
+        slot.count += count;
+        for (size_t i = 0; i < numBuckets_; i++) {
+            buckets[i] += delta_[i];
+        }
+    }
+}
+
+
+template <typename CB>
+void HdrHistogram::forEachSlot(size_t level, CB&& cb) const {
+    DCHECK_LT(level, kNumLevels);
+    const auto& conf = kLevels[level];
+    int64_t seq = lastUpdate_ / conf.slotSeconds;
+    for (size_t i = 0; i < conf.numSlots; i++) {
+        auto index = conf.offset + i;
+        auto slotSeq = slots_[index].seq;
+        if (slotSeq >= 0 && slotSeq <= seq && slotSeq > seq - static_cast<int64_t>(conf.numSlots)) {
+            cb(index);
+        }
+    }
+}
+
+
+int64_t HdrHistogram::elapsed(size_t level) const {
+    DCHECK_LT(level, kNumLevels);
+    const auto& conf = kLevels[level];
+    int64_t duration = conf.slotSeconds * conf.numSlots;
+    if (firstUpdate_ < 0) {
+        return duration;
+    }
+    return std::min(duration, lastUpdate_ - firstUpdate_ + 1);
+}
+
+
+HdrHistogram::VT HdrHistogram::sum(size_t level) const {
+    VT total = 0;
+    forEachSlot(level, [&] (size_t index) {
+        total += slots_[index].sum;
+    });
+    return total;
+}
+
+
+int64_t HdrHistogram::count(size_t level) const {
+    int64_t total = 0;
+    forEachSlot(level, [&] (size_t index) {
+        total += slots_[index].count;
+    });
+    return total;
+}
+
+
+uint64_t HdrHistogram::mergeBuckets(size_t level, std::vector<uint64_t>& buckets) const {
+    buckets.assign(numBuckets_, 0);
+    uint64_t total = 0;
+    forEachSlot(level, [&] (size_t index) {
+        if (slots_[index].count == 0) {
+            return;
+        }
+        const auto* slotBuckets = &slotBuckets_[index * numBuckets_];
+        for (size_t i = 0; i < numBuckets_; i++) {
+            buckets[i] += slotBuckets[i];
+            total += slotBuckets[i];
+        }
+    });
+    return total;
+}
+
+
+HdrHistogram::VT HdrHistogram::getPercentileEstimate(double pct, size_t level) const {
+    std::vector<uint64_t> merged;
+    auto total = mergeBuckets(level, merged);
+    if (total == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(std::ceil(total * pct / 100.0));
+    rank = std::max<uint64_t>(1, std::min(rank, total));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < numBuckets_; i++) {
+        if (seen + merged[i] < rank) {
+            seen += merged[i];
+            continue;
+        }
+        // Interpolate inside the bucket
+        auto lower = bucketLowerBound(i);
+        auto upper = std::min(bucketLowerBound(i + 1) - 1, max_);
+        double fraction = static_cast<double>(rank - seen) / merged[i];
+        return lower + static_cast<VT>((upper - lower) * fraction);
+    }
+    return max_;
+}
+
+
+size_t HdrHistogram::memoryUsage() const {
+    return sizeof(*this) +
+           shards_.size() * (sizeof(Shard) + numBuckets_ * sizeof(std::atomic<uint64_t>)) +
+           slots_.size() * sizeof(Slot) +
+           (slotBuckets_.size() + delta_.size()) * sizeof(uint64_t);
+}
+
+}  // namespace stats
+}  // namespace nebula
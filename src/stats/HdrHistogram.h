@@ -0,0 +1,132 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_STATS_HDRHISTOGRAM_H_
+#define COMMON_STATS_HDRHISTOGRAM_H_
+
+#include "base/Base.h"
+#include <folly/lang/Align.h>
+
+namespace nebula {
+namespace stats {
+
+/**
+ * A time series histogram with log-linear buckets, in the spirit of HdrHistogram.
+ *
+ * Values below 2^kSubBucketBits have one bucket each. Above that, every power
+ * of two is split into 2^kSubBucketBits linear sub-buckets, so the width of a
+ * bucket is never more than 1/16 of its lower bound, which bounds the relative
+ * error of any percentile regardless of the magnitude of the values. Values
+ * above `max' are clamped into the last bucket.
+ *
+ * Recording is lock-free: addValue() does relaxed atomic increments on one of
+ * kNumShards per-thread shards. update() folds the shards into the time windows,
+ * which must be serialized by the caller, as well as all the read methods.
+ *
+ * The time windows mirror the levels of StatsManager, i.e. 5 seconds, 1 minute,
+ * 10 minutes and 1 hour, each kept as a ring of 5, 12, 10 and 6 slots.
+ *
+ * Memory: (kNumShards + 33) * numBuckets() * 8 bytes. For latencies in
+ * microseconds, 1us to 10s (max = 10000000) takes 324 buckets, i.e. ~124KB per
+ * histogram. As a comparison, a folly::TimeseriesHistogram keeps a
+ * MultiLevelTimeSeries of ~4KB per bucket, so covering the same range with a
+ * fixed bucket width of 1ms, i.e. bucketSize = 1000 and 10001 buckets, takes
+ * ~40MB. See the footprint logged by StatsManagerBenchmark.
+ */
+class HdrHistogram final {
+public:
+    using VT = int64_t;
+
+    static constexpr size_t kNumShards = 16;
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kNumLevels = 4;
+
+    explicit HdrHistogram(VT max);
+
+    HdrHistogram(const HdrHistogram&) = delete;
+    HdrHistogram& operator=(const HdrHistogram&) = delete;
+
+    // Lock-free, `shard' is any number identifying the calling thread
+    void addValue(size_t shard, VT value);
+
+    // Fold all shards into the time windows and advance the windows to `now'
+    void update(std::chrono::seconds now);
+
+    // The following read methods reflect the state of the last update()
+    VT sum(size_t level) const;
+    int64_t count(size_t level) const;
+
+    template <typename ReturnType = double>
+    ReturnType avg(size_t level) const {
+        auto cnt = count(level);
+        return cnt == 0 ? ReturnType(0) : static_cast<ReturnType>(sum(level)) / cnt;
+    }
+
+    template <typename ReturnType = double>
+    ReturnType rate(size_t level) const {
+        return static_cast<ReturnType>(sum(level)) / elapsed(level);
+    }
+
+    // The estimated value below which `pct' percent of values fall
+    VT getPercentileEstimate(double pct, size_t level) const;
+
+    // Sum up the buckets of all slots inside the window of `level' into `buckets',
+    // which is resized to numBuckets(). Return the total count.
+    uint64_t mergeBuckets(size_t level, std::vector<uint64_t>& buckets) const;
+
+    size_t numBuckets() const {
+        return numBuckets_;
+    }
+
+    size_t memoryUsage() const;
+
+    static size_t bucketIndex(VT value);
+    // The smallest value of the bucket
+    static VT bucketLowerBound(size_t index);
+
+private:
+    // Padded, so that sum and count of two shards never share a cache line
+    struct Shard {
+        std::atomic<VT>                             sum{0};
+        std::atomic<int64_t>                        count{0};
+        std::unique_ptr<std::atomic<uint64_t>[]>    buckets;
+        char                                        padding[
+            folly::hardware_destructive_interference_size -
+            sizeof(std::atomic<VT>) -
+            sizeof(std::atomic<int64_t>) -
+            sizeof(std::unique_ptr<std::atomic<uint64_t>[]>)];
+    };
+
+    struct Slot {
+        // Which slot of the level since epoch, -1 for never used
+        int64_t     seq{-1};
+        VT          sum{0};
+        int64_t     count{0};
+    };
+
+    // Call `cb' with the index of each slot inside the window of `level'
+    template <typename CB>
+    void forEachSlot(size_t level, CB&& cb) const;
+    // The number of seconds covered by the window of `level'
+    int64_t elapsed(size_t level) const;
+
+private:
+    const VT                        max_;
+    const size_t                    numBuckets_;
+    std::vector<Shard>              shards_;
+    // The slots of all levels, and numBuckets_ buckets for each slot
+    std::vector<Slot>               slots_;
+    std::vector<uint64_t>           slotBuckets_;
+    // Scratch buffer to fold the shards
+    std::vector<uint64_t>           delta_;
+    int64_t                         firstUpdate_{-1};
+    int64_t                         lastUpdate_{0};
+};
+
+}  // namespace stats
+}  // namespace nebula
+
+#endif  // COMMON_STATS_HDRHISTOGRAM_H_
@@ -8,10 +8,69 @@
 #include "stats/StatsManager.h"
 #include <folly/stats/MultiLevelTimeSeries-defs.h>
 #include <folly/stats/TimeseriesHistogram-defs.h>
+#include <folly/io/Cursor.h>
 
 namespace nebula {
 namespace stats {
 
+namespace {
+
+// Write the text straight into the IOBuf chain, without any temporary string
+class MetricsWriter final {
+public:
+    explicit MetricsWriter(folly::IOBufQueue& out) : appender_(&out, kGrowth) {}
+
+    MetricsWriter& append(folly::StringPiece str) {
+        appender_.push(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+        return *this;
+    }
+
+    MetricsWriter& append(int64_t val) {
+        appender_.ensure(kMaxDigits);
+        auto* buf = reinterpret_cast<char*>(appender_.writableData());
+        size_t len = 0;
+        uint64_t uval = val;
+        if (val < 0) {
+            buf[len++] = '-';
+            uval = ~uval + 1;
+        }
+        len += folly::uint64ToBufferUnsafe(uval, buf + len);
+        appender_.append(len);
+        return *this;
+    }
+
+    // A metric name only allows [a-zA-Z0-9_:], anything else becomes '_', and
+    // it must not start with a digit, which is prefixed by '_'
+    MetricsWriter& appendName(folly::StringPiece name) {
+        appender_.ensure(name.size() + 1);
+        auto* buf = reinterpret_cast<char*>(appender_.writableData());
+        size_t len = 0;
+        if (!name.empty() && std::isdigit(static_cast<unsigned char>(name[0]))) {
+            buf[len++] = '_';
+        }
+        for (auto c : name) {
+            buf[len++] = (std::isalnum(static_cast<unsigned char>(c)) || c == ':') ? c : '_';
+        }
+        appender_.append(len);
+        return *this;
+    }
+
+private:
+    static constexpr size_t kGrowth = 16 * 1024;
+    static constexpr size_t kMaxDigits = 21;
+
+    folly::io::QueueAppender appender_;
+};
+
+const folly::StringPiece kRangeLabels[] = {
+    "{range=\"5\"",
+    "{range=\"60\"",
+    "{range=\"600\"",
+    "{range=\"3600\"",
+};
+
+}  // namespace
+
 // static
 StatsManager& StatsManager::get() {
     static StatsManager smInst;
@@ -19,6 +78,18 @@ StatsManager& StatsManager::get() {
 }
 
 
+StatsManager::~StatsManager() {
+    {
+        std::lock_guard<std::mutex> g(aggregatorLock_);
+        aggregatorStopped_ = true;
+    }
+    aggregatorCV_.notify_one();
+    if (aggregator_.joinable()) {
+        aggregator_.join();
+    }
+}
+
+
 // static
 void StatsManager::setDomain(folly::StringPiece domain) {
     get().domain_ = domain.toString();
@@ -35,6 +106,18 @@ void StatsManager::setReportInfo(HostAddr addr, int32_t interval) {
 
 // static
 int32_t StatsManager::registerStats(folly::StringPiece counterName) {
+    return registerStatsInternal(counterName, false);
+}
+
+
+// static
+int32_t StatsManager::registerShardedStats(folly::StringPiece counterName) {
+    return registerStatsInternal(counterName, true);
+}
+
+
+// static
+int32_t StatsManager::registerStatsInternal(folly::StringPiece counterName, bool sharded) {
     using std::chrono::seconds;
 
     auto& sm = get();
@@ -48,16 +131,19 @@ int32_t StatsManager::registerStats(folly::StringPiece counterName) {
     }
 
     // Insert the Stats
-    sm.stats_.emplace_back(
-        std::make_pair(
-            std::make_unique<std::mutex>(),
-            std::make_unique<StatsType>(
-                60,
-                std::initializer_list<StatsType::Duration>({seconds(5),
-                                                            seconds(60),
-                                                            seconds(600),
-                                                            seconds(3600)}))));
-    int32_t index = sm.stats_.size();
+    StatsEntry entry;
+    entry.lock = std::make_unique<std::mutex>();
+    entry.stats = std::make_unique<StatsType>(
+        60,
+        std::initializer_list<StatsType::Duration>({seconds(5),
+                                                    seconds(60),
+                                                    seconds(600),
+                                                    seconds(3600)}));
+    if (sharded) {
+        entry.shards = std::make_unique<Shards>();
+        sm.startAggregator();
+    }
+    int32_t index = sm.stats_.emplace_back(std::move(entry)) + 1;
     sm.nameMap_[name] = index;
     return index;
 }
@@ -70,6 +156,97 @@ int32_t StatsManager::registerHisto(folly::StringPiece counterName,
                                     StatsManager::VT max) {
     using std::chrono::seconds;
 
+    HistoEntry entry;
+    entry.histo = std::make_unique<HistogramType>(
+        bucketSize,
+        min,
+        max,
+        StatsType(60, {seconds(5), seconds(60), seconds(600), seconds(3600)}));
+    auto index = registerHistoInternal(counterName, std::move(entry));
+
+    LOG(INFO) << "registerHisto, bucketSize: " << bucketSize
+              << ", min: " << min << ", max: " << max;
+    return index;
+}
+
+
+// static
+int32_t StatsManager::registerHdrHisto(folly::StringPiece counterName, StatsManager::VT max) {
+    HistoEntry entry;
+    entry.hdr = std::make_unique<HdrHistogram>(max);
+    auto numBuckets = entry.hdr->numBuckets();
+    auto index = registerHistoInternal(counterName, std::move(entry));
+
+    LOG(INFO) << "registerHdrHisto, max: " << max << ", buckets: " << numBuckets;
+    return index;
+}
+
+
+// static
+int32_t StatsManager::registerGauge(folly::StringPiece gaugeName, std::function<VT()> gauge) {
+    CHECK(gauge != nullptr);
+    auto& sm = get();
+
+    std::string name = gaugeName.toString();
+    folly::RWSpinLock::WriteHolder wh(sm.nameMapLock_);
+    auto it = sm.nameMap_.find(name);
+    if (it != sm.nameMap_.end()) {
+        if (it->second > 0 && sm.stats_[it->second - 1].stats == nullptr) {
+            auto& entry = sm.stats_[it->second - 1];
+            std::lock_guard<std::mutex> g(*entry.lock);
+            entry.gauge = std::move(gauge);
+        } else {
+            LOG(ERROR) << "The counter \"" << name << "\" already exists, and is not a gauge";
+        }
+        return it->second;
+    }
+
+    int32_t index;
+    if (!sm.freeGauges_.empty()) {
+        index = sm.freeGauges_.back();
+        sm.freeGauges_.pop_back();
+        auto& entry = sm.stats_[index - 1];
+        std::lock_guard<std::mutex> g(*entry.lock);
+        entry.gauge = std::move(gauge);
+    } else {
+        StatsEntry entry;
+        entry.lock = std::make_unique<std::mutex>();
+        entry.gauge = std::move(gauge);
+        index = sm.stats_.emplace_back(std::move(entry)) + 1;
+    }
+    sm.nameMap_[name] = index;
+    return index;
+}
+
+
+// static
+void StatsManager::unregisterGauge(folly::StringPiece gaugeName) {
+    auto& sm = get();
+
+    std::string name = gaugeName.toString();
+    folly::RWSpinLock::WriteHolder wh(sm.nameMapLock_);
+    auto it = sm.nameMap_.find(name);
+    if (it == sm.nameMap_.end() ||
+        it->second < 0 ||
+        sm.stats_[it->second - 1].stats != nullptr) {
+        LOG(ERROR) << "The gauge \"" << name << "\" does not exist";
+        return;
+    }
+    // The entry is kept for the next gauge, since the indices of the others
+    // must not change
+    auto& entry = sm.stats_[it->second - 1];
+    {
+        std::lock_guard<std::mutex> g(*entry.lock);
+        entry.gauge = nullptr;
+    }
+    sm.freeGauges_.emplace_back(it->second);
+    sm.nameMap_.erase(it);
+}
+
+
+// static
+int32_t StatsManager::registerHistoInternal(folly::StringPiece counterName,
+                                            HistoEntry entry) {
     auto& sm = get();
     std::string name = counterName.toString();
     folly::RWSpinLock::WriteHolder wh(sm.nameMapLock_);
@@ -80,19 +257,12 @@ int32_t StatsManager::registerHisto(folly::StringPiece counterName,
     }
 
     // Insert the Histogram
-    sm.histograms_.emplace_back(
-        std::make_pair(
-            std::make_unique<std::mutex>(),
-            std::make_unique<HistogramType>(
-                bucketSize,
-                min,
-                max,
-                StatsType(60, {seconds(5), seconds(60), seconds(600), seconds(3600)}))));
-    int32_t index = - sm.histograms_.size();
+    entry.lock = std::make_unique<std::mutex>();
+    if (entry.hdr != nullptr) {
+        sm.startAggregator();
+    }
+    int32_t index = - (sm.histograms_.emplace_back(std::move(entry)) + 1);
     sm.nameMap_[name] = index;
-
-    LOG(INFO) << "registerHisto, bucketSize: " << bucketSize
-              << ", min: " << min << ", max: " << max;
     return index;
 }
 
@@ -107,14 +277,31 @@ void StatsManager::addValue(int32_t index, VT value) {
         // Stats
         --index;
         DCHECK_LT(index, sm.stats_.size());
-        std::lock_guard<std::mutex> g(*(sm.stats_[index].first));
-        sm.stats_[index].second->addValue(seconds(time::WallClock::fastNowInSec()), value);
+        auto& entry = sm.stats_[index];
+        if (entry.stats == nullptr) {
+            LOG(ERROR) << "Can't add a value to a gauge";
+            return;
+        }
+        if (entry.shards != nullptr) {
+            // Sharded, leave it to the aggregator
+            auto& slot = (*entry.shards)[shardIndex()];
+            slot.sum.fetch_add(value, std::memory_order_relaxed);
+            slot.count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::lock_guard<std::mutex> g(*entry.lock);
+        entry.stats->addValue(seconds(time::WallClock::fastNowInSec()), value);
     } else {
         // Histogram
         index = - (index + 1);
         DCHECK_LT(index, sm.histograms_.size());
-        std::lock_guard<std::mutex> g(*(sm.histograms_[index].first));
-        sm.histograms_[index].second->addValue(seconds(time::WallClock::fastNowInSec()), value);
+        auto& entry = sm.histograms_[index];
+        if (entry.hdr != nullptr) {
+            entry.hdr->addValue(shardIndex(), value);
+            return;
+        }
+        std::lock_guard<std::mutex> g(*entry.lock);
+        entry.histo->addValue(seconds(time::WallClock::fastNowInSec()), value);
     }
 }
 
@@ -183,6 +370,7 @@ StatusOr<StatsManager::VT> StatsManager::readValue(folly::StringPiece metricName
 void StatsManager::readAllValue(folly::dynamic& vals) {
     auto& sm = get();
 
+    folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
     for (auto &statsName : sm.nameMap_) {
         for (auto method = StatsMethod::SUM; method <= StatsMethod::RATE;
              method = static_cast<StatsMethod>(static_cast<int>(method) + 1)) {
@@ -235,6 +423,113 @@ void StatsManager::readAllValue(folly::dynamic& vals) {
 }
 
 
+// static
+void StatsManager::readAllMetrics(folly::IOBufQueue& out) {
+    using std::chrono::seconds;
+    // Not "_sum" nor "_count", which are reserved for the histograms
+    static const folly::StringPiece kMethods[] = {
+        "_sum_in_range", "_count_in_range", "_avg", "_rate"
+    };
+    static constexpr auto kNumRanges = static_cast<size_t>(TimeRange::ONE_HOUR) + 1;
+
+    auto& sm = get();
+    MetricsWriter writer(out);
+    auto now = seconds(time::WallClock::fastNowInSec());
+
+    // <name><suffix>{range="<range>"} <value>
+    auto writeGauges = [&writer] (const std::string& name, auto& stats, StatsMethod first) {
+        for (auto method = first; method <= StatsMethod::RATE;
+             method = static_cast<StatsMethod>(static_cast<int>(method) + 1)) {
+            auto suffix = kMethods[static_cast<int>(method) - 1];
+            writer.append("# TYPE ").appendName(name).append(suffix).append(" gauge\n");
+            for (size_t level = 0; level < kNumRanges; level++) {
+                auto range = static_cast<TimeRange>(level);
+                writer.appendName(name).append(suffix).append(kRangeLabels[level])
+                      .append("} ").append(readValue(stats, range, method)).append("\n");
+            }
+        }
+    };
+    // <name>_bucket{range="<range>",le="<upper>"} <cumulative count>
+    auto writeBucket = [&writer] (const std::string& name, size_t level, int64_t upper,
+                                  uint64_t count) {
+        writer.appendName(name).append("_bucket").append(kRangeLabels[level])
+              .append(",le=\"").append(upper).append("\"} ")
+              .append(static_cast<int64_t>(count)).append("\n");
+    };
+    auto writeHistoTail = [&writer] (const std::string& name, size_t level, uint64_t count,
+                                     VT sum) {
+        writer.appendName(name).append("_bucket").append(kRangeLabels[level])
+              .append(",le=\"+Inf\"} ").append(static_cast<int64_t>(count)).append("\n");
+        writer.appendName(name).append("_count").append(kRangeLabels[level])
+              .append("} ").append(static_cast<int64_t>(count)).append("\n");
+        writer.appendName(name).append("_sum").append(kRangeLabels[level])
+              .append("} ").append(sum).append("\n");
+    };
+
+    std::vector<uint64_t> buckets;
+    folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
+    for (auto& counter : sm.nameMap_) {
+        auto& name = counter.first;
+        auto index = counter.second;
+        if (index > 0) {
+            auto& entry = sm.stats_[index - 1];
+            std::lock_guard<std::mutex> g(*entry.lock);
+            if (entry.stats == nullptr) {
+                // <name> <value>
+                writer.append("# TYPE ").appendName(name).append(" gauge\n");
+                writer.appendName(name).append(" ").append(entry.gauge()).append("\n");
+                continue;
+            }
+            if (entry.shards != nullptr) {
+                foldShards(entry);
+            }
+            entry.stats->update(now);
+            writeGauges(name, *entry.stats, StatsMethod::SUM);
+            continue;
+        }
+
+        auto& entry = sm.histograms_[- (index + 1)];
+        std::lock_guard<std::mutex> g(*entry.lock);
+        writer.append("# TYPE ").appendName(name).append(" histogram\n");
+        if (entry.hdr != nullptr) {
+            auto& hdr = *entry.hdr;
+            hdr.update(now);
+            for (size_t level = 0; level < kNumRanges; level++) {
+                auto total = hdr.mergeBuckets(level, buckets);
+                uint64_t cumulative = 0;
+                // The last bucket holds the clamped values, leave it to "+Inf"
+                for (size_t i = 0; i + 1 < buckets.size(); i++) {
+                    cumulative += buckets[i];
+                    writeBucket(name, level, HdrHistogram::bucketLowerBound(i + 1) - 1,
+                                cumulative);
+                }
+                writeHistoTail(name, level, total, hdr.sum(level));
+            }
+            writeGauges(name, hdr, StatsMethod::AVG);
+        } else {
+            auto& histo = *entry.histo;
+            histo.update(now);
+            for (size_t level = 0; level < kNumRanges; level++) {
+                uint64_t cumulative = 0;
+                // The first bucket holds the values below min, and the last one
+                // those not below max
+                for (size_t i = 0; i + 1 < histo.getNumBuckets(); i++) {
+                    cumulative += histo.getBucket(i).count(level);
+                    auto upper = i == 0
+                        ? histo.getMin() - 1
+                        : std::min(histo.getBucketMin(i) + histo.getBucketSize(),
+                                   histo.getMax()) - 1;
+                    writeBucket(name, level, upper, cumulative);
+                }
+                writeHistoTail(name, level, histo.count(level), histo.sum(level));
+            }
+            writeGauges(name, histo, StatsMethod::AVG);
+        }
+    }
+    writer.append("# EOF\n");
+}
+
+
 // static
 StatusOr<StatsManager::VT> StatsManager::readStats(int32_t index,
                                          StatsManager::TimeRange range,
@@ -250,16 +545,31 @@ StatusOr<StatsManager::VT> StatsManager::readStats(int32_t index,
         // stats
         --index;
         DCHECK_LT(index, sm.stats_.size());
-        std::lock_guard<std::mutex> g(*(sm.stats_[index].first));
-        sm.stats_[index].second->update(seconds(time::WallClock::fastNowInSec()));
-        return readValue(*(sm.stats_[index].second), range, method);
+        auto& entry = sm.stats_[index];
+        std::lock_guard<std::mutex> g(*entry.lock);
+        if (entry.stats == nullptr) {
+            if (entry.gauge == nullptr) {
+                return Status::Error("Invalid stats");
+            }
+            return entry.gauge();
+        }
+        if (entry.shards != nullptr) {
+            foldShards(entry);
+        }
+        entry.stats->update(seconds(time::WallClock::fastNowInSec()));
+        return readValue(*entry.stats, range, method);
     } else {
         // histograms_
         index = - (index + 1);
         DCHECK_LT(index, sm.histograms_.size());
-        std::lock_guard<std::mutex> g(*(sm.histograms_[index].first));
-        sm.histograms_[index].second->update(seconds(time::WallClock::fastNowInSec()));
-        return readValue(*(sm.histograms_[index].second), range, method);
+        auto& entry = sm.histograms_[index];
+        std::lock_guard<std::mutex> g(*entry.lock);
+        if (entry.hdr != nullptr) {
+            entry.hdr->update(seconds(time::WallClock::fastNowInSec()));
+            return readValue(*entry.hdr, range, method);
+        }
+        entry.histo->update(seconds(time::WallClock::fastNowInSec()));
+        return readValue(*entry.histo, range, method);
     }
 }
 
@@ -274,6 +584,7 @@ StatusOr<StatsManager::VT> StatsManager::readStats(const std::string& counterNam
     int32_t index = 0;
 
     {
+        folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
         auto it = sm.nameMap_.find(counterName);
         if (it == sm.nameMap_.end()) {
             // Not found
@@ -297,6 +608,7 @@ StatusOr<StatsManager::VT> StatsManager::readHisto(const std::string& counterNam
     // Look up the counter name
     int32_t index = 0;
     {
+        folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
         auto it = sm.nameMap_.find(counterName);
         if (it == sm.nameMap_.end()) {
             // Not found
@@ -314,10 +626,92 @@ StatusOr<StatsManager::VT> StatsManager::readHisto(const std::string& counterNam
         return Status::Error("Invalid stats");
     }
 
-    std::lock_guard<std::mutex> g(*(sm.histograms_[index].first));
-    sm.histograms_[index].second->update(seconds(time::WallClock::fastNowInSec()));
+    auto& entry = sm.histograms_[index];
     auto level = static_cast<size_t>(range);
-    return sm.histograms_[index].second->getPercentileEstimate(pct, level);
+    std::lock_guard<std::mutex> g(*entry.lock);
+    if (entry.hdr != nullptr) {
+        entry.hdr->update(seconds(time::WallClock::fastNowInSec()));
+        return entry.hdr->getPercentileEstimate(pct, level);
+    }
+    entry.histo->update(seconds(time::WallClock::fastNowInSec()));
+    return entry.histo->getPercentileEstimate(pct, level);
+}
+
+
+// static
+size_t StatsManager::shardIndex() {
+    static std::atomic<size_t> nextShard{0};
+    static thread_local size_t shard =
+        nextShard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+    return shard;
+}
+
+
+// static
+void StatsManager::foldShards(StatsEntry& entry) {
+    using std::chrono::seconds;
+
+    VT sum = 0;
+    int64_t count = 0;
+    for (auto& slot : *entry.shards) {
+        // The two fields are not swapped atomically as a whole, a value being
+        // added concurrently may have its count folded in the next round.
+        sum += slot.sum.exchange(0, std::memory_order_relaxed);
+        count += slot.count.exchange(0, std::memory_order_relaxed);
+    }
+    if (sum == 0 && count == 0) {
+        return;
+    }
+    entry.stats->addValueAggregated(seconds(time::WallClock::fastNowInSec()), sum, count);
+}
+
+
+void StatsManager::startAggregator() {
+    if (aggregator_.joinable()) {
+        return;
+    }
+    aggregator_ = std::thread(&StatsManager::aggregate, this);
+}
+
+
+void StatsManager::aggregate() {
+    using std::chrono::seconds;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(aggregatorLock_);
+            aggregatorCV_.wait_for(lk, seconds(1), [this] {
+                return aggregatorStopped_;
+            });
+            if (aggregatorStopped_) {
+                return;
+            }
+        }
+        aggregateOnce();
+    }
+}
+
+
+void StatsManager::aggregateOnce() {
+    using std::chrono::seconds;
+
+    folly::RWSpinLock::ReadHolder rh(nameMapLock_);
+    for (size_t i = 0; i < stats_.size(); i++) {
+        auto& entry = stats_[i];
+        if (entry.shards == nullptr) {
+            continue;
+        }
+        std::lock_guard<std::mutex> g(*entry.lock);
+        foldShards(entry);
+    }
+    for (size_t i = 0; i < histograms_.size(); i++) {
+        auto& entry = histograms_[i];
+        if (entry.hdr == nullptr) {
+            continue;
+        }
+        std::lock_guard<std::mutex> g(*entry.lock);
+        entry.hdr->update(seconds(time::WallClock::fastNowInSec()));
+    }
 }
 
 }  // namespace stats
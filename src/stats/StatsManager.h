@@ -9,11 +9,15 @@
 
 #include "base/Base.h"
 #include <folly/RWSpinLock.h>
+#include <folly/io/IOBufQueue.h>
+#include <folly/lang/Align.h>
 #include <folly/stats/MultiLevelTimeSeries.h>
 #include <folly/stats/TimeseriesHistogram.h>
+#include <gtest/gtest_prod.h>
 #include "datatypes/HostAddr.h"
 #include "time/WallClock.h"
 #include "base/StatusOr.h"
+#include "stats/HdrHistogram.h"
 
 namespace nebula {
 namespace stats {
@@ -40,8 +44,25 @@ namespace stats {
  *   latency.p9999.60   -- The latency that slower than 99.99% of all queries
  *                           in the last one minute
  *   error.count.600    -- Total number of errors in the last ten minutes
+ *
+ * A counter registered by registerShardedStats() is updated without any lock.
+ * Each writer thread adds into its own cache-line-padded slot, and a background
+ * aggregator folds all slots into the time series once per second. Reading a
+ * sharded counter folds the pending slots first, so the read side behaves
+ * exactly like an ordinary counter.
+ *
+ * Likewise, a histogram registered by registerHdrHisto() records values
+ * lock-free into per-thread shards of log-linear buckets (see HdrHistogram),
+ * which are merged on read. It supports all the statistic types of the
+ * ordinary histograms, with a bounded relative error of the percentiles.
+ *
+ * A gauge registered by registerGauge() has no time series. Its value is sampled
+ * from a callback whenever it's read, so all the statistic types and time ranges
+ * of a gauge read the same current value, e.g. the memory used by a cache.
  */
 class StatsManager final {
+    FRIEND_TEST(StatsManager, ShardedStatsTest);
+
     using VT = int64_t;
     using StatsType = folly::MultiLevelTimeSeries<VT>;
     using HistogramType = folly::TimeseriesHistogram<VT>;
@@ -69,13 +90,28 @@ public:
 
     // Both register methods return the index to the internal data structure.
     // This index will be used by addValue() methods.
-    // Both register methods is not thread safe, and user need to register stats one
-    // by onebefore calling addValue, readStats, readHisto and so on.
+    // The register methods are thread safe, but the index returned is valid for
+    // addValue() only once the method returns, so the counter should be
+    // registered before any thread adds values to it.
     static int32_t registerStats(folly::StringPiece counterName);
     static int32_t registerHisto(folly::StringPiece counterName,
                                  VT bucketSize,
                                  VT min,
                                  VT max);
+    // Same as registerStats(), but the counter is sharded per thread, which is
+    // preferable for the hot counters bumped from many threads concurrently.
+    // Each sharded counter costs kNumShards cache lines of extra memory.
+    static int32_t registerShardedStats(folly::StringPiece counterName);
+    // Register a lock-free histogram with log-linear buckets, covering values
+    // in [0, max], e.g. max = 10000000 for latencies from 1us to 10s.
+    // See HdrHistogram for the precision and the memory footprint.
+    static int32_t registerHdrHisto(folly::StringPiece counterName, VT max);
+    // Register a gauge reading the current value from `gauge'. Registering an
+    // existing gauge again replaces its callback. The callback must stay valid
+    // until the gauge is unregistered. The index of an unregistered gauge may be
+    // given to a gauge registered later.
+    static int32_t registerGauge(folly::StringPiece gaugeName, std::function<VT()> gauge);
+    static void unregisterGauge(folly::StringPiece gaugeName);
 
     static void addValue(int32_t index, VT value = 1);
 
@@ -90,6 +126,81 @@ public:
                                   TimeRange range,
                                   double pct);
     static void readAllValue(folly::dynamic& vals);
+    // Append all counters to `out' in the OpenMetrics text format. Every statistic
+    // type becomes a gauge labeled with its time range, and the histograms are
+    // exported as native histograms with cumulative buckets. The sums and counts
+    // of a time range are gauges named `<name>_sum_in_range' and
+    // `<name>_count_in_range', since `_sum' and `_count' are reserved for the
+    // samples of histograms and summaries.
+    static void readAllMetrics(folly::IOBufQueue& out);
+
+private:
+    // The number of slots of a sharded counter. Threads are assigned to the slots
+    // round-robin, so a slot is only shared when there are more writer threads
+    // than slots.
+    static constexpr size_t kNumShards = 64;
+
+    // The slot is padded to the destructive interference size, so that no two
+    // threads write into the same cache line.
+    struct ShardSlot {
+        std::atomic<VT>         sum{0};
+        std::atomic<int64_t>    count{0};
+        char                    padding[folly::hardware_destructive_interference_size -
+                                        sizeof(std::atomic<VT>) -
+                                        sizeof(std::atomic<int64_t>)];
+    };
+    using Shards = std::array<ShardSlot, kNumShards>;
+
+    // Either `stats' or `gauge' is present
+    struct StatsEntry {
+        std::unique_ptr<std::mutex>     lock;
+        std::unique_ptr<StatsType>      stats;
+        // Only present for the sharded counters
+        std::unique_ptr<Shards>         shards;
+        std::function<VT()>             gauge;
+    };
+
+    // Either `histo' or `hdr' is present
+    struct HistoEntry {
+        std::unique_ptr<std::mutex>     lock;
+        std::unique_ptr<HistogramType>  histo;
+        std::unique_ptr<HdrHistogram>   hdr;
+    };
+
+    // An append-only table of fixed-size chunks, so that an entry never moves once
+    // added. addValue() and readStats() reach the entries by index without
+    // `nameMapLock_', while another thread may be registering a new one.
+    template<class Entry>
+    class EntryTable final {
+    public:
+        static constexpr size_t kChunkSize = 1024;
+        static constexpr size_t kMaxChunks = 1024;
+
+        Entry& operator[](size_t index) {
+            return chunks_[index / kChunkSize][index % kChunkSize];
+        }
+
+        size_t size() const {
+            return size_.load(std::memory_order_acquire);
+        }
+
+        // `nameMapLock_' must be held in write mode
+        size_t emplace_back(Entry&& entry) {
+            auto index = size_.load(std::memory_order_relaxed);
+            auto chunk = index / kChunkSize;
+            CHECK_LT(chunk, kMaxChunks) << "Too many counters";
+            if (chunks_[chunk] == nullptr) {
+                chunks_[chunk].reset(new Entry[kChunkSize]);
+            }
+            chunks_[chunk][index % kChunkSize] = std::move(entry);
+            size_.store(index + 1, std::memory_order_release);
+            return index;
+        }
+
+    private:
+        std::unique_ptr<Entry[]>        chunks_[kMaxChunks];
+        std::atomic<size_t>             size_{0};
+    };
 
 private:
     static StatsManager& get();
@@ -97,10 +208,25 @@ private:
     StatsManager() = default;
     StatsManager(const StatsManager&) = delete;
     StatsManager(StatsManager&&) = delete;
+    ~StatsManager();
 
     template<class StatsHolder>
     static VT readValue(StatsHolder& stats, TimeRange range, StatsMethod method);
 
+    static int32_t registerStatsInternal(folly::StringPiece counterName, bool sharded);
+    static int32_t registerHistoInternal(folly::StringPiece counterName, HistoEntry entry);
+
+    // The slot the calling thread writes into
+    static size_t shardIndex();
+    // Fold the pending slots into the time series, the lock of `entry' must be held
+    static void foldShards(StatsEntry& entry);
+
+    // !NOTE! `nameMapLock_' must be held in write mode
+    void startAggregator();
+    void aggregate();
+    // A single round of the aggregator
+    void aggregateOnce();
+
 
 private:
     std::string domain_;
@@ -114,18 +240,18 @@ private:
     std::unordered_map<std::string, int32_t> nameMap_;
 
     // All time series stats
-    std::vector<
-        std::pair<std::unique_ptr<std::mutex>,
-                  std::unique_ptr<StatsType>
-        >
-    > stats_;
+    EntryTable<StatsEntry> stats_;
+    // The entries of the unregistered gauges, to be reused by registerGauge()
+    std::vector<int32_t> freeGauges_;
 
     // All histogram stats
-    std::vector<
-        std::pair<std::unique_ptr<std::mutex>,
-                  std::unique_ptr<HistogramType>
-        >
-    > histograms_;
+    EntryTable<HistoEntry> histograms_;
+
+    // The background thread folding the sharded counters and histograms
+    std::thread aggregator_;
+    std::mutex aggregatorLock_;
+    std::condition_variable aggregatorCV_;
+    bool aggregatorStopped_{false};
 };
 
 }  // namespace stats
@@ -0,0 +1,140 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_STATS_TASKPRIORITYSTATS_H_
+#define COMMON_STATS_TASKPRIORITYSTATS_H_
+
+#include "base/Base.h"
+#include "base/TaskStats.h"
+#include "stats/StatsManager.h"
+
+namespace nebula {
+namespace stats {
+
+/**
+ * Export the tasks of each priority class run by a GenericWorker or a
+ * GenericThreadPool to StatsManager, where <class> is high, normal or low:
+ *   <prefix>_<class>_queue_depth   -- The number of tasks queued, as a gauge
+ *   <prefix>_<class>_wait_us       -- The time in microseconds a task is queued
+ *   <prefix>_<class>_exec_us       -- The time in microseconds a task runs
+ *   <prefix>_<class>_expired       -- The number of tasks dropped for their deadlines
+ *
+ * The instances are shared by prefix, i.e. get() returns the live one of the
+ * prefix if any, so the workers given the same prefix are counted together.
+ * The gauges are unregistered once the last user of the prefix is gone, but
+ * the histograms and the counters stay in StatsManager for good, about 750KB
+ * per prefix, and are taken again by the next instance of the prefix. So the
+ * prefixes should be a few long-lived names, e.g. one per kind of worker,
+ * rather than one per worker.
+ */
+class TaskPriorityStats final : public TaskStats {
+public:
+    static std::shared_ptr<TaskPriorityStats> get(const std::string& prefix) {
+        std::lock_guard<std::mutex> g(registryLock());
+        auto& live = registry()[prefix];
+        auto stats = live.lock();
+        if (stats == nullptr) {
+            stats.reset(new TaskPriorityStats(prefix), &destroy);
+            live = stats;
+        }
+        return stats;
+    }
+
+    TaskPriorityStats(const TaskPriorityStats&) = delete;
+    TaskPriorityStats& operator=(const TaskPriorityStats&) = delete;
+
+    void onQueued(TaskPriority priority) override {
+        of(priority).depth.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void onExpired(TaskPriority priority) override {
+        auto& klass = of(priority);
+        klass.depth.fetch_sub(1, std::memory_order_relaxed);
+        StatsManager::addValue(klass.expired);
+    }
+
+    void onStarted(TaskPriority priority, Duration wait) override {
+        auto& klass = of(priority);
+        klass.depth.fetch_sub(1, std::memory_order_relaxed);
+        StatsManager::addValue(klass.wait, toMicros(wait));
+    }
+
+    void onFinished(TaskPriority priority, Duration exec) override {
+        StatsManager::addValue(of(priority).exec, toMicros(exec));
+    }
+
+private:
+    explicit TaskPriorityStats(const std::string& prefix) : prefix_(prefix) {
+        for (auto i = 0UL; i < kNumTaskPriorities; i++) {
+            auto name = folly::stringPrintf("%s_%s",
+                                            prefix.c_str(),
+                                            toString(static_cast<TaskPriority>(i)));
+            auto& klass = classes_[i];
+            auto* depth = &klass.depth;
+            klass.depthName = name + "_queue_depth";
+            StatsManager::registerGauge(klass.depthName, [depth] () -> int64_t {
+                return depth->load(std::memory_order_relaxed);
+            });
+            // Up to 10s
+            klass.wait = StatsManager::registerHdrHisto(name + "_wait_us", 10000000);
+            klass.exec = StatsManager::registerHdrHisto(name + "_exec_us", 10000000);
+            klass.expired = StatsManager::registerShardedStats(name + "_expired");
+        }
+    }
+
+    // The deleter of the instances made by get(). Another instance of the
+    // prefix may have been made since the last reference to this one was
+    // dropped, which has taken over the gauges then.
+    static void destroy(TaskPriorityStats* stats) {
+        {
+            std::lock_guard<std::mutex> g(registryLock());
+            auto& live = registry();
+            auto it = live.find(stats->prefix_);
+            if (it != live.end() && it->second.expired()) {
+                live.erase(it);
+                for (auto& klass : stats->classes_) {
+                    StatsManager::unregisterGauge(klass.depthName);
+                }
+            }
+        }
+        delete stats;
+    }
+
+    static std::mutex& registryLock() {
+        static std::mutex lock;
+        return lock;
+    }
+
+    static std::unordered_map<std::string, std::weak_ptr<TaskPriorityStats>>& registry() {
+        static std::unordered_map<std::string, std::weak_ptr<TaskPriorityStats>> live;
+        return live;
+    }
+
+    struct Class {
+        std::atomic<int64_t>    depth{0};
+        std::string             depthName;
+        int32_t                 wait{0};
+        int32_t                 exec{0};
+        int32_t                 expired{0};
+    };
+
+    Class& of(TaskPriority priority) {
+        return classes_[static_cast<size_t>(priority)];
+    }
+
+    static int64_t toMicros(Duration duration) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    }
+
+private:
+    const std::string                   prefix_;
+    Class                               classes_[kNumTaskPriorities];
+};
+
+}  // namespace stats
+}  // namespace nebula
+
+#endif  // COMMON_STATS_TASKPRIORITYSTATS_H_
@@ -0,0 +1,132 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "stats/HdrHistogram.h"
+
+namespace nebula {
+namespace stats {
+
+using std::chrono::seconds;
+
+TEST(HdrHistogram, BucketTest) {
+    for (int64_t v = 0; v < 16; v++) {
+        EXPECT_EQ(v, HdrHistogram::bucketIndex(v));
+        EXPECT_EQ(v, HdrHistogram::bucketLowerBound(v));
+    }
+    EXPECT_EQ(0, HdrHistogram::bucketIndex(-5));
+
+    // Every value falls into [lower, nextLower), and the width of any bucket
+    // is within 1/16 of its lower bound
+    for (int64_t v = 16; v < 10000000; v = v * 3 / 2 + 1) {
+        auto index = HdrHistogram::bucketIndex(v);
+        auto lower = HdrHistogram::bucketLowerBound(index);
+        auto upper = HdrHistogram::bucketLowerBound(index + 1);
+        EXPECT_LE(lower, v);
+        EXPECT_LT(v, upper);
+        EXPECT_LE((upper - lower) * 16, lower);
+    }
+
+    // 1us to 10s
+    HdrHistogram histo(10000000);
+    EXPECT_EQ(324, histo.numBuckets());
+}
+
+
+TEST(HdrHistogram, PercentileTest) {
+    HdrHistogram histo(100);
+    for (int64_t v = 1; v <= 100; v++) {
+        histo.addValue(v, v);
+    }
+    histo.update(seconds(1000));
+
+    for (size_t level = 0; level < HdrHistogram::kNumLevels; level++) {
+        EXPECT_EQ(5050, histo.sum(level));
+        EXPECT_EQ(100, histo.count(level));
+        EXPECT_EQ(50, histo.avg<int64_t>(level));
+        EXPECT_EQ(99, histo.getPercentileEstimate(99, level));
+        EXPECT_EQ(100, histo.getPercentileEstimate(100, level));
+        EXPECT_EQ(10, histo.getPercentileEstimate(10, level));
+        EXPECT_EQ(50, histo.getPercentileEstimate(50, level));
+    }
+}
+
+
+TEST(HdrHistogram, RelativeErrorTest) {
+    HdrHistogram histo(10000000);
+    // Latencies from 1us to 10s
+    std::vector<int64_t> values;
+    for (int64_t v = 1; v <= 10000000; v = v * 11 / 10 + 1) {
+        values.emplace_back(v);
+        histo.addValue(v, v);
+    }
+    histo.update(seconds(1000));
+
+    for (double pct : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+        auto rank = static_cast<size_t>(std::ceil(values.size() * pct / 100));
+        auto expected = values[rank - 1];
+        auto actual = histo.getPercentileEstimate(pct, 0);
+        EXPECT_LE(std::abs(actual - expected) * 16, expected) << "p" << pct;
+    }
+}
+
+
+TEST(HdrHistogram, WindowTest) {
+    HdrHistogram histo(1000);
+    histo.addValue(0, 10);
+    histo.update(seconds(1000));
+    histo.addValue(0, 20);
+    histo.update(seconds(1003));
+    EXPECT_EQ(30, histo.sum(0));
+    EXPECT_EQ(2, histo.count(0));
+    EXPECT_EQ(7, histo.rate<int64_t>(0));
+
+    // The first value falls out of the 5 seconds window
+    histo.update(seconds(1005));
+    EXPECT_EQ(20, histo.sum(0));
+    EXPECT_EQ(20, histo.getPercentileEstimate(50, 0));
+    EXPECT_EQ(30, histo.sum(1));
+
+    // And both fall out of the 1 minute window
+    histo.update(seconds(1100));
+    EXPECT_EQ(0, histo.sum(0));
+    EXPECT_EQ(0, histo.count(1));
+    EXPECT_EQ(0, histo.getPercentileEstimate(50, 1));
+    EXPECT_EQ(30, histo.sum(2));
+    EXPECT_EQ(30, histo.sum(3));
+}
+
+
+TEST(HdrHistogram, ConcurrentTest) {
+    HdrHistogram histo(1000000);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 32; i++) {
+        threads.emplace_back([&histo, i] () {
+            for (int64_t k = 1; k <= 10000; k++) {
+                histo.addValue(i, k);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    histo.update(seconds(1000));
+    EXPECT_EQ(320000, histo.count(3));
+    EXPECT_EQ(32 * 50005000L, histo.sum(3));
+}
+
+}   // namespace stats
+}   // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,68 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <folly/io/IOBufQueue.h>
+#include "stats/StatsManager.h"
+
+using nebula::stats::StatsManager;
+
+DEFINE_int32(num_counters, 10000, "Number of counters to export");
+
+// The same as GetStatsHandler::toStr()
+std::string toStr(folly::dynamic& vals) {
+    std::stringstream ss;
+    for (auto& counter : vals) {
+        auto& val = counter["value"];
+        ss << counter["name"].asString() << "="
+           << val.asString()
+           << "\n";
+    }
+    return ss.str();
+}
+
+
+BENCHMARK(export_plain_text, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        folly::dynamic vals = folly::dynamic::array();
+        StatsManager::readAllValue(vals);
+        auto str = toStr(vals);
+        folly::doNotOptimizeAway(str);
+    }
+}
+
+BENCHMARK_RELATIVE(export_json, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        folly::dynamic vals = folly::dynamic::array();
+        StatsManager::readAllValue(vals);
+        auto str = folly::toJson(vals);
+        folly::doNotOptimizeAway(str);
+    }
+}
+
+BENCHMARK_RELATIVE(export_open_metrics, iters) {
+    for (size_t i = 0; i < iters; i++) {
+        folly::IOBufQueue queue(folly::IOBufQueue::cacheChainLength());
+        StatsManager::readAllMetrics(queue);
+        folly::doNotOptimizeAway(queue.chainLength());
+    }
+}
+
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+
+    for (int32_t i = 0; i < FLAGS_num_counters; i++) {
+        auto id = StatsManager::registerStats(folly::stringPrintf("counter_%d", i));
+        for (int64_t k = 1; k <= 10; k++) {
+            StatsManager::addValue(id, k);
+        }
+    }
+
+    folly::runBenchmarks();
+    return 0;
+}
@@ -7,11 +7,36 @@
 #include "base/Base.h"
 #include <folly/Benchmark.h>
 #include "stats/StatsManager.h"
+#include <folly/stats/TimeseriesHistogram-defs.h>
 
 using nebula::stats::StatsManager;
+using nebula::stats::HdrHistogram;
+
+// Bytes allocated through the global operator new, to measure the footprint
+// of the histograms
+static std::atomic<size_t> gAllocatedBytes{0};
+
+void* operator new(size_t size) {
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    auto* p = ::malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    ::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    ::free(p);
+}
 
 const int32_t kCounterStats = StatsManager::registerStats("stats");
 const int32_t kCounterHisto = StatsManager::registerHisto("histogram", 10, 1, 100);
+const int32_t kCounterSharded = StatsManager::registerShardedStats("sharded_stats");
+const int32_t kCounterHdrHisto = StatsManager::registerHdrHisto("hdr_histogram", 100);
 
 
 void statsBM(int32_t counterId, uint32_t numThreads, uint32_t iters) {
@@ -46,6 +71,28 @@ BENCHMARK(add_stats_value_8t, iters) {
     statsBM(kCounterStats, 8, iters);
 }
 
+BENCHMARK(add_stats_value_16t, iters) {
+    statsBM(kCounterStats, 16, iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(add_sharded_stats_value_1t, iters) {
+    statsBM(kCounterSharded, 1, iters);
+}
+
+BENCHMARK(add_sharded_stats_value_4t, iters) {
+    statsBM(kCounterSharded, 4, iters);
+}
+
+BENCHMARK(add_sharded_stats_value_8t, iters) {
+    statsBM(kCounterSharded, 8, iters);
+}
+
+BENCHMARK(add_sharded_stats_value_16t, iters) {
+    statsBM(kCounterSharded, 16, iters);
+}
+
 BENCHMARK_DRAW_LINE();
 
 BENCHMARK(add_histogram_value_1t, iters) {
@@ -60,6 +107,28 @@ BENCHMARK(add_histogram_value_8t, iters) {
     statsBM(kCounterHisto, 8, iters);
 }
 
+BENCHMARK(add_histogram_value_16t, iters) {
+    statsBM(kCounterHisto, 16, iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(add_hdr_histogram_value_1t, iters) {
+    statsBM(kCounterHdrHisto, 1, iters);
+}
+
+BENCHMARK(add_hdr_histogram_value_4t, iters) {
+    statsBM(kCounterHdrHisto, 4, iters);
+}
+
+BENCHMARK(add_hdr_histogram_value_8t, iters) {
+    statsBM(kCounterHdrHisto, 8, iters);
+}
+
+BENCHMARK(add_hdr_histogram_value_16t, iters) {
+    statsBM(kCounterHdrHisto, 16, iters);
+}
+
 BENCHMARK_DRAW_LINE();
 
 
@@ -67,6 +136,21 @@ int main(int argc, char** argv) {
     folly::init(&argc, &argv, true);
 
     folly::runBenchmarks();
+
+    // Memory footprint of one histogram, both covering 1us to 10s
+    using std::chrono::seconds;
+    using StatsType = folly::MultiLevelTimeSeries<int64_t>;
+    auto before = gAllocatedBytes.load();
+    auto histo = std::make_unique<folly::TimeseriesHistogram<int64_t>>(
+        1000, 1, 10000000,
+        StatsType(60, {seconds(5), seconds(60), seconds(600), seconds(3600)}));
+    auto histoBytes = gAllocatedBytes.load() - before;
+    before = gAllocatedBytes.load();
+    auto hdr = std::make_unique<HdrHistogram>(10000000);
+    auto hdrBytes = gAllocatedBytes.load() - before;
+    LOG(INFO) << "TimeseriesHistogram (bucket width 1ms): " << histoBytes << " bytes";
+    LOG(INFO) << "HdrHistogram (" << hdr->numBuckets() << " log buckets): "
+              << hdrBytes << " bytes";
     return 0;
 }
 
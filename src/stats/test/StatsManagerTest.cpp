@@ -7,7 +7,11 @@
 #include "base/Base.h"
 #include <gtest/gtest.h>
 #include "stats/StatsManager.h"
+#include "stats/CacheStats.h"
+#include "stats/TaskPriorityStats.h"
+#include "base/ConcurrentLRUCache.h"
 #include "thread/GenericWorker.h"
+#include <folly/synchronization/Baton.h>
 
 namespace nebula {
 namespace stats {
@@ -91,6 +95,176 @@ TEST(StatsManager, HistogramTest) {
 }
 
 
+TEST(StatsManager, ShardedStatsTest) {
+    auto statId = StatsManager::registerShardedStats("stat03");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 100; i++) {
+        threads.emplace_back([statId, i] () {
+            for (int k = i * 10 + 1; k <= i * 10 + 10; k++) {
+                StatsManager::addValue(statId, k);
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // The pending slots are folded on read, no need to wait for the aggregator
+    EXPECT_EQ(500500, StatsManager::readValue("stat03.sum.60").value());
+    EXPECT_EQ(1000, StatsManager::readValue("stat03.count.60").value());
+    EXPECT_EQ(500, StatsManager::readValue("stat03.avg.60").value());
+
+    // Values folded by the aggregator are read the same
+    StatsManager::addValue(statId, 1000);
+    StatsManager::get().aggregateOnce();
+    EXPECT_EQ(501500, StatsManager::readValue("stat03.sum.600").value());
+    EXPECT_EQ(1001, StatsManager::readValue("stat03.count.3600").value());
+}
+
+
+TEST(StatsManager, HdrHistogramTest) {
+    auto statId = StatsManager::registerHdrHisto("stat04", 100);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 10; i++) {
+        threads.emplace_back([statId, i] () {
+            for (int k = i * 10 + 1; k <= i * 10 + 10; k++) {
+                StatsManager::addValue(statId, k);
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(5050, StatsManager::readValue("stat04.sum.60").value());
+    EXPECT_EQ(100, StatsManager::readValue("stat04.count.600").value());
+    EXPECT_EQ(50, StatsManager::readValue("stat04.avg.3600").value());
+    EXPECT_EQ(99, StatsManager::readValue("stat04.p99.60").value());
+    EXPECT_EQ(100, StatsManager::readValue("stat04.p9999.600").value());
+    EXPECT_EQ(50, StatsManager::readValue("stat04.p50.3600").value());
+    EXPECT_FALSE(StatsManager::readValue("stat04.t99.60").ok());
+}
+
+
+TEST(StatsManager, GaugeTest) {
+    int64_t value = 10;
+    auto statId = StatsManager::registerGauge("stat05", [&value] { return value; });
+    EXPECT_EQ(10, StatsManager::readValue("stat05.sum.60").value());
+    value = 20;
+    EXPECT_EQ(20, StatsManager::readValue("stat05.avg.3600").value());
+    EXPECT_EQ(20, StatsManager::readStats(statId,
+                                          StatsManager::TimeRange::ONE_MINUTE,
+                                          StatsManager::StatsMethod::RATE).value());
+
+    // Replace the callback
+    EXPECT_EQ(statId, StatsManager::registerGauge("stat05", [] { return 30; }));
+    EXPECT_EQ(30, StatsManager::readValue("stat05.count.5").value());
+
+    folly::IOBufQueue queue;
+    StatsManager::readAllMetrics(queue);
+    auto metrics = queue.move()->moveToFbString().toStdString();
+    EXPECT_NE(std::string::npos, metrics.find("# TYPE stat05 gauge\nstat05 30\n"));
+
+    StatsManager::unregisterGauge("stat05");
+    EXPECT_FALSE(StatsManager::readValue("stat05.sum.60").ok());
+    EXPECT_FALSE(StatsManager::readStats(statId,
+                                         StatsManager::TimeRange::ONE_MINUTE,
+                                         StatsManager::StatsMethod::SUM).ok());
+
+    // The entry is reused by the next gauge
+    EXPECT_EQ(statId, StatsManager::registerGauge("stat06", [] { return 40; }));
+    EXPECT_EQ(40, StatsManager::readValue("stat06.sum.60").value());
+    StatsManager::unregisterGauge("stat06");
+}
+
+
+TEST(StatsManager, CacheStatsTest) {
+    auto weigher = [] (const int32_t&, const std::string& val) {
+        return val.size();
+    };
+    ConcurrentLRUCache<int32_t, std::string> cache(1024, 0, weigher);
+    {
+        CacheStats cacheStats("cache01", cache);
+        cache.insert(1, std::string(100, 'a'));
+        cache.insert(2, std::string(200, 'a'));
+        EXPECT_TRUE(cache.get(1).ok());
+        EXPECT_FALSE(cache.get(3).ok());
+        EXPECT_EQ(300, StatsManager::readValue("cache01_weight.sum.60").value());
+        EXPECT_EQ(1024, StatsManager::readValue("cache01_capacity.sum.60").value());
+        EXPECT_EQ(1, StatsManager::readValue("cache01_hits.sum.60").value());
+        EXPECT_EQ(2, StatsManager::readValue("cache01_total.sum.60").value());
+        EXPECT_EQ(0, StatsManager::readValue("cache01_evicts.sum.60").value());
+    }
+    EXPECT_FALSE(StatsManager::readValue("cache01_weight.sum.60").ok());
+}
+
+
+TEST(StatsManager, TaskPriorityStatsTest) {
+    using thread::TaskOptions;
+    using thread::TaskPriority;
+    {
+        thread::GenericWorker worker;
+        worker.setStats(TaskPriorityStats::get("worker01"));
+        ASSERT_TRUE(worker.start());
+        folly::Baton<> started;
+        folly::Baton<> baton;
+        worker.run([&] () {
+            started.post();
+            baton.wait();
+        });
+        started.wait();
+        for (auto i = 0; i < 3; i++) {
+            worker.run([] () { ::usleep(1000); }, TaskOptions(TaskPriority::HIGH));
+        }
+        worker.run([] () {}, TaskOptions(TaskPriority::LOW, TaskOptions::Clock::now()));
+        EXPECT_EQ(3, StatsManager::readValue("worker01_high_queue_depth.sum.60").value());
+        EXPECT_EQ(1, StatsManager::readValue("worker01_low_queue_depth.sum.60").value());
+        ::usleep(5000);
+        baton.post();
+        worker.addTask([] () {}).get();
+        EXPECT_EQ(0, StatsManager::readValue("worker01_high_queue_depth.sum.60").value());
+        EXPECT_EQ(0, StatsManager::readValue("worker01_low_queue_depth.sum.60").value());
+        EXPECT_EQ(3, StatsManager::readValue("worker01_high_exec_us.count.60").value());
+        // Within the error of the buckets
+        EXPECT_LE(900, StatsManager::readValue("worker01_high_exec_us.p50.60").value());
+        EXPECT_LE(4500, StatsManager::readValue("worker01_high_wait_us.p50.60").value());
+        EXPECT_EQ(1, StatsManager::readValue("worker01_low_expired.sum.60").value());
+        EXPECT_EQ(0, StatsManager::readValue("worker01_low_exec_us.count.60").value());
+    }
+    EXPECT_FALSE(StatsManager::readValue("worker01_high_queue_depth.sum.60").ok());
+
+    // The gauges come and go while the others are updated and read
+    auto probe = StatsManager::registerGauge("worker02_probe", [] { return 0; });
+    StatsManager::unregisterGauge("worker02_probe");
+    thread::GenericWorker worker;
+    worker.setStats(TaskPriorityStats::get("worker02"));
+    ASSERT_TRUE(worker.start());
+    std::thread churner([] () {
+        for (auto i = 0; i < 100; i++) {
+            auto stats = TaskPriorityStats::get("worker03");
+        }
+    });
+    for (auto i = 0; i < 100; i++) {
+        worker.addTask(TaskOptions(TaskPriority::HIGH), [] () {}).get();
+        EXPECT_EQ(0, StatsManager::readValue("worker02_high_queue_depth.sum.60").value());
+    }
+    churner.join();
+    EXPECT_EQ(100, StatsManager::readValue("worker02_high_exec_us.count.60").value());
+    EXPECT_FALSE(StatsManager::readValue("worker03_high_queue_depth.sum.60").ok());
+
+    // Shared by the prefix, so the gauge of worker02 outlives the one got here
+    EXPECT_EQ(TaskPriorityStats::get("worker02").get(), TaskPriorityStats::get("worker02").get());
+    EXPECT_TRUE(StatsManager::readValue("worker02_high_queue_depth.sum.60").ok());
+    worker.stop();
+    worker.wait();
+    // The entries are reused, so worker02 and worker03 took six gauges and six
+    // counters in all
+    EXPECT_GE(probe + 10, StatsManager::registerGauge("worker02_probe", [] { return 0; }));
+    StatsManager::unregisterGauge("worker02_probe");
+}
+
 }   // namespace stats
 }   // namespace nebula
 
@@ -0,0 +1,133 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+#ifndef COMMON_THREAD_CPUBINDING_H_
+#define COMMON_THREAD_CPUBINDING_H_
+
+#include "base/Base.h"
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+
+/**
+ * CpuBinding is the set of CPUs a thread is bound to, and the NUMA node of them.
+ * It is header-only, like NamedThread which applies it.
+ *
+ * PlacementRegistry keeps the binding of each NamedThread alive, so that the web
+ * service reports where the threads are placed.
+ */
+
+namespace nebula {
+namespace thread {
+
+struct CpuBinding {
+    // The NUMA node of `cpus', or -1 if they are not on a single node
+    int                                 node{-1};
+    // Empty if the thread floats over all the CPUs
+    std::vector<int>                    cpus;
+
+    bool empty() const {
+        return cpus.empty();
+    }
+
+    /**
+     * To bind the calling thread to `cpus'.
+     * @return  false if any of them is not allowed, e.g. offline or out of the cpuset
+     */
+    bool apply() const {
+        if (cpus.empty()) {
+            return true;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (auto cpu : cpus) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                LOG(ERROR) << "Invalid CPU " << cpu;
+                return false;
+            }
+            CPU_SET(cpu, &set);
+        }
+        auto err = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            LOG(ERROR) << "Failed to bind the thread to CPUs " << toString()
+                       << ": " << ::strerror(err);
+            return false;
+        }
+        return true;
+    }
+
+    std::string toString() const {
+        if (cpus.empty()) {
+            return "any";
+        }
+        // In ranges, e.g. "0-3,8"
+        std::string str;
+        for (auto i = 0UL; i < cpus.size();) {
+            auto j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+                j++;
+            }
+            if (!str.empty()) {
+                str += ",";
+            }
+            str += folly::to<std::string>(cpus[i]);
+            if (j > i) {
+                str += folly::to<std::string>("-", cpus[j]);
+            }
+            i = j + 1;
+        }
+        return str;
+    }
+};
+
+
+class PlacementRegistry final {
+public:
+    struct Entry {
+        pid_t                           tid;
+        std::string                     name;
+        CpuBinding                      binding;
+    };
+
+    static PlacementRegistry& instance() {
+        static PlacementRegistry registry;
+        return registry;
+    }
+
+    void add(pid_t tid, std::string name, CpuBinding binding) {
+        std::lock_guard<std::mutex> guard(lock_);
+        entries_[tid] = Entry{tid, std::move(name), std::move(binding)};
+    }
+
+    void remove(pid_t tid) {
+        std::lock_guard<std::mutex> guard(lock_);
+        entries_.erase(tid);
+    }
+
+    // The threads alive, in the order of their IDs
+    std::vector<Entry> snapshot() const {
+        std::lock_guard<std::mutex> guard(lock_);
+        std::vector<Entry> entries;
+        entries.reserve(entries_.size());
+        for (auto &entry : entries_) {
+            entries.emplace_back(entry.second);
+        }
+        return entries;
+    }
+
+private:
+    PlacementRegistry() = default;
+
+private:
+    mutable std::mutex                  lock_;
+    std::map<pid_t, Entry>              entries_;
+};
+
+}   // namespace thread
+}   // namespace nebula
+
+#endif  // COMMON_THREAD_CPUBINDING_H_
@@ -10,6 +10,21 @@
 namespace nebula {
 namespace thread {
 
+namespace {
+
+// The pool and the index of the thread running, if it is a pool's
+struct CurrentThread {
+    GenericThreadPool  *pool{nullptr};
+    size_t              idx{0};
+};
+
+thread_local CurrentThread currentThread;
+
+}   // namespace
+
+constexpr size_t GenericThreadPool::kMaxTasksPerRound;
+constexpr size_t GenericThreadPool::kMaxFreeTasks;
+
 GenericThreadPool::GenericThreadPool() {
 }
 
@@ -18,15 +33,31 @@ GenericThreadPool::~GenericThreadPool() {
     wait();
 }
 
-bool GenericThreadPool::start(size_t nrThreads, const std::string &name) {
+bool GenericThreadPool::start(size_t nrThreads,
+                              const std::string &name,
+                              bool workStealing,
+                              const ThreadPlacement &placement) {
     if (nrThreads_ != 0) {
         return false;
     }
     nrThreads_ = nrThreads;
+    workStealing_ = workStealing;
+    if (workStealing_) {
+        for (auto i = 0UL; i < nrThreads_; i++) {
+            slots_.emplace_back(std::make_unique<Slot>());
+        }
+        nrSleeping_ = nrThreads_;
+    }
     auto ok = true;
     for (auto i = 0UL; ok && i < nrThreads_; i++) {
         pool_.emplace_back(std::make_unique<GenericWorker>());
-        ok = ok && pool_.back()->start(name);
+        if (workStealing_) {
+            pool_.back()->pool_ = this;
+            pool_.back()->poolIndex_ = i;
+        }
+        pool_.back()->setStats(stats_);
+        bindings_.emplace_back(placement.bindingOf(i));
+        ok = ok && pool_.back()->start(name, bindings_.back());
     }
     return ok;
 }
@@ -46,6 +77,15 @@ bool GenericThreadPool::wait() {
     }
     nrThreads_ = 0;
     pool_.clear();
+    bindings_.clear();
+    // The tasks never run are dropped, which breaks their promises
+    for (auto &slot : slots_) {
+        Task task;
+        while (takeTask(*slot, *slot, task)) {
+            task.reset();
+        }
+    }
+    slots_.clear();
     return ok;
 }
 
@@ -55,5 +95,107 @@ void GenericThreadPool::purgeTimerTask(uint64_t id) {
     pool_[idx]->purgeTimerTask(id);
 }
 
+void GenericThreadPool::schedule(Task task) {
+    size_t idx;
+    if (currentThread.pool == this) {
+        idx = currentThread.idx;
+        auto &slot = *slots_[idx];
+        std::unique_ptr<Task> node;
+        if (slot.free_.empty()) {
+            node = std::make_unique<Task>(std::move(task));
+        } else {
+            node = std::move(slot.free_.back());
+            slot.free_.pop_back();
+            *node = std::move(task);
+        }
+        slot.deque_.push(node.release());
+    } else {
+        idx = nextThread_++ % nrThreads_;
+        slots_[idx]->inbound_.enqueue(std::move(task));
+    }
+    // Pairs with the fence in runTasks, so either the thread sees the task
+    // before it sleeps, or we see it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (wake(idx) || nrSleeping_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    // The thread is busy, wake another one to steal the task
+    for (auto i = 1UL; i < nrThreads_; i++) {
+        if (wake((idx + i) % nrThreads_)) {
+            return;
+        }
+    }
+}
+
+bool GenericThreadPool::wake(size_t idx) {
+    auto &sleeping = slots_[idx]->sleeping_;
+    if (!sleeping.load(std::memory_order_relaxed) || !sleeping.exchange(false)) {
+        return false;
+    }
+    nrSleeping_--;
+    pool_[idx]->notify();
+    return true;
+}
+
+void GenericThreadPool::runTasks(size_t idx) {
+    currentThread.pool = this;
+    currentThread.idx = idx;
+    auto &slot = *slots_[idx];
+    Task task;
+    for (auto i = 0UL; i < kMaxTasksPerRound; i++) {
+        if (!nextTask(idx, task)) {
+            // Look once more after being marked as sleeping, so that a task
+            // added meanwhile is either found here or wakes this thread
+            if (!slot.sleeping_.exchange(true)) {
+                nrSleeping_++;
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!nextTask(idx, task)) {
+                return;
+            }
+            if (slot.sleeping_.exchange(false)) {
+                nrSleeping_--;
+            }
+        }
+        task();
+        task.reset();
+    }
+    // Let the timers and the tasks of the worker itself run, and come back
+    pool_[idx]->notify();
+}
+
+bool GenericThreadPool::nextTask(size_t idx, Task &task) {
+    auto &slot = *slots_[idx];
+    if (takeTask(slot, slot, task)) {
+        return true;
+    }
+    auto start = folly::Random::rand32(nrThreads_);
+    for (auto i = 0UL; i < nrThreads_; i++) {
+        auto victim = (start + i) % nrThreads_;
+        if (victim == idx) {
+            continue;
+        }
+        if (takeTask(slot, *slots_[victim], task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// static
+bool GenericThreadPool::takeTask(Slot &own, Slot &from, Task &task) {
+    Task *node = nullptr;
+    if (&own == &from ? from.deque_.pop(node) : from.deque_.steal(node)) {
+        task = std::move(*node);
+        if (own.free_.size() < kMaxFreeTasks) {
+            own.free_.emplace_back(node);
+        } else {
+            delete node;
+        }
+        return true;
+    }
+    return from.inbound_.try_dequeue(task);
+}
+
 }   // namespace thread
 }   // namespace nebula
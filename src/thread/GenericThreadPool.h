@@ -6,13 +6,28 @@
 #ifndef COMMON_THREAD_GENERICTHREADPOOL_H_
 #define COMMON_THREAD_GENERICTHREADPOOL_H_
 
+#include <folly/concurrency/UnboundedQueue.h>
 #include "thread/GenericWorker.h"
+#include "thread/ThreadPlacement.h"
+#include "thread/WorkStealingDeque.h"
 
 /**
  * Based on GenericWorker, GenericThreadPool implements a thread pool that execute tasks asynchronously.
  *
  * Under the hood, GenericThreadPool distributes tasks around the internal threads in a round-robin way.
  *
+ * In the work-stealing mode, the normal tasks are shared by all the threads instead. A task added
+ * from outside is queued to a thread in the round-robin way, and one added by a task goes to the
+ * WorkStealingDeque of its own thread. A thread out of tasks steals from the others before it
+ * sleeps, and is only woken, through its eventfd, if it is sleeping. The timer tasks still run
+ * on the thread they are added to.
+ *
+ * The tasks of each priority class are queued apart on each thread, see TaskOptions. The tasks
+ * with options are never shared in the work-stealing mode, but queued to a thread round-robin.
+ *
+ * The threads could be placed on the CPUs and NUMA nodes by a ThreadPlacement, and the state
+ * of each thread is then best made by `makeLocal', on the node of the thread.
+ *
  * Please NOTE that, as the name indicates, this a thread pool for the general purpose,
  * but not for the performance critical situation.
  */
@@ -38,10 +53,15 @@ public:
      * A GenericThreadPool MUST be `start'ed successfully before invoking
      * any other interfaces.
      *
-     * @nrThreads   number of internal threads
-     * @name        name of internal threads
+     * @nrThreads       number of internal threads
+     * @name            name of internal threads
+     * @workStealing    whether the idle threads steal the normal tasks of the busy ones
+     * @placement       how the internal threads are bound to the CPUs
      */
-    bool start(size_t nrThreads, const std::string &name = "");
+    bool start(size_t nrThreads,
+               const std::string &name = "",
+               bool workStealing = false,
+               const ThreadPlacement &placement = ThreadPlacement());
 
     /**
      * Asynchronouly to notify the workers to stop handling further new tasks.
@@ -63,6 +83,15 @@ public:
     using FutureType = folly::SemiFuture<ReturnType<F, Args...>>;
     using UnitFutureType = folly::SemiFuture<folly::Unit>;
 
+    /**
+     * To run a task, whose result or exception is dropped.
+     * @task    a callable object, which takes no arguments
+     */
+    template <typename F>
+    void run(F&&);
+    template <typename F>
+    void run(F&&, const TaskOptions&);
+
     /**
      * To add a normal task.
      * @task    a callable object
@@ -83,6 +112,28 @@ public:
             UnitFutureType
            >::type;
 
+    /**
+     * To add a task of a priority class, or with a deadline.
+     * @options priority class and deadline of the task
+     * @task    a callable object
+     * @args    variadic arguments
+     * @return  an instance of `folly::SemiFuture' you could wait upon
+     *          for the result of `task', which fails with `folly::BrokenPromise'
+     *          if the task is dropped for its deadline
+     */
+    template <typename F, typename...Args>
+    auto addTask(const TaskOptions&, F&&, Args&&...)
+        -> typename std::enable_if<
+            !std::is_void<ReturnType<F, Args...>>::value,
+            FutureType<F, Args...>
+           >::type;
+    template <typename F, typename...Args>
+    auto addTask(const TaskOptions&, F&&, Args&&...)
+        -> typename std::enable_if<
+            std::is_void<ReturnType<F, Args...>>::value,
+            UnitFutureType
+           >::type;
+
     /**
      * To add a oneshot timer task which will be executed after a while.
      * @ms      milliseconds from now when the task get executed
@@ -120,33 +171,158 @@ public:
      */
     void purgeTimerTask(uint64_t id);
 
+    /**
+     * To be notified of the tasks queued and run by all the threads,
+     * e.g. by `stats::TaskPriorityStats'. It must be set before `start'.
+     */
+    void setStats(std::shared_ptr<TaskStats> stats) {
+        stats_ = std::move(stats);
+    }
+
+    size_t size() const {
+        return nrThreads_;
+    }
+
+    /**
+     * The CPUs the idx-th thread is bound to.
+     */
+    const CpuBinding& bindingOf(size_t idx) const {
+        return bindings_[idx];
+    }
+
+    /**
+     * To make an object on the idx-th thread, so that its memory is allocated
+     * from the NUMA node of the thread, and wait for it.
+     * It must not be called by the threads of this pool.
+     */
+    template <typename T, typename...Args>
+    std::unique_ptr<T> makeLocal(size_t idx, Args &&...args);
+
 private:
+    friend class GenericWorker;
+
+    // The tasks of one thread in the work-stealing mode
+    struct Slot {
+        // Added by the tasks running on this thread. The deque only takes
+        // pointers, so the tasks are moved into the nodes of `free_'
+        WorkStealingDeque<Task*>                    deque_;
+        // Added from outside the pool
+        folly::UMPMCQueue<Task, false>              inbound_;
+        // The nodes of the tasks this thread took from any deque, only touched
+        // by this thread, so the deques allocate nothing once warmed up
+        std::vector<std::unique_ptr<Task>>          free_;
+        std::atomic<bool>                           sleeping_{true};
+    };
+
+    // To queue a normal task in the work-stealing mode
+    void schedule(Task task);
+    // To wake the idx-th thread if it is sleeping, return true if woken
+    bool wake(size_t idx);
+    // To run the shared tasks on the idx-th thread, till there is none left
+    void runTasks(size_t idx);
+    // To take a task for the idx-th thread, of its own or stolen
+    bool nextTask(size_t idx, Task &task);
+    // To take a task of `from' for the thread of `own', by stealing if they differ
+    static bool takeTask(Slot &own, Slot &from, Task &task);
+
+private:
+    // The most tasks run in a row, before the thread goes back to its events
+    static constexpr size_t kMaxTasksPerRound = 256;
+    // The most nodes kept by a thread for the next tasks
+    static constexpr size_t kMaxFreeTasks = 1024;
     size_t                                          nrThreads_{0};
     std::atomic<size_t>                             nextThread_{0};
     std::vector<std::unique_ptr<GenericWorker>>     pool_;
+    std::vector<CpuBinding>                         bindings_;
+    std::shared_ptr<TaskStats>                      stats_;
+    bool                                            workStealing_{false};
+    std::vector<std::unique_ptr<Slot>>              slots_;
+    std::atomic<size_t>                             nrSleeping_{0};
 };
 
 
+template <typename F>
+void GenericThreadPool::run(F &&f) {
+    if (!workStealing_) {
+        auto idx = nextThread_++ % nrThreads_;
+        pool_[idx]->run(std::forward<F>(f));
+        return;
+    }
+    schedule(Task(std::forward<F>(f)));
+}
+
+
+template <typename F, typename...Args>
+auto GenericThreadPool::addTask(F &&f, Args &&...args)
+        -> typename std::enable_if<
+            !std::is_void<ReturnType<F, Args...>>::value,
+            FutureType<F, Args...>
+           >::type {
+    if (!workStealing_) {
+        auto idx = nextThread_++ % nrThreads_;
+        return pool_[idx]->addTask(std::forward<F>(f),
+                                   std::forward<Args>(args)...);
+    }
+    folly::Promise<ReturnType<F, Args...>> promise;
+    auto future = promise.getSemiFuture();
+    schedule([promise = std::move(promise),
+              task = Task::bind(std::forward<F>(f), std::forward<Args>(args)...)] () mutable {
+        promise.setWith(task);
+    });
+    return future;
+}
+
+
 template <typename F, typename...Args>
 auto GenericThreadPool::addTask(F &&f, Args &&...args)
+        -> typename std::enable_if<
+            std::is_void<ReturnType<F, Args...>>::value,
+            UnitFutureType
+           >::type {
+    if (!workStealing_) {
+        auto idx = nextThread_++ % nrThreads_;
+        return pool_[idx]->addTask(std::forward<F>(f),
+                                   std::forward<Args>(args)...);
+    }
+    folly::Promise<folly::Unit> promise;
+    auto future = promise.getSemiFuture();
+    schedule([promise = std::move(promise),
+              task = Task::bind(std::forward<F>(f), std::forward<Args>(args)...)] () mutable {
+        promise.setWith(task);
+    });
+    return future;
+}
+
+
+template <typename F>
+void GenericThreadPool::run(F &&f, const TaskOptions &options) {
+    auto idx = nextThread_++ % nrThreads_;
+    pool_[idx]->run(std::forward<F>(f), options);
+}
+
+
+template <typename F, typename...Args>
+auto GenericThreadPool::addTask(const TaskOptions &options, F &&f, Args &&...args)
         -> typename std::enable_if<
             !std::is_void<ReturnType<F, Args...>>::value,
             FutureType<F, Args...>
            >::type {
     auto idx = nextThread_++ % nrThreads_;
-    return pool_[idx]->addTask(std::forward<F>(f),
+    return pool_[idx]->addTask(options,
+                               std::forward<F>(f),
                                std::forward<Args>(args)...);
 }
 
 
 template <typename F, typename...Args>
-auto GenericThreadPool::addTask(F &&f, Args &&...args)
+auto GenericThreadPool::addTask(const TaskOptions &options, F &&f, Args &&...args)
         -> typename std::enable_if<
             std::is_void<ReturnType<F, Args...>>::value,
             UnitFutureType
            >::type {
     auto idx = nextThread_++ % nrThreads_;
-    return pool_[idx]->addTask(std::forward<F>(f),
+    return pool_[idx]->addTask(options,
+                               std::forward<F>(f),
                                std::forward<Args>(args)...);
 }
 
@@ -186,6 +362,15 @@ uint64_t GenericThreadPool::addRepeatTask(size_t ms, F &&f, Args &&...args) {
     return ((idx << GenericWorker::TIMER_ID_BITS) | id);
 }
 
+
+template <typename T, typename...Args>
+std::unique_ptr<T> GenericThreadPool::makeLocal(size_t idx, Args &&...args) {
+    auto future = pool_[idx]->addTask([&] () {
+        return std::make_unique<T>(std::forward<Args>(args)...);
+    });
+    return std::move(future).get();
+}
+
 }   // namespace thread
 }   // namespace nebula
 
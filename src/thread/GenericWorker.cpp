@@ -6,12 +6,16 @@
 
 #include "base/Base.h"
 #include "thread/GenericWorker.h"
+#include "thread/GenericThreadPool.h"
+#include <folly/synchronization/Baton.h>
 #include <sys/eventfd.h>
 #include <event2/event.h>
 
 namespace nebula {
 namespace thread {
 
+constexpr size_t GenericWorker::kMaxTasksPerRound;
+
 GenericWorker::GenericWorker() = default;
 
 GenericWorker::~GenericWorker() {
@@ -21,6 +25,10 @@ GenericWorker::~GenericWorker() {
         event_free(notifier_);
         notifier_ = nullptr;
     }
+    if (ticker_ != nullptr) {
+        event_free(ticker_);
+        ticker_ = nullptr;
+    }
     if (evbase_ != nullptr) {
         event_base_free(evbase_);
         evbase_ = nullptr;
@@ -30,7 +38,7 @@ GenericWorker::~GenericWorker() {
     }
 }
 
-bool GenericWorker::start(std::string name) {
+bool GenericWorker::start(std::string name, CpuBinding binding) {
     if (!stopped_.load(std::memory_order_acquire)) {
         LOG(WARNING) << "GenericWroker already started";
         return false;
@@ -57,13 +65,39 @@ bool GenericWorker::start(std::string name) {
     notifier_  = event_new(evbase_, evfd_, events, cb, this);
     DCHECK(notifier_ != nullptr);
     event_add(notifier_, nullptr);
+    auto onTick = [] (int, int16_t, void *arg) {
+        reinterpret_cast<GenericWorker*>(arg)->onTimer();
+    };
+    ticker_ = evtimer_new(evbase_, onTick, this);
+    DCHECK(ticker_ != nullptr);
 
-    // Launch a new thread to run the event loop
-    thread_ = std::make_unique<NamedThread>(name_, &GenericWorker::loop, this);
+    // Launch a new thread to run the event loop, once it is bound to the CPUs
+    auto wanted = !binding.empty();
+    auto bound = false;
+    folly::Baton<> started;
+    thread_ = std::make_unique<NamedThread>(name_, std::move(binding),
+                                            [this, wanted, &bound, &started] () {
+        auto ok = !wanted || !NamedThread::binding().empty();
+        bound = ok;
+        started.post();
+        if (ok) {
+            loop();
+        }
+    });
+    started.wait();
+    if (!bound) {
+        LOG(ERROR) << "Failed to bind the worker `" << name_ << "' to its CPUs";
+        thread_->join();
+        thread_.reset();
+        return false;
+    }
 
     // Mark this worker as started
     stopped_.store(false, std::memory_order_release);
 
+    // Arm the timers added before started, if any
+    notify();
+
     return true;
 }
 
@@ -94,92 +128,192 @@ void GenericWorker::notify() {
         return;
     }
     DCHECK_NE(-1, evfd_);
+    // The wakeup pending will see whatever was added before this one
+    if (notified_.exchange(true)) {
+        return;
+    }
     auto one = 1UL;
     auto len = ::write(evfd_, &one, sizeof(one));
     DCHECK(len == sizeof(one));
 }
 
 void GenericWorker::onNotify() {
+    // Cleared before anything is taken, so nothing added after is missed
+    notified_.store(false);
+    auto limit = kMaxTasksPerRound;
     if (stopped_.load(std::memory_order_acquire)) {
         event_base_loopexit(evbase_, nullptr);
-        // Even been broken, we still fall through to finish the current loop.
+        // Even been broken, we still fall through to finish the current loop,
+        // which runs all the tasks queued by now, since it is not coming back.
+        pullTasks();
+        limit = 0;
+        for (auto i = 0UL; i < kNumTaskPriorities; i++) {
+            limit += runningTasks_[i].size() - runningHeads_[i];
+        }
+    }
+    runTasks(limit);
+    armTimer();
+    if (pool_ != nullptr && !stopped_.load(std::memory_order_acquire)) {
+        pool_->runTasks(poolIndex_);
+    }
+}
+
+void GenericWorker::enqueue(Task task, const TaskOptions &options) {
+    auto priority = static_cast<size_t>(options.priority);
+    DCHECK_LT(priority, kNumTaskPriorities);
+    // The clock is only read if the wait is measured
+    auto enqueued = Clock::time_point();
+    if (stats_ != nullptr) {
+        enqueued = Clock::now();
+        stats_->onQueued(options.priority);
     }
     {
-        decltype(pendingTasks_) newcomings;
-        {
-            std::lock_guard<std::mutex> guard(lock_);
-            newcomings.swap(pendingTasks_);
+        std::lock_guard<std::mutex> guard(lock_);
+        pendingTasks_[priority].emplace_back(std::move(task), enqueued, options.deadline);
+        nrPending_++;
+    }
+    notify();
+}
+
+void GenericWorker::runTasks(size_t limit) {
+    auto ran = 0UL;
+    while (ran < limit) {
+        // A cycle of the weighted round-robin, which sees the tasks added
+        // meanwhile, so a task of high priority waits for no more than a cycle
+        pullTasks();
+        auto before = ran;
+        for (auto i = 0UL; i < kNumTaskPriorities && ran < limit; i++) {
+            for (auto n = 0UL; n < kTaskPriorityWeights[i] && ran < limit
+                    && runningHeads_[i] < runningTasks_[i].size(); n++) {
+                runTask(i);
+                ran++;
+            }
         }
-        for (auto &task : newcomings) {
-            task();
+        if (ran == before) {
+            return;
         }
     }
-    {
-        decltype(pendingTimers_) newcomings;
-        {
-            std::lock_guard<std::mutex> guard(lock_);
-            newcomings.swap(pendingTimers_);
+    // Let the timers run, and come back for the rest
+    notify();
+}
+
+void GenericWorker::pullTasks() {
+    if (nrPending_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(lock_);
+    for (auto i = 0UL; i < kNumTaskPriorities; i++) {
+        auto &pending = pendingTasks_[i];
+        auto &running = runningTasks_[i];
+        if (pending.empty()) {
+            continue;
         }
-        auto cb = [] (int fd, int16_t, void *arg) {
-            UNUSED(fd);
-            auto timer = reinterpret_cast<Timer*>(arg);
-            auto worker = timer->owner_;
-            timer->callback_();
-            if (timer->intervalMSec_ == 0.0) {
-                worker->purgeTimerInternal(timer->id_);
-            }
-        };
-        for (auto &timer : newcomings) {
-            timer->ev_ = event_new(evbase_, -1, EV_PERSIST, cb, timer.get());
-
-            auto delay = timer->delayMSec_;
-            struct timeval tv;
-            tv.tv_sec = delay / 1000;
-            tv.tv_usec = delay % 1000 * 1000;
-            evtimer_add(timer->ev_, &tv);
-
-            auto id = timer->id_;
-            activeTimers_[id] = std::move(timer);
+        if (running.empty()) {
+            running.swap(pending);
+        } else {
+            running.insert(running.end(),
+                           std::make_move_iterator(pending.begin()),
+                           std::make_move_iterator(pending.end()));
+            pending.clear();
+        }
+    }
+    nrPending_ = 0;
+}
+
+void GenericWorker::runTask(size_t priority) {
+    auto &running = runningTasks_[priority];
+    // Not moved by the task, which only adds to `pendingTasks_'
+    auto &queued = running[runningHeads_[priority]++];
+    auto klass = static_cast<TaskPriority>(priority);
+    auto now = Clock::time_point();
+    if (stats_ != nullptr || queued.deadline_ != Clock::time_point::max()) {
+        now = Clock::now();
+    }
+    if (queued.deadline_ < now) {
+        // Dropped, which breaks its promise if any
+        queued.task_.reset();
+        if (stats_ != nullptr) {
+            stats_->onExpired(klass);
         }
+    } else if (stats_ != nullptr) {
+        stats_->onStarted(klass, now - queued.enqueued_);
+        queued.task_();
+        queued.task_.reset();
+        stats_->onFinished(klass, Clock::now() - now);
+    } else {
+        queued.task_();
+        queued.task_.reset();
     }
+    if (runningHeads_[priority] == running.size()) {
+        running.clear();
+        runningHeads_[priority] = 0;
+    }
+}
+
+void GenericWorker::onTimer() {
     {
-        decltype(purgingingTimers_) newcomings;
+        std::lock_guard<std::mutex> guard(lock_);
+        armedTick_ = TimerWheel::kNever;
+        timers_.advance(nowInMSec(), expiredTimers_);
+    }
+    // Run out of the lock, since a callback may add or purge timers, unless
+    // purged since it expired
+    for (auto *timer : expiredTimers_) {
         {
             std::lock_guard<std::mutex> guard(lock_);
-            newcomings.swap(purgingingTimers_);
+            if (timer->cancelled_) {
+                continue;
+            }
         }
-        for (auto id : newcomings) {
-            purgeTimerInternal(id);
+        timer->callback_();
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        for (auto *timer : expiredTimers_) {
+            auto callback = timers_.finish(timer);
+            if (callback) {
+                finishedCallbacks_.emplace_back(std::move(callback));
+            }
         }
     }
+    expiredTimers_.clear();
+    // Destroyed out of the lock as well
+    finishedCallbacks_.clear();
+    armTimer();
 }
 
-GenericWorker::Timer::Timer(std::function<void(void)> cb) {
-    callback_ = std::move(cb);
+void GenericWorker::armTimer() {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto next = timers_.nextTick();
+    if (next == TimerWheel::kNever) {
+        evtimer_del(ticker_);
+        armedTick_ = next;
+        return;
+    }
+    auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+    auto delay = std::max<int64_t>(0, static_cast<int64_t>(next) * 1000 - now);
+    struct timeval tv;
+    tv.tv_sec = delay / 1000000;
+    tv.tv_usec = delay % 1000000;
+    evtimer_add(ticker_, &tv);
+    armedTick_ = next;
 }
 
-GenericWorker::Timer::~Timer() {
-    if (ev_ != nullptr) {
-        event_free(ev_);
-    }
+uint64_t GenericWorker::nowInMSec(bool roundUp) const {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+    return roundUp ? (us + 999) / 1000 : us / 1000;
 }
 
 void GenericWorker::purgeTimerTask(uint64_t id) {
+    // The callback is destroyed out of the lock
+    Task callback;
     {
         std::lock_guard<std::mutex> guard(lock_);
-        purgingingTimers_.emplace_back(id);
-    }
-    notify();
-}
-
-void GenericWorker::purgeTimerInternal(uint64_t id) {
-    auto iter = activeTimers_.find(id);
-    if (iter != activeTimers_.end()) {
-        evtimer_del(iter->second->ev_);
-        activeTimers_.erase(iter);
+        callback = timers_.cancel(id);
     }
 }
 
 }   // namespace thread
 }   // namespace nebula
-
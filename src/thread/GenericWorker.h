@@ -11,13 +11,21 @@
 #include <folly/Unit.h>
 #include "cpp/helpers.h"
 #include "thread/NamedThread.h"
+#include "thread/Task.h"
+#include "thread/TaskOptions.h"
+#include "thread/TimerWheel.h"
 
 /**
  * GenericWorker implements a event-based task executor that executes tasks asynchronously
  * in a separate thread. Like `std::thread', It takes any callable object and its optional
  * arguments as a normal, delayed or repeated task.
  *
- * GenericWorker executes tasks one after one, in the FIFO way, while tasks are non-preemptible.
+ * GenericWorker executes tasks one after one, while tasks are non-preemptible. Tasks of the same
+ * priority class run in the FIFO way, and the classes are served in a weighted round-robin way,
+ * see TaskOptions.
+ *
+ * The timer tasks are kept in a TimerWheel of millisecond ticks, so a timer is added or purged
+ * in O(1) by any thread, and the worker is only woken when a timer expires before its next tick.
  *
  * Please NOTE that, as the name indicates, this a worker thread for the general purpose,
  * but not for the performance critical situation.
@@ -29,6 +37,8 @@ struct event_base;
 namespace nebula {
 namespace thread {
 
+class GenericThreadPool;
+
 class GenericWorker final : public nebula::cpp::NonCopyable, public nebula::cpp::NonMovable {
 public:
     friend class GenericThreadPool;
@@ -48,8 +58,12 @@ public:
      *
      * A GenericWorker MUST be `start'ed successfully before invoking
      * any other interfaces.
+     *
+     * @name        name of the internal thread
+     * @binding     CPUs to bind the internal thread to, it floats if empty
+     * @return      false if already started, or the thread can't be bound
      */
-    bool MUST_USE_RESULT start(std::string name = "");
+    bool MUST_USE_RESULT start(std::string name = "", CpuBinding binding = CpuBinding());
 
     /**
      * Asynchronouly to notify the worker to stop handling further new tasks.
@@ -71,6 +85,16 @@ public:
     using FutureType = folly::SemiFuture<ReturnType<F, Args...>>;
     using UnitFutureType = folly::SemiFuture<folly::Unit>;
 
+    /**
+     * To run a task, whose result or exception is dropped.
+     * Unlike `addTask', no promise is made, and a small task is queued
+     * without any allocation.
+     * @task    a callable object, which takes no arguments
+     * @options priority class and deadline of the task
+     */
+    template <typename F>
+    void run(F &&task, const TaskOptions &options = TaskOptions());
+
     /**
      * To add a normal task.
      * @task    a callable object
@@ -91,6 +115,36 @@ public:
             FutureType<F, Args...>
            >::type;
 
+    /**
+     * To add a task of a priority class, or with a deadline.
+     * @options priority class and deadline of the task
+     * @task    a callable object
+     * @args    variadic arguments
+     * @return  an instance of `folly::SemiFuture' you could wait upon
+     *          for the result of `task', which fails with `folly::BrokenPromise'
+     *          if the task is dropped for its deadline
+     */
+    template <typename F, typename...Args>
+    auto addTask(const TaskOptions &options, F &&task, Args &&...args)
+        -> typename std::enable_if<
+            std::is_void<ReturnType<F, Args...>>::value,
+            UnitFutureType
+           >::type;
+    template <typename F, typename...Args>
+    auto addTask(const TaskOptions &options, F &&task, Args &&...args)
+        -> typename std::enable_if<
+            !std::is_void<ReturnType<F, Args...>>::value,
+            FutureType<F, Args...>
+           >::type;
+
+    /**
+     * To be notified of the tasks queued and run, e.g. by `stats::TaskPriorityStats'.
+     * It must be set before `start'.
+     */
+    void setStats(std::shared_ptr<TaskStats> stats) {
+        stats_ = std::move(stats);
+    }
+
     /**
      * To add a oneshot timer task which will be executed after a while.
      * @ms      milliseconds from now when the task get executed
@@ -132,71 +186,86 @@ public:
     uint64_t addTimerTask(size_t, size_t, F&&, Args&&...);
 
 private:
-    void purgeTimerInternal(uint64_t id);
+    using Clock = std::chrono::steady_clock;
 
-private:
-    struct Timer {
-        explicit Timer(std::function<void(void)> cb);
-        ~Timer();
-        uint64_t                                id_;
-        uint64_t                                delayMSec_;
-        uint64_t                                intervalMSec_;
-        std::function<void(void)>               callback_;
-        struct event                           *ev_{nullptr};
-        GenericWorker                          *owner_{nullptr};
+    struct QueuedTask {
+        QueuedTask(Task task, Clock::time_point enqueued, Clock::time_point deadline)
+            : task_(std::move(task)), enqueued_(enqueued), deadline_(deadline) {
+        }
+
+        Task                                    task_;
+        // Only taken if there are stats
+        Clock::time_point                       enqueued_;
+        Clock::time_point                       deadline_;
     };
 
-private:
     void loop();
     void notify();
     void onNotify();
-    uint64_t nextTimerId() {
-        // !NOTE! `lock_' must be hold
-        return (nextTimerId_++ & TIMER_ID_MASK);
-    }
+    void enqueue(Task task, const TaskOptions &options);
+    // To run the tasks in the weighted round-robin way, no more than `limit' of them
+    void runTasks(size_t limit);
+    // To move the tasks added into `runningTasks_'
+    void pullTasks();
+    void runTask(size_t priority);
+    // To run the timers expired
+    void onTimer();
+    // To arm `ticker_' at the next tick of `timers_'
+    void armTimer();
+    // The milliseconds since the worker was created, rounded up or down
+    uint64_t nowInMSec(bool roundUp = false) const;
 
 private:
     static constexpr uint64_t TIMER_ID_BITS     = 6 * 8;
     static constexpr uint64_t TIMER_ID_MASK     = ((~0x0UL) >> (64 - TIMER_ID_BITS));
+    static_assert(TIMER_ID_BITS == 2 * TimerWheel::kIndexBits, "Unexpected bits of timer ID");
     std::string                                 name_;
     std::atomic<bool>                           stopped_{true};
-    volatile uint64_t                           nextTimerId_{0};
     struct event_base                          *evbase_ = nullptr;
     int                                         evfd_ = -1;
     struct event                               *notifier_ = nullptr;
+    struct event                               *ticker_ = nullptr;
+    std::chrono::steady_clock::time_point       epoch_{std::chrono::steady_clock::now()};
+    // The most tasks run in a row, before the worker goes back to its events
+    static constexpr size_t kMaxTasksPerRound = 256;
     std::mutex                                  lock_;
-    std::vector<std::function<void()>>          pendingTasks_;
-    using TimerPtr = std::unique_ptr<Timer>;
-    std::vector<TimerPtr>                       pendingTimers_;
-    std::vector<uint64_t>                       purgingingTimers_;
-    std::unordered_map<uint64_t, TimerPtr>      activeTimers_;
+    // A queue of each priority class, in the order of TaskPriority
+    std::vector<QueuedTask>                     pendingTasks_[kNumTaskPriorities];
+    std::atomic<size_t>                         nrPending_{0};
+    // Swapped with `pendingTasks_' to run them, so that both keep their capacity,
+    // and run from `runningHeads_' on. Only touched by the worker thread.
+    std::vector<QueuedTask>                     runningTasks_[kNumTaskPriorities];
+    size_t                                      runningHeads_[kNumTaskPriorities] = {0};
+    std::shared_ptr<TaskStats>                  stats_;
+    // Guarded by `lock_', like the tick `ticker_' is armed at
+    TimerWheel                                  timers_;
+    uint64_t                                    armedTick_{TimerWheel::kNever};
+    // Only touched by the worker thread, and kept for their capacity
+    std::vector<TimerWheel::Timer*>             expiredTimers_;
+    std::vector<Task>                           finishedCallbacks_;
     std::unique_ptr<NamedThread>                thread_;
+    // Set while a notification is pending, so that the eventfd is written
+    // once per wakeup rather than once per task
+    std::atomic<bool>                           notified_{false};
+    // The pool whose shared tasks this worker runs, in the work-stealing mode
+    GenericThreadPool                          *pool_{nullptr};
+    size_t                                      poolIndex_{0};
 };
 
 
+template <typename F>
+void GenericWorker::run(F &&f, const TaskOptions &options) {
+    enqueue(Task(std::forward<F>(f)), options);
+}
+
+
 template <typename F, typename...Args>
 auto GenericWorker::addTask(F &&f, Args &&...args)
         -> typename std::enable_if<
             std::is_void<ReturnType<F, Args...>>::value,
             UnitFutureType
            >::type {
-    auto promise = std::make_shared<folly::Promise<folly::Unit>>();
-    auto task = std::make_shared<std::function<ReturnType<F, Args...> ()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    auto future = promise->getSemiFuture();
-    {
-        std::lock_guard<std::mutex> guard(lock_);
-        pendingTasks_.emplace_back([=] {
-            try {
-                (*task)();
-                promise->setValue(folly::unit);
-            } catch (const std::exception& ex) {
-                promise->setException(ex);
-            }
-        });
-    }
-    notify();
-    return future;
+    return addTask(TaskOptions(), std::forward<F>(f), std::forward<Args>(args)...);
 }
 
 
@@ -206,17 +275,38 @@ auto GenericWorker::addTask(F &&f, Args &&...args)
             !std::is_void<ReturnType<F, Args...>>::value,
             FutureType<F, Args...>
            >::type {
-    auto promise = std::make_shared<folly::Promise<ReturnType<F, Args...>>>();
-    auto task = std::make_shared<std::function<ReturnType<F, Args...> ()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    auto future = promise->getSemiFuture();
-    {
-        std::lock_guard<std::mutex> guard(lock_);
-        pendingTasks_.emplace_back([=] {
-            promise->setWith(*task);
-        });
-    }
-    notify();
+    return addTask(TaskOptions(), std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+
+template <typename F, typename...Args>
+auto GenericWorker::addTask(const TaskOptions &options, F &&f, Args &&...args)
+        -> typename std::enable_if<
+            std::is_void<ReturnType<F, Args...>>::value,
+            UnitFutureType
+           >::type {
+    folly::Promise<folly::Unit> promise;
+    auto future = promise.getSemiFuture();
+    run([promise = std::move(promise),
+         task = Task::bind(std::forward<F>(f), std::forward<Args>(args)...)] () mutable {
+        promise.setWith(task);
+    }, options);
+    return future;
+}
+
+
+template <typename F, typename...Args>
+auto GenericWorker::addTask(const TaskOptions &options, F &&f, Args &&...args)
+        -> typename std::enable_if<
+            !std::is_void<ReturnType<F, Args...>>::value,
+            FutureType<F, Args...>
+           >::type {
+    folly::Promise<ReturnType<F, Args...>> promise;
+    auto future = promise.getSemiFuture();
+    run([promise = std::move(promise),
+         task = Task::bind(std::forward<F>(f), std::forward<Args>(args)...)] () mutable {
+        promise.setWith(task);
+    }, options);
     return future;
 }
 
@@ -227,17 +317,12 @@ auto GenericWorker::addDelayTask(size_t ms, F &&f, Args &&...args)
             std::is_void<ReturnType<F, Args...>>::value,
             UnitFutureType
            >::type {
-    auto promise = std::make_shared<folly::Promise<folly::Unit>>();
-    auto task = std::make_shared<std::function<ReturnType<F, Args...> ()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    auto future = promise->getSemiFuture();
-    addTimerTask(ms, 0, [=] {
-        try {
-            (*task)();
-            promise->setValue(folly::unit);
-        } catch (const std::exception& ex) {
-            promise->setException(ex);
-        }
+    folly::Promise<folly::Unit> promise;
+    auto future = promise.getSemiFuture();
+    addTimerTask(ms, 0, [promise = std::move(promise),
+                         task = Task::bind(std::forward<F>(f), std::forward<Args>(args)...)]
+                         () mutable {
+        promise.setWith(task);
     });
     return future;
 }
@@ -249,12 +334,12 @@ auto GenericWorker::addDelayTask(size_t ms, F &&f, Args &&...args)
             !std::is_void<ReturnType<F, Args...>>::value,
             FutureType<F, Args...>
            >::type {
-    auto promise = std::make_shared<folly::Promise<ReturnType<F, Args...>>>();
-    auto task = std::make_shared<std::function<ReturnType<F, Args...> ()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    auto future = promise->getSemiFuture();
-    addTimerTask(ms, 0, [=] {
-        promise->setWith(*task);
+    folly::Promise<ReturnType<F, Args...>> promise;
+    auto future = promise.getSemiFuture();
+    addTimerTask(ms, 0, [promise = std::move(promise),
+                         task = Task::bind(std::forward<F>(f), std::forward<Args>(args)...)]
+                         () mutable {
+        promise.setWith(task);
     });
     return future;
 }
@@ -274,18 +359,29 @@ uint64_t GenericWorker::addTimerTask(size_t delay,
                                      size_t interval,
                                      F &&f,
                                      Args &&...args) {
-    auto timer = std::make_unique<Timer>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    timer->delayMSec_ = delay;
-    timer->intervalMSec_ = interval;
-    timer->owner_ = this;
+    Task callback(Task::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    // Not to fire before `delay' passes
+    auto expire = nowInMSec(true) + delay;
     auto id = 0UL;
+    auto wakeup = false;
     {
         std::lock_guard<std::mutex> guard(lock_);
-        timer->id_ = (id = nextTimerId());
-        pendingTimers_.emplace_back(std::move(timer));
+        if (timers_.size() == 0) {
+            // Catch up the clock of the idle wheel, nothing expires
+            std::vector<TimerWheel::Timer*> none;
+            timers_.advance(nowInMSec(), none);
+        }
+        id = timers_.add(expire, interval, std::move(callback));
+        // The worker is only woken if the timer expires before it would wake up
+        auto next = timers_.nextTick();
+        if (next < armedTick_) {
+            armedTick_ = next;
+            wakeup = true;
+        }
+    }
+    if (wakeup) {
+        notify();
     }
-    notify();
     return id;
 }
 
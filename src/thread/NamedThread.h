@@ -14,6 +14,7 @@
 #include <sys/syscall.h>
 
 #include <sys/prctl.h>
+#include "thread/CpuBinding.h"
 
 namespace nebula {
 namespace thread {
@@ -26,10 +27,19 @@ public:
     NamedThread(NamedThread&&) = default;
     template <typename F, typename...Args>
     NamedThread(const std::string &name, F &&f, Args&&...args);
+    // To bind the thread to the CPUs of `binding' before it runs `f'
+    template <typename F, typename...Args>
+    NamedThread(const std::string &name, CpuBinding binding, F &&f, Args&&...args);
     NamedThread& operator=(NamedThread&&) = default;
     NamedThread(const NamedThread&) = delete;
     NamedThread& operator=(const NamedThread&) = delete;
 
+    // The CPUs the calling NamedThread is bound to, empty if it floats,
+    // including when it failed to be bound
+    static const CpuBinding& binding() {
+        return currentBinding();
+    }
+
 public:
     class Nominator {
     public:
@@ -57,18 +67,38 @@ public:
     };
 
 private:
+    static CpuBinding& currentBinding() {
+        static thread_local CpuBinding binding;
+        return binding;
+    }
+
     static void hook(const std::string &name,
+                     const CpuBinding &binding,
                      const std::function<void()> &f) {
         if (!name.empty()) {
             Nominator::set(name);
         }
+        if (binding.apply()) {
+            currentBinding() = binding;
+        }
+        pid_t tid = ::syscall(SYS_gettid);
+        std::string current;
+        Nominator::get(current);
+        PlacementRegistry::instance().add(tid, std::move(current), currentBinding());
         f();
+        PlacementRegistry::instance().remove(tid);
     }
 };
 
 template <typename F, typename...Args>
 NamedThread::NamedThread(const std::string &name, F &&f, Args&&...args)
-    : std::thread(hook, name,
+    : std::thread(hook, name, CpuBinding(),
+                  std::bind(std::forward<F>(f), std::forward<Args>(args)...)) {
+}
+
+template <typename F, typename...Args>
+NamedThread::NamedThread(const std::string &name, CpuBinding binding, F &&f, Args&&...args)
+    : std::thread(hook, name, std::move(binding),
                   std::bind(std::forward<F>(f), std::forward<Args>(args)...)) {
 }
 
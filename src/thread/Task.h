@@ -0,0 +1,186 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+#ifndef COMMON_THREAD_TASK_H_
+#define COMMON_THREAD_TASK_H_
+
+#include "base/Base.h"
+#include <cstddef>
+#include <folly/functional/Invoke.h>
+
+/**
+ * Task is a move-only `void()' callable, which keeps a callable of no more than
+ * `kInlineSize' bytes in place, so queuing a small lambda allocates nothing.
+ * A larger one is moved to the heap.
+ *
+ * Unlike `std::function', the callable doesn't need to be copyable, e.g. it may
+ * own a `folly::Promise'.
+ */
+
+namespace nebula {
+namespace thread {
+
+class Task final {
+public:
+    static constexpr size_t kInlineSize = 7 * sizeof(void*);
+
+    Task() = default;
+
+    template <typename F,
+              typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<F>::type, Task>::value
+              >::type>
+    Task(F &&f) {   // NOLINT
+        using Callable = typename std::decay<F>::type;
+        emplace<Callable>(std::forward<F>(f), std::integral_constant<bool, isInline<Callable>()>());
+    }
+
+    Task(Task &&rhs) noexcept {
+        moveFrom(rhs);
+    }
+
+    Task& operator=(Task &&rhs) noexcept {
+        if (this != &rhs) {
+            reset();
+            moveFrom(rhs);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        reset();
+    }
+
+    explicit operator bool() const {
+        return ops_ != nullptr;
+    }
+
+    void operator()() {
+        DCHECK(ops_ != nullptr);
+        ops_->call(buf_);
+    }
+
+    void reset() {
+        if (ops_ != nullptr) {
+            ops_->destroy(buf_);
+            ops_ = nullptr;
+        }
+    }
+
+    /**
+     * To make the callable running `f' with `args', which are kept by value
+     * like `std::bind' does, without wrapping it in a `std::function'.
+     */
+    template <typename F, typename...Args>
+    static auto bind(F &&f, Args &&...args) {
+        return [f = std::forward<F>(f),
+                args = std::make_tuple(std::forward<Args>(args)...)] () mutable -> decltype(auto) {
+            return apply(f, args, std::index_sequence_for<Args...>());
+        };
+    }
+
+private:
+    struct Ops {
+        void (*call)(void *buf);
+        // Move the callable in `src' to the uninitialized `dst', and destroy it in `src'
+        void (*move)(void *dst, void *src);
+        void (*destroy)(void *buf);
+    };
+
+    template <typename Callable>
+    static constexpr bool isInline() {
+        return sizeof(Callable) <= kInlineSize
+            && alignof(Callable) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible<Callable>::value;
+    }
+
+    template <typename Callable, typename F>
+    void emplace(F &&f, std::true_type) {
+        new (buf_) Callable(std::forward<F>(f));
+        ops_ = &inlineOps<Callable>;
+    }
+
+    template <typename Callable, typename F>
+    void emplace(F &&f, std::false_type) {
+        *reinterpret_cast<Callable**>(buf_) = new Callable(std::forward<F>(f));
+        ops_ = &heapOps<Callable>;
+    }
+
+    template <typename Callable>
+    static void inlineCall(void *buf) {
+        (*static_cast<Callable*>(buf))();
+    }
+
+    template <typename Callable>
+    static void inlineMove(void *dst, void *src) {
+        new (dst) Callable(std::move(*static_cast<Callable*>(src)));
+        static_cast<Callable*>(src)->~Callable();
+    }
+
+    template <typename Callable>
+    static void inlineDestroy(void *buf) {
+        static_cast<Callable*>(buf)->~Callable();
+    }
+
+    template <typename Callable>
+    static void heapCall(void *buf) {
+        (**static_cast<Callable**>(buf))();
+    }
+
+    static void heapMove(void *dst, void *src) {
+        *static_cast<void**>(dst) = *static_cast<void**>(src);
+    }
+
+    template <typename Callable>
+    static void heapDestroy(void *buf) {
+        delete *static_cast<Callable**>(buf);
+    }
+
+    template <typename F, typename Tuple, size_t...I>
+    static decltype(auto) apply(F &f, Tuple &args, std::index_sequence<I...>) {
+        return folly::invoke(f, std::get<I>(args)...);
+    }
+
+    void moveFrom(Task &rhs) {
+        ops_ = rhs.ops_;
+        if (ops_ != nullptr) {
+            ops_->move(buf_, rhs.buf_);
+            rhs.ops_ = nullptr;
+        }
+    }
+
+private:
+    template <typename Callable>
+    static const Ops inlineOps;
+    template <typename Callable>
+    static const Ops heapOps;
+
+    alignas(std::max_align_t) unsigned char     buf_[kInlineSize];
+    const Ops                                  *ops_{nullptr};
+};
+
+
+template <typename Callable>
+const Task::Ops Task::inlineOps = {
+    &Task::inlineCall<Callable>,
+    &Task::inlineMove<Callable>,
+    &Task::inlineDestroy<Callable>,
+};
+
+
+template <typename Callable>
+const Task::Ops Task::heapOps = {
+    &Task::heapCall<Callable>,
+    &Task::heapMove,
+    &Task::heapDestroy<Callable>,
+};
+
+}   // namespace thread
+}   // namespace nebula
+
+#endif  // COMMON_THREAD_TASK_H_
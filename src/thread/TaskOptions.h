@@ -0,0 +1,65 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+#ifndef COMMON_THREAD_TASKOPTIONS_H_
+#define COMMON_THREAD_TASKOPTIONS_H_
+
+#include "base/Base.h"
+#include "base/TaskStats.h"
+
+/**
+ * TaskOptions is the priority class and the deadline of a task given to a
+ * GenericWorker or a GenericThreadPool.
+ *
+ * Each priority class has a run queue of its own, and the queues are served
+ * in a weighted round-robin way, `kTaskPriorityWeights' tasks of each class
+ * per cycle. So the latency-critical tasks wait for no more than a few others,
+ * while the background ones are never starved.
+ *
+ * A task not started by its deadline is dropped, so its future fails with
+ * `folly::BrokenPromise'.
+ *
+ * TaskStats, in base/TaskStats.h, is notified of the tasks of each class
+ * queued, expired, started and finished, see `stats::TaskPriorityStats' which
+ * exports them to StatsManager.
+ */
+
+namespace nebula {
+namespace thread {
+
+using TaskPriority = ::nebula::TaskPriority;
+using TaskStats = ::nebula::TaskStats;
+
+// The most tasks of each class run in a cycle, in the order of TaskPriority
+constexpr size_t kTaskPriorityWeights[kNumTaskPriorities] = {8, 4, 1};
+
+
+struct TaskOptions {
+    using Clock = std::chrono::steady_clock;
+
+    TaskOptions() = default;
+
+    explicit TaskOptions(TaskPriority p, Clock::time_point d = Clock::time_point::max())
+        : priority(p), deadline(d) {
+    }
+
+    // To drop the task if it is not started in `timeout' from now
+    template <typename Rep, typename Period>
+    static TaskOptions within(TaskPriority p, std::chrono::duration<Rep, Period> timeout) {
+        return TaskOptions(p, Clock::now() + timeout);
+    }
+
+    bool hasDeadline() const {
+        return deadline != Clock::time_point::max();
+    }
+
+    TaskPriority                        priority{TaskPriority::NORMAL};
+    Clock::time_point                   deadline{Clock::time_point::max()};
+};
+
+}   // namespace thread
+}   // namespace nebula
+
+#endif  // COMMON_THREAD_TASKOPTIONS_H_
@@ -0,0 +1,257 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "thread/ThreadPlacement.h"
+
+DEFINE_int32(numa_simulated_nodes, 0,
+             "Split the CPUs into this many NUMA nodes in place of the real ones, "
+             "to try the thread placement on a host of a single node, 0 to disable");
+
+namespace nebula {
+namespace thread {
+
+namespace {
+
+// The CPUs this process is allowed to run on
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) != 0) {
+        LOG(ERROR) << "Failed to get the CPU affinity: " << ::strerror(errno);
+        return cpus;
+    }
+    for (auto cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.emplace_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+CpuTopology readTopology() {
+    auto allowed = allowedCpus();
+    if (FLAGS_numa_simulated_nodes > 0) {
+        return CpuTopology::simulate(allowed, FLAGS_numa_simulated_nodes);
+    }
+    std::vector<CpuTopology::Node> nodes;
+    std::unordered_set<int> remaining(allowed.begin(), allowed.end());
+    // The node IDs may have holes
+    for (auto id = 0, misses = 0; misses < 64; id++) {
+        std::ifstream file(folly::stringPrintf("/sys/devices/system/node/node%d/cpulist", id));
+        std::string line;
+        if (!file.good() || !std::getline(file, line)) {
+            misses++;
+            continue;
+        }
+        misses = 0;
+        auto cpus = CpuTopology::parseCpuList(folly::trimWhitespace(line));
+        if (!cpus.hasValue()) {
+            LOG(ERROR) << "Malformed CPU list of node " << id << ": " << line;
+            continue;
+        }
+        CpuTopology::Node node{id, {}};
+        for (auto cpu : *cpus) {
+            if (remaining.erase(cpu) > 0) {
+                node.cpus.emplace_back(cpu);
+            }
+        }
+        if (!node.cpus.empty()) {
+            nodes.emplace_back(std::move(node));
+        }
+    }
+    if (nodes.empty()) {
+        // No NUMA, or no sysfs
+        return CpuTopology::simulate(allowed, 1);
+    }
+    return CpuTopology(std::move(nodes));
+}
+
+}   // namespace
+
+CpuTopology::CpuTopology(std::vector<Node> nodes) : nodes_(std::move(nodes)) {
+}
+
+const CpuTopology& CpuTopology::host() {
+    static const CpuTopology topology = readTopology();
+    return topology;
+}
+
+CpuTopology CpuTopology::simulate(const std::vector<int> &cpus, size_t nrNodes) {
+    nrNodes = std::max(1UL, std::min(nrNodes, cpus.size()));
+    std::vector<Node> nodes;
+    for (auto i = 0UL; i < nrNodes; i++) {
+        // The CPUs next to each other, like the real nodes
+        auto begin = cpus.size() * i / nrNodes;
+        auto end = cpus.size() * (i + 1) / nrNodes;
+        nodes.emplace_back(Node{static_cast<int>(i),
+                                std::vector<int>(cpus.begin() + begin, cpus.begin() + end)});
+    }
+    return CpuTopology(std::move(nodes));
+}
+
+folly::Optional<std::vector<int>> CpuTopology::parseCpuList(folly::StringPiece list) {
+    std::vector<int> cpus;
+    if (list.empty()) {
+        return cpus;
+    }
+    std::vector<folly::StringPiece> ranges;
+    folly::split(',', list, ranges);
+    for (auto range : ranges) {
+        auto first = range.split_step('-');
+        auto begin = folly::tryTo<int>(folly::trimWhitespace(first));
+        auto end = range.empty() ? begin : folly::tryTo<int>(folly::trimWhitespace(range));
+        if (!begin.hasValue() || !end.hasValue()
+                || begin.value() < 0 || begin.value() > end.value()
+                || end.value() >= CPU_SETSIZE) {
+            return folly::none;
+        }
+        for (auto cpu = begin.value(); cpu <= end.value(); cpu++) {
+            cpus.emplace_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+int CpuTopology::nodeOf(int cpu) const {
+    for (auto &node : nodes_) {
+        if (std::binary_search(node.cpus.begin(), node.cpus.end(), cpu)) {
+            return node.id;
+        }
+    }
+    return -1;
+}
+
+const CpuTopology::Node* CpuTopology::node(int id) const {
+    for (auto &node : nodes_) {
+        if (node.id == id) {
+            return &node;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<int> CpuTopology::allCpus() const {
+    std::vector<int> cpus;
+    for (auto &node : nodes_) {
+        cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+    }
+    std::sort(cpus.begin(), cpus.end());
+    return cpus;
+}
+
+
+ThreadPlacement ThreadPlacement::cores(std::vector<int> cores) {
+    ThreadPlacement placement;
+    if (cores.empty()) {
+        LOG(WARNING) << "No cores given, the threads float";
+        return placement;
+    }
+    placement.policy_ = Policy::CORES;
+    placement.cores_ = std::move(cores);
+    return placement;
+}
+
+ThreadPlacement ThreadPlacement::spread() {
+    ThreadPlacement placement;
+    placement.policy_ = Policy::SPREAD;
+    return placement;
+}
+
+ThreadPlacement ThreadPlacement::compact(int node) {
+    ThreadPlacement placement;
+    placement.policy_ = Policy::COMPACT;
+    placement.node_ = node;
+    return placement;
+}
+
+folly::Optional<ThreadPlacement> ThreadPlacement::parse(folly::StringPiece spec) {
+    spec = folly::trimWhitespace(spec);
+    auto name = spec.split_step(':');
+    if (name == "floating" && spec.empty()) {
+        return ThreadPlacement();
+    }
+    if (name == "spread" && spec.empty()) {
+        return spread();
+    }
+    if (name == "compact") {
+        if (spec.empty()) {
+            return compact();
+        }
+        auto node = folly::tryTo<int>(spec);
+        if (!node.hasValue() || node.value() < 0) {
+            return folly::none;
+        }
+        return compact(node.value());
+    }
+    if (name == "cores") {
+        auto cpus = CpuTopology::parseCpuList(spec);
+        if (!cpus.hasValue() || cpus->empty()) {
+            return folly::none;
+        }
+        return cores(std::move(cpus).value());
+    }
+    return folly::none;
+}
+
+CpuBinding ThreadPlacement::bindingOf(size_t idx, const CpuTopology &topology) const {
+    CpuBinding binding;
+    switch (policy_) {
+        case Policy::FLOATING:
+            break;
+        case Policy::CORES: {
+            auto cpu = cores_[idx % cores_.size()];
+            binding.node = topology.nodeOf(cpu);
+            binding.cpus.emplace_back(cpu);
+            break;
+        }
+        case Policy::SPREAD: {
+            if (topology.numNodes() == 0) {
+                break;
+            }
+            auto &node = topology.nodes()[idx % topology.numNodes()];
+            binding.node = node.id;
+            binding.cpus = node.cpus;
+            break;
+        }
+        case Policy::COMPACT: {
+            const CpuTopology::Node *node = nullptr;
+            if (node_ >= 0) {
+                node = topology.node(node_);
+                LOG_IF(ERROR, node == nullptr) << "No such NUMA node " << node_
+                                               << ", the thread floats";
+            } else if (topology.numNodes() > 0) {
+                node = &topology.nodes().front();
+            }
+            if (node != nullptr) {
+                binding.node = node->id;
+                binding.cpus = node->cpus;
+            }
+            break;
+        }
+    }
+    return binding;
+}
+
+std::string ThreadPlacement::toString() const {
+    switch (policy_) {
+        case Policy::FLOATING:
+            return "floating";
+        case Policy::CORES:
+            return "cores:" + CpuBinding{-1, cores_}.toString();
+        case Policy::SPREAD:
+            return "spread";
+        case Policy::COMPACT:
+            return node_ < 0 ? "compact" : folly::to<std::string>("compact:", node_);
+    }
+    return "unknown";
+}
+
+}   // namespace thread
+}   // namespace nebula
@@ -0,0 +1,128 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+#ifndef COMMON_THREAD_THREADPLACEMENT_H_
+#define COMMON_THREAD_THREADPLACEMENT_H_
+
+#include "base/Base.h"
+#include <folly/Optional.h>
+#include "thread/CpuBinding.h"
+
+DECLARE_int32(numa_simulated_nodes);
+
+/**
+ * CpuTopology is the NUMA nodes of the host and their CPUs, as read from sysfs.
+ * Only the CPUs the process is allowed to run on are counted. With
+ * `--numa_simulated_nodes', the CPUs are split into that many nodes instead, so
+ * that the placement is tried on a host of a single node.
+ *
+ * ThreadPlacement is the policy to place the threads of a pool on the CPUs:
+ *  - floating, the threads run anywhere, which is the default
+ *  - cores, the i-th thread is pinned to the i-th core of a list, round-robin
+ *  - spread, the i-th thread is bound to the CPUs of the i-th node, round-robin
+ *  - compact, all the threads are bound to the CPUs of one node
+ *
+ * A thread bound to a node allocates its memory from the node, as long as it
+ * touches the memory first. So the state of a worker is best allocated by the
+ * worker itself, see `GenericThreadPool::makeLocal'.
+ */
+
+namespace nebula {
+namespace thread {
+
+class CpuTopology final {
+public:
+    struct Node {
+        int                             id;
+        std::vector<int>                cpus;
+    };
+
+    explicit CpuTopology(std::vector<Node> nodes);
+
+    /**
+     * The topology of this host, read once.
+     */
+    static const CpuTopology& host();
+
+    /**
+     * To split `cpus' into `nrNodes' nodes, as evenly as possible.
+     */
+    static CpuTopology simulate(const std::vector<int> &cpus, size_t nrNodes);
+
+    /**
+     * To parse a CPU list of the kernel, e.g. "0-3,8,10-11".
+     */
+    static folly::Optional<std::vector<int>> parseCpuList(folly::StringPiece list);
+
+    size_t numNodes() const {
+        return nodes_.size();
+    }
+
+    const std::vector<Node>& nodes() const {
+        return nodes_;
+    }
+
+    /**
+     * The ID of the node `cpu' is on, or -1 if not known.
+     */
+    int nodeOf(int cpu) const;
+
+    /**
+     * The node of the ID, or nullptr if not known.
+     */
+    const Node* node(int id) const;
+
+    std::vector<int> allCpus() const;
+
+private:
+    std::vector<Node>                   nodes_;
+};
+
+
+class ThreadPlacement final {
+public:
+    enum class Policy : uint8_t {
+        FLOATING,
+        CORES,
+        SPREAD,
+        COMPACT,
+    };
+
+    ThreadPlacement() = default;
+
+    // Floating if `cores' is empty
+    static ThreadPlacement cores(std::vector<int> cores);
+    static ThreadPlacement spread();
+    // On the node of the ID, or on the first one if -1
+    static ThreadPlacement compact(int node = -1);
+
+    /**
+     * To parse a placement, one of "floating", "spread", "compact", "compact:<node>"
+     * and "cores:<CPU list>", e.g. "cores:0-3,8".
+     * @return  none if malformed
+     */
+    static folly::Optional<ThreadPlacement> parse(folly::StringPiece spec);
+
+    Policy policy() const {
+        return policy_;
+    }
+
+    /**
+     * The binding of the idx-th thread of a pool on `topology'.
+     */
+    CpuBinding bindingOf(size_t idx, const CpuTopology &topology = CpuTopology::host()) const;
+
+    std::string toString() const;
+
+private:
+    Policy                              policy_{Policy::FLOATING};
+    std::vector<int>                    cores_;
+    int                                 node_{-1};
+};
+
+}   // namespace thread
+}   // namespace nebula
+
+#endif  // COMMON_THREAD_THREADPLACEMENT_H_
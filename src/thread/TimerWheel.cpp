@@ -0,0 +1,227 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "thread/TimerWheel.h"
+
+namespace nebula {
+namespace thread {
+
+constexpr uint64_t TimerWheel::kNever;
+
+TimerWheel::TimerWheel() {
+    ::memset(slots_, 0, sizeof(slots_));
+    ::memset(occupied_, 0, sizeof(occupied_));
+}
+
+TimerWheel::~TimerWheel() = default;
+
+uint64_t TimerWheel::add(uint64_t expire, uint64_t interval, Task callback) {
+    auto *timer = allocTimer();
+    timer->expire_ = std::max(expire, current_ + 1);
+    timer->intervalMSec_ = interval;
+    timer->callback_ = std::move(callback);
+    link(timer);
+    size_++;
+    return timer->id_;
+}
+
+Task TimerWheel::cancel(uint64_t id) {
+    auto *timer = findTimer(id);
+    if (timer == nullptr) {
+        return Task();
+    }
+    if (timer->slot_ < 0) {
+        // Expired, it is freed once finished
+        timer->cancelled_ = true;
+        return Task();
+    }
+    unlink(timer);
+    size_--;
+    auto callback = std::move(timer->callback_);
+    freeTimer(timer);
+    return callback;
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<Timer*> &expired) {
+    if (size_ == 0) {
+        current_ = std::max(current_, now);
+        return;
+    }
+    while (current_ < now) {
+        // The slots skipped are all empty
+        current_ = std::min(now, nextTick());
+        for (auto level = kLevels - 1; level > 0; level--) {
+            if ((current_ & ((1UL << (kSlotBits * level)) - 1)) == 0) {
+                cascade(level, expired);
+            }
+        }
+        auto slot = current_ & kSlotMask;
+        auto *timer = slots_[0][slot];
+        if (timer == nullptr) {
+            continue;
+        }
+        slots_[0][slot] = nullptr;
+        occupied_[0][slot / 64] &= ~(1UL << (slot % 64));
+        while (timer != nullptr) {
+            auto *next = timer->next_;
+            timer->prev_ = nullptr;
+            timer->next_ = nullptr;
+            timer->slot_ = -1;
+            // A slot of the finest wheel holds only the timers expiring at it
+            DCHECK_EQ(timer->expire_, current_);
+            size_--;
+            expired.emplace_back(timer);
+            timer = next;
+        }
+    }
+}
+
+Task TimerWheel::finish(Timer *timer) {
+    if (!timer->cancelled_ && timer->intervalMSec_ > 0) {
+        // Repeated at a fixed rate, or at once if it is already late
+        timer->expire_ = std::max(timer->expire_ + timer->intervalMSec_, current_ + 1);
+        link(timer);
+        size_++;
+        return Task();
+    }
+    auto callback = std::move(timer->callback_);
+    freeTimer(timer);
+    return callback;
+}
+
+uint64_t TimerWheel::nextTick() const {
+    if (size_ == 0) {
+        return kNever;
+    }
+    // The finer wheel is checked till the end of its rotation, when the
+    // coarser ones are cascaded
+    auto rotationEnd = (current_ | kSlotMask) + 1;
+    auto base = current_ + 1;
+    if (base == rotationEnd) {
+        return base;
+    }
+    for (auto i = base & kSlotMask; i < kSlots;) {
+        auto word = occupied_[0][i / 64] >> (i % 64);
+        if (word != 0) {
+            return (current_ & ~kSlotMask) + i + __builtin_ctzll(word);
+        }
+        i = (i / 64 + 1) * 64;
+    }
+    return rotationEnd;
+}
+
+TimerWheel::Timer* TimerWheel::allocTimer() {
+    if (free_ == nullptr) {
+        auto base = chunks_.size() * kChunkSize;
+        CHECK_LE(base + kChunkSize, kIndexMask + 1) << "Too many timers";
+        chunks_.emplace_back(std::make_unique<Timer[]>(kChunkSize));
+        auto *chunk = chunks_.back().get();
+        for (auto i = kChunkSize; i > 0; i--) {
+            auto *timer = &chunk[i - 1];
+            timer->id_ = base + i - 1;
+            timer->next_ = free_;
+            free_ = timer;
+        }
+    }
+    auto *timer = free_;
+    free_ = timer->next_;
+    timer->next_ = nullptr;
+    return timer;
+}
+
+void TimerWheel::freeTimer(Timer *timer) {
+    // A new generation, so that the old ID no longer finds it
+    auto generation = ((timer->id_ >> kIndexBits) + 1) & kGenerationMask;
+    timer->id_ = (generation << kIndexBits) | (timer->id_ & kIndexMask);
+    timer->callback_.reset();
+    timer->cancelled_ = false;
+    timer->prev_ = nullptr;
+    timer->next_ = free_;
+    free_ = timer;
+}
+
+TimerWheel::Timer* TimerWheel::findTimer(uint64_t id) {
+    auto index = id & kIndexMask;
+    if (index / kChunkSize >= chunks_.size()) {
+        return nullptr;
+    }
+    auto *timer = &chunks_[index / kChunkSize][index % kChunkSize];
+    return timer->id_ == id ? timer : nullptr;
+}
+
+void TimerWheel::link(Timer *timer) {
+    // In the finest wheel that spans the time till it expires, whose slot of
+    // `expire' is cascaded at the start of the period `expire' is in
+    auto expire = timer->expire_;
+    DCHECK_GE(expire, current_);
+    auto delta = expire - current_;
+    auto level = 0UL;
+    while (level < kLevels && delta >= (1UL << (kSlotBits * (level + 1)))) {
+        level++;
+    }
+    uint64_t slot;
+    if (level == kLevels) {
+        // Too far, park it in the slot of the coarsest wheel cascaded last,
+        // to be linked again from there
+        level = kLevels - 1;
+        slot = ((current_ >> (kSlotBits * level)) + kSlotMask) & kSlotMask;
+    } else {
+        slot = (expire >> (kSlotBits * level)) & kSlotMask;
+    }
+    auto *&head = slots_[level][slot];
+    timer->prev_ = nullptr;
+    timer->next_ = head;
+    if (head != nullptr) {
+        head->prev_ = timer;
+    }
+    head = timer;
+    occupied_[level][slot / 64] |= (1UL << (slot % 64));
+    timer->slot_ = static_cast<int32_t>(level * kSlots + slot);
+}
+
+void TimerWheel::unlink(Timer *timer) {
+    auto level = timer->slot_ / kSlots;
+    auto slot = timer->slot_ % kSlots;
+    if (timer->prev_ != nullptr) {
+        timer->prev_->next_ = timer->next_;
+    } else {
+        slots_[level][slot] = timer->next_;
+    }
+    if (timer->next_ != nullptr) {
+        timer->next_->prev_ = timer->prev_;
+    }
+    if (slots_[level][slot] == nullptr) {
+        occupied_[level][slot / 64] &= ~(1UL << (slot % 64));
+    }
+    timer->prev_ = nullptr;
+    timer->next_ = nullptr;
+    timer->slot_ = -1;
+}
+
+void TimerWheel::cascade(uint64_t level, std::vector<Timer*> &expired) {
+    auto slot = (current_ >> (kSlotBits * level)) & kSlotMask;
+    auto *timer = slots_[level][slot];
+    slots_[level][slot] = nullptr;
+    occupied_[level][slot / 64] &= ~(1UL << (slot % 64));
+    while (timer != nullptr) {
+        auto *next = timer->next_;
+        if (timer->expire_ <= current_) {
+            // Already due
+            timer->prev_ = nullptr;
+            timer->next_ = nullptr;
+            timer->slot_ = -1;
+            size_--;
+            expired.emplace_back(timer);
+        } else {
+            link(timer);
+        }
+        timer = next;
+    }
+}
+
+}   // namespace thread
+}   // namespace nebula
@@ -0,0 +1,126 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+#ifndef COMMON_THREAD_TIMERWHEEL_H_
+#define COMMON_THREAD_TIMERWHEEL_H_
+
+#include "base/Base.h"
+#include "cpp/helpers.h"
+#include "thread/Task.h"
+
+/**
+ * TimerWheel is a hierarchical timing wheel of millisecond ticks, with `kLevels' wheels
+ * of `kSlots' slots each, so that a timer is added or cancelled in O(1). A timer far in
+ * the future sits in a coarse wheel, and is moved down to a finer one as its time nears.
+ *
+ * The timers are kept in a slab of chunks and reused, and the ID of a timer tells its
+ * place in the slab, so nothing is allocated or looked up per timer once the slab is warm.
+ *
+ * TimerWheel is not thread-safe, GenericWorker guards it with its lock.
+ */
+
+namespace nebula {
+namespace thread {
+
+class TimerWheel final : public nebula::cpp::NonCopyable, public nebula::cpp::NonMovable {
+public:
+    static constexpr uint64_t kSlotBits = 8;
+    static constexpr uint64_t kSlots = 1UL << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr uint64_t kLevels = 4;
+    // A timer ID is its generation and its index in the slab, in 48 bits
+    static constexpr uint64_t kIndexBits = 24;
+    static constexpr uint64_t kIndexMask = (1UL << kIndexBits) - 1;
+    static constexpr uint64_t kGenerationMask = (1UL << 24) - 1;
+
+    struct Timer {
+        uint64_t                        id_{0};
+        // The tick to fire at
+        uint64_t                        expire_{0};
+        uint64_t                        intervalMSec_{0};
+        Task                            callback_;
+        Timer                          *prev_{nullptr};
+        Timer                          *next_{nullptr};
+        // The slot of all the wheels it is in, or -1
+        int32_t                         slot_{-1};
+        // Cancelled after it was taken out by `advance'
+        bool                            cancelled_{false};
+    };
+
+    TimerWheel();
+    ~TimerWheel();
+
+    /**
+     * To add a timer.
+     * @expire      the tick to fire at
+     * @interval    interval in ticks to repeat, or 0 if oneshot
+     * @return      ID of the timer
+     */
+    uint64_t add(uint64_t expire, uint64_t interval, Task callback);
+
+    /**
+     * To cancel a timer, which is never started since, though it may be running
+     * already. A timer taken out by `advance' is only marked as `cancelled_',
+     * which the caller must check, with the same lock held, before running it.
+     * @return      the callback, to be destroyed by the caller out of its lock,
+     *              or an empty one if the timer is taken out or gone
+     */
+    Task cancel(uint64_t id);
+
+    /**
+     * To move the clock to `now', and take out all the timers expired in `expired'.
+     * Each of them must be given back by `finish' once it runs.
+     */
+    void advance(uint64_t now, std::vector<Timer*> &expired);
+
+    /**
+     * To add back a repeated timer that ran, or else to free it.
+     * @return      the callback of the timer freed, to be destroyed by the caller
+     */
+    Task finish(Timer *timer);
+
+    /**
+     * The tick to check the timers at next, which is no later than the first one
+     * expires, or `kNever' if there is none.
+     */
+    uint64_t nextTick() const;
+
+    uint64_t now() const {
+        return current_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+private:
+    static constexpr size_t kChunkSize = 4096;
+
+    Timer* allocTimer();
+    void freeTimer(Timer *timer);
+    Timer* findTimer(uint64_t id);
+
+    void link(Timer *timer);
+    void unlink(Timer *timer);
+    // To move the timers of the slot at `current_' in `level' down to the finer wheels,
+    // or into `expired' if they are due
+    void cascade(uint64_t level, std::vector<Timer*> &expired);
+
+private:
+    uint64_t                                    current_{0};
+    size_t                                      size_{0};
+    Timer                                      *slots_[kLevels][kSlots];
+    // The slots not empty of each wheel
+    uint64_t                                    occupied_[kLevels][kSlots / 64];
+    std::vector<std::unique_ptr<Timer[]>>       chunks_;
+    Timer                                      *free_{nullptr};
+};
+
+}   // namespace thread
+}   // namespace nebula
+
+#endif  // COMMON_THREAD_TIMERWHEEL_H_
@@ -0,0 +1,149 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+#ifndef COMMON_THREAD_WORKSTEALINGDEQUE_H_
+#define COMMON_THREAD_WORKSTEALINGDEQUE_H_
+
+#include "base/Base.h"
+#include "cpp/helpers.h"
+
+/**
+ * WorkStealingDeque is the lock-free deque of Chase and Lev, in the C11 form of
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al., PPoPP'13).
+ *
+ * Only the owner thread `push'es and `pop's, at the bottom, and any other thread
+ * `steal's, at the top. The ring grows when full, and the rings outgrown are
+ * kept till the deque is destroyed, since a thief may still be reading them.
+ *
+ * T must be trivially copyable, e.g. a pointer.
+ */
+
+namespace nebula {
+namespace thread {
+
+template <typename T>
+class WorkStealingDeque final : public nebula::cpp::NonCopyable
+                              , public nebula::cpp::NonMovable {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+    explicit WorkStealingDeque(size_t capacity = 1024) {
+        size_t cap = 1;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        rings_.emplace_back(std::make_unique<Ring>(cap));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    /**
+     * To push an item at the bottom, by the owner only.
+     */
+    void push(T item) {
+        auto b = bottom_.load(std::memory_order_relaxed);
+        auto t = top_.load(std::memory_order_acquire);
+        auto *ring = ring_.load(std::memory_order_relaxed);
+        if (b - t > static_cast<int64_t>(ring->mask_)) {
+            ring = grow(ring, t, b);
+        }
+        ring->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * To pop the item pushed last, by the owner only.
+     * @return  false if empty
+     */
+    bool pop(T &item) {
+        auto b = bottom_.load(std::memory_order_relaxed) - 1;
+        auto *ring = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        item = ring->get(b);
+        if (t == b) {
+            // The last one, which a thief may be taking at the same time
+            auto won = top_.compare_exchange_strong(t, t + 1,
+                                                    std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * To steal the item pushed first, by any thread.
+     * @return  false if empty, or lost to another thief or to the owner
+     */
+    bool steal(T &item) {
+        auto t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        auto *ring = ring_.load(std::memory_order_acquire);
+        item = ring->get(t);
+        return top_.compare_exchange_strong(t, t + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+
+    /**
+     * The number of items, which is only a hint while others push or steal.
+     */
+    size_t size() const {
+        auto b = bottom_.load(std::memory_order_relaxed);
+        auto t = top_.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+private:
+    struct Ring {
+        explicit Ring(size_t capacity)
+            : mask_(capacity - 1)
+            , items_(new std::atomic<T>[capacity]) {
+        }
+
+        T get(int64_t i) const {
+            return items_[i & mask_].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, T item) {
+            items_[i & mask_].store(item, std::memory_order_relaxed);
+        }
+
+        size_t                                  mask_;
+        std::unique_ptr<std::atomic<T>[]>       items_;
+    };
+
+    Ring* grow(Ring *ring, int64_t t, int64_t b) {
+        auto bigger = std::make_unique<Ring>((ring->mask_ + 1) * 2);
+        for (auto i = t; i < b; i++) {
+            bigger->put(i, ring->get(i));
+        }
+        rings_.emplace_back(std::move(bigger));
+        ring_.store(rings_.back().get(), std::memory_order_release);
+        return rings_.back().get();
+    }
+
+private:
+    std::atomic<int64_t>                        top_{0};
+    std::atomic<int64_t>                        bottom_{0};
+    std::atomic<Ring*>                          ring_{nullptr};
+    // All the rings ever used, only touched by the owner
+    std::vector<std::unique_ptr<Ring>>          rings_;
+};
+
+}   // namespace thread
+}   // namespace nebula
+
+#endif  // COMMON_THREAD_WORKSTEALINGDEQUE_H_
@@ -0,0 +1,176 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <folly/synchronization/Baton.h>
+#include "thread/GenericThreadPool.h"
+
+DEFINE_uint32(bm_threads, 8, "The number of threads of the pool");
+
+using nebula::thread::GenericThreadPool;
+
+// Blocks allocated through the global operator new, to check that queuing a
+// task allocates nothing
+static std::atomic<size_t> gAllocations{0};
+
+void* operator new(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    auto* p = ::malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    ::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    ::free(p);
+}
+
+// Keep the thread busy for a while
+void spin(size_t us) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// One in every `slowEvery' tasks takes 1ms, the others 1us
+void throughput(size_t iters, bool workStealing, size_t slowEvery) {
+    GenericThreadPool pool;
+    std::vector<GenericThreadPool::UnitFutureType> futures;
+    BENCHMARK_SUSPEND {
+        CHECK(pool.start(FLAGS_bm_threads, "bm", workStealing));
+        futures.reserve(iters);
+    }
+    for (auto i = 0UL; i < iters; i++) {
+        futures.emplace_back(pool.addTask(&spin, i % slowEvery == 0 ? 1000 : 1));
+    }
+    for (auto &future : futures) {
+        std::move(future).get();
+    }
+    BENCHMARK_SUSPEND {
+        pool.stop();
+        pool.wait();
+    }
+}
+
+// The time taken by a burst of short tasks, added along with a slow one of
+// 2ms, which is hardly seen if the others don't wait behind it
+void latency(size_t iters, bool workStealing) {
+    GenericThreadPool pool;
+    BENCHMARK_SUSPEND {
+        CHECK(pool.start(FLAGS_bm_threads, "bm", workStealing));
+    }
+    std::vector<GenericThreadPool::UnitFutureType> futures;
+    for (auto i = 0UL; i < iters; i++) {
+        auto slow = pool.addTask(&spin, 2000);
+        for (auto j = 0UL; j < FLAGS_bm_threads * 4; j++) {
+            futures.emplace_back(pool.addTask(&spin, 1));
+        }
+        for (auto &future : futures) {
+            std::move(future).get();
+        }
+        futures.clear();
+        BENCHMARK_SUSPEND {
+            std::move(slow).get();
+        }
+    }
+    BENCHMARK_SUSPEND {
+        pool.stop();
+        pool.wait();
+    }
+}
+
+// A task of a chain, which queues the next one from within the pool till
+// `left' drops below zero, and posts `done' if it is the last one of all
+struct Link {
+    void operator()() const {
+        auto n = --*left;
+        if (n >= 0) {
+            pool->run(*this);
+        } else if (n == -numChains) {
+            done->post();
+        }
+    }
+
+    GenericThreadPool          *pool;
+    std::atomic<int64_t>       *left;
+    folly::Baton<>             *done;
+    int64_t                     numChains;
+};
+
+// Run `iters' tasks in `FLAGS_bm_threads * 4' chains, and return the blocks
+// allocated meanwhile
+size_t runChains(GenericThreadPool &pool, size_t iters) {
+    auto numChains = static_cast<int64_t>(FLAGS_bm_threads * 4);
+    std::atomic<int64_t> left{static_cast<int64_t>(iters)};
+    folly::Baton<> done;
+    auto before = gAllocations.load();
+    for (auto i = 0; i < numChains; i++) {
+        pool.run(Link{&pool, &left, &done, numChains});
+    }
+    done.wait();
+    return gAllocations.load() - before;
+}
+
+// The tasks queued by the tasks, and stolen by the idle threads, which must
+// allocate nothing once the deques and the nodes of the pool are warmed up
+void chains(size_t iters) {
+    GenericThreadPool pool;
+    BENCHMARK_SUSPEND {
+        CHECK(pool.start(FLAGS_bm_threads, "bm", true));
+        runChains(pool, 100000);
+    }
+    auto allocated = runChains(pool, iters);
+    BENCHMARK_SUSPEND {
+        // Only the first tasks of the chains, queued from outside the pool,
+        // may allocate
+        CHECK_LE(allocated, FLAGS_bm_threads * 4) << "in " << iters << " tasks";
+        pool.stop();
+        pool.wait();
+    }
+}
+
+BENCHMARK(workStealing_chains, iters) {
+    chains(iters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(roundRobin_uniform, iters) {
+    throughput(iters, false, std::numeric_limits<size_t>::max());
+}
+BENCHMARK_RELATIVE(workStealing_uniform, iters) {
+    throughput(iters, true, std::numeric_limits<size_t>::max());
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(roundRobin_skewed, iters) {
+    throughput(iters, false, 100);
+}
+BENCHMARK_RELATIVE(workStealing_skewed, iters) {
+    throughput(iters, true, 100);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(roundRobin_latency, iters) {
+    latency(iters, false);
+}
+BENCHMARK_RELATIVE(workStealing_latency, iters) {
+    latency(iters, true);
+}
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 #include "thread/GenericThreadPool.h"
 #include "time/Duration.h"
+#include <folly/synchronization/Baton.h>
 
 namespace nebula {
 namespace thread {
@@ -144,5 +145,49 @@ TEST(GenericThreadPool, purgeRepeatTask) {
     }
 }
 
+TEST(GenericThreadPool, WorkStealing) {
+    GenericThreadPool pool;
+    ASSERT_TRUE(pool.start(4, "", true));
+    // futures with and without values
+    {
+        volatile auto flag = false;
+        pool.addTask([&] () { flag = true; }).get();
+        ASSERT_TRUE(flag);
+        ASSERT_EQ("Innuendo", pool.addTask([] () { return std::string("Innuendo"); }).get());
+    }
+    // tasks added by tasks
+    {
+        std::atomic<size_t> counter{0};
+        auto task = [&] () {
+            std::vector<GenericThreadPool::UnitFutureType> futures;
+            for (auto i = 0; i < 100; i++) {
+                futures.emplace_back(pool.addTask([&] () { counter++; }));
+            }
+            return futures;
+        };
+        auto futures = pool.addTask(task).get();
+        for (auto &future : futures) {
+            std::move(future).get();
+        }
+        ASSERT_EQ(100UL, counter);
+    }
+    // a slow task doesn't hold the tasks queued behind it
+    {
+        folly::Baton<> baton;
+        auto blocked = pool.addTask([&] () { baton.wait(); });
+        std::vector<GenericThreadPool::UnitFutureType> futures;
+        for (auto i = 0; i < 100; i++) {
+            futures.emplace_back(pool.addTask([] () {}));
+        }
+        for (auto &future : futures) {
+            std::move(future).get();
+        }
+        baton.post();
+        std::move(blocked).get();
+    }
+    // timer tasks still work
+    ASSERT_EQ(1, pool.addDelayTask(10, [] () { return 1; }).get());
+}
+
 }   // namespace thread
 }   // namespace nebula
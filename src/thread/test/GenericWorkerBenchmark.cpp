@@ -0,0 +1,144 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <folly/synchronization/Baton.h>
+#include <event2/event.h>
+#include "thread/GenericWorker.h"
+#include "thread/TimerWheel.h"
+
+using nebula::thread::GenericWorker;
+using nebula::thread::TimerWheel;
+
+// Enqueue `iters' tiny tasks and wait till all of them are executed, the
+// last one posts the baton
+template <typename Submit>
+void enqueueAndExecute(size_t iters, Submit submit) {
+    GenericWorker worker;
+    BENCHMARK_SUSPEND {
+        CHECK(worker.start());
+    }
+    folly::Baton<> baton;
+    size_t counter = 0;
+    auto task = [&counter, &baton, iters] (size_t i) {
+        counter += i;
+        if (i + 1 == iters) {
+            baton.post();
+        }
+    };
+    for (auto i = 0UL; i < iters; i++) {
+        submit(worker, task, i);
+    }
+    baton.wait();
+    folly::doNotOptimizeAway(counter);
+    BENCHMARK_SUSPEND {
+        worker.stop();
+        worker.wait();
+    }
+}
+
+// The way addTask submitted before, with a shared promise and a shared
+// std::function of std::bind, wrapped in another std::function
+BENCHMARK(sharedFunction, iters) {
+    enqueueAndExecute(iters, [] (GenericWorker &worker, auto &f, size_t i) {
+        auto promise = std::make_shared<folly::Promise<folly::Unit>>();
+        auto task = std::make_shared<std::function<void()>>(std::bind(f, i));
+        std::function<void()> wrapper = [=] {
+            (*task)();
+            promise->setValue(folly::unit);
+        };
+        worker.run(std::move(wrapper));
+    });
+}
+
+BENCHMARK_RELATIVE(addTask, iters) {
+    enqueueAndExecute(iters, [] (GenericWorker &worker, auto &f, size_t i) {
+        worker.addTask(f, i);
+    });
+}
+
+BENCHMARK_RELATIVE(run, iters) {
+    enqueueAndExecute(iters, [] (GenericWorker &worker, auto &f, size_t i) {
+        worker.run([&f, i] () { f(i); });
+    });
+}
+
+BENCHMARK_DRAW_LINE();
+
+// Schedule and cancel `iters' timers, which is what a timeout guarding each
+// request does, mostly cancelled before it fires
+static constexpr size_t kNumTimers = 1000000;
+
+// An event of libevent each, which GenericWorker once created per timer
+BENCHMARK(libeventTimers, iters) {
+    struct event_base *base = nullptr;
+    BENCHMARK_SUSPEND {
+        base = event_base_new();
+    }
+    for (auto n = 0UL; n < iters; n++) {
+        std::vector<struct event*> events;
+        events.reserve(kNumTimers);
+        for (auto i = 0UL; i < kNumTimers; i++) {
+            auto *ev = event_new(base, -1, 0, [] (int, int16_t, void*) {}, nullptr);
+            struct timeval tv;
+            tv.tv_sec = 1 + i % 60;
+            tv.tv_usec = 0;
+            evtimer_add(ev, &tv);
+            events.emplace_back(ev);
+        }
+        for (auto *ev : events) {
+            event_del(ev);
+            event_free(ev);
+        }
+    }
+    BENCHMARK_SUSPEND {
+        event_base_free(base);
+    }
+}
+
+BENCHMARK_RELATIVE(timerWheel, iters) {
+    TimerWheel wheel;
+    std::vector<uint64_t> ids;
+    ids.reserve(kNumTimers);
+    for (auto n = 0UL; n < iters; n++) {
+        for (auto i = 0UL; i < kNumTimers; i++) {
+            ids.emplace_back(wheel.add(1000 * (1 + i % 60), 0, [] () {}));
+        }
+        for (auto id : ids) {
+            wheel.cancel(id);
+        }
+        ids.clear();
+    }
+}
+
+BENCHMARK_RELATIVE(workerTimers, iters) {
+    GenericWorker worker;
+    BENCHMARK_SUSPEND {
+        CHECK(worker.start());
+    }
+    std::vector<uint64_t> ids;
+    ids.reserve(kNumTimers);
+    for (auto n = 0UL; n < iters; n++) {
+        for (auto i = 0UL; i < kNumTimers; i++) {
+            ids.emplace_back(worker.addRepeatTask(1000 * (1 + i % 60), [] () {}));
+        }
+        for (auto id : ids) {
+            worker.purgeTimerTask(id);
+        }
+        ids.clear();
+    }
+    BENCHMARK_SUSPEND {
+        worker.stop();
+        worker.wait();
+    }
+}
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
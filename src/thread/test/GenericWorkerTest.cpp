@@ -6,6 +6,7 @@
 
 #include "base/Base.h"
 #include <gtest/gtest.h>
+#include <folly/synchronization/Baton.h>
 #include "thread/GenericWorker.h"
 #include "time/Duration.h"
 
@@ -88,6 +89,85 @@ TEST(GenericWorker, addTask) {
     }
 }
 
+TEST(GenericWorker, run) {
+    GenericWorker worker;
+    ASSERT_TRUE(worker.start());
+    // tasks run in order
+    {
+        std::vector<int> order;
+        for (auto i = 0; i < 10; i++) {
+            worker.run([&order, i] () { order.emplace_back(i); });
+        }
+        worker.addTask([] () {}).get();
+        ASSERT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), order);
+    }
+    // move-only task
+    {
+        auto ptr = std::make_unique<int>(918);
+        auto value = 0;
+        worker.run([ptr = std::move(ptr), &value] () { value = *ptr; });
+        worker.addTask([] () {}).get();
+        ASSERT_EQ(918, value);
+    }
+    // exception is dropped, and the future of addTask gets it
+    {
+        worker.run([] () { throw std::runtime_error("dropped"); });
+        auto future = worker.addTask([] () -> int { throw std::runtime_error("kept"); });
+        ASSERT_THROW(std::move(future).get(), std::runtime_error);
+    }
+}
+
+TEST(GenericWorker, priority) {
+    GenericWorker worker;
+    ASSERT_TRUE(worker.start());
+    // Held by a task, till all the others are queued
+    folly::Baton<> started;
+    folly::Baton<> baton;
+    worker.run([&] () {
+        started.post();
+        baton.wait();
+    });
+    started.wait();
+    std::vector<std::string> order;
+    for (auto i = 0; i < 10; i++) {
+        worker.run([&order] () { order.emplace_back("L"); }, TaskOptions(TaskPriority::LOW));
+    }
+    for (auto i = 0; i < 10; i++) {
+        worker.run([&order] () { order.emplace_back("H"); }, TaskOptions(TaskPriority::HIGH));
+    }
+    auto future = worker.addTask(TaskOptions(TaskPriority::LOW), [] () { return 1; });
+    baton.post();
+    ASSERT_EQ(1, std::move(future).get());
+    // 8 high and 1 low in each round
+    ASSERT_EQ("HHHHHHHHLHHLLLLLLLLL", folly::join("", order));
+}
+
+TEST(GenericWorker, deadline) {
+    GenericWorker worker;
+    ASSERT_TRUE(worker.start());
+    folly::Baton<> started;
+    folly::Baton<> baton;
+    worker.run([&] () {
+        started.post();
+        baton.wait();
+    });
+    started.wait();
+    auto counter = 0;
+    auto future = worker.addTask(TaskOptions::within(TaskPriority::HIGH,
+                                                     std::chrono::milliseconds(1)),
+                                 [&] () { counter++; });
+    worker.run([&] () { counter++; }, TaskOptions::within(TaskPriority::NORMAL,
+                                                          std::chrono::milliseconds(1)));
+    auto kept = worker.addTask(TaskOptions::within(TaskPriority::LOW, std::chrono::hours(1)),
+                               [&] () { counter++; });
+    ::usleep(10 * 1000);
+    baton.post();
+    // The expired ones are dropped
+    ASSERT_THROW(std::move(future).get(), folly::BrokenPromise);
+    std::move(kept).get();
+    ASSERT_EQ(1, counter);
+}
+
 static testing::AssertionResult msAboutEqual(size_t expected, size_t actual) {
     if (std::max(expected, actual) - std::min(expected, actual) <= 10) {
         return testing::AssertionSuccess();
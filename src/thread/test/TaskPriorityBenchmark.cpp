@@ -0,0 +1,103 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "thread/GenericThreadPool.h"
+
+DEFINE_int32(priority_bm_threads, 4, "Number of threads of the pool");
+DEFINE_int32(priority_bm_backlog, 1000, "Number of the background tasks kept queued");
+DEFINE_int32(priority_bm_task_us, 20, "Microseconds each background task runs");
+
+using nebula::thread::GenericThreadPool;
+using nebula::thread::TaskOptions;
+using nebula::thread::TaskPriority;
+using Clock = std::chrono::steady_clock;
+
+// The wait in microseconds of each probe, by the benchmark
+static std::map<std::string, std::vector<int64_t>> waits;
+
+static void spin(int64_t us) {
+    auto until = Clock::now() + std::chrono::microseconds(us);
+    while (Clock::now() < until) {
+    }
+}
+
+// Add `iters' probes of the class `probe', one after another, while the pool is
+// saturated by the background tasks of the class `background'
+void probeUnderLoad(size_t iters,
+                    const std::string &name,
+                    TaskPriority probe,
+                    TaskPriority background) {
+    GenericThreadPool pool;
+    std::atomic<bool> stopped{false};
+    std::atomic<int64_t> queued{0};
+    std::unique_ptr<std::thread> flooder;
+    BENCHMARK_SUSPEND {
+        CHECK(pool.start(FLAGS_priority_bm_threads));
+        flooder = std::make_unique<std::thread>([&] () {
+            while (!stopped.load()) {
+                if (queued.load() >= FLAGS_priority_bm_backlog) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                queued++;
+                pool.run([&queued] () {
+                    spin(FLAGS_priority_bm_task_us);
+                    queued--;
+                }, TaskOptions(background));
+            }
+        });
+        // Till saturated
+        while (queued.load() < FLAGS_priority_bm_backlog) {
+            std::this_thread::yield();
+        }
+    }
+    auto &samples = waits[name];
+    for (auto i = 0UL; i < iters; i++) {
+        auto submitted = Clock::now();
+        auto started = pool.addTask(TaskOptions(probe), [] () {
+            return Clock::now();
+        }).get();
+        samples.emplace_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(started - submitted).count());
+    }
+    BENCHMARK_SUSPEND {
+        stopped = true;
+        flooder->join();
+        pool.stop();
+        pool.wait();
+    }
+}
+
+// Every task in the FIFO way, as before there were the priority classes
+BENCHMARK(fifo, iters) {
+    probeUnderLoad(iters, "fifo", TaskPriority::NORMAL, TaskPriority::NORMAL);
+}
+
+BENCHMARK_RELATIVE(highOverLow, iters) {
+    probeUnderLoad(iters, "highOverLow", TaskPriority::HIGH, TaskPriority::LOW);
+}
+
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    folly::runBenchmarks();
+    for (auto &pair : waits) {
+        auto &samples = pair.second;
+        if (samples.empty()) {
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto pct = [&samples] (double p) {
+            return samples[std::min(samples.size() - 1,
+                                    static_cast<size_t>(samples.size() * p))];
+        };
+        LOG(INFO) << pair.first << ": wait in us of " << samples.size() << " probes, "
+                  << "p50 " << pct(0.5) << ", p99 " << pct(0.99)
+                  << ", max " << samples.back();
+    }
+    return 0;
+}
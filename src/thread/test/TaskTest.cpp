@@ -0,0 +1,70 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include <array>
+#include "thread/Task.h"
+
+namespace nebula {
+namespace thread {
+
+TEST(Task, InlineAndHeap) {
+    auto counter = 0;
+    // small callable kept in place
+    {
+        Task task([&] () { counter++; });
+        ASSERT_TRUE(static_cast<bool>(task));
+        task();
+        Task moved(std::move(task));
+        ASSERT_FALSE(static_cast<bool>(task));
+        moved();
+        ASSERT_EQ(2, counter);
+    }
+    // large callable moved to the heap
+    {
+        std::array<char, 128> big;
+        big.fill(1);
+        Task task([&, big] () { counter += big[0]; });
+        Task assigned;
+        ASSERT_FALSE(static_cast<bool>(assigned));
+        assigned = std::move(task);
+        assigned();
+        ASSERT_EQ(3, counter);
+    }
+    // move-only callable, destroyed with the task
+    {
+        auto shared = std::make_shared<int>(1);
+        {
+            auto ptr = std::make_unique<std::shared_ptr<int>>(shared);
+            Task task([ptr = std::move(ptr)] () { (**ptr)++; });
+            task();
+            ASSERT_EQ(2, shared.use_count());
+        }
+        ASSERT_EQ(2, *shared);
+        ASSERT_EQ(1, shared.use_count());
+    }
+}
+
+TEST(Task, Bind) {
+    struct X {
+        std::string itos(size_t i) {
+            return std::to_string(i);
+        }
+    } x;
+    ASSERT_EQ("918", Task::bind(&X::itos, &x, 918)());
+    ASSERT_EQ("918", Task::bind(&X::itos, std::make_shared<X>(), 918)());
+    auto add = Task::bind([] (int a, int b) { return a + b; }, 1, 2);
+    ASSERT_EQ(3, add());
+    // arguments are kept by value
+    std::string str("Innuendo");
+    auto size = Task::bind([] (const std::string &s) { return s.size(); }, str);
+    str.clear();
+    ASSERT_EQ(8UL, size());
+}
+
+}   // namespace thread
+}   // namespace nebula
@@ -0,0 +1,117 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <folly/synchronization/Baton.h>
+#include "thread/GenericThreadPool.h"
+#include "thread/ThreadPlacement.h"
+
+DEFINE_int32(placement_bm_threads, 4, "Number of threads of the pool");
+DEFINE_int32(placement_bm_chain_mb, 32, "Size in MB of the state of each thread");
+DEFINE_int32(placement_bm_steps, 100000, "Number of loads each task makes");
+
+using nebula::thread::CpuTopology;
+using nebula::thread::GenericThreadPool;
+using nebula::thread::ThreadPlacement;
+
+// The state of a thread, a random cycle over a buffer much larger than the caches,
+// so that each load misses, and goes to the NUMA node the buffer is allocated from
+class Chain final {
+public:
+    explicit Chain(size_t mb) : next_(mb * 1024 * 1024 / sizeof(uint32_t)) {
+        // Sattolo's shuffle, to make a single cycle
+        for (auto i = 0UL; i < next_.size(); i++) {
+            next_[i] = i;
+        }
+        for (auto i = next_.size() - 1; i > 0; i--) {
+            std::swap(next_[i], next_[folly::Random::rand32(i)]);
+        }
+    }
+
+    // From a random point, so that no path stays in the caches
+    uint32_t walk(size_t steps) const {
+        uint32_t from = folly::Random::rand32(next_.size());
+        for (auto i = 0UL; i < steps; i++) {
+            from = next_[from];
+        }
+        return from;
+    }
+
+private:
+    std::vector<uint32_t>               next_;
+};
+
+// Run `iters' walks on the threads placed by `placement', with the chains made
+// by the threads themselves if `local', or else by the caller
+void walkChains(size_t iters, const ThreadPlacement &placement, bool local) {
+    GenericThreadPool pool;
+    std::vector<std::unique_ptr<Chain>> chains;
+    BENCHMARK_SUSPEND {
+        size_t nrThreads = FLAGS_placement_bm_threads;
+        CHECK(pool.start(nrThreads, "placement-bm", false, placement));
+        for (auto i = 0UL; i < nrThreads; i++) {
+            if (local) {
+                chains.emplace_back(pool.makeLocal<Chain>(i, FLAGS_placement_bm_chain_mb));
+            } else {
+                chains.emplace_back(std::make_unique<Chain>(FLAGS_placement_bm_chain_mb));
+            }
+        }
+    }
+    folly::Baton<> baton;
+    std::atomic<size_t> remaining{iters};
+    std::atomic<uint32_t> sink{0};
+    // The pool is round-robin, so the i-th task runs on the thread of the i-th chain
+    for (auto i = 0UL; i < iters; i++) {
+        auto *chain = chains[i % chains.size()].get();
+        pool.addTask([chain, &baton, &remaining, &sink] () {
+            sink += chain->walk(FLAGS_placement_bm_steps);
+            if (--remaining == 0) {
+                baton.post();
+            }
+        });
+    }
+    if (iters > 0) {
+        baton.wait();
+    }
+    folly::doNotOptimizeAway(sink.load());
+    BENCHMARK_SUSPEND {
+        pool.stop();
+        pool.wait();
+        chains.clear();
+    }
+}
+
+BENCHMARK(floatingRemote, iters) {
+    walkChains(iters, ThreadPlacement(), false);
+}
+
+BENCHMARK_RELATIVE(spreadRemote, iters) {
+    walkChains(iters, ThreadPlacement::spread(), false);
+}
+
+BENCHMARK_RELATIVE(spreadLocal, iters) {
+    walkChains(iters, ThreadPlacement::spread(), true);
+}
+
+BENCHMARK_RELATIVE(compactLocal, iters) {
+    walkChains(iters, ThreadPlacement::compact(), true);
+}
+
+/*
+ * With `--numa_simulated_nodes=2' on a host of a single node, the placement
+ * is made as if there were two nodes, though every load is local anyway.
+ */
+int main(int argc, char** argv) {
+    gflags::ParseCommandLineFlags(&argc, &argv, true);
+    auto &topology = CpuTopology::host();
+    for (auto &node : topology.nodes()) {
+        LOG(INFO) << "NUMA node " << node.id << ": CPUs "
+                  << nebula::thread::CpuBinding{node.id, node.cpus}.toString();
+    }
+    folly::runBenchmarks();
+    return 0;
+}
@@ -0,0 +1,124 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "thread/GenericThreadPool.h"
+#include "thread/ThreadPlacement.h"
+
+namespace nebula {
+namespace thread {
+
+TEST(ThreadPlacement, ParseCpuList) {
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+              CpuTopology::parseCpuList("0-3,8,10-11").value());
+    ASSERT_EQ(std::vector<int>({1, 2, 5}), CpuTopology::parseCpuList("5,1-2,2").value());
+    ASSERT_TRUE(CpuTopology::parseCpuList("").value().empty());
+    ASSERT_FALSE(CpuTopology::parseCpuList("3-1").hasValue());
+    ASSERT_FALSE(CpuTopology::parseCpuList("a").hasValue());
+    ASSERT_FALSE(CpuTopology::parseCpuList("1,,2").hasValue());
+    ASSERT_FALSE(CpuTopology::parseCpuList("-1").hasValue());
+}
+
+TEST(ThreadPlacement, Parse) {
+    for (auto spec : {"floating", "spread", "compact", "compact:1", "cores:0-3,8"}) {
+        auto placement = ThreadPlacement::parse(spec);
+        ASSERT_TRUE(placement.hasValue()) << spec;
+        ASSERT_EQ(spec, placement->toString());
+    }
+    for (auto spec : {"", "float", "spread:1", "compact:x", "cores", "cores:", "cores:2-1"}) {
+        ASSERT_FALSE(ThreadPlacement::parse(spec).hasValue()) << spec;
+    }
+}
+
+TEST(ThreadPlacement, Binding) {
+    auto topology = CpuTopology::simulate({0, 1, 2, 3, 4, 5, 6, 7}, 2);
+    ASSERT_EQ(2UL, topology.numNodes());
+    ASSERT_EQ(0, topology.nodeOf(3));
+    ASSERT_EQ(1, topology.nodeOf(4));
+    ASSERT_EQ(-1, topology.nodeOf(8));
+
+    auto floating = ThreadPlacement().bindingOf(0, topology);
+    ASSERT_TRUE(floating.empty());
+    ASSERT_EQ(-1, floating.node);
+    ASSERT_EQ("any", floating.toString());
+
+    auto cores = ThreadPlacement::cores({2, 5});
+    ASSERT_EQ(std::vector<int>{2}, cores.bindingOf(0, topology).cpus);
+    ASSERT_EQ(0, cores.bindingOf(0, topology).node);
+    ASSERT_EQ(std::vector<int>{5}, cores.bindingOf(1, topology).cpus);
+    ASSERT_EQ(1, cores.bindingOf(1, topology).node);
+    ASSERT_EQ(std::vector<int>{2}, cores.bindingOf(2, topology).cpus);
+    // floats if no cores
+    ASSERT_EQ(ThreadPlacement::Policy::FLOATING, ThreadPlacement::cores({}).policy());
+    ASSERT_TRUE(ThreadPlacement::cores({}).bindingOf(0, topology).empty());
+
+    auto spread = ThreadPlacement::spread();
+    for (auto i = 0; i < 4; i++) {
+        auto binding = spread.bindingOf(i, topology);
+        ASSERT_EQ(i % 2, binding.node);
+        ASSERT_EQ(i % 2 == 0 ? "0-3" : "4-7", binding.toString());
+    }
+
+    for (auto i = 0; i < 4; i++) {
+        auto binding = ThreadPlacement::compact(1).bindingOf(i, topology);
+        ASSERT_EQ(1, binding.node);
+        ASSERT_EQ("4-7", binding.toString());
+        ASSERT_EQ(0, ThreadPlacement::compact().bindingOf(i, topology).node);
+    }
+    // floats if no such node
+    ASSERT_TRUE(ThreadPlacement::compact(2).bindingOf(0, topology).empty());
+}
+
+TEST(ThreadPlacement, Pool) {
+    // Bound to the first CPU allowed, which always exists
+    auto cpu = CpuTopology::host().allCpus().front();
+    GenericThreadPool pool;
+    ASSERT_TRUE(pool.start(2, "placement", false, ThreadPlacement::cores({cpu})));
+    for (auto i = 0UL; i < pool.size(); i++) {
+        ASSERT_EQ(std::vector<int>{cpu}, pool.bindingOf(i).cpus);
+        auto local = pool.makeLocal<int>(i, -1);
+        ASSERT_EQ(-1, *local);
+    }
+    auto ran = pool.addTask([] () { return ::sched_getcpu(); }).get();
+    ASSERT_EQ(cpu, ran);
+
+    // Reported while alive
+    auto count = 0;
+    for (auto &entry : PlacementRegistry::instance().snapshot()) {
+        if (entry.name == "placement") {
+            ASSERT_EQ(std::vector<int>{cpu}, entry.binding.cpus);
+            count++;
+        }
+    }
+    ASSERT_EQ(2, count);
+
+    pool.stop();
+    pool.wait();
+    for (auto &entry : PlacementRegistry::instance().snapshot()) {
+        ASSERT_NE("placement", entry.name);
+    }
+}
+
+TEST(ThreadPlacement, BindFailure) {
+    // No such CPU
+    CpuBinding bad{-1, {CPU_SETSIZE + 1}};
+    auto floating = false;
+    NamedThread thread("bad-binding", bad, [&floating] () {
+        floating = NamedThread::binding().empty();
+    });
+    thread.join();
+    ASSERT_TRUE(floating);
+
+    GenericWorker worker;
+    ASSERT_FALSE(worker.start("bad-binding", bad));
+    for (auto &entry : PlacementRegistry::instance().snapshot()) {
+        ASSERT_NE("bad-binding", entry.name);
+    }
+}
+
+}   // namespace thread
+}   // namespace nebula
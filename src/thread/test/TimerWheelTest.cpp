@@ -0,0 +1,132 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "thread/TimerWheel.h"
+
+namespace nebula {
+namespace thread {
+
+// Advance the wheel to `now', run the timers expired and return their IDs
+static std::vector<uint64_t> advance(TimerWheel &wheel, uint64_t now) {
+    std::vector<TimerWheel::Timer*> expired;
+    wheel.advance(now, expired);
+    std::vector<uint64_t> ids;
+    for (auto *timer : expired) {
+        ids.emplace_back(timer->id_);
+        timer->callback_();
+        wheel.finish(timer);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+TEST(TimerWheel, OneShot) {
+    TimerWheel wheel;
+    auto counter = 0;
+    ASSERT_EQ(TimerWheel::kNever, wheel.nextTick());
+    // in each of the wheels
+    auto id1 = wheel.add(10, 0, [&] () { counter++; });
+    auto id2 = wheel.add(1000, 0, [&] () { counter++; });
+    auto id3 = wheel.add(100000, 0, [&] () { counter++; });
+    auto id4 = wheel.add(20000000, 0, [&] () { counter++; });
+    ASSERT_EQ(4UL, wheel.size());
+    ASSERT_EQ(10UL, wheel.nextTick());
+
+    ASSERT_TRUE(advance(wheel, 9).empty());
+    ASSERT_EQ(std::vector<uint64_t>{id1}, advance(wheel, 10));
+    ASSERT_TRUE(advance(wheel, 999).empty());
+    ASSERT_EQ(std::vector<uint64_t>{id2}, advance(wheel, 1000));
+    ASSERT_TRUE(advance(wheel, 99999).empty());
+    ASSERT_EQ(std::vector<uint64_t>{id3}, advance(wheel, 100000));
+    // fired at once if late
+    ASSERT_EQ(std::vector<uint64_t>{id4}, advance(wheel, 30000000));
+    ASSERT_EQ(4, counter);
+    ASSERT_EQ(0UL, wheel.size());
+    ASSERT_EQ(TimerWheel::kNever, wheel.nextTick());
+
+    // an expire passed is the next tick
+    auto id5 = wheel.add(0, 0, [] () {});
+    ASSERT_EQ(30000001UL, wheel.nextTick());
+    ASSERT_EQ(std::vector<uint64_t>{id5}, advance(wheel, 30000001));
+}
+
+TEST(TimerWheel, Repeat) {
+    TimerWheel wheel;
+    auto counter = 0;
+    auto id = wheel.add(50, 50, [&] () { counter++; });
+    ASSERT_EQ(std::vector<uint64_t>{id}, advance(wheel, 50));
+    ASSERT_EQ(std::vector<uint64_t>{id}, advance(wheel, 120));
+    ASSERT_EQ(std::vector<uint64_t>{id}, advance(wheel, 150));
+    ASSERT_EQ(3, counter);
+    // fired once after a long pause
+    ASSERT_EQ(std::vector<uint64_t>{id}, advance(wheel, 10000));
+    ASSERT_EQ(4, counter);
+    ASSERT_EQ(10001UL, wheel.nextTick());
+    ASSERT_TRUE(static_cast<bool>(wheel.cancel(id)));
+    ASSERT_TRUE(advance(wheel, 20000).empty());
+    ASSERT_EQ(4, counter);
+}
+
+TEST(TimerWheel, Cancel) {
+    TimerWheel wheel;
+    auto shared = std::make_shared<int>(0);
+    auto id1 = wheel.add(100, 0, [shared] () {});
+    auto id2 = wheel.add(100, 0, [shared] () {});
+    auto id3 = wheel.add(100000, 0, [shared] () {});
+    ASSERT_EQ(4, shared.use_count());
+    // the callback is given back
+    {
+        auto callback = wheel.cancel(id1);
+        ASSERT_TRUE(static_cast<bool>(callback));
+    }
+    ASSERT_EQ(3, shared.use_count());
+    ASSERT_FALSE(static_cast<bool>(wheel.cancel(id1)));
+    ASSERT_TRUE(static_cast<bool>(wheel.cancel(id3)));
+    ASSERT_EQ(1UL, wheel.size());
+
+    // the slot of the timer freed last is reused with another ID
+    auto id4 = wheel.add(200, 0, [] () {});
+    ASSERT_NE(id3, id4);
+    ASSERT_EQ(id3 & TimerWheel::kIndexMask, id4 & TimerWheel::kIndexMask);
+    ASSERT_FALSE(static_cast<bool>(wheel.cancel(id3)));
+
+    // cancelled while running, freed once finished
+    std::vector<TimerWheel::Timer*> expired;
+    wheel.advance(100, expired);
+    ASSERT_EQ(1UL, expired.size());
+    ASSERT_EQ(id2, expired[0]->id_);
+    ASSERT_FALSE(static_cast<bool>(wheel.cancel(id2)));
+    ASSERT_TRUE(static_cast<bool>(wheel.finish(expired[0])));
+    ASSERT_EQ(1, shared.use_count());
+    ASSERT_EQ(std::vector<uint64_t>{id4}, advance(wheel, 1000));
+}
+
+TEST(TimerWheel, Boundary) {
+    TimerWheel wheel;
+    // crossing the rotation of the coarsest wheel
+    constexpr uint64_t kRotation = 1UL << 32;
+    ASSERT_TRUE(advance(wheel, kRotation - 10).empty());
+    auto id1 = wheel.add(kRotation + 5, 0, [] () {});
+    auto id2 = wheel.add(kRotation + 1000000, 0, [] () {});
+    ASSERT_TRUE(advance(wheel, kRotation + 4).empty());
+    ASSERT_EQ(std::vector<uint64_t>{id1}, advance(wheel, kRotation + 5));
+    ASSERT_TRUE(advance(wheel, kRotation + 999999).empty());
+    ASSERT_EQ(std::vector<uint64_t>{id2}, advance(wheel, kRotation + 1000000));
+
+    // beyond the coarsest wheel, parked and linked again
+    auto id3 = wheel.add(2 * kRotation + 1000300, 0, [] () {});
+    auto id4 = wheel.add(5 * kRotation, 0, [] () {});
+    ASSERT_TRUE(advance(wheel, 2 * kRotation + 1000299).empty());
+    ASSERT_EQ(std::vector<uint64_t>{id3}, advance(wheel, 2 * kRotation + 1000300));
+    ASSERT_TRUE(advance(wheel, 5 * kRotation - 1).empty());
+    ASSERT_EQ(std::vector<uint64_t>{id4}, advance(wheel, 5 * kRotation));
+    ASSERT_EQ(0UL, wheel.size());
+}
+
+}   // namespace thread
+}   // namespace nebula
@@ -0,0 +1,77 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "thread/WorkStealingDeque.h"
+
+namespace nebula {
+namespace thread {
+
+TEST(WorkStealingDeque, PushPopSteal) {
+    WorkStealingDeque<size_t> deque(2);
+    size_t item = 0;
+    ASSERT_FALSE(deque.pop(item));
+    ASSERT_FALSE(deque.steal(item));
+    // grows beyond the initial capacity
+    for (auto i = 0UL; i < 10; i++) {
+        deque.push(i);
+    }
+    ASSERT_EQ(10UL, deque.size());
+    ASSERT_TRUE(deque.pop(item));
+    ASSERT_EQ(9UL, item);
+    ASSERT_TRUE(deque.steal(item));
+    ASSERT_EQ(0UL, item);
+    ASSERT_EQ(8UL, deque.size());
+    for (auto i = 8UL; i > 0; i--) {
+        ASSERT_TRUE(deque.pop(item));
+        ASSERT_EQ(i, item);
+    }
+    ASSERT_FALSE(deque.pop(item));
+    ASSERT_FALSE(deque.steal(item));
+    ASSERT_EQ(0UL, deque.size());
+}
+
+TEST(WorkStealingDeque, ConcurrentSteal) {
+    static constexpr size_t kItems = 1000000;
+    static constexpr size_t kThieves = 4;
+    WorkStealingDeque<size_t> deque(16);
+    std::atomic<bool> done{false};
+    std::vector<size_t> taken(kItems, 0);
+    std::vector<std::thread> thieves;
+    for (auto i = 0UL; i < kThieves; i++) {
+        thieves.emplace_back([&] () {
+            size_t item;
+            while (!done.load()) {
+                if (deque.steal(item)) {
+                    taken[item]++;
+                }
+            }
+        });
+    }
+    // the owner pushes all, popping one in every three
+    size_t item;
+    for (auto i = 0UL; i < kItems; i++) {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(item)) {
+            taken[item]++;
+        }
+    }
+    while (deque.pop(item)) {
+        taken[item]++;
+    }
+    done = true;
+    for (auto &thief : thieves) {
+        thief.join();
+    }
+    // each item is taken exactly once
+    for (auto i = 0UL; i < kItems; i++) {
+        ASSERT_EQ(1UL, taken[i]) << "item: " << i;
+    }
+}
+
+}   // namespace thread
+}   // namespace nebula
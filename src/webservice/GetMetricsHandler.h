@@ -0,0 +1,42 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef WEBSERVICE_GETMETRICSHANDLER_H_
+#define WEBSERVICE_GETMETRICSHANDLER_H_
+
+#include "base/Base.h"
+#include "webservice/Common.h"
+#include <proxygen/httpserver/RequestHandler.h>
+
+namespace nebula {
+
+/**
+ * Serve all stats in the OpenMetrics text format, to be scraped by Prometheus.
+ * The response body is streamed by StatsManager into an IOBuf chain directly.
+ */
+class GetMetricsHandler : public proxygen::RequestHandler {
+public:
+    GetMetricsHandler() = default;
+
+    void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+    void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override;
+
+    void onEOM() noexcept override;
+
+    void onUpgrade(proxygen::UpgradeProtocol proto) noexcept override;
+
+    void requestComplete() noexcept override;
+
+    void onError(proxygen::ProxygenError err) noexcept override;
+
+private:
+    HttpCode err_{HttpCode::SUCCEEDED};
+};
+
+}  // namespace nebula
+
+#endif  // WEBSERVICE_GETMETRICSHANDLER_H_
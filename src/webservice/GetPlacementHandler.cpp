@@ -0,0 +1,83 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "webservice/GetPlacementHandler.h"
+#include "thread/CpuBinding.h"
+#include <proxygen/httpserver/RequestHandler.h>
+#include <proxygen/lib/http/ProxygenErrorEnum.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+
+namespace nebula {
+
+using proxygen::HTTPMessage;
+using proxygen::HTTPMethod;
+using proxygen::ProxygenError;
+using proxygen::UpgradeProtocol;
+using proxygen::ResponseBuilder;
+using nebula::thread::PlacementRegistry;
+
+void GetPlacementHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
+    if (headers->getMethod().value() != HTTPMethod::GET) {
+        // Unsupported method
+        err_ = HttpCode::E_UNSUPPORTED_METHOD;
+        return;
+    }
+}
+
+void GetPlacementHandler::onBody(std::unique_ptr<folly::IOBuf>) noexcept {
+    // Do nothing, we only support GET
+}
+
+void GetPlacementHandler::onEOM() noexcept {
+    switch (err_) {
+        case HttpCode::E_UNSUPPORTED_METHOD:
+            ResponseBuilder(downstream_)
+                .status(WebServiceUtils::to(HttpStatusCode::METHOD_NOT_ALLOWED),
+                        WebServiceUtils::toString(HttpStatusCode::METHOD_NOT_ALLOWED))
+                .sendWithEOM();
+            return;
+        default:
+            break;
+    }
+
+    folly::dynamic vals = getPlacement();
+    ResponseBuilder(downstream_)
+        .status(WebServiceUtils::to(HttpStatusCode::OK),
+                WebServiceUtils::toString(HttpStatusCode::OK))
+        .body(folly::toJson(vals))
+        .sendWithEOM();
+}
+
+
+void GetPlacementHandler::onUpgrade(UpgradeProtocol) noexcept {
+    // Do nothing
+}
+
+
+void GetPlacementHandler::requestComplete() noexcept {
+    delete this;
+}
+
+
+void GetPlacementHandler::onError(ProxygenError error) noexcept {
+    LOG(ERROR) << "Web service GetPlacementHandler got error: "
+               << proxygen::getErrorString(error);
+}
+
+folly::dynamic GetPlacementHandler::getPlacement() {
+    folly::dynamic threads = folly::dynamic::array();
+    for (auto &entry : PlacementRegistry::instance().snapshot()) {
+        folly::dynamic thread = folly::dynamic::object();
+        thread["tid"] = entry.tid;
+        thread["name"] = entry.name;
+        thread["node"] = entry.binding.node;
+        thread["cpus"] = entry.binding.toString();
+        threads.push_back(std::move(thread));
+    }
+    return threads;
+}
+
+}  // namespace nebula
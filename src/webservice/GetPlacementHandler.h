@@ -0,0 +1,44 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef WEBSERVICE_GETPLACEMENTHANDLER_H_
+#define WEBSERVICE_GETPLACEMENTHANDLER_H_
+
+#include "base/Base.h"
+#include "webservice/Common.h"
+#include <proxygen/httpserver/RequestHandler.h>
+
+namespace nebula {
+
+using nebula::HttpCode;
+
+// To report the CPUs and the NUMA node each named thread is bound to
+class GetPlacementHandler : public proxygen::RequestHandler {
+public:
+    GetPlacementHandler() = default;
+
+    void onRequest(std::unique_ptr<proxygen::HTTPMessage> headers) noexcept override;
+
+    void onBody(std::unique_ptr<folly::IOBuf> body)  noexcept override;
+
+    void onEOM() noexcept override;
+
+    void onUpgrade(proxygen::UpgradeProtocol protocol) noexcept override;
+
+    void requestComplete() noexcept override;
+
+    void onError(proxygen::ProxygenError error) noexcept override;
+
+private:
+    folly::dynamic getPlacement();
+
+private:
+    HttpCode err_{HttpCode::SUCCEEDED};
+};
+
+}  // namespace nebula
+
+#endif  // WEBSERVICE_GETPLACEMENTHANDLER_H_
@@ -15,6 +15,8 @@
 #include "webservice/GetFlagsHandler.h"
 #include "webservice/SetFlagsHandler.h"
 #include "webservice/GetStatsHandler.h"
+#include "webservice/GetMetricsHandler.h"
+#include "webservice/GetPlacementHandler.h"
 #include "webservice/Router.h"
 #include "webservice/StatusHandler.h"
 
@@ -91,6 +93,14 @@ Status WebService::start() {
         DCHECK(params.empty());
         return new GetStatsHandler();
     });
+    router().get("/metrics").handler([](web::PathParams&& params) {
+        DCHECK(params.empty());
+        return new GetMetricsHandler();
+    });
+    router().get("/placement").handler([](web::PathParams&& params) {
+        DCHECK(params.empty());
+        return new GetPlacementHandler();
+    });
     router().get("/status").handler([](web::PathParams&& params) {
         DCHECK(params.empty());
         return new StatusHandler();
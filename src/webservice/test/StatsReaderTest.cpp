@@ -203,6 +203,57 @@ TEST(StatsReaderTest, GetHistoTest) {
     }
 }
 
+TEST(StatsReaderTest, GetMetricsTest) {
+    auto statId = StatsManager::registerStats("stat.metrics");
+    auto histoId = StatsManager::registerHisto("histo_metrics", 10, 1, 100);
+    auto hdrId = StatsManager::registerHdrHisto("hdr_metrics", 100);
+    auto digitId = StatsManager::registerStats("5xx.metrics");
+    StatsManager::addValue(digitId, 1);
+    for (int k = 1; k <= 100; k++) {
+        StatsManager::addValue(statId, k);
+        StatsManager::addValue(histoId, k);
+        StatsManager::addValue(hdrId, k);
+    }
+
+    std::string resp;
+    ASSERT_TRUE(getUrl("/metrics", resp));
+    std::vector<std::string> lines;
+    folly::split("\n", resp, lines, true);
+    auto contains = [&lines] (const std::string& line) {
+        return std::find(lines.begin(), lines.end(), line) != lines.end();
+    };
+
+    // The name is sanitized
+    EXPECT_TRUE(contains("# TYPE stat_metrics_sum_in_range gauge"));
+    EXPECT_TRUE(contains("stat_metrics_sum_in_range{range=\"60\"} 5050"));
+    EXPECT_TRUE(contains("stat_metrics_count_in_range{range=\"3600\"} 100"));
+    EXPECT_TRUE(contains("stat_metrics_avg{range=\"600\"} 50"));
+    // The suffixes of the histograms are not taken
+    EXPECT_FALSE(contains("# TYPE stat_metrics_sum gauge"));
+    EXPECT_FALSE(contains("# TYPE stat_metrics_count gauge"));
+    EXPECT_TRUE(contains("# TYPE _5xx_metrics_sum_in_range gauge"));
+    EXPECT_TRUE(contains("_5xx_metrics_sum_in_range{range=\"60\"} 1"));
+
+    EXPECT_TRUE(contains("# TYPE histo_metrics histogram"));
+    // Every bucket is there, even the empty ones
+    EXPECT_TRUE(contains("histo_metrics_bucket{range=\"60\",le=\"0\"} 0"));
+    EXPECT_TRUE(contains("histo_metrics_bucket{range=\"60\",le=\"10\"} 10"));
+    EXPECT_TRUE(contains("histo_metrics_bucket{range=\"60\",le=\"90\"} 90"));
+    EXPECT_TRUE(contains("histo_metrics_bucket{range=\"60\",le=\"+Inf\"} 100"));
+    EXPECT_TRUE(contains("histo_metrics_count{range=\"60\"} 100"));
+    EXPECT_TRUE(contains("histo_metrics_sum{range=\"60\"} 5050"));
+    EXPECT_TRUE(contains("histo_metrics_avg{range=\"60\"} 50"));
+
+    EXPECT_TRUE(contains("# TYPE hdr_metrics histogram"));
+    EXPECT_TRUE(contains("hdr_metrics_bucket{range=\"60\",le=\"0\"} 0"));
+    EXPECT_TRUE(contains("hdr_metrics_bucket{range=\"60\",le=\"15\"} 15"));
+    EXPECT_TRUE(contains("hdr_metrics_bucket{range=\"60\",le=\"99\"} 99"));
+    EXPECT_TRUE(contains("hdr_metrics_bucket{range=\"60\",le=\"+Inf\"} 100"));
+    EXPECT_TRUE(contains("hdr_metrics_sum{range=\"5\"} 5050"));
+
+    EXPECT_EQ("# EOF", lines.back());
+}
+
 }  // namespace nebula
 
 
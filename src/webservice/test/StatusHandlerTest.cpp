@@ -61,6 +61,25 @@ TEST(StatusHandlerTest, SimpleTest) {
     }
 }
 
+TEST(StatusHandlerTest, PlacementTest) {
+    auto request = folly::stringPrintf("http://%s:%d/placement", FLAGS_ws_ip.c_str(),
+                                       FLAGS_ws_http_port);
+    auto resp = http::HttpClient::get(request);
+    ASSERT_TRUE(resp.ok());
+    auto json = folly::parseJson(resp.value());
+    ASSERT_TRUE(json.isArray());
+    auto found = false;
+    for (auto &thread : json) {
+        if (thread["name"].asString() == "webservice-list") {
+            // The listener floats
+            ASSERT_EQ(-1, thread["node"].asInt());
+            ASSERT_EQ("any", thread["cpus"].asString());
+            found = true;
+        }
+    }
+    ASSERT_TRUE(found) << folly::toPrettyJson(json);
+}
+
 }  // namespace nebula
 
 